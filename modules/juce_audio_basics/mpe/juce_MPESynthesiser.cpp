@@ -259,6 +259,9 @@ void MPESynthesiser::addVoice (MPESynthesiserVoice* const newVoice)
     const ScopedLock sl (voicesLock);
     newVoice->setCurrentSampleRate (getSampleRate());
     voices.add (newVoice);
+
+    if (parallelRenderer != nullptr)
+        voicesToRender.reserve ((size_t) voices.size());
 }
 
 void MPESynthesiser::clearVoices()
@@ -317,9 +320,33 @@ void MPESynthesiser::turnOffAllVoices (bool allowTailOff)
 
 //==============================================================================
 void MPESynthesiser::renderNextSubBlock (AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    renderActiveVoices (buffer, startSample, numSamples);
+}
+
+void MPESynthesiser::renderNextSubBlock (AudioBuffer<double>& buffer, int startSample, int numSamples)
+{
+    renderActiveVoices (buffer, startSample, numSamples);
+}
+
+template <typename floatType>
+void MPESynthesiser::renderActiveVoices (AudioBuffer<floatType>& buffer, int startSample, int numSamples)
 {
     const ScopedLock sl (voicesLock);
 
+    if (parallelRenderer != nullptr)
+    {
+        voicesToRender.clear();
+
+        for (auto* voice : voices)
+            if (voice->isActive())
+                voicesToRender.push_back (voice);
+
+        if (parallelRenderer->render (voicesToRender.data(), (int) voicesToRender.size(),
+                                      buffer, startSample, numSamples))
+            return;
+    }
+
     for (auto* voice : voices)
     {
         if (voice->isActive())
@@ -327,15 +354,25 @@ void MPESynthesiser::renderNextSubBlock (AudioBuffer<float>& buffer, int startSa
     }
 }
 
-void MPESynthesiser::renderNextSubBlock (AudioBuffer<double>& buffer, int startSample, int numSamples)
+//==============================================================================
+void MPESynthesiser::setNumRenderingThreads (int numThreads, int maxNumChannels, int maximumBlockSize)
 {
-    const ScopedLock sl (voicesLock);
+    std::unique_ptr<ParallelVoiceRenderer> newRenderer;
+
+    if (numThreads > 1)
+        newRenderer = std::make_unique<ParallelVoiceRenderer> (numThreads, maxNumChannels, maximumBlockSize);
 
-    for (auto* voice : voices)
     {
-        if (voice->isActive())
-            voice->renderNextBlock (buffer, startSample, numSamples);
+        const ScopedLock sl (voicesLock);
+        std::swap (parallelRenderer, newRenderer);
+        voicesToRender.reserve ((size_t) voices.size());
     }
 }
 
+int MPESynthesiser::getNumRenderingThreads() const noexcept
+{
+    const ScopedLock sl (voicesLock);
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
+}
+
 } // namespace juce
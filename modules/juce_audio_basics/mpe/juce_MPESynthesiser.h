@@ -23,6 +23,8 @@
 namespace juce
 {
 
+class ParallelVoiceRenderer;
+
 //==============================================================================
 /**
     Base class for an MPE-compatible musical device that can play sounds.
@@ -173,6 +175,32 @@ public:
     virtual void handleProgramChange (int /*midiChannel*/,
                                       int /*programNumber*/) {}
 
+    //==============================================================================
+    /** Makes the synth render its voices on several threads at once.
+
+        Each worker thread renders a share of the active voices into its own scratch buffer,
+        and these are added to the output at the end of each sub-block, so MIDI events are
+        still handled with the same timing accuracy as usual. This is only worthwhile when
+        your voices are expensive to render, and your voices' renderNextBlock() methods must
+        be safe to call at the same time as those of other voices.
+
+        This creates threads and allocates buffers, so call it from a non-realtime
+        thread, e.g. in your prepareToPlay() method.
+
+        @param numThreads           the total number of threads to render with, including the
+                                    one that calls renderNextBlock(). A value of 1 or less
+                                    turns off multi-threaded rendering.
+        @param maxNumChannels       the largest number of channels that will be rendered
+        @param maximumBlockSize     the largest number of samples that will be rendered in one
+                                    block. Any larger blocks will be rendered on a single thread.
+    */
+    void setNumRenderingThreads (int numThreads, int maxNumChannels, int maximumBlockSize);
+
+    /** Returns the number of threads that are used to render the voices.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
 protected:
     //==============================================================================
     /** Attempts to start playing a new note.
@@ -305,6 +333,12 @@ private:
     std::atomic<bool> shouldStealVoices { false };
     uint32 lastNoteOnCounter = 0;
 
+    std::unique_ptr<ParallelVoiceRenderer> parallelRenderer;
+    std::vector<MPESynthesiserVoice*> voicesToRender;
+
+    template <typename floatType>
+    void renderActiveVoices (AudioBuffer<floatType>&, int startSample, int numSamples);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MPESynthesiser)
 };
 
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Used internally by Synthesiser and MPESynthesiser to render a set of voices
+    on several threads at once.
+
+    The thread that calls render() renders its share of the voices straight into
+    the output buffer, while each worker thread renders into a private scratch buffer.
+    When all the voices are finished, the scratch buffers are added to the output.
+
+    @tags{Audio}
+*/
+class ParallelVoiceRenderer
+{
+public:
+    ParallelVoiceRenderer (int numThreadsToUse, int maxNumChannels, int maxBlockSize)
+        : numChannels (maxNumChannels),
+          maxNumSamples (maxBlockSize)
+    {
+        jassert (numThreadsToUse > 1 && maxNumChannels > 0 && maxBlockSize > 0);
+
+        for (int i = 1; i < numThreadsToUse; ++i)
+            workers.add (new Worker (*this, i));
+
+        for (auto* w : workers)
+            w->startThread (Thread::realtimeAudioPriority);
+    }
+
+    ~ParallelVoiceRenderer()
+    {
+        for (auto* w : workers)
+            w->signalThreadShouldExit();
+
+        for (auto* w : workers)
+            w->startEvent.signal();
+
+        for (auto* w : workers)
+            w->stopThread (1000);
+    }
+
+    /** Returns the total number of threads, including the one that calls render(). */
+    int getNumThreads() const noexcept      { return workers.size() + 1; }
+
+    /** Renders a list of voices, adding their output to the given region of the buffer.
+
+        Returns false without rendering anything if the buffer is too large for the
+        scratch buffers, in which case the caller should render the voices itself.
+
+        This never blocks waiting for a worker thread to wake up: any voices that the
+        workers haven't picked up by the time the calling thread runs out of work are
+        rendered by the calling thread instead.
+    */
+    template <typename VoiceType, typename FloatType>
+    bool render (VoiceType* const* voicesToRender, int numVoicesToRender,
+                 AudioBuffer<FloatType>& output, int startSample, int numSamples)
+    {
+        if (output.getNumSamples() > maxNumSamples || output.getNumChannels() > numChannels)
+            return false;
+
+        if (numVoicesToRender < 2)
+        {
+            for (int i = 0; i < numVoicesToRender; ++i)
+                voicesToRender[i]->renderNextBlock (output, startSample, numSamples);
+
+            return true;
+        }
+
+        jobVoices = voicesToRender;
+        jobNumChannels = output.getNumChannels();
+        jobBufferSize = output.getNumSamples();
+        jobStartSample = startSample;
+        jobNumSamples = numSamples;
+        jobRenderFunction = renderVoice<VoiceType, FloatType>;
+        numVoices = numVoicesToRender;
+        nextVoice = 0;
+
+        for (auto* w : workers)
+            w->hasRenderedVoices = false;
+
+        jobState.store (jobIsOpen, std::memory_order_release);
+
+        for (auto* w : workers)
+            w->startEvent.signal();
+
+        for (int i = nextVoice++; i < numVoices; i = nextVoice++)
+            voicesToRender[i]->renderNextBlock (output, startSample, numSamples);
+
+        // Every voice has now been claimed, so stop any more workers from joining in, and
+        // wait for the ones that are still busy to finish the voices they're rendering.
+        jobState.fetch_and (~jobIsOpen, std::memory_order_acq_rel);
+
+        while (jobState.load (std::memory_order_acquire) != 0)
+            Thread::yield();
+
+        for (auto* w : workers)
+            if (w->hasRenderedVoices)
+                for (int ch = 0; ch < jobNumChannels; ++ch)
+                    FloatVectorOperations::add (output.getWritePointer (ch, startSample),
+                                                std::get<AudioBuffer<FloatType>> (w->scratch).getReadPointer (ch, startSample),
+                                                numSamples);
+
+        return true;
+    }
+
+private:
+    //==============================================================================
+    struct Worker  : public Thread
+    {
+        Worker (ParallelVoiceRenderer& r, int index)
+            : Thread ("Voice renderer " + String (index)),
+              owner (r)
+        {
+            std::get<AudioBuffer<float>>  (scratch).setSize (owner.numChannels, owner.maxNumSamples);
+            std::get<AudioBuffer<double>> (scratch).setSize (owner.numChannels, owner.maxNumSamples);
+        }
+
+        void run() override
+        {
+            for (;;)
+            {
+                startEvent.wait (-1);
+
+                if (threadShouldExit())
+                    return;
+
+                // If this thread woke up too late, the job will already be closed, and the
+                // calling thread will have rendered all the voices itself.
+                if (! owner.tryToJoinJob())
+                    continue;
+
+                for (int i = owner.nextVoice++; i < owner.numVoices; i = owner.nextVoice++)
+                {
+                    owner.jobRenderFunction (owner, *this, i);
+                    hasRenderedVoices = true;
+                }
+
+                owner.jobState.fetch_sub (oneWorker, std::memory_order_release);
+            }
+        }
+
+        ParallelVoiceRenderer& owner;
+        WaitableEvent startEvent;
+        std::tuple<AudioBuffer<float>, AudioBuffer<double>> scratch;
+        bool hasRenderedVoices = false;
+    };
+
+    bool tryToJoinJob() noexcept
+    {
+        auto state = jobState.load (std::memory_order_relaxed);
+
+        while ((state & jobIsOpen) != 0)
+            if (jobState.compare_exchange_weak (state, state + oneWorker, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+
+        return false;
+    }
+
+    template <typename VoiceType, typename FloatType>
+    static void renderVoice (ParallelVoiceRenderer& renderer, Worker& worker, int voiceIndex)
+    {
+        auto& scratch = std::get<AudioBuffer<FloatType>> (worker.scratch);
+
+        // The scratch buffer is cleared lazily, so that workers which don't get any
+        // voices to render don't need to touch it at all
+        if (! worker.hasRenderedVoices)
+            for (int ch = 0; ch < renderer.jobNumChannels; ++ch)
+                FloatVectorOperations::clear (scratch.getWritePointer (ch, renderer.jobStartSample), renderer.jobNumSamples);
+
+        // The voice sees a buffer with the same size as the caller's, so that it gets called
+        // with exactly the same arguments as it would when rendering on a single thread
+        AudioBuffer<FloatType> region (scratch.getArrayOfWritePointers(), renderer.jobNumChannels,
+                                       renderer.jobBufferSize);
+
+        static_cast<VoiceType* const*> (renderer.jobVoices)[voiceIndex]->renderNextBlock (region, renderer.jobStartSample,
+                                                                                           renderer.jobNumSamples);
+    }
+
+    //==============================================================================
+    // The lowest bit of jobState is set while workers may join the current job, and the
+    // rest of it counts the workers that have joined and not yet finished.
+    enum { jobIsOpen = 1, oneWorker = 2 };
+
+    const int numChannels, maxNumSamples;
+    OwnedArray<Worker> workers;
+
+    const void* jobVoices = nullptr;
+    int jobNumChannels = 0, jobBufferSize = 0, jobStartSample = 0, jobNumSamples = 0;
+    void (*jobRenderFunction) (ParallelVoiceRenderer&, Worker&, int) = nullptr;
+    std::atomic<int> nextVoice { 0 }, numVoices { 0 }, jobState { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelVoiceRenderer)
+};
+
+} // namespace juce
@@ -94,19 +94,61 @@ void Synthesiser::clearVoices()
 {
     const ScopedLock sl (lock);
     voices.clear();
+    rebuildVoiceLists();
 }
 
 SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
     const ScopedLock sl (lock);
     newVoice->setCurrentPlaybackSampleRate (sampleRate);
-    return voices.add (newVoice);
+    newVoice->nextVoiceWithSameNote = nullptr;
+    newVoice->indexedNote = -1;
+    newVoice->indexInSynth = voices.size();
+    newVoice->isInActiveVoiceList = false;
+    voices.add (newVoice);
+    voicesToRender.reserve ((size_t) voices.size());
+
+    if (trackActiveVoices)
+    {
+        activeVoices.reserve ((size_t) voices.size());
+
+        if (newVoice->isVoiceActive())
+        {
+            auto insertPos = std::upper_bound (activeVoices.begin(), activeVoices.end(), newVoice,
+                                               [] (const SynthesiserVoice* a, const SynthesiserVoice* b) { return a->wasStartedBefore (*b); });
+            activeVoices.insert (insertPos, newVoice);
+            newVoice->isInActiveVoiceList = true;
+            addToNoteIndex (newVoice);
+        }
+        else
+        {
+            freeVoices.setBit (newVoice->indexInSynth);
+        }
+    }
+
+    return newVoice;
 }
 
 void Synthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (lock);
-    voices.remove (index);
+
+    if (auto* voice = voices[index])
+    {
+        if (trackActiveVoices)
+        {
+            if (voice->isInActiveVoiceList)
+                activeVoices.erase (std::find (activeVoices.begin(), activeVoices.end(), voice));
+
+            removeFromNoteIndex (voice);
+            freeVoices.shiftBits (-1, index);
+        }
+
+        for (int i = index + 1; i < voices.size(); ++i)
+            --(voices.getUnchecked (i)->indexInSynth);
+
+        voices.remove (index);
+    }
 }
 
 void Synthesiser::clearSounds()
@@ -139,6 +181,153 @@ void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples, bool shoul
     subBlockSubdivisionIsStrict = shouldBeStrict;
 }
 
+//==============================================================================
+void Synthesiser::setActiveVoiceTrackingEnabled (bool shouldBeEnabled)
+{
+    const ScopedLock sl (lock);
+    trackActiveVoices = shouldBeEnabled;
+    rebuildVoiceLists();
+}
+
+void Synthesiser::setNumRenderingThreads (int numThreads, int maxNumChannels, int maximumBlockSize)
+{
+    std::unique_ptr<ParallelVoiceRenderer> newRenderer;
+
+    if (numThreads > 1)
+        newRenderer = std::make_unique<ParallelVoiceRenderer> (numThreads, maxNumChannels, maximumBlockSize);
+
+    {
+        const ScopedLock sl (lock);
+        std::swap (parallelRenderer, newRenderer);
+        voicesToRender.reserve ((size_t) voices.size());
+    }
+}
+
+int Synthesiser::getNumRenderingThreads() const noexcept
+{
+    const ScopedLock sl (lock);
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
+}
+
+void Synthesiser::rebuildVoiceLists()
+{
+    activeVoices.clear();
+    freeVoices.clear();
+    std::fill (std::begin (firstVoiceForNote), std::end (firstVoiceForNote), nullptr);
+
+    for (int i = 0; i < voices.size(); ++i)
+    {
+        auto* voice = voices.getUnchecked (i);
+        voice->nextVoiceWithSameNote = nullptr;
+        voice->indexedNote = -1;
+        voice->indexInSynth = i;
+        voice->isInActiveVoiceList = false;
+    }
+
+    voicesToRender.reserve ((size_t) voices.size());
+
+    if (! trackActiveVoices)
+        return;
+
+    // reserve enough space that the lists never need to allocate on the audio thread
+    activeVoices.reserve ((size_t) voices.size());
+    freeVoices.setRange (0, voices.size(), true);
+
+    for (auto* voice : voices)
+    {
+        if (voice->isVoiceActive())
+        {
+            activeVoices.push_back (voice);
+            freeVoices.clearBit (voice->indexInSynth);
+        }
+    }
+
+    std::sort (activeVoices.begin(), activeVoices.end(),
+               [] (const SynthesiserVoice* a, const SynthesiserVoice* b) { return a->wasStartedBefore (*b); });
+
+    for (auto* voice : activeVoices)
+    {
+        voice->isInActiveVoiceList = true;
+        addToNoteIndex (voice);
+    }
+}
+
+void Synthesiser::updateActiveVoiceLists()
+{
+    auto newEnd = std::remove_if (activeVoices.begin(), activeVoices.end(), [this] (SynthesiserVoice* voice)
+    {
+        if (voice->isVoiceActive())
+            return false;
+
+        removeFromNoteIndex (voice);
+        voice->isInActiveVoiceList = false;
+        freeVoices.setBit (voice->indexInSynth);
+        return true;
+    });
+
+    activeVoices.erase (newEnd, activeVoices.end());
+}
+
+void Synthesiser::addToNoteIndex (SynthesiserVoice* voice) noexcept
+{
+    auto note = voice->getCurrentlyPlayingNote();
+
+    if (isPositiveAndBelow (note, numElementsInArray (firstVoiceForNote)))
+    {
+        voice->nextVoiceWithSameNote = firstVoiceForNote[note];
+        voice->indexedNote = note;
+        firstVoiceForNote[note] = voice;
+    }
+}
+
+void Synthesiser::removeFromNoteIndex (SynthesiserVoice* voice) noexcept
+{
+    if (voice->indexedNote < 0)
+        return;
+
+    for (auto** v = firstVoiceForNote + voice->indexedNote; *v != nullptr; v = &((*v)->nextVoiceWithSameNote))
+    {
+        if (*v == voice)
+        {
+            *v = voice->nextVoiceWithSameNote;
+            break;
+        }
+    }
+
+    voice->nextVoiceWithSameNote = nullptr;
+    voice->indexedNote = -1;
+}
+
+template <typename Callback>
+void Synthesiser::forEachVoice (Callback&& callback)
+{
+    if (trackActiveVoices)
+    {
+        for (auto* voice : activeVoices)
+            callback (voice);
+    }
+    else
+    {
+        for (auto* voice : voices)
+            callback (voice);
+    }
+}
+
+template <typename Callback>
+void Synthesiser::forEachVoicePlayingNote (int midiNoteNumber, Callback&& callback)
+{
+    if (! trackActiveVoices)
+    {
+        for (auto* voice : voices)
+            callback (voice);
+    }
+    else if (isPositiveAndBelow (midiNoteNumber, numElementsInArray (firstVoiceForNote)))
+    {
+        for (auto* voice = firstVoiceForNote[midiNoteNumber]; voice != nullptr; voice = voice->nextVoiceWithSameNote)
+            callback (voice);
+    }
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -230,14 +419,38 @@ void Synthesiser::renderNextBlock (AudioBuffer<double>& outputAudio, const MidiB
 
 void Synthesiser::renderVoices (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
-    for (auto* voice : voices)
-        voice->renderNextBlock (buffer, startSample, numSamples);
+    renderAllVoices (buffer, startSample, numSamples);
 }
 
 void Synthesiser::renderVoices (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
-    for (auto* voice : voices)
-        voice->renderNextBlock (buffer, startSample, numSamples);
+    renderAllVoices (buffer, startSample, numSamples);
+}
+
+template <typename floatType>
+void Synthesiser::renderAllVoices (AudioBuffer<floatType>& buffer, int startSample, int numSamples)
+{
+    bool hasRendered = false;
+
+    if (parallelRenderer != nullptr)
+    {
+        voicesToRender.clear();
+
+        forEachVoice ([this] (SynthesiserVoice* voice)
+        {
+            if (voice->isVoiceActive())
+                voicesToRender.push_back (voice);
+        });
+
+        hasRendered = parallelRenderer->render (voicesToRender.data(), (int) voicesToRender.size(),
+                                                buffer, startSample, numSamples);
+    }
+
+    if (! hasRendered)
+        forEachVoice ([&] (SynthesiserVoice* voice) { voice->renderNextBlock (buffer, startSample, numSamples); });
+
+    if (trackActiveVoices)
+        updateActiveVoiceLists();
 }
 
 void Synthesiser::handleMidiEvent (const MidiMessage& m)
@@ -293,9 +506,14 @@ void Synthesiser::noteOn (const int midiChannel,
         {
             // If hitting a note that's still ringing, stop it first (it could be
             // still playing because of the sustain or sostenuto pedal).
-            for (auto* voice : voices)
+            forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice* voice)
+            {
                 if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel (midiChannel))
                     stopVoice (voice, 1.0f, true);
+            });
+
+            if (trackActiveVoices)
+                updateActiveVoiceLists();
 
             startVoice (findFreeVoice (sound, midiChannel, midiNoteNumber, shouldStealNotes),
                         sound, midiChannel, midiNoteNumber, velocity);
@@ -322,6 +540,25 @@ void Synthesiser::startVoice (SynthesiserVoice* const voice,
         voice->setSostenutoPedalDown (false);
         voice->setSustainPedalDown (sustainPedalsDown[midiChannel]);
 
+        if (trackActiveVoices)
+        {
+            // move the voice to the end of the active list, which is kept in order of age
+            if (voice->isInActiveVoiceList)
+            {
+                auto iter = std::find (activeVoices.rbegin(), activeVoices.rend(), voice);
+                activeVoices.erase (std::next (iter).base());
+            }
+            else if (voice->indexInSynth >= 0)
+            {
+                freeVoices.clearBit (voice->indexInSynth);
+            }
+
+            removeFromNoteIndex (voice);
+            activeVoices.push_back (voice);
+            voice->isInActiveVoiceList = true;
+            addToNoteIndex (voice);
+        }
+
         voice->startNote (midiNoteNumber, velocity, sound,
                           lastPitchWheelValues [midiChannel - 1]);
     }
@@ -344,7 +581,7 @@ void Synthesiser::noteOff (const int midiChannel,
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice* voice)
     {
         if (voice->getCurrentlyPlayingNote() == midiNoteNumber
               && voice->isPlayingChannel (midiChannel))
@@ -363,16 +600,18 @@ void Synthesiser::noteOff (const int midiChannel,
                 }
             }
         }
-    }
+    });
 }
 
 void Synthesiser::allNotesOff (const int midiChannel, const bool allowTailOff)
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoice ([&] (SynthesiserVoice* voice)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->stopNote (1.0f, allowTailOff);
+    });
 
     sustainPedalsDown.clear();
 }
@@ -381,9 +620,11 @@ void Synthesiser::handlePitchWheel (const int midiChannel, const int wheelValue)
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoice ([&] (SynthesiserVoice* voice)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->pitchWheelMoved (wheelValue);
+    });
 }
 
 void Synthesiser::handleController (const int midiChannel,
@@ -400,28 +641,34 @@ void Synthesiser::handleController (const int midiChannel,
 
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoice ([&] (SynthesiserVoice* voice)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->controllerMoved (controllerNumber, controllerValue);
+    });
 }
 
 void Synthesiser::handleAftertouch (int midiChannel, int midiNoteNumber, int aftertouchValue)
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice* voice)
+    {
         if (voice->getCurrentlyPlayingNote() == midiNoteNumber
               && (midiChannel <= 0 || voice->isPlayingChannel (midiChannel)))
             voice->aftertouchChanged (aftertouchValue);
+    });
 }
 
 void Synthesiser::handleChannelPressure (int midiChannel, int channelPressureValue)
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoice ([&] (SynthesiserVoice* voice)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->channelPressureChanged (channelPressureValue);
+    });
 }
 
 void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
@@ -433,13 +680,15 @@ void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
     {
         sustainPedalsDown.setBit (midiChannel);
 
-        for (auto* voice : voices)
+        forEachVoice ([&] (SynthesiserVoice* voice)
+        {
             if (voice->isPlayingChannel (midiChannel) && voice->isKeyDown())
                 voice->setSustainPedalDown (true);
+        });
     }
     else
     {
-        for (auto* voice : voices)
+        forEachVoice ([&] (SynthesiserVoice* voice)
         {
             if (voice->isPlayingChannel (midiChannel))
             {
@@ -448,7 +697,7 @@ void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
                 if (! (voice->isKeyDown() || voice->isSostenutoPedalDown()))
                     stopVoice (voice, 1.0f, true);
             }
-        }
+        });
 
         sustainPedalsDown.clearBit (midiChannel);
     }
@@ -459,7 +708,7 @@ void Synthesiser::handleSostenutoPedal (int midiChannel, bool isDown)
     jassert (midiChannel > 0 && midiChannel <= 16);
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoice ([&] (SynthesiserVoice* voice)
     {
         if (voice->isPlayingChannel (midiChannel))
         {
@@ -468,7 +717,7 @@ void Synthesiser::handleSostenutoPedal (int midiChannel, bool isDown)
             else if (voice->isSostenutoPedalDown())
                 stopVoice (voice, 1.0f, true);
         }
-    }
+    });
 }
 
 void Synthesiser::handleSoftPedal (int midiChannel, bool /*isDown*/)
@@ -490,9 +739,22 @@ SynthesiserVoice* Synthesiser::findFreeVoice (SynthesiserSound* soundToPlay,
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
-        if ((! voice->isVoiceActive()) && voice->canPlaySound (soundToPlay))
-            return voice;
+    if (trackActiveVoices)
+    {
+        for (int i = freeVoices.findNextSetBit (0); i >= 0; i = freeVoices.findNextSetBit (i + 1))
+        {
+            auto* voice = voices.getUnchecked (i);
+
+            if ((! voice->isVoiceActive()) && voice->canPlaySound (soundToPlay))
+                return voice;
+        }
+    }
+    else
+    {
+        for (auto* voice : voices)
+            if ((! voice->isVoiceActive()) && voice->canPlaySound (soundToPlay))
+                return voice;
+    }
 
     if (stealIfNoneAvailable)
         return findVoiceToSteal (soundToPlay, midiChannel, midiNoteNumber);
@@ -500,6 +762,44 @@ SynthesiserVoice* Synthesiser::findFreeVoice (SynthesiserSound* soundToPlay,
     return nullptr;
 }
 
+template <typename VoiceList>
+static SynthesiserVoice* chooseVoiceToSteal (const VoiceList& voicesOldestFirst, SynthesiserSound* soundToPlay,
+                                             int midiNoteNumber, SynthesiserVoice* low, SynthesiserVoice* top)
+{
+    // Eliminate pathological cases (ie: only 1 note playing): we always give precedence to the lowest note(s)
+    if (top == low)
+        top = nullptr;
+
+    // The oldest note that's playing with the target pitch is ideal..
+    for (auto* voice : voicesOldestFirst)
+        if (voice->canPlaySound (soundToPlay) && voice->getCurrentlyPlayingNote() == midiNoteNumber)
+            return voice;
+
+    // Oldest voice that has been released (no finger on it and not held by sustain pedal)
+    for (auto* voice : voicesOldestFirst)
+        if (voice != low && voice != top && voice->canPlaySound (soundToPlay) && voice->isPlayingButReleased())
+            return voice;
+
+    // Oldest voice that doesn't have a finger on it:
+    for (auto* voice : voicesOldestFirst)
+        if (voice != low && voice != top && voice->canPlaySound (soundToPlay) && ! voice->isKeyDown())
+            return voice;
+
+    // Oldest voice that isn't protected
+    for (auto* voice : voicesOldestFirst)
+        if (voice != low && voice != top && voice->canPlaySound (soundToPlay))
+            return voice;
+
+    // We've only got "protected" voices now: lowest note takes priority
+    jassert (low != nullptr);
+
+    // Duophonic synth: give priority to the bass note:
+    if (top != nullptr)
+        return top;
+
+    return low;
+}
+
 SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
                                                  int /*midiChannel*/, int midiNoteNumber) const
 {
@@ -514,6 +814,44 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
     SynthesiserVoice* low = nullptr; // Lowest sounding note, might be sustained, but NOT in release phase
     SynthesiserVoice* top = nullptr; // Highest sounding note, might be sustained, but NOT in release phase
 
+    auto checkProtectedVoices = [&] (SynthesiserVoice* voice)
+    {
+        if (! voice->isPlayingButReleased()) // Don't protect released notes
+        {
+            auto note = voice->getCurrentlyPlayingNote();
+
+            // When several voices are playing the same note, pick the first one in the voices
+            // array. The active voice list isn't in that order, so needs an explicit check.
+            auto comesFirst = [this, voice] (SynthesiserVoice* other)
+            {
+                return trackActiveVoices && voice->indexInSynth < other->indexInSynth;
+            };
+
+            if (low == nullptr || note < low->getCurrentlyPlayingNote()
+                 || (note == low->getCurrentlyPlayingNote() && comesFirst (low)))
+                low = voice;
+
+            if (top == nullptr || note > top->getCurrentlyPlayingNote()
+                 || (note == top->getCurrentlyPlayingNote() && comesFirst (top)))
+                top = voice;
+        }
+    };
+
+    if (trackActiveVoices)
+    {
+        // The active voice list is already sorted by age, so there's no need to build a new one
+        for (auto* voice : activeVoices)
+        {
+            if (voice->canPlaySound (soundToPlay))
+            {
+                jassert (voice->isVoiceActive()); // We wouldn't be here otherwise
+                checkProtectedVoices (voice);
+            }
+        }
+
+        return chooseVoiceToSteal (activeVoices, soundToPlay, midiNoteNumber, low, top);
+    }
+
     // this is a list of voices we can steal, sorted by how long they've been running
     Array<SynthesiserVoice*> usableVoices;
     usableVoices.ensureStorageAllocated (voices.size());
@@ -525,61 +863,301 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
             jassert (voice->isVoiceActive()); // We wouldn't be here otherwise
 
             usableVoices.add (voice);
+            checkProtectedVoices (voice);
+        }
+    }
 
-            // NB: Using a functor rather than a lambda here due to scare-stories about
-            // compilers generating code containing heap allocations..
-            struct Sorter
+    struct Sorter
+    {
+        bool operator() (const SynthesiserVoice* a, const SynthesiserVoice* b) const noexcept { return a->wasStartedBefore (*b); }
+    };
+
+    std::sort (usableVoices.begin(), usableVoices.end(), Sorter());
+
+    return chooseVoiceToSteal (usableVoices, soundToPlay, midiNoteNumber, low, top);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SynthesiserTests  : public UnitTest
+{
+public:
+    SynthesiserTests()
+        : UnitTest ("Synthesiser", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Active voice tracking produces the same output as the default mode");
+        {
+            auto random = getRandom();
+
+            for (int iteration = 0; iteration < 5; ++iteration)
             {
-                bool operator() (const SynthesiserVoice* a, const SynthesiserVoice* b) const noexcept { return a->wasStartedBefore (*b); }
-            };
+                const auto numVoices = 16 << random.nextInt (6);
+
+                Synthesiser defaultSynth, trackingSynth;
+                prepare (defaultSynth, numVoices);
+                prepare (trackingSynth, numVoices);
+                trackingSynth.setActiveVoiceTrackingEnabled (true);
+
+                AudioBuffer<float> defaultOutput (1, blockSize), trackingOutput (1, blockSize);
+
+                for (int block = 0; block < 50; ++block)
+                {
+                    auto midi = createDenseMidi (random);
+
+                    defaultOutput.clear();
+                    trackingOutput.clear();
+                    defaultSynth.renderNextBlock (defaultOutput, midi, 0, blockSize);
+                    trackingSynth.renderNextBlock (trackingOutput, midi, 0, blockSize);
+
+                    for (int i = 0; i < blockSize; ++i)
+                        expectWithinAbsoluteError (trackingOutput.getSample (0, i),
+                                                   defaultOutput.getSample (0, i),
+                                                   1.0e-3f);
+
+                    expectEquals (countActiveVoices (trackingSynth), countActiveVoices (defaultSynth));
+                }
+            }
+        }
+
+        beginTest ("Voice lists are updated when voices change");
+        {
+            Synthesiser synth;
+            prepare (synth, 4);
+            synth.setActiveVoiceTrackingEnabled (true);
+
+            for (int note = 60; note < 64; ++note)
+                synth.noteOn (1, note, 1.0f);
+
+            expectEquals (countActiveVoices (synth), 4);
+
+            synth.removeVoice (0);
+            synth.addVoice (new TestVoice());
+            synth.noteOn (1, 70, 1.0f);
+
+            expectEquals (countActiveVoices (synth), 4);
+
+            synth.noteOff (1, 70, 1.0f, false);
+            synth.allNotesOff (1, false);
+            expectEquals (countActiveVoices (synth), 0);
+        }
+
+        beginTest ("Adding and removing voices allocates voices as the default mode does");
+        {
+            Synthesiser defaultSynth, trackingSynth;
+            prepare (defaultSynth, 8);
+            prepare (trackingSynth, 8);
+            trackingSynth.setActiveVoiceTrackingEnabled (true);
+
+            for (auto* synth : { &defaultSynth, &trackingSynth })
+            {
+                for (int note = 60; note < 66; ++note)
+                    synth->noteOn (1, note, 1.0f);
+
+                synth->noteOff (1, 61, 1.0f, false);
+                synth->noteOff (1, 64, 1.0f, false);
+                synth->removeVoice (2);
+                synth->removeVoice (0);
+                synth->addVoice (new TestVoice());
+
+                for (int note = 70; note < 74; ++note)
+                    synth->noteOn (1, note, 1.0f);
+
+                synth->noteOff (1, 63, 1.0f, false);
+            }
+
+            expectEquals (trackingSynth.getNumVoices(), defaultSynth.getNumVoices());
+
+            for (int i = 0; i < defaultSynth.getNumVoices(); ++i)
+                expectEquals (trackingSynth.getVoice (i)->getCurrentlyPlayingNote(),
+                              defaultSynth.getVoice (i)->getCurrentlyPlayingNote());
+
+            expectEquals (countActiveVoices (trackingSynth), countActiveVoices (defaultSynth));
+        }
 
-            std::sort (usableVoices.begin(), usableVoices.end(), Sorter());
+        beginTest ("Multi-threaded rendering produces the same output as single-threaded rendering");
+        {
+            auto random = getRandom();
 
-            if (! voice->isPlayingButReleased()) // Don't protect released notes
+            for (int iteration = 0; iteration < 4; ++iteration)
             {
-                auto note = voice->getCurrentlyPlayingNote();
+                Synthesiser serialSynth, parallelSynth;
+                prepare (serialSynth, 64);
+                prepare (parallelSynth, 64);
+
+                parallelSynth.setNumRenderingThreads (2 + iteration % 3, 1, blockSize);
+                parallelSynth.setActiveVoiceTrackingEnabled (iteration % 2 == 1);
+                expectEquals (parallelSynth.getNumRenderingThreads(), 2 + iteration % 3);
+
+                AudioBuffer<float> serialOutput (1, blockSize), parallelOutput (1, blockSize);
+
+                for (int block = 0; block < 50; ++block)
+                {
+                    auto midi = createDenseMidi (random);
+
+                    serialOutput.clear();
+                    parallelOutput.clear();
+                    serialSynth.renderNextBlock (serialOutput, midi, 0, blockSize);
+                    parallelSynth.renderNextBlock (parallelOutput, midi, 0, blockSize);
 
-                if (low == nullptr || note < low->getCurrentlyPlayingNote())
-                    low = voice;
+                    for (int i = 0; i < blockSize; ++i)
+                        expectWithinAbsoluteError (parallelOutput.getSample (0, i),
+                                                   serialOutput.getSample (0, i),
+                                                   1.0e-3f);
 
-                if (top == nullptr || note > top->getCurrentlyPlayingNote())
-                    top = voice;
+                    expectEquals (countActiveVoices (parallelSynth), countActiveVoices (serialSynth));
+                }
+
+                parallelSynth.setNumRenderingThreads (1, 1, blockSize);
+                expectEquals (parallelSynth.getNumRenderingThreads(), 1);
             }
         }
+
+        beginTest ("Multi-threaded rendering passes the caller's buffer size and start sample to the voices");
+        {
+            Synthesiser serialSynth, parallelSynth;
+            prepare (serialSynth, 16);
+            prepare (parallelSynth, 16);
+            parallelSynth.setNumRenderingThreads (3, 1, blockSize * 2);
+
+            constexpr int startSample = 100;
+            MidiBuffer midi;
+
+            for (int note = 60; note < 76; ++note)
+                midi.addEvent (MidiMessage::noteOn (1, note, (uint8) 100), startSample);
+
+            AudioBuffer<float> serialOutput (1, blockSize * 2), parallelOutput (1, blockSize * 2);
+
+            for (auto* buffer : { &serialOutput, &parallelOutput })
+                buffer->clear();
+
+            serialSynth.renderNextBlock (serialOutput, midi, startSample, blockSize);
+            parallelSynth.renderNextBlock (parallelOutput, midi, startSample, blockSize);
+
+            for (int i = 0; i < parallelSynth.getNumVoices(); ++i)
+            {
+                auto* voice = dynamic_cast<TestVoice*> (parallelSynth.getVoice (i));
+                expectEquals (voice->lastBufferSize, blockSize * 2);
+                expectEquals (voice->lastStartSample, startSample);
+            }
+
+            for (int i = 0; i < blockSize * 2; ++i)
+                expectWithinAbsoluteError (parallelOutput.getSample (0, i), serialOutput.getSample (0, i), 1.0e-3f);
+
+            expectEquals (parallelOutput.getMagnitude (0, startSample), 0.0f);
+            expectEquals (parallelOutput.getMagnitude (startSample + blockSize, blockSize - startSample), 0.0f);
+        }
     }
 
-    // Eliminate pathological cases (ie: only 1 note playing): we always give precedence to the lowest note(s)
-    if (top == low)
-        top = nullptr;
+private:
+    static constexpr int blockSize = 256;
 
-    // The oldest note that's playing with the target pitch is ideal..
-    for (auto* voice : usableVoices)
-        if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
-            return voice;
+    struct TestSound  : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
 
-    // Oldest voice that has been released (no finger on it and not held by sustain pedal)
-    for (auto* voice : usableVoices)
-        if (voice != low && voice != top && voice->isPlayingButReleased())
-            return voice;
+    struct TestVoice  : public SynthesiserVoice
+    {
+        bool canPlaySound (SynthesiserSound*) override  { return true; }
 
-    // Oldest voice that doesn't have a finger on it:
-    for (auto* voice : usableVoices)
-        if (voice != low && voice != top && ! voice->isKeyDown())
-            return voice;
+        void startNote (int note, float velocity, SynthesiserSound*, int) override
+        {
+            phase = 0;
+            level = velocity;
+            increment = (double) note / 1000.0;
+            tailOff = 0;
+        }
 
-    // Oldest voice that isn't protected
-    for (auto* voice : usableVoices)
-        if (voice != low && voice != top)
-            return voice;
+        void stopNote (float, bool allowTailOff) override
+        {
+            if (allowTailOff)
+                tailOff = 1.0;
+            else
+                clearCurrentNote();
+        }
 
-    // We've only got "protected" voices now: lowest note takes priority
-    jassert (low != nullptr);
+        void pitchWheelMoved (int) override {}
+        void controllerMoved (int, int) override {}
 
-    // Duophonic synth: give priority to the bass note:
-    if (top != nullptr)
-        return top;
+        void renderNextBlock (AudioBuffer<float>& output, int startSample, int numSamples) override
+        {
+            lastBufferSize = output.getNumSamples();
+            lastStartSample = startSample;
 
-    return low;
-}
+            if (! isVoiceActive())
+                return;
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                auto gain = tailOff > 0 ? tailOff : 1.0;
+                output.addSample (0, i, (float) (std::sin (phase) * level * gain));
+                phase += increment;
+
+                if (tailOff > 0 && (tailOff *= 0.9) < 0.01)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        using SynthesiserVoice::renderNextBlock;
+
+        double phase = 0, increment = 0, tailOff = 0;
+        float level = 0;
+        int lastBufferSize = -1, lastStartSample = -1;
+    };
+
+    static void prepare (Synthesiser& synth, int numVoices)
+    {
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice (new TestVoice());
+
+        synth.addSound (new TestSound());
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.setMinimumRenderingSubdivisionSize (1, true);
+    }
+
+    static MidiBuffer createDenseMidi (Random& random)
+    {
+        MidiBuffer midi;
+
+        for (int i = 0; i < 64; ++i)
+        {
+            auto time = random.nextInt (blockSize);
+            auto channel = 1 + random.nextInt (2);
+            auto note = 36 + random.nextInt (48);
+
+            switch (random.nextInt (6))
+            {
+                case 0:  midi.addEvent (MidiMessage::noteOff (channel, note), time); break;
+                case 1:  midi.addEvent (MidiMessage::controllerEvent (channel, 0x40, random.nextBool() ? 127 : 0), time); break;
+                default: midi.addEvent (MidiMessage::noteOn (channel, note, (uint8) (1 + random.nextInt (127))), time); break;
+            }
+        }
+
+        return midi;
+    }
+
+    static int countActiveVoices (const Synthesiser& synth)
+    {
+        int numActive = 0;
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+            if (synth.getVoice (i)->isVoiceActive())
+                ++numActive;
+
+        return numActive;
+    }
+};
+
+static SynthesiserTests synthesiserTests;
+
+#endif
 
 } // namespace juce
@@ -23,6 +23,8 @@
 namespace juce
 {
 
+class ParallelVoiceRenderer;
+
 //==============================================================================
 /**
     Describes one of the sounds that a Synthesiser can play.
@@ -272,6 +274,11 @@ private:
     SynthesiserSound::Ptr currentlyPlayingSound;
     bool keyIsDown = false, sustainPedalDown = false, sostenutoPedalDown = false;
 
+    // used by the Synthesiser's active voice tracking
+    SynthesiserVoice* nextVoiceWithSameNote = nullptr;
+    int indexedNote = -1, indexInSynth = -1;
+    bool isInActiveVoiceList = false;
+
     AudioBuffer<float> tempBuffer;
 
     JUCE_LEAK_DETECTOR (SynthesiserVoice)
@@ -557,6 +564,56 @@ public:
     */
     void setMinimumRenderingSubdivisionSize (int numSamples, bool shouldBeStrict = false) noexcept;
 
+    //==============================================================================
+    /** Enables some extra bookkeeping that helps synths with very large numbers of voices.
+
+        When this is enabled, the synth keeps a list of its active voices in the order in
+        which they were started, a list of its free voices, and an index of the voices that
+        are playing each midi note. Rendering, midi handling and voice-stealing then take time
+        in proportion to the number of voices that are actually sounding, rather than the total
+        number of voices.
+
+        In this mode, voices which aren't active won't have their renderNextBlock() method
+        called, and won't be sent any pitch-wheel, controller or pressure changes. A voice
+        must only become active by being started by the synth, and if you add or remove voices
+        by modifying the voices array directly rather than with addVoice() and removeVoice(),
+        you'll need to call this method again to rebuild the lists.
+
+        This is disabled by default.
+    */
+    void setActiveVoiceTrackingEnabled (bool shouldBeEnabled);
+
+    /** Returns true if active voice tracking is enabled.
+        @see setActiveVoiceTrackingEnabled
+    */
+    bool isActiveVoiceTrackingEnabled() const noexcept              { return trackActiveVoices; }
+
+    //==============================================================================
+    /** Makes the synth render its voices on several threads at once.
+
+        Each worker thread renders a share of the active voices into its own scratch buffer,
+        and these are added to the output at the end of each sub-block, so midi events are
+        still handled with the same timing accuracy as usual. This is only worthwhile when
+        your voices are expensive to render, and your voices' renderNextBlock() methods must
+        be safe to call at the same time as those of other voices.
+
+        This creates threads and allocates buffers, so call it from a non-realtime
+        thread, e.g. in your prepareToPlay() method.
+
+        @param numThreads           the total number of threads to render with, including the
+                                    one that calls renderNextBlock(). A value of 1 or less
+                                    turns off multi-threaded rendering.
+        @param maxNumChannels       the largest number of channels that will be rendered
+        @param maximumBlockSize     the largest number of samples that will be rendered in one
+                                    block. Any larger blocks will be rendered on a single thread.
+    */
+    void setNumRenderingThreads (int numThreads, int maxNumChannels, int maximumBlockSize);
+
+    /** Returns the number of threads that are used to render the voices.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -628,9 +685,31 @@ private:
     bool shouldStealNotes = true;
     BigInteger sustainPedalsDown;
 
+    bool trackActiveVoices = false;
+    std::vector<SynthesiserVoice*> activeVoices;
+    BigInteger freeVoices;
+    SynthesiserVoice* firstVoiceForNote[128] = {};
+
+    void rebuildVoiceLists();
+    void updateActiveVoiceLists();
+    void addToNoteIndex (SynthesiserVoice*) noexcept;
+    void removeFromNoteIndex (SynthesiserVoice*) noexcept;
+
+    template <typename Callback>
+    void forEachVoice (Callback&&);
+
+    template <typename Callback>
+    void forEachVoicePlayingNote (int midiNoteNumber, Callback&&);
+
+    std::unique_ptr<ParallelVoiceRenderer> parallelRenderer;
+    std::vector<SynthesiserVoice*> voicesToRender;
+
     template <typename floatType>
     void processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
 
+    template <typename floatType>
+    void renderAllVoices (AudioBuffer<floatType>&, int startSample, int numSamples);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Synthesiser)
 };
 
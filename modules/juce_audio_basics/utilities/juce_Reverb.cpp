@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace ReverbHelpers
+{
+    /* A minimal vector of four floats, used to run four comb filters at once. */
+    struct FloatVector4
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 value;
+
+        static FloatVector4 load (const float* src) noexcept        { return { _mm_loadu_ps (src) }; }
+        static FloatVector4 gather (const float* const* src, int offset) noexcept
+        {
+            return { _mm_set_ps (src[3][offset], src[2][offset], src[1][offset], src[0][offset]) };
+        }
+        static FloatVector4 expand (float v) noexcept               { return { _mm_set1_ps (v) }; }
+        void store (float* dest) const noexcept                     { _mm_storeu_ps (dest, value); }
+
+        FloatVector4 operator+ (FloatVector4 other) const noexcept  { return { _mm_add_ps (value, other.value) }; }
+        FloatVector4 operator- (FloatVector4 other) const noexcept  { return { _mm_sub_ps (value, other.value) }; }
+        FloatVector4 operator* (FloatVector4 other) const noexcept  { return { _mm_mul_ps (value, other.value) }; }
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t value;
+
+        static FloatVector4 load (const float* src) noexcept        { return { vld1q_f32 (src) }; }
+        static FloatVector4 gather (const float* const* src, int offset) noexcept
+        {
+            float values[] = { src[0][offset], src[1][offset], src[2][offset], src[3][offset] };
+            return load (values);
+        }
+        static FloatVector4 expand (float v) noexcept               { return { vdupq_n_f32 (v) }; }
+        void store (float* dest) const noexcept                     { vst1q_f32 (dest, value); }
+
+        FloatVector4 operator+ (FloatVector4 other) const noexcept  { return { vaddq_f32 (value, other.value) }; }
+        FloatVector4 operator- (FloatVector4 other) const noexcept  { return { vsubq_f32 (value, other.value) }; }
+        FloatVector4 operator* (FloatVector4 other) const noexcept  { return { vmulq_f32 (value, other.value) }; }
+       #else
+        float value[4];
+
+        static FloatVector4 load (const float* src) noexcept        { return { { src[0], src[1], src[2], src[3] } }; }
+        static FloatVector4 gather (const float* const* src, int offset) noexcept
+        {
+            return { { src[0][offset], src[1][offset], src[2][offset], src[3][offset] } };
+        }
+        static FloatVector4 expand (float v) noexcept               { return { { v, v, v, v } }; }
+        void store (float* dest) const noexcept                     { for (int i = 0; i < 4; ++i) dest[i] = value[i]; }
+
+        FloatVector4 operator+ (FloatVector4 other) const noexcept  { return apply (other, [] (float a, float b) { return a + b; }); }
+        FloatVector4 operator- (FloatVector4 other) const noexcept  { return apply (other, [] (float a, float b) { return a - b; }); }
+        FloatVector4 operator* (FloatVector4 other) const noexcept  { return apply (other, [] (float a, float b) { return a * b; }); }
+
+        template <typename Op>
+        FloatVector4 apply (FloatVector4 other, Op op) const noexcept
+        {
+            return { { op (value[0], other.value[0]), op (value[1], other.value[1]),
+                       op (value[2], other.value[2]), op (value[3], other.value[3]) } };
+        }
+       #endif
+    };
+
+    // The vector equivalent of JUCE_UNDENORMALISE, which gives exactly the same results
+    inline void undenormalise (FloatVector4& v) noexcept
+    {
+       #if JUCE_INTEL
+        const auto offset = FloatVector4::expand (0.1f);
+        v = v + offset;
+        v = v - offset;
+       #else
+        ignoreUnused (v);
+       #endif
+    }
+}
+
+//==============================================================================
+void Reverb::setSampleRate (const double sampleRate)
+{
+    jassert (sampleRate > 0);
+
+    static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
+    static const short allPassTunings[] = { 556, 441, 341, 225 };
+    const int stereoSpread = 23;
+    const int intSampleRate = (int) sampleRate;
+
+    auto getSize = [intSampleRate] (int tuning) { return jmax (1, (intSampleRate * tuning) / 44100); };
+
+    size_t totalSize = 0;
+
+    for (int j = 0; j < numChannels; ++j)
+    {
+        auto& c = channels[j];
+        const int spread = j * stereoSpread;
+
+        for (int i = 0; i < numCombs; ++i)
+            c.combDelays[i] = getSize (combTunings[i] + spread);
+
+        c.numCombRows = *std::max_element (c.combDelays, c.combDelays + numCombs);
+        c.combWriteRow = 0;
+        totalSize += (size_t) (c.numCombRows * numCombs);
+
+        for (int i = 0; i < numAllPasses; ++i)
+        {
+            c.allPassSizes[i] = getSize (allPassTunings[i] + spread);
+            c.allPassIndexes[i] = 0;
+            totalSize += (size_t) c.allPassSizes[i];
+        }
+    }
+
+    numDelaySamples = totalSize;
+    memory.malloc (numDelaySamples + 5 * maxChunkSize);
+
+    auto* data = memory.get();
+
+    for (auto& c : channels)
+    {
+        c.combs = data;
+        data += c.numCombRows * numCombs;
+
+        for (int i = 0; i < numAllPasses; ++i)
+        {
+            c.allPasses[i] = data;
+            data += c.allPassSizes[i];
+        }
+    }
+
+    scratch = data;
+    reset();
+
+    const double smoothTime = 0.01;
+    damping .reset (sampleRate, smoothTime);
+    feedback.reset (sampleRate, smoothTime);
+    dryGain .reset (sampleRate, smoothTime);
+    wetGain1.reset (sampleRate, smoothTime);
+    wetGain2.reset (sampleRate, smoothTime);
+}
+
+void Reverb::reset()
+{
+    memory.clear (numDelaySamples);
+
+    for (auto& c : channels)
+        std::fill (std::begin (c.combLast), std::end (c.combLast), 0.0f);
+}
+
+//==============================================================================
+void Reverb::processStereo (float* const left, float* const right, const int numSamples) noexcept
+{
+    JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
+    jassert (left != nullptr && right != nullptr);
+
+    auto* input    = scratch;
+    auto* damp     = input + maxChunkSize;
+    auto* feedbck  = damp  + maxChunkSize;
+    auto* outL     = feedbck + maxChunkSize;
+    auto* outR     = outL  + maxChunkSize;
+
+    for (int start = 0; start < numSamples; start += maxChunkSize)
+    {
+        const int num = jmin ((int) maxChunkSize, numSamples - start);
+        auto* l = left + start;
+        auto* r = right + start;
+
+        for (int i = 0; i < num; ++i)
+        {
+            input[i]   = (l[i] + r[i]) * gain;
+            damp[i]    = damping.getNextValue();
+            feedbck[i] = feedback.getNextValue();
+        }
+
+        processCombs (channels[0], input, damp, feedbck, outL, num);   // accumulate the comb filters in parallel
+        processCombs (channels[1], input, damp, feedbck, outR, num);
+
+        processAllPasses (channels[0], outL, num);  // run the allpass filters in series
+        processAllPasses (channels[1], outR, num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            const float dry  = dryGain.getNextValue();
+            const float wet1 = wetGain1.getNextValue();
+            const float wet2 = wetGain2.getNextValue();
+
+            l[i] = outL[i] * wet1 + outR[i] * wet2 + l[i] * dry;
+            r[i] = outR[i] * wet1 + outL[i] * wet2 + r[i] * dry;
+        }
+    }
+    JUCE_END_IGNORE_WARNINGS_MSVC
+}
+
+void Reverb::processMono (float* const samples, const int numSamples) noexcept
+{
+    JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
+    jassert (samples != nullptr);
+
+    auto* input    = scratch;
+    auto* damp     = input + maxChunkSize;
+    auto* feedbck  = damp  + maxChunkSize;
+    auto* output   = feedbck + maxChunkSize;
+
+    for (int start = 0; start < numSamples; start += maxChunkSize)
+    {
+        const int num = jmin ((int) maxChunkSize, numSamples - start);
+        auto* s = samples + start;
+
+        for (int i = 0; i < num; ++i)
+        {
+            input[i]   = s[i] * gain;
+            damp[i]    = damping.getNextValue();
+            feedbck[i] = feedback.getNextValue();
+        }
+
+        processCombs (channels[0], input, damp, feedbck, output, num);
+        processAllPasses (channels[0], output, num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            const float dry  = dryGain.getNextValue();
+            const float wet1 = wetGain1.getNextValue();
+
+            s[i] = output[i] * wet1 + s[i] * dry;
+        }
+    }
+    JUCE_END_IGNORE_WARNINGS_MSVC
+}
+
+//==============================================================================
+void Reverb::processCombs (Channel& c, const float* input, const float* damp,
+                           const float* feedbackLevel, float* output, int numSamples) noexcept
+{
+    using ReverbHelpers::FloatVector4;
+    static_assert (numCombs == 8, "The combs are expected to fill two vectors");
+
+    auto last0 = FloatVector4::load (c.combLast);
+    auto last1 = FloatVector4::load (c.combLast + 4);
+
+    for (int start = 0; start < numSamples;)
+    {
+        // Each chunk stops before either the write row or any of the read rows wraps around
+        int num = jmin (numSamples - start, c.numCombRows - c.combWriteRow);
+        const float* readPointers[numCombs];
+
+        for (int j = 0; j < numCombs; ++j)
+        {
+            auto readRow = c.combWriteRow - c.combDelays[j];
+
+            if (readRow < 0)
+                readRow += c.numCombRows;
+
+            num = jmin (num, c.numCombRows - readRow);
+            readPointers[j] = c.combs + readRow * numCombs + j;
+        }
+
+        auto* writePointer = c.combs + c.combWriteRow * numCombs;
+
+        for (int i = 0; i < num; ++i)
+        {
+            const auto delayed0 = FloatVector4::gather (readPointers, i * numCombs);
+            const auto delayed1 = FloatVector4::gather (readPointers + 4, i * numCombs);
+
+            float sum = 0;
+
+            for (int j = 0; j < numCombs; ++j)
+                sum += readPointers[j][i * numCombs];
+
+            output[start + i] = sum;
+
+            const auto dampValue = damp[start + i];
+            const auto d = FloatVector4::expand (dampValue);
+            const auto oneMinusD = FloatVector4::expand (1.0f - dampValue);
+            const auto fb = FloatVector4::expand (feedbackLevel[start + i]);
+            const auto in = FloatVector4::expand (input[start + i]);
+
+            last0 = (delayed0 * oneMinusD) + (last0 * d);
+            last1 = (delayed1 * oneMinusD) + (last1 * d);
+            ReverbHelpers::undenormalise (last0);
+            ReverbHelpers::undenormalise (last1);
+
+            auto temp0 = in + (last0 * fb);
+            auto temp1 = in + (last1 * fb);
+            ReverbHelpers::undenormalise (temp0);
+            ReverbHelpers::undenormalise (temp1);
+
+            temp0.store (writePointer + i * numCombs);
+            temp1.store (writePointer + i * numCombs + 4);
+        }
+
+        c.combWriteRow += num;
+
+        if (c.combWriteRow == c.numCombRows)
+            c.combWriteRow = 0;
+
+        start += num;
+    }
+
+    last0.store (c.combLast);
+    last1.store (c.combLast + 4);
+}
+
+void Reverb::processAllPasses (Channel& c, float* samples, int numSamples) noexcept
+{
+    using ReverbHelpers::FloatVector4;
+    const auto half = FloatVector4::expand (0.5f);
+
+    for (int j = 0; j < numAllPasses; ++j)
+    {
+        auto& index = c.allPassIndexes[j];
+
+        for (int start = 0; start < numSamples;)
+        {
+            // Within a chunk, every sample reads a value that was written a whole buffer-length
+            // ago, so the samples are independent and can be processed four at a time
+            const int num = jmin (numSamples - start, c.allPassSizes[j] - index);
+            auto* buffer = c.allPasses[j] + index;
+            auto* x = samples + start;
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+            {
+                const auto bufferedValue = FloatVector4::load (buffer + i);
+                const auto in = FloatVector4::load (x + i);
+
+                auto temp = in + (bufferedValue * half);
+                ReverbHelpers::undenormalise (temp);
+
+                temp.store (buffer + i);
+                (bufferedValue - in).store (x + i);
+            }
+
+            for (; i < num; ++i)
+            {
+                const float bufferedValue = buffer[i];
+                float temp = x[i] + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                buffer[i] = temp;
+                x[i] = bufferedValue - x[i];
+            }
+
+            index += num;
+
+            if (index == c.allPassSizes[j])
+                index = 0;
+
+            start += num;
+        }
+    }
+}
+
+} // namespace juce
@@ -35,7 +35,7 @@ namespace juce
 
     @tags{Audio}
 */
-class Reverb
+class JUCE_API  Reverb
 {
 public:
     //==============================================================================
@@ -85,112 +85,17 @@ public:
     /** Sets the sample rate that will be used for the reverb.
         You must call this before the process methods, in order to tell it the correct sample rate.
     */
-    void setSampleRate (const double sampleRate)
-    {
-        jassert (sampleRate > 0);
-
-        static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
-        static const short allPassTunings[] = { 556, 441, 341, 225 };
-        const int stereoSpread = 23;
-        const int intSampleRate = (int) sampleRate;
-
-        for (int i = 0; i < numCombs; ++i)
-        {
-            comb[0][i].setSize ((intSampleRate * combTunings[i]) / 44100);
-            comb[1][i].setSize ((intSampleRate * (combTunings[i] + stereoSpread)) / 44100);
-        }
-
-        for (int i = 0; i < numAllPasses; ++i)
-        {
-            allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
-            allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
-        }
-
-        const double smoothTime = 0.01;
-        damping .reset (sampleRate, smoothTime);
-        feedback.reset (sampleRate, smoothTime);
-        dryGain .reset (sampleRate, smoothTime);
-        wetGain1.reset (sampleRate, smoothTime);
-        wetGain2.reset (sampleRate, smoothTime);
-    }
+    void setSampleRate (double sampleRate);
 
     /** Clears the reverb's buffers. */
-    void reset()
-    {
-        for (int j = 0; j < numChannels; ++j)
-        {
-            for (int i = 0; i < numCombs; ++i)
-                comb[j][i].clear();
-
-            for (int i = 0; i < numAllPasses; ++i)
-                allPass[j][i].clear();
-        }
-    }
+    void reset();
 
     //==============================================================================
     /** Applies the reverb to two stereo channels of audio data. */
-    void processStereo (float* const left, float* const right, const int numSamples) noexcept
-    {
-        JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
-        jassert (left != nullptr && right != nullptr);
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = (left[i] + right[i]) * gain;
-            float outL = 0, outR = 0;
-
-            const float damp    = damping.getNextValue();
-            const float feedbck = feedback.getNextValue();
-
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-            {
-                outL += comb[0][j].process (input, damp, feedbck);
-                outR += comb[1][j].process (input, damp, feedbck);
-            }
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-            {
-                outL = allPass[0][j].process (outL);
-                outR = allPass[1][j].process (outR);
-            }
-
-            const float dry  = dryGain.getNextValue();
-            const float wet1 = wetGain1.getNextValue();
-            const float wet2 = wetGain2.getNextValue();
-
-            left[i]  = outL * wet1 + outR * wet2 + left[i]  * dry;
-            right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
-        }
-        JUCE_END_IGNORE_WARNINGS_MSVC
-    }
+    void processStereo (float* left, float* right, int numSamples) noexcept;
 
     /** Applies the reverb to a single mono channel of audio data. */
-    void processMono (float* const samples, const int numSamples) noexcept
-    {
-        JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
-        jassert (samples != nullptr);
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = samples[i] * gain;
-            float output = 0;
-
-            const float damp    = damping.getNextValue();
-            const float feedbck = feedback.getNextValue();
-
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-                output += comb[0][j].process (input, damp, feedbck);
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-                output = allPass[0][j].process (output);
-
-            const float dry  = dryGain.getNextValue();
-            const float wet1 = wetGain1.getNextValue();
-
-            samples[i] = output * wet1 + samples[i] * dry;
-        }
-        JUCE_END_IGNORE_WARNINGS_MSVC
-    }
+    void processMono (float* samples, int numSamples) noexcept;
 
 private:
     //==============================================================================
@@ -216,98 +121,40 @@ private:
     }
 
     //==============================================================================
-    class CombFilter
-    {
-    public:
-        CombFilter() noexcept {}
-
-        void setSize (const int size)
-        {
-            if (size != bufferSize)
-            {
-                bufferIndex = 0;
-                buffer.malloc (size);
-                bufferSize = size;
-            }
-
-            clear();
-        }
-
-        void clear() noexcept
-        {
-            last = 0;
-            buffer.clear ((size_t) bufferSize);
-        }
-
-        float process (const float input, const float damp, const float feedbackLevel) noexcept
-        {
-            const float output = buffer[bufferIndex];
-            last = (output * (1.0f - damp)) + (last * damp);
-            JUCE_UNDENORMALISE (last);
-
-            float temp = input + (last * feedbackLevel);
-            JUCE_UNDENORMALISE (temp);
-            buffer[bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
-            return output;
-        }
-
-    private:
-        HeapBlock<float> buffer;
-        int bufferSize = 0, bufferIndex = 0;
-        float last = 0.0f;
-
-        JUCE_DECLARE_NON_COPYABLE (CombFilter)
-    };
+    enum { numCombs = 8, numAllPasses = 4, numChannels = 2, maxChunkSize = 256 };
 
-    //==============================================================================
-    class AllPassFilter
+    /*  The delay lines of a channel all live in the reverb's memory block.
+
+        The comb filters are interleaved, with one row of numCombs samples per time step,
+        so that the parallel combs can be processed together in vector registers. They
+        share a write position, and each one reads at its own distance behind it.
+        The all-pass filters run in series, so each one has its own contiguous buffer
+        and is processed over a whole chunk of samples at a time.
+    */
+    struct Channel
     {
-    public:
-        AllPassFilter() noexcept {}
-
-        void setSize (const int size)
-        {
-            if (size != bufferSize)
-            {
-                bufferIndex = 0;
-                buffer.malloc (size);
-                bufferSize = size;
-            }
-
-            clear();
-        }
-
-        void clear() noexcept
-        {
-            buffer.clear ((size_t) bufferSize);
-        }
-
-        float process (const float input) noexcept
-        {
-            const float bufferedValue = buffer [bufferIndex];
-            float temp = input + (bufferedValue * 0.5f);
-            JUCE_UNDENORMALISE (temp);
-            buffer [bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
-            return bufferedValue - input;
-        }
-
-    private:
-        HeapBlock<float> buffer;
-        int bufferSize = 0, bufferIndex = 0;
-
-        JUCE_DECLARE_NON_COPYABLE (AllPassFilter)
+        float* combs = nullptr;
+        float combLast[numCombs] = {};
+        int combDelays[numCombs] = {};
+        int numCombRows = 0, combWriteRow = 0;
+
+        float* allPasses[numAllPasses] = {};
+        int allPassSizes[numAllPasses] = {};
+        int allPassIndexes[numAllPasses] = {};
     };
 
-    //==============================================================================
-    enum { numCombs = 8, numAllPasses = 4, numChannels = 2 };
+    static void processCombs (Channel&, const float* input, const float* damp,
+                              const float* feedbackLevel, float* output, int numSamples) noexcept;
+    static void processAllPasses (Channel&, float* samples, int numSamples) noexcept;
 
+    //==============================================================================
     Parameters parameters;
     float gain;
 
-    CombFilter comb [numChannels][numCombs];
-    AllPassFilter allPass [numChannels][numAllPasses];
+    HeapBlock<float> memory;
+    size_t numDelaySamples = 0;
+    float* scratch = nullptr;
+    Channel channels[numChannels];
 
     SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
 
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct ReverbTests  : public UnitTest
+{
+    ReverbTests()  : UnitTest ("Reverb", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        beginTest ("Stereo output matches a sample-by-sample reference");
+        {
+            for (auto sampleRate : { 22050.0, 44100.0, 96000.0 })
+            {
+                for (auto blockSize : { 1, 7, 300, 1024 })
+                {
+                    Reverb reverb;
+                    ReferenceReverb reference;
+                    reverb.setSampleRate (sampleRate);
+                    reference.setSampleRate (sampleRate);
+
+                    auto left = makeNoise (1), right = makeNoise (2);
+                    auto refLeft = left, refRight = right;
+
+                    for (int start = 0; start < numSamples; start += blockSize)
+                    {
+                        if (start >= numSamples / 2 && start - blockSize < numSamples / 2)
+                        {
+                            reverb.setParameters (getOtherParameters());
+                            reference.setParameters (getOtherParameters());
+                        }
+
+                        const auto num = jmin (blockSize, numSamples - start);
+                        reverb.processStereo (left.data() + start, right.data() + start, num);
+                        reference.processStereo (refLeft.data() + start, refRight.data() + start, num);
+                    }
+
+                    expectSimilar (left, refLeft);
+                    expectSimilar (right, refRight);
+                }
+            }
+        }
+
+        beginTest ("Mono output matches a sample-by-sample reference");
+        {
+            Reverb reverb;
+            ReferenceReverb reference;
+            reverb.setParameters (getOtherParameters());
+            reference.setParameters (getOtherParameters());
+
+            auto samples = makeNoise (3);
+            auto refSamples = samples;
+
+            for (int start = 0; start < numSamples; start += 500)
+            {
+                const auto num = jmin (500, numSamples - start);
+                reverb.processMono (samples.data() + start, num);
+                reference.processMono (refSamples.data() + start, num);
+            }
+
+            expectSimilar (samples, refSamples);
+        }
+
+        beginTest ("Reset clears the tail");
+        {
+            Reverb reverb;
+            auto samples = makeNoise (4);
+            reverb.processMono (samples.data(), numSamples);
+            reverb.reset();
+
+            std::vector<float> silence ((size_t) numSamples, 0.0f);
+            Reverb::Parameters silentDry;
+            silentDry.dryLevel = 0.0f;
+            reverb.setParameters (silentDry);
+            reverb.processMono (silence.data(), numSamples);
+
+            for (auto s : silence)
+                expectEquals (s, 0.0f);
+        }
+    }
+
+    //==============================================================================
+    static constexpr int numSamples = 10000;
+
+    static std::vector<float> makeNoise (int seed)
+    {
+        Random random (seed);
+        std::vector<float> samples ((size_t) numSamples);
+
+        for (auto& s : samples)
+            s = random.nextFloat() * 2.0f - 1.0f;
+
+        return samples;
+    }
+
+    static Reverb::Parameters getOtherParameters()
+    {
+        Reverb::Parameters p;
+        p.roomSize = 0.9f;
+        p.damping = 0.2f;
+        p.wetLevel = 0.5f;
+        p.width = 0.6f;
+        return p;
+    }
+
+    // The vectorised code does its arithmetic in the same order as the reference, and the
+    // results are identical with SSE. Compilers may still fuse some of the reference's
+    // multiply-adds into FMA instructions on other targets, so a tiny tolerance is allowed.
+    void expectSimilar (const std::vector<float>& a, const std::vector<float>& b)
+    {
+        auto maxError = 0.0f;
+
+        for (size_t i = 0; i < a.size(); ++i)
+            maxError = jmax (maxError, std::abs (a[i] - b[i]));
+
+        expectLessThan (maxError, 1.0e-5f);
+    }
+
+    //==============================================================================
+    // The original FreeVerb-style implementation, processing one sample at a time
+    struct ReferenceReverb
+    {
+        ReferenceReverb()
+        {
+            setParameters ({});
+            setSampleRate (44100.0);
+        }
+
+        struct DelayLine
+        {
+            void setSize (int size)     { buffer.assign ((size_t) jmax (1, size), 0.0f); index = 0; }
+
+            float& current()            { return buffer[(size_t) index]; }
+            void advance()              { index = (index + 1) % (int) buffer.size(); }
+
+            std::vector<float> buffer;
+            int index = 0;
+        };
+
+        void setSampleRate (double sampleRate)
+        {
+            static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+            static const short allPassTunings[] = { 556, 441, 341, 225 };
+            const int intSampleRate = (int) sampleRate;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    combs[ch][i].setSize ((intSampleRate * (combTunings[i] + ch * 23)) / 44100);
+                    combLast[ch][i] = 0;
+                }
+
+                for (int i = 0; i < 4; ++i)
+                    allPasses[ch][i].setSize ((intSampleRate * (allPassTunings[i] + ch * 23)) / 44100);
+            }
+
+            for (auto* s : { &damping, &feedback, &dryGain, &wetGain1, &wetGain2 })
+                s->reset (sampleRate, 0.01);
+        }
+
+        void setParameters (const Reverb::Parameters& p)
+        {
+            const float wet = p.wetLevel * 3.0f;
+            dryGain.setTargetValue (p.dryLevel * 2.0f);
+            wetGain1.setTargetValue (0.5f * wet * (1.0f + p.width));
+            wetGain2.setTargetValue (0.5f * wet * (1.0f - p.width));
+            damping.setTargetValue (p.damping * 0.4f);
+            feedback.setTargetValue (p.roomSize * 0.28f + 0.7f);
+        }
+
+        float processChannel (int ch, float input, float damp, float feedbackLevel)
+        {
+            float output = 0;
+
+            for (int j = 0; j < 8; ++j)
+            {
+                auto& comb = combs[ch][j];
+                auto& last = combLast[ch][j];
+                const float delayed = comb.current();
+                last = (delayed * (1.0f - damp)) + (last * damp);
+                JUCE_UNDENORMALISE (last);
+
+                float temp = input + (last * feedbackLevel);
+                JUCE_UNDENORMALISE (temp);
+                comb.current() = temp;
+                comb.advance();
+                output += delayed;
+            }
+
+            for (auto& allPass : allPasses[ch])
+            {
+                const float bufferedValue = allPass.current();
+                float temp = output + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                allPass.current() = temp;
+                allPass.advance();
+                output = bufferedValue - output;
+            }
+
+            return output;
+        }
+
+        void processStereo (float* left, float* right, int num)
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                const float input = (left[i] + right[i]) * 0.015f;
+                const float damp = damping.getNextValue();
+                const float feedbck = feedback.getNextValue();
+                const float outL = processChannel (0, input, damp, feedbck);
+                const float outR = processChannel (1, input, damp, feedbck);
+
+                const float dry  = dryGain.getNextValue();
+                const float wet1 = wetGain1.getNextValue();
+                const float wet2 = wetGain2.getNextValue();
+
+                left[i]  = outL * wet1 + outR * wet2 + left[i]  * dry;
+                right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
+            }
+        }
+
+        void processMono (float* samples, int num)
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                const float damp = damping.getNextValue();
+                const float feedbck = feedback.getNextValue();
+                const float output = processChannel (0, samples[i] * 0.015f, damp, feedbck);
+
+                const float dry  = dryGain.getNextValue();
+                const float wet1 = wetGain1.getNextValue();
+
+                samples[i] = output * wet1 + samples[i] * dry;
+            }
+        }
+
+        DelayLine combs[2][8], allPasses[2][4];
+        float combLast[2][8] = {};
+        SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
+    };
+};
+
+static ReverbTests reverbTests;
+
+} // namespace juce
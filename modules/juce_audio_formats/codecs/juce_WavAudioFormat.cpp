@@ -1236,6 +1236,19 @@ public:
     //==============================================================================
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override
+    {
+        return readSampleData (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readSamplesAsFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples) override
+    {
+        return readSampleData (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    template <typename SampleType>
+    bool readSampleData (SampleType* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                         int64 startSampleInFile, int numSamples)
     {
         clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                            startSampleInFile, numSamples, lengthInSamples);
@@ -1286,6 +1299,22 @@ public:
         }
     }
 
+    static void copySampleData (unsigned int numBitsPerSample, const bool floatingPointData,
+                                float* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numberOfChannels, int numSamples) noexcept
+    {
+        switch (numBitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Float32, AudioData::UInt8, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 16:    ReadHelper<AudioData::Float32, AudioData::Int16, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 24:    ReadHelper<AudioData::Float32, AudioData::Int24, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 32:    if (floatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
+                        else                   ReadHelper<AudioData::Float32, AudioData::Int32,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
+                        break;
+            default:    jassertfalse; break;
+        }
+    }
+
     //==============================================================================
     AudioChannelSet getChannelLayout() override
     {
@@ -1960,6 +1989,51 @@ struct WaveAudioFormatTests : public UnitTest
             expect (a[WavAudioFormat::riffInfoSource] == "source");
             expect (a[WavAudioFormat::internationalStandardRecordingCode] == "UUVVVXXYYYYY");
         }
+
+        for (auto bitDepth : { 8, 16, 24, 32 })
+        {
+            beginTest ("Reading " + String (bitDepth) + "-bit data as floats matches the fixed-point path");
+
+            AudioBuffer<float> source (2, numTestAudioBufferSamples);
+            auto random = getRandom();
+
+            for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                for (int i = 0; i < source.getNumSamples(); ++i)
+                    source.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            MemoryBlock mb;
+
+            {
+                auto writer = rawToUniquePtr (format.createWriterFor (new MemoryOutputStream (mb, false),
+                                                                      44100.0, 2, bitDepth, {}, 0));
+                expect (writer != nullptr);
+                expect (writer->writeFromAudioSampleBuffer (source, 0, source.getNumSamples()));
+            }
+
+            auto reader = rawToUniquePtr (format.createReaderFor (new MemoryInputStream (mb, false), true));
+            expect (reader != nullptr);
+
+            const int offset = -5, numToRead = numTestAudioBufferSamples + 10;
+            AudioBuffer<float> asFloat (3, numToRead), asInt (3, numToRead);
+            reader->read (&asFloat, 0, numToRead, offset, true, true);
+
+            expect (reader->read (reinterpret_cast<int* const*> (asInt.getArrayOfWritePointers()), 3, offset, numToRead, true));
+
+            for (int ch = 0; ch < asInt.getNumChannels(); ++ch)
+            {
+                auto* data = asInt.getWritePointer (ch);
+
+                if (bitDepth != 32)
+                    FloatVectorOperations::convertFixedToFloat (data, reinterpret_cast<const int*> (data),
+                                                                1.0f / static_cast<float> (0x7fffffff), numToRead);
+
+                for (int i = 0; i < numToRead; ++i)
+                    expectWithinAbsoluteError (asFloat.getSample (ch, i), data[i], 1.0e-6f);
+            }
+
+            for (int i = 0; i < numToRead; ++i)
+                expectEquals (asFloat.getSample (2, i), asFloat.getSample (1, i));
+        }
     }
 
 private:
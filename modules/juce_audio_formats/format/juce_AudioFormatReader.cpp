@@ -36,34 +36,68 @@ AudioFormatReader::~AudioFormatReader()
     delete input;
 }
 
-static void convertFixedToFloat (int* const* channels, int numChannels, int numSamples)
+bool AudioFormatReader::read (float* const* destChannels, int numDestChannels,
+                              int64 startSampleInSource, int numSamplesToRead)
 {
-    constexpr auto scaleFactor = 1.0f / static_cast<float> (0x7fffffff);
+    return readAsFloat (destChannels, numDestChannels, startSampleInSource, numSamplesToRead, false);
+}
 
-    for (int i = 0; i < numChannels; ++i)
-        if (auto d = channels[i])
-            FloatVectorOperations::convertFixedToFloat (reinterpret_cast<float*> (d), d, scaleFactor, numSamples);
+bool AudioFormatReader::read (int* const* destChannels,
+                              int numDestChannels,
+                              int64 startSampleInSource,
+                              int numSamplesToRead,
+                              bool fillLeftoverChannelsWithCopies)
+{
+    return readWithPadding (destChannels, numDestChannels, startSampleInSource, numSamplesToRead,
+                            fillLeftoverChannelsWithCopies,
+                            [this] (int* const* dest, int numDest, int offset, int64 start, int num)
+                            {
+                                return readSamples (const_cast<int**> (dest), numDest, offset, start, num);
+                            });
 }
 
-bool AudioFormatReader::read (float* const* destChannels, int numDestChannels,
-                              int64 startSampleInSource, int numSamplesToRead)
+bool AudioFormatReader::readAsFloat (float* const* destChannels, int numDestChannels,
+                                     int64 startSampleInSource, int numSamplesToRead,
+                                     bool fillLeftoverChannelsWithCopies)
+{
+    return readWithPadding (destChannels, numDestChannels, startSampleInSource, numSamplesToRead,
+                            fillLeftoverChannelsWithCopies,
+                            [this] (float* const* dest, int numDest, int offset, int64 start, int num)
+                            {
+                                return readSamplesAsFloat (dest, numDest, offset, start, num);
+                            });
+}
+
+bool AudioFormatReader::readSamplesAsFloat (float* const* destChannels, int numDestChannels,
+                                            int startOffsetInDestBuffer, int64 startSampleInFile,
+                                            int numSamples)
 {
-    auto channelsAsInt = reinterpret_cast<int* const*> (destChannels);
+    auto channelsAsInt = reinterpret_cast<int**> (const_cast<float**> (destChannels));
 
-    if (! read (channelsAsInt, numDestChannels, startSampleInSource, numSamplesToRead, false))
+    if (! readSamples (channelsAsInt, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples))
         return false;
 
     if (! usesFloatingPointData)
-        convertFixedToFloat (channelsAsInt, numDestChannels, numSamplesToRead);
+    {
+        constexpr auto scaleFactor = 1.0f / static_cast<float> (0x7fffffff);
+
+        for (int i = 0; i < numDestChannels; ++i)
+            if (auto d = destChannels[i])
+                FloatVectorOperations::convertFixedToFloat (d + startOffsetInDestBuffer,
+                                                            channelsAsInt[i] + startOffsetInDestBuffer,
+                                                            scaleFactor, numSamples);
+    }
 
     return true;
 }
 
-bool AudioFormatReader::read (int* const* destChannels,
-                              int numDestChannels,
-                              int64 startSampleInSource,
-                              int numSamplesToRead,
-                              bool fillLeftoverChannelsWithCopies)
+template <typename SampleType, typename ReadFunction>
+bool AudioFormatReader::readWithPadding (SampleType* const* destChannels,
+                                         int numDestChannels,
+                                         int64 startSampleInSource,
+                                         int numSamplesToRead,
+                                         bool fillLeftoverChannelsWithCopies,
+                                         ReadFunction&& readFunction)
 {
     jassert (numDestChannels > 0); // you have to actually give this some channels to work with!
 
@@ -76,7 +110,7 @@ bool AudioFormatReader::read (int* const* destChannels,
 
         for (int i = numDestChannels; --i >= 0;)
             if (auto d = destChannels[i])
-                zeromem (d, (size_t) silence * sizeof (int));
+                zeromem (d, (size_t) silence * sizeof (SampleType));
 
         startOffsetInDestBuffer += silence;
         numSamplesToRead -= silence;
@@ -86,9 +120,8 @@ bool AudioFormatReader::read (int* const* destChannels,
     if (numSamplesToRead <= 0)
         return true;
 
-    if (! readSamples (const_cast<int**> (destChannels),
-                       jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
-                       startSampleInSource, numSamplesToRead))
+    if (! readFunction (destChannels, jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
+                        startSampleInSource, numSamplesToRead))
         return false;
 
     if (numDestChannels > (int) numChannels)
@@ -109,33 +142,19 @@ bool AudioFormatReader::read (int* const* destChannels,
             if (lastFullChannel != nullptr)
                 for (int i = (int) numChannels; i < numDestChannels; ++i)
                     if (auto d = destChannels[i])
-                        memcpy (d, lastFullChannel, sizeof (int) * originalNumSamplesToRead);
+                        memcpy (d, lastFullChannel, sizeof (SampleType) * originalNumSamplesToRead);
         }
         else
         {
             for (int i = (int) numChannels; i < numDestChannels; ++i)
                 if (auto d = destChannels[i])
-                    zeromem (d, sizeof (int) * originalNumSamplesToRead);
+                    zeromem (d, sizeof (SampleType) * originalNumSamplesToRead);
         }
     }
 
     return true;
 }
 
-static void readChannels (AudioFormatReader& reader, int** chans, AudioBuffer<float>* buffer,
-                          int startSample, int numSamples, int64 readerStartSample, int numTargetChannels,
-                          bool convertToFloat)
-{
-    for (int j = 0; j < numTargetChannels; ++j)
-        chans[j] = reinterpret_cast<int*> (buffer->getWritePointer (j, startSample));
-
-    chans[numTargetChannels] = nullptr;
-    reader.read (chans, numTargetChannels, readerStartSample, numSamples, true);
-
-    if (convertToFloat)
-        convertFixedToFloat (chans, numTargetChannels, numSamples);
-}
-
 void AudioFormatReader::read (AudioBuffer<float>* buffer,
                               int startSample,
                               int numSamples,
@@ -152,9 +171,9 @@ void AudioFormatReader::read (AudioBuffer<float>* buffer,
 
         if (numTargetChannels <= 2)
         {
-            int* dests[2] = { reinterpret_cast<int*> (buffer->getWritePointer (0, startSample)),
-                              reinterpret_cast<int*> (numTargetChannels > 1 ? buffer->getWritePointer (1, startSample) : nullptr) };
-            int* chans[3] = {};
+            float* dests[2] = { buffer->getWritePointer (0, startSample),
+                                numTargetChannels > 1 ? buffer->getWritePointer (1, startSample) : nullptr };
+            float* chans[3] = {};
 
             if (useReaderLeftChan == useReaderRightChan)
             {
@@ -172,7 +191,7 @@ void AudioFormatReader::read (AudioBuffer<float>* buffer,
                 chans[1] = dests[0];
             }
 
-            read (chans, 2, readerStartSample, numSamples, true);
+            readAsFloat (chans, 2, readerStartSample, numSamples, true);
 
             // if the target's stereo and the source is mono, dupe the first channel..
             if (numTargetChannels > 1
@@ -181,21 +200,15 @@ void AudioFormatReader::read (AudioBuffer<float>* buffer,
             {
                 memcpy (dests[1], dests[0], (size_t) numSamples * sizeof (float));
             }
-
-            if (! usesFloatingPointData)
-                convertFixedToFloat (dests, 2, numSamples);
-        }
-        else if (numTargetChannels <= 64)
-        {
-            int* chans[65];
-            readChannels (*this, chans, buffer, startSample, numSamples,
-                          readerStartSample, numTargetChannels, ! usesFloatingPointData);
         }
         else
         {
-            HeapBlock<int*> chans (numTargetChannels + 1);
-            readChannels (*this, chans, buffer, startSample, numSamples,
-                          readerStartSample, numTargetChannels, ! usesFloatingPointData);
+            HeapBlock<float*> chans (numTargetChannels);
+
+            for (int j = 0; j < numTargetChannels; ++j)
+                chans[j] = buffer->getWritePointer (j, startSample);
+
+            readAsFloat (chans, numTargetChannels, readerStartSample, numSamples, true);
         }
     }
 }
@@ -269,6 +269,25 @@ public:
                               int64 startSampleInFile,
                               int numSamples) = 0;
 
+    /** Reads samples from the stream and converts them to 32-bit floats.
+
+        Callers should use read() instead of calling this directly.
+
+        The default implementation calls readSamples() and then converts the integer data
+        that it returns to floating point with a second pass over the buffers. Subclasses
+        which decode a fixed-point format can override this to convert each sample straight
+        from the source data into the destination buffers, which saves a full pass over
+        the destination memory.
+
+        The parameters have the same meanings as for readSamples().
+
+        @see readSamples
+    */
+    virtual bool readSamplesAsFloat (float* const* destChannels,
+                                     int numDestChannels,
+                                     int startOffsetInDestBuffer,
+                                     int64 startSampleInFile,
+                                     int numSamples);
 
 protected:
     //==============================================================================
@@ -302,7 +321,8 @@ protected:
     /** Used by AudioFormatReader subclasses to clear any parts of the data blocks that lie
         beyond the end of their available length.
     */
-    static void clearSamplesBeyondAvailableLength (int** destChannels, int numDestChannels,
+    template <typename SampleType>
+    static void clearSamplesBeyondAvailableLength (SampleType* const* destChannels, int numDestChannels,
                                                    int startOffsetInDestBuffer, int64 startSampleInFile,
                                                    int& numSamples, int64 fileLengthInSamples)
     {
@@ -318,13 +338,22 @@ protected:
         {
             for (int i = numDestChannels; --i >= 0;)
                 if (destChannels[i] != nullptr)
-                    zeromem (destChannels[i] + startOffsetInDestBuffer, (size_t) numSamples * sizeof (int));
+                    zeromem (destChannels[i] + startOffsetInDestBuffer, (size_t) numSamples * sizeof (SampleType));
 
             numSamples = (int) samplesAvailable;
         }
     }
 
 private:
+    template <typename SampleType, typename ReadFunction>
+    bool readWithPadding (SampleType* const* destChannels, int numDestChannels,
+                          int64 startSampleInSource, int numSamplesToRead,
+                          bool fillLeftoverChannelsWithCopies, ReadFunction&& readFunction);
+
+    bool readAsFloat (float* const* destChannels, int numDestChannels,
+                      int64 startSampleInSource, int numSamplesToRead,
+                      bool fillLeftoverChannelsWithCopies);
+
     String formatName;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatReader)
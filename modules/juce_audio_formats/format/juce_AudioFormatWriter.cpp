@@ -243,7 +243,11 @@ public:
         fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
 
         if (size1 + size2 < numSamples)
+        {
+            ++numDroppedBlocks;
+            numDroppedSamples += numSamples;
             return false;
+        }
 
         for (int i = buffer.getNumChannels(); --i >= 0;)
         {
@@ -252,6 +256,13 @@ public:
         }
 
         fifo.finishedWrite (size1 + size2);
+
+        auto numReady = fifo.getNumReady();
+        auto previousMax = highWaterMark.load();
+
+        while (numReady > previousMax && ! highWaterMark.compare_exchange_weak (previousMax, numReady))
+        {}
+
         timeSliceThread.notify();
         return true;
     }
@@ -263,7 +274,7 @@ public:
 
     int writePendingData()
     {
-        auto numToDo = fifo.getTotalSize() / 4;
+        auto numToDo = batchSize > 0 ? batchSize.load() : fifo.getTotalSize() / 4;
 
         int start1, size1, start2, size2;
         fifo.prepareToRead (numToDo, start1, size1, start2, size2);
@@ -321,6 +332,29 @@ public:
         samplesPerFlush = numSamples;
     }
 
+    void setWriteBatchSize (int numSamples) noexcept
+    {
+        batchSize = jmin (numSamples, fifo.getTotalSize());
+    }
+
+    Statistics getStatistics() const noexcept
+    {
+        Statistics stats;
+        stats.bufferSize = fifo.getTotalSize() - 1;
+        stats.numSamplesBuffered = fifo.getNumReady();
+        stats.highWaterMark = highWaterMark;
+        stats.numDroppedBlocks = numDroppedBlocks;
+        stats.numDroppedSamples = numDroppedSamples;
+        return stats;
+    }
+
+    void resetStatistics() noexcept
+    {
+        highWaterMark = fifo.getNumReady();
+        numDroppedBlocks = 0;
+        numDroppedSamples = 0;
+    }
+
 private:
     AbstractFifo fifo;
     AudioBuffer<float> buffer;
@@ -331,6 +365,8 @@ private:
     int64 samplesWritten = 0;
     int samplesPerFlush = 0, flushSampleCounter = 0;
     std::atomic<bool> isRunning { true };
+    std::atomic<int> batchSize { 0 }, highWaterMark { 0 }, numDroppedBlocks { 0 };
+    std::atomic<int64> numDroppedSamples { 0 };
 
     JUCE_DECLARE_NON_COPYABLE (Buffer)
 };
@@ -359,4 +395,127 @@ void AudioFormatWriter::ThreadedWriter::setFlushInterval (int numSamplesPerFlush
     buffer->setFlushInterval (numSamplesPerFlush);
 }
 
+void AudioFormatWriter::ThreadedWriter::setWriteBatchSize (int maxSamplesPerBatch) noexcept
+{
+    buffer->setWriteBatchSize (maxSamplesPerBatch);
+}
+
+AudioFormatWriter::ThreadedWriter::Statistics AudioFormatWriter::ThreadedWriter::getStatistics() const noexcept
+{
+    return buffer->getStatistics();
+}
+
+void AudioFormatWriter::ThreadedWriter::resetStatistics() noexcept
+{
+    buffer->resetStatistics();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ThreadedWriterTests  : public UnitTest
+{
+    ThreadedWriterTests()
+        : UnitTest ("ThreadedWriter", UnitTestCategories::audio)
+    {}
+
+    struct CountingWriter  : public AudioFormatWriter
+    {
+        explicit CountingWriter (std::atomic<int64>& counter, WaitableEvent* gateToWaitFor = nullptr)
+            : AudioFormatWriter (nullptr, "Counting", 44100.0, 2, 32),
+              numWritten (counter), gate (gateToWaitFor)
+        {
+            usesFloatingPointData = true;
+        }
+
+        bool write (const int** data, int numSamples) override
+        {
+            jassert (data[0] != nullptr && data[1] != nullptr);
+
+            if (gate != nullptr)
+            {
+                writeStarted.signal();
+                gate->wait (-1);
+            }
+
+            numWritten += numSamples;
+            return true;
+        }
+
+        std::atomic<int64>& numWritten;
+        WaitableEvent* gate;
+        WaitableEvent writeStarted;
+    };
+
+    void runTest() override
+    {
+        HeapBlock<float> channelData (1024, true);
+        const float* channels[] = { channelData, channelData };
+
+        beginTest ("Overruns are counted and the high-water mark is tracked");
+        {
+            TimeSliceThread thread ("ThreadedWriter test");
+            std::atomic<int64> numWritten { 0 };
+            WaitableEvent writerCanContinue (true);
+            auto* countingWriter = new CountingWriter (numWritten, &writerCanContinue);
+            AudioFormatWriter::ThreadedWriter writer (countingWriter, thread, 512);
+
+            thread.startThread();
+
+            auto stats = writer.getStatistics();
+            expectEquals (stats.bufferSize, 511);
+            expectEquals (stats.numDroppedBlocks, 0);
+
+            // The background thread is held inside its first write, so that the samples it
+            // has taken stay counted as buffered and nothing more gets consumed.
+            expect (writer.write (channels, 100));
+            expect (countingWriter->writeStarted.wait (10000));
+
+            expect (writer.write (channels, 256));
+            expect (! writer.write (channels, 1024));
+
+            stats = writer.getStatistics();
+            expectEquals (stats.numSamplesBuffered, 356);
+            expectEquals (stats.highWaterMark, 356);
+            expectEquals (stats.numDroppedBlocks, 1);
+            expectEquals (stats.numDroppedSamples, (int64) 1024);
+
+            writer.resetStatistics();
+            stats = writer.getStatistics();
+            expectEquals (stats.highWaterMark, 356);
+            expectEquals (stats.numDroppedBlocks, 0);
+
+            writerCanContinue.signal();
+        }
+
+        beginTest ("Several writers can share one thread");
+        {
+            TimeSliceThread thread ("ThreadedWriter test");
+            std::atomic<int64> numWritten[4] {};
+            OwnedArray<AudioFormatWriter::ThreadedWriter> writers;
+
+            for (auto& n : numWritten)
+            {
+                writers.add (new AudioFormatWriter::ThreadedWriter (new CountingWriter (n), thread, 8192));
+                writers.getLast()->setWriteBatchSize (64);
+            }
+
+            thread.startThread();
+
+            for (int block = 0; block < 16; ++block)
+                for (auto* w : writers)
+                    expect (w->write (channels, 256));
+
+            writers.clear();
+
+            for (auto& n : numWritten)
+                expectEquals (n.load(), (int64) 16 * 256);
+        }
+    }
+};
+
+static ThreadedWriterTests threadedWriterTests;
+
+#endif
+
 } // namespace juce
@@ -237,6 +237,37 @@ public:
         */
         void setFlushInterval (int numSamplesPerFlush) noexcept;
 
+        /** Sets the largest number of samples that the background thread will pass to the
+            AudioFormatWriter each time it is called.
+
+            The default is a quarter of the FIFO size. Using a smaller batch size means that
+            a TimeSliceThread which is shared between many ThreadedWriters will spread its
+            time more evenly between them, at the cost of making more calls to the writer.
+        */
+        void setWriteBatchSize (int maxSamplesPerBatch) noexcept;
+
+        /** Some statistics describing the state of a ThreadedWriter's FIFO.
+            @see getStatistics
+        */
+        struct Statistics
+        {
+            int bufferSize = 0;             /**< The total number of samples that the FIFO can hold. */
+            int numSamplesBuffered = 0;     /**< The number of samples currently waiting to be written. */
+            int highWaterMark = 0;          /**< The largest number of samples that have been waiting at any one time. */
+            int numDroppedBlocks = 0;       /**< The number of calls to write() that failed because the FIFO was full. */
+            int64 numDroppedSamples = 0;    /**< The total number of samples passed to write() calls that failed. */
+        };
+
+        /** Returns the current statistics for this writer.
+
+            This can be called from any thread, so it can be used to monitor a set of
+            writers for overruns while they are recording.
+        */
+        Statistics getStatistics() const noexcept;
+
+        /** Resets the high-water mark and the dropped block counters. */
+        void resetStatistics() noexcept;
+
     private:
         class Buffer;
         std::unique_ptr<Buffer> buffer;
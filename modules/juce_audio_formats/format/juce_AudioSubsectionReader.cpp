@@ -60,6 +60,16 @@ bool AudioSubsectionReader::readSamples (int** destSamples, int numDestChannels,
                                 startSampleInFile + startSample, numSamples);
 }
 
+bool AudioSubsectionReader::readSamplesAsFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                                int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, length);
+
+    return source->readSamplesAsFloat (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile + startSample, numSamples);
+}
+
 void AudioSubsectionReader::readMaxLevels (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead)
 {
     startSampleInFile = jmax ((int64) 0, startSampleInFile);
@@ -69,6 +69,9 @@ public:
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override;
 
+    bool readSamplesAsFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples) override;
+
     void readMaxLevels (int64 startSample, int64 numSamples,
                         Range<float>* results, int numChannelsToRead) override;
 
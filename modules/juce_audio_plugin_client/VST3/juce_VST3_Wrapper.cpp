@@ -3094,13 +3094,31 @@ public:
                    #endif
                     {
                         if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
+                        {
                             setValueAndNotifyIfChanged (*param, (float) value);
+                            addParameterChangesToAutomation (*paramQueue, param->getParameterIndex());
+                        }
                     }
                 }
             }
         }
     }
 
+    void addParameterChangesToAutomation (Vst::IParamValueQueue& paramQueue, int parameterIndex)
+    {
+        if (parameterIndex < 0)
+            return;
+
+        for (Steinberg::int32 i = 0; i < paramQueue.getPointCount(); ++i)
+        {
+            Steinberg::int32 offsetSamples = 0;
+            double value = 0.0;
+
+            if (paramQueue.getPoint (i, offsetSamples, value) == kResultTrue)
+                parameterAutomation.addEvent (parameterIndex, (float) value, (int) offsetSamples);
+        }
+    }
+
     void addParameterChangeToMidiBuffer (const Steinberg::int32 offsetSamples, const Vst::ParamID id, const double value)
     {
         // If the parameter is mapped to a MIDI CC message then insert it into the midiBuffer.
@@ -3145,6 +3163,7 @@ public:
         }
 
         midiBuffer.clear();
+        parameterAutomation.clear();
 
         if (data.inputParameterChanges != nullptr)
             processParameterChanges (*data.inputParameterChanges);
@@ -3383,12 +3402,16 @@ private:
                 if (totalInputChans == pluginInstance->getTotalNumInputChannels()
                  && totalOutputChans == pluginInstance->getTotalNumOutputChannels())
                 {
+                    pluginInstance->setParameterAutomation (&parameterAutomation);
+
                     // processBlockBypassed should only ever be called if the AudioProcessor doesn't
                     // return a valid parameter from getBypassParameter
                     if (pluginInstance->getBypassParameter() == nullptr && comPluginInstance->getBypassParameter()->getValue() >= 0.5f)
                         pluginInstance->processBlockBypassed (buffer, midiBuffer);
                     else
                         pluginInstance->processBlock (buffer, midiBuffer);
+
+                    pluginInstance->setParameterAutomation (nullptr);
                 }
             }
 
@@ -3475,6 +3498,9 @@ private:
 
         midiBuffer.ensureSize (2048);
         midiBuffer.clear();
+
+        parameterAutomation.ensureSize (2048);
+        parameterAutomation.clear();
     }
 
     //==============================================================================
@@ -3528,6 +3554,7 @@ private:
     Vst::ProcessSetup processSetup;
 
     MidiBuffer midiBuffer;
+    ParameterAutomationBuffer parameterAutomation;
     Array<float*> channelListFloat;
     Array<double*> channelListDouble;
 
@@ -326,6 +326,21 @@ void AudioProcessor::setPlayHead (AudioPlayHead* newPlayHead)
     playHead = newPlayHead;
 }
 
+void AudioProcessor::setParameterAutomation (const ParameterAutomationBuffer* automationForNextBlock)
+{
+    parameterAutomation = automationForNextBlock;
+}
+
+const ParameterAutomationBuffer& AudioProcessor::getParameterAutomation() const noexcept
+{
+    static const ParameterAutomationBuffer noAutomation;
+
+    if (auto* automation = parameterAutomation.load())
+        return *automation;
+
+    return noAutomation;
+}
+
 void AudioProcessor::addListener (AudioProcessorListener* newListener)
 {
     const ScopedLock sl (listenerLock);
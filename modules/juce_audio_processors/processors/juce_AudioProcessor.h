@@ -711,6 +711,21 @@ public:
     */
     AudioPlayHead* getPlayHead() const noexcept                 { return playHead; }
 
+    /** Returns the parameter changes that the host has provided for the block
+        that is currently being processed, with sample-accurate time-stamps.
+
+        As with getPlayHead(), you can ONLY call this from your processBlock() method,
+        and you mustn't keep a reference to the buffer after processBlock() returns.
+
+        If the host doesn't provide sample-accurate automation, this will return an
+        empty buffer. Hosts that do provide it will still set each parameter's value
+        once per block as usual, so processors that ignore this buffer carry on
+        working in the same way.
+
+        @see ParameterAutomationBuffer, setParameterAutomation
+    */
+    const ParameterAutomationBuffer& getParameterAutomation() const noexcept;
+
     //==============================================================================
     /** Returns the total number of input channels.
 
@@ -1132,6 +1147,16 @@ public:
     */
     virtual void setPlayHead (AudioPlayHead* newPlayHead);
 
+    /** Tells the processor which sample-accurate parameter changes to use for the next block.
+
+        A host should call this before calling processBlock(), and can pass nullptr
+        afterwards or whenever it has no automation to provide. The processor will not
+        take ownership of the buffer, and it must remain valid until processBlock() returns.
+
+        @see getParameterAutomation
+    */
+    virtual void setParameterAutomation (const ParameterAutomationBuffer* automationForNextBlock);
+
     //==============================================================================
     /** This is called by the processor to specify its details before being played. Use this
         version of the function if you are not interested in any sidechain and/or aux buses
@@ -1375,6 +1400,9 @@ protected:
     /** @internal */
     std::atomic<AudioPlayHead*> playHead { nullptr };
 
+    /** @internal */
+    std::atomic<const ParameterAutomationBuffer*> parameterAutomation { nullptr };
+
     /** @internal */
     void sendParamChangeMessageToListeners (int parameterIndex, float newValue);
 
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace ParameterAutomationHelpers
+{
+    using Event = ParameterAutomationBuffer::Event;
+
+    static std::vector<Event>::iterator findFirstEventAtOrAfter (std::vector<Event>& events, int samplePosition) noexcept
+    {
+        return std::lower_bound (events.begin(), events.end(), samplePosition,
+                                 [] (const Event& e, int pos) { return e.samplePosition < pos; });
+    }
+}
+
+void ParameterAutomationBuffer::clear (int start, int numSamples)
+{
+    auto first = ParameterAutomationHelpers::findFirstEventAtOrAfter (events, start);
+    auto last  = ParameterAutomationHelpers::findFirstEventAtOrAfter (events, start + numSamples);
+
+    events.erase (first, last);
+}
+
+void ParameterAutomationBuffer::ensureSize (int minimumNumEvents)
+{
+    events.reserve ((size_t) jmax (0, minimumNumEvents));
+}
+
+void ParameterAutomationBuffer::addEvent (int parameterIndex, float newValue, int samplePosition)
+{
+    jassert (parameterIndex >= 0);
+
+    const Event newEvent { samplePosition, parameterIndex, newValue };
+
+    // Most events arrive in order, so check for the common case of appending first
+    if (events.empty() || events.back().samplePosition <= samplePosition)
+    {
+        events.push_back (newEvent);
+        return;
+    }
+
+    events.insert (std::upper_bound (events.begin(), events.end(), samplePosition,
+                                     [] (int pos, const Event& e) { return pos < e.samplePosition; }),
+                   newEvent);
+}
+
+void ParameterAutomationBuffer::addEvents (const ParameterAutomationBuffer& otherBuffer,
+                                           int startSample, int numSamples, int sampleDeltaToAdd)
+{
+    for (auto& event : otherBuffer)
+    {
+        if (event.samplePosition >= startSample && event.samplePosition < startSample + numSamples)
+            addEvent (event.parameterIndex, event.value, event.samplePosition + sampleDeltaToAdd);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParameterAutomationBufferTests  : public UnitTest
+{
+public:
+    ParameterAutomationBufferTests()
+        : UnitTest ("ParameterAutomationBuffer", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Events are kept in time order");
+        {
+            ParameterAutomationBuffer buffer;
+            buffer.addEvent (0, 0.5f, 100);
+            buffer.addEvent (1, 0.25f, 10);
+            buffer.addEvent (2, 0.75f, 100);
+            buffer.addEvent (3, 1.0f, 50);
+
+            expectEquals (buffer.getNumEvents(), 4);
+            expectEquals (buffer.getFirstEventTime(), 10);
+            expectEquals (buffer.getLastEventTime(), 100);
+
+            Array<int> order;
+
+            for (auto& event : buffer)
+                order.add (event.parameterIndex);
+
+            expect (order == Array<int> (1, 3, 0, 2));
+
+            buffer.clear (50, 51);
+            expectEquals (buffer.getNumEvents(), 1);
+            expectEquals (buffer.begin()->parameterIndex, 1);
+        }
+
+        beginTest ("Events can be copied between buffers");
+        {
+            ParameterAutomationBuffer source, dest;
+
+            for (int i = 0; i < 10; ++i)
+                source.addEvent (i, (float) i / 10.0f, i * 10);
+
+            dest.addEvents (source, 20, 40, -20);
+
+            expectEquals (dest.getNumEvents(), 4);
+            expectEquals (dest.getFirstEventTime(), 0);
+            expectEquals (dest.getLastEventTime(), 30);
+            expectEquals (dest.begin()->parameterIndex, 2);
+        }
+
+        beginTest ("Blocks are split at change points");
+        {
+            ParameterAutomationBuffer buffer;
+            buffer.addEvent (0, 0.1f, 0);
+            buffer.addEvent (0, 0.2f, 30);
+            buffer.addEvent (1, 0.3f, 32);
+            buffer.addEvent (0, 0.4f, 200);
+
+            Array<int> starts, lengths;
+            int numEventsApplied = 0;
+
+            buffer.processInSubBlocks (64,
+                                       [&] (const ParameterAutomationBuffer::Event&) { ++numEventsApplied; },
+                                       [&] (int start, int num) { starts.add (start); lengths.add (num); });
+
+            expect (starts  == Array<int> (0, 30, 32));
+            expect (lengths == Array<int> (30, 2, 32));
+            expectEquals (numEventsApplied, 4);
+
+            starts.clear();
+            lengths.clear();
+
+            buffer.processInSubBlocks (64,
+                                       [] (const ParameterAutomationBuffer::Event&) {},
+                                       [&] (int start, int num) { starts.add (start); lengths.add (num); },
+                                       8);
+
+            expect (starts  == Array<int> (0, 30));
+            expect (lengths == Array<int> (30, 34));
+        }
+
+        beginTest ("Smoothed values ramp from the sample where each change arrives");
+        {
+            ParameterAutomationBuffer buffer;
+            buffer.addEvent (0, 1.0f, 16);
+            buffer.addEvent (1, 0.5f, 20);
+
+            SmoothedValue<float> smoother (0.0f);
+            smoother.reset (8);
+
+            float values[64];
+            buffer.fillSmoothedValues (0, smoother, values, 64, [] (float v) { return v * 2.0f; });
+
+            for (int i = 0; i < 16; ++i)
+                expectEquals (values[i], 0.0f);
+
+            expectWithinAbsoluteError (values[16], 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError (values[23], 2.0f, 1.0e-6f);
+            expectEquals (values[63], 2.0f);
+        }
+    }
+};
+
+static ParameterAutomationBufferTests parameterAutomationBufferTests;
+
+#endif
+
+} // namespace juce
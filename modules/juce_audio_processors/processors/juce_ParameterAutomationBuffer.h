@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a block's worth of time-stamped parameter changes.
+
+    This is to parameters what a MidiBuffer is to MIDI: a host that knows exactly
+    where in a block each parameter change happens can pass these changes to an
+    AudioProcessor with AudioProcessor::setParameterAutomation(), and the processor
+    can then read them with AudioProcessor::getParameterAutomation() from inside
+    its processBlock() method.
+
+    The events are kept sorted by their sample position, and are stored in a
+    single flat array, so once enough space has been reserved with ensureSize(),
+    filling, clearing and reading the buffer won't allocate or lock.
+
+    In the following example, a gain parameter is smoothed sample-by-sample,
+    ramping towards each new value at the point where the host changed it:
+    @code
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+    {
+        getParameterAutomation().fillSmoothedValues (gain->getParameterIndex(), gainSmoother,
+                                                     gainValues.data(), buffer.getNumSamples());
+        ...
+    }
+    @endcode
+
+    @see AudioProcessor::getParameterAutomation, MidiBuffer
+
+    @tags{Audio}
+*/
+class JUCE_API  ParameterAutomationBuffer
+{
+public:
+    //==============================================================================
+    /** A single parameter change. */
+    struct Event
+    {
+        /** The position of the change within the block. */
+        int samplePosition;
+
+        /** The index of the parameter, as returned by AudioProcessorParameter::getParameterIndex(). */
+        int parameterIndex;
+
+        /** The new normalised value of the parameter, in the range 0 to 1. */
+        float value;
+    };
+
+    //==============================================================================
+    /** Creates an empty buffer. */
+    ParameterAutomationBuffer() = default;
+
+    /** Removes all events from the buffer, without freeing its storage. */
+    void clear() noexcept                               { events.clear(); }
+
+    /** Removes any events that lie within a range of sample positions. */
+    void clear (int start, int numSamples);
+
+    /** Preallocates space for the given number of events, so that adding up to this
+        many events won't need to allocate any memory.
+    */
+    void ensureSize (int minimumNumEvents);
+
+    /** Adds a parameter change to the buffer.
+
+        The event is inserted after any existing events with the same sample position,
+        so changes that happen at the same time stay in the order they were added.
+    */
+    void addEvent (int parameterIndex, float newValue, int samplePosition);
+
+    /** Adds the events from another buffer that lie within a range of sample positions,
+        shifting their positions by the given amount.
+    */
+    void addEvents (const ParameterAutomationBuffer& otherBuffer,
+                    int startSample, int numSamples, int sampleDeltaToAdd);
+
+    //==============================================================================
+    /** Returns true if there are no events in the buffer. */
+    bool isEmpty() const noexcept                       { return events.empty(); }
+
+    /** Returns the number of events in the buffer. */
+    int getNumEvents() const noexcept                   { return (int) events.size(); }
+
+    /** Returns the sample position of the first event, or 0 if the buffer is empty. */
+    int getFirstEventTime() const noexcept              { return isEmpty() ? 0 : events.front().samplePosition; }
+
+    /** Returns the sample position of the last event, or 0 if the buffer is empty. */
+    int getLastEventTime() const noexcept               { return isEmpty() ? 0 : events.back().samplePosition; }
+
+    /** Returns a pointer to the first event, for use in range-based for loops. */
+    const Event* begin() const noexcept                 { return events.data(); }
+
+    /** Returns a pointer just past the last event, for use in range-based for loops. */
+    const Event* end() const noexcept                   { return events.data() + events.size(); }
+
+    //==============================================================================
+    /** Splits a block of samples at the points where parameters change.
+
+        The applyEvent callback is called with each event in turn (as a const Event&), and
+        the renderSubBlock callback is called with the start sample and length of each
+        stretch of samples between changes, so that a processor which can't ramp its
+        parameters smoothly can still apply each change at the right moment.
+
+        To avoid rendering very short sub-blocks when the automation is dense, any events
+        that are closer than minimumSubBlockSize samples to the start of the current
+        sub-block are applied at the start of that sub-block. Events which lie beyond the
+        end of the block are applied after the last sub-block has been rendered.
+    */
+    template <typename EventCallback, typename SubBlockCallback>
+    void processInSubBlocks (int numSamples, EventCallback&& applyEvent,
+                             SubBlockCallback&& renderSubBlock, int minimumSubBlockSize = 1) const
+    {
+        jassert (minimumSubBlockSize > 0);
+
+        auto* event = begin();
+        auto* lastEvent = end();
+        int startSample = 0;
+
+        while (startSample < numSamples)
+        {
+            while (event != lastEvent && event->samplePosition < startSample + minimumSubBlockSize)
+                applyEvent (*event++);
+
+            auto endSample = event != lastEvent ? jmin (numSamples, event->samplePosition)
+                                                : numSamples;
+
+            renderSubBlock (startSample, endSample - startSample);
+            startSample = endSample;
+        }
+
+        while (event != lastEvent)
+            applyEvent (*event++);
+    }
+
+    /** Fills an array with one value per sample for a single parameter, using a
+        SmoothedValue to ramp towards each new value from the sample at which it arrives.
+
+        The mapValue function is used to convert each event's normalised value to the
+        value that will be given to the smoother, e.g. a parameter's convertFrom0to1().
+    */
+    template <typename SmoothedValueType, typename FloatType, typename ValueMapper>
+    void fillSmoothedValues (int parameterIndex, SmoothedValueType& smoother,
+                             FloatType* destValues, int numSamples, ValueMapper&& mapValue) const
+    {
+        int pos = 0;
+
+        for (auto& event : *this)
+        {
+            if (event.parameterIndex != parameterIndex)
+                continue;
+
+            for (auto eventPos = jlimit (0, numSamples, event.samplePosition); pos < eventPos; ++pos)
+                destValues[pos] = smoother.getNextValue();
+
+            smoother.setTargetValue (mapValue (event.value));
+        }
+
+        for (; pos < numSamples; ++pos)
+            destValues[pos] = smoother.getNextValue();
+    }
+
+    /** Fills an array with one value per sample for a single parameter, using a
+        SmoothedValue to ramp towards each new normalised value from the sample at which
+        it arrives.
+    */
+    template <typename SmoothedValueType, typename FloatType>
+    void fillSmoothedValues (int parameterIndex, SmoothedValueType& smoother,
+                             FloatType* destValues, int numSamples) const
+    {
+        fillSmoothedValues (parameterIndex, smoother, destValues, numSamples,
+                            [] (float v) { return (FloatType) v; });
+    }
+
+private:
+    //==============================================================================
+    std::vector<Event> events;
+
+    JUCE_LEAK_DETECTOR (ParameterAutomationBuffer)
+};
+
+} // namespace juce
@@ -54,36 +54,144 @@ NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (NamedValue&& ot
 bool NamedValueSet::NamedValue::operator== (const NamedValue& other) const noexcept   { return name == other.name && value == other.value; }
 bool NamedValueSet::NamedValue::operator!= (const NamedValue& other) const noexcept   { return ! operator== (other); }
 
+//==============================================================================
+/*  A hash table of the positions of the values, which is only created once a set
+    is big enough for a linear search to be slow. Identifiers are pooled, so names
+    can be hashed and compared using the address of their characters.
+*/
+struct NamedValueSet::Index
+{
+    explicit Index (const Array<NamedValue>& values)    { rebuild (values); }
+
+    void rebuild (const Array<NamedValue>& values)
+    {
+        // The table is kept at most half full, so that the chains of probes stay short
+        const auto numSlots = (size_t) nextPowerOfTwo (values.size() * 2);
+
+        slots.calloc (numSlots);
+        mask = numSlots - 1;
+        numItems = 0;
+
+        for (int i = 0; i < values.size(); ++i)
+            insert (values.getReference (i).name, i);
+    }
+
+    void add (const Array<NamedValue>& values)
+    {
+        if ((size_t) (numItems + 1) * 2 > mask + 1)
+            rebuild (values);
+        else
+            insert (values.getLast().name, values.size() - 1);
+    }
+
+    int find (const Identifier& name) const noexcept
+    {
+        const auto* key = getKey (name);
+
+        for (auto i = getSlot (key);; i = (i + 1) & mask)
+        {
+            const auto& slot = slots[i];
+
+            if (slot.key == key)
+                return slot.valueIndex;
+
+            if (slot.key == nullptr)
+                return -1;
+        }
+    }
+
+    static constexpr int minNumValues = 16;
+
+private:
+    struct Slot
+    {
+        const void* key;
+        int valueIndex;
+    };
+
+    static const void* getKey (const Identifier& name) noexcept     { return name.getCharPointer().getAddress(); }
+
+    size_t getSlot (const void* key) const noexcept
+    {
+        return (size_t) (((uint64) (pointer_sized_uint) key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+    }
+
+    void insert (const Identifier& name, int valueIndex) noexcept
+    {
+        const auto* key = getKey (name);
+        auto i = getSlot (key);
+
+        while (slots[i].key != nullptr)
+            i = (i + 1) & mask;
+
+        slots[i] = { key, valueIndex };
+        ++numItems;
+    }
+
+    HeapBlock<Slot> slots;
+    size_t mask = 0;
+    int numItems = 0;
+};
+
 //==============================================================================
 NamedValueSet::NamedValueSet() noexcept {}
 NamedValueSet::~NamedValueSet() noexcept {}
 
-NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values) {}
+NamedValueSet::NamedValueSet (const NamedValueSet& other)
+   : values (other.values)
+{
+    updateIndex();
+}
 
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-   : values (std::move (other.values)) {}
+   : values (std::move (other.values)),
+     nameIndex (std::move (other.nameIndex))
+{
+}
 
 NamedValueSet::NamedValueSet (std::initializer_list<NamedValue> list)
    : values (std::move (list))
 {
+    updateIndex();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    updateIndex();
     return *this;
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    std::swap (other.nameIndex, nameIndex);
     return *this;
 }
 
 void NamedValueSet::clear()
 {
     values.clear();
+    nameIndex.reset();
+}
+
+void NamedValueSet::updateIndex()
+{
+    if (values.size() < Index::minNumValues)
+        nameIndex.reset();
+    else if (nameIndex != nullptr)
+        nameIndex->rebuild (values);
+    else
+        nameIndex = std::make_unique<Index> (values);
+}
+
+void NamedValueSet::updateIndexAfterAdding()
+{
+    if (nameIndex != nullptr)
+        nameIndex->add (values);
+    else if (values.size() >= Index::minNumValues)
+        nameIndex = std::make_unique<Index> (values);
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const noexcept
@@ -149,20 +257,12 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 const var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 bool NamedValueSet::set (const Identifier& name, var&& newValue)
@@ -177,6 +277,7 @@ bool NamedValueSet::set (const Identifier& name, var&& newValue)
     }
 
     values.add ({ name, std::move (newValue) });
+    updateIndexAfterAdding();
     return true;
 }
 
@@ -192,6 +293,7 @@ bool NamedValueSet::set (const Identifier& name, const var& newValue)
     }
 
     values.add ({ name, newValue });
+    updateIndexAfterAdding();
     return true;
 }
 
@@ -202,6 +304,9 @@ bool NamedValueSet::contains (const Identifier& name) const noexcept
 
 int NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
+    if (nameIndex != nullptr)
+        return nameIndex->find (name);
+
     auto numValues = values.size();
 
     for (int i = 0; i < numValues; ++i)
@@ -213,18 +318,14 @@ int NamedValueSet::indexOf (const Identifier& name) const noexcept
 
 bool NamedValueSet::remove (const Identifier& name)
 {
-    auto numValues = values.size();
+    auto i = indexOf (name);
 
-    for (int i = 0; i < numValues; ++i)
-    {
-        if (values.getReference(i).name == name)
-        {
-            values.remove (i);
-            return true;
-        }
-    }
+    if (i < 0)
+        return false;
 
-    return false;
+    values.remove (i);
+    updateIndex();
+    return true;
 }
 
 Identifier NamedValueSet::getName (const int index) const noexcept
@@ -280,6 +381,8 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add ({ att->name, var (att->value) });
     }
+
+    updateIndex();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -303,4 +406,88 @@ void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests()
+        : UnitTest ("NamedValueSet", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Large sets behave like small ones");
+        {
+            Array<Identifier> names;
+
+            for (int i = 0; i < 300; ++i)
+                names.add ("property" + String (i));
+
+            NamedValueSet set;
+
+            for (int i = 0; i < names.size(); ++i)
+            {
+                expect (set.set (names[i], i));
+                expect (! set.set (names[i], i));
+                expectEquals (set.size(), i + 1);
+
+                for (int j = 0; j <= i; j += 7)
+                {
+                    expectEquals (set.indexOf (names[j]), j);
+                    expect (set[names[j]] == var (j));
+                }
+
+                expect (! set.contains ("missing"));
+            }
+
+            for (int i = 0; i < names.size(); i += 2)
+                expect (set.remove (names[i]));
+
+            expect (! set.remove (names[0]));
+            expectEquals (set.size(), names.size() / 2);
+
+            for (int i = 0; i < names.size(); ++i)
+            {
+                expect (set.contains (names[i]) == ((i % 2) != 0));
+                expect (set.getWithDefault (names[i], -1) == var ((i % 2) != 0 ? i : -1));
+            }
+
+            for (int i = 0; i < set.size(); ++i)
+                expectEquals (set.indexOf (set.getName (i)), i);
+
+            auto copy = set;
+            expect (copy == set);
+            expect (copy.set (names[1], "changed"));
+            expect (copy != set);
+            expect (copy[names[1]] == var ("changed"));
+
+            NamedValueSet moved (std::move (copy));
+            expect (moved[names[1]] == var ("changed"));
+            expect (moved.contains (names[299]));
+
+            moved = set;
+            expect (moved == set);
+
+            while (moved.size() > 0)
+            {
+                auto lastName = moved.getName (moved.size() - 1);
+                expect (moved.remove (lastName));
+                expect (! moved.contains (lastName));
+            }
+
+            set.clear();
+            expect (! set.contains (names[1]));
+            expect (set.set (names[1], 1));
+            expectEquals (set.indexOf (names[1]), 0);
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace juce
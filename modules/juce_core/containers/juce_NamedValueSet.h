@@ -179,7 +179,13 @@ public:
 
 private:
     //==============================================================================
+    struct Index;
+
+    void updateIndex();
+    void updateIndexAfterAdding();
+
     Array<NamedValue> values;
+    std::unique_ptr<Index> nameIndex;
 };
 
 } // namespace juce
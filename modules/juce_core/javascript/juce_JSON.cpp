@@ -365,10 +365,36 @@ struct JSONFormatter
         out << "\\u" << String::toHexString ((int) value).paddedLeft ('0', 4);
     }
 
+    static bool isPlainCharacter (juce_wchar c) noexcept
+    {
+        return c >= 32 && c < 127 && c != '\"' && c != '\\';
+    }
+
+    static void writePlainCharacters (OutputStream& out, CharPointer_UTF8 start, CharPointer_UTF8 end)
+    {
+        out.write (start.getAddress(), (size_t) (end.getAddress() - start.getAddress()));
+    }
+
+    template <typename CharPointerType>
+    static void writePlainCharacters (OutputStream& out, CharPointerType start, CharPointerType end)
+    {
+        while (start != end)
+            out << (char) start.getAndAdvance();
+    }
+
     static void writeString (OutputStream& out, String::CharPointerType t)
     {
         for (;;)
         {
+            // Characters that don't need escaping are written in runs, rather than one at a time
+            auto runStart = t;
+
+            while (isPlainCharacter (*t))
+                ++t;
+
+            if (t != runStart)
+                writePlainCharacters (out, runStart, t);
+
             auto c = t.getAndAdvance();
 
             switch (c)
@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct JSONDocument::Data  : public JSONStreamParser::Listener
+{
+    //==============================================================================
+    // Memory is handed out from a list of blocks, which are never freed individually
+    void* allocate (size_t numBytes)
+    {
+        numBytes = (numBytes + alignment - 1) & ~(alignment - 1);
+
+        if (numBytes > spaceInBlock)
+        {
+            nextBlockSize = jmin (nextBlockSize * 2, maxBlockSize);
+            const auto blockSize = jmax (nextBlockSize, numBytes);
+
+            blocks.emplace_back (blockSize);
+            nextFree = blocks.back().get();
+            spaceInBlock = blockSize;
+            memoryUsed += blockSize;
+        }
+
+        auto* result = nextFree;
+        nextFree += numBytes;
+        spaceInBlock -= numBytes;
+        return result;
+    }
+
+    const char* copyText (StringRef text)
+    {
+        const auto numBytes = text.text.sizeInBytes();
+        auto* dest = static_cast<char*> (allocate (numBytes));
+        memcpy (dest, text.text.getAddress(), numBytes);
+        return dest;
+    }
+
+    //==============================================================================
+    // The items of each object or array that's being parsed are collected on a stack, and
+    // then moved into a single allocation when it ends, so that they're contiguous
+    void add (const Item& item)
+    {
+        pendingItems.push_back (item);
+        pendingItems.back().name = pendingName;
+        pendingName = nullptr;
+    }
+
+    void startContainer (Item::Type type)
+    {
+        Item container;
+        container.type = type;
+        add (container);
+        containerStarts.push_back (pendingItems.size());
+    }
+
+    void endContainer()
+    {
+        const auto start = containerStarts.back();
+        const auto numChildren = pendingItems.size() - start;
+        containerStarts.pop_back();
+
+        auto& container = pendingItems[start - 1];
+        container.numChildren = (uint32) numChildren;
+
+        if (numChildren > 0)
+        {
+            auto* children = static_cast<Item*> (allocate (numChildren * sizeof (Item)));
+            std::uninitialized_copy (pendingItems.begin() + (ptrdiff_t) start, pendingItems.end(), children);
+            container.children = children;
+        }
+
+        pendingItems.resize (start);
+    }
+
+    void objectStarted() override                   { startContainer (Item::Type::object); }
+    void arrayStarted() override                    { startContainer (Item::Type::array); }
+    void objectEnded() override                     { endContainer(); }
+    void arrayEnded() override                      { endContainer(); }
+    void propertyName (StringRef name) override     { pendingName = copyText (name); }
+
+    void stringValue (StringRef text) override
+    {
+        Item item;
+        item.type = Item::Type::string;
+        item.text = copyText (text);
+        add (item);
+    }
+
+    void intValue (int64 value) override
+    {
+        Item item;
+        item.type = Item::Type::integer;
+        item.intValue = value;
+        add (item);
+    }
+
+    void doubleValue (double value) override
+    {
+        Item item;
+        item.type = Item::Type::floatingPoint;
+        item.doubleValue = value;
+        add (item);
+    }
+
+    void boolValue (bool value) override
+    {
+        Item item;
+        item.type = Item::Type::boolean;
+        item.intValue = value ? 1 : 0;
+        add (item);
+    }
+
+    void nullValue() override
+    {
+        add ({});
+    }
+
+    Item getRoot() const noexcept
+    {
+        return pendingItems.size() == 1 && containerStarts.empty() ? pendingItems.front() : Item();
+    }
+
+    //==============================================================================
+    static constexpr size_t alignment = alignof (Item);
+    static constexpr size_t maxBlockSize = 1 << 20;
+
+    std::vector<HeapBlock<char>> blocks;
+    char* nextFree = nullptr;
+    size_t spaceInBlock = 0, nextBlockSize = 2048, memoryUsed = 0;
+
+    std::vector<Item> pendingItems;
+    std::vector<size_t> containerStarts;
+    const char* pendingName = nullptr;
+};
+
+//==============================================================================
+JSONDocument::JSONDocument() = default;
+JSONDocument::~JSONDocument() = default;
+
+Result JSONDocument::parse (InputStream& input)
+{
+    data = std::make_unique<Data>();
+    auto result = JSONStreamParser (*data).parse (input);
+
+    if (result.failed())
+        data.reset();
+
+    return result;
+}
+
+Result JSONDocument::parse (const String& text)
+{
+    MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+    return parse (in);
+}
+
+void JSONDocument::clear()
+{
+    data.reset();
+}
+
+JSONDocument::Item JSONDocument::getRoot() const noexcept
+{
+    return data != nullptr ? data->getRoot() : Item();
+}
+
+size_t JSONDocument::getMemoryUsed() const noexcept
+{
+    return data != nullptr ? data->memoryUsed : 0;
+}
+
+//==============================================================================
+bool JSONDocument::Item::isVoid() const noexcept      { return type == Type::null; }
+bool JSONDocument::Item::isBool() const noexcept      { return type == Type::boolean; }
+bool JSONDocument::Item::isInt() const noexcept       { return type == Type::integer; }
+bool JSONDocument::Item::isDouble() const noexcept    { return type == Type::floatingPoint; }
+bool JSONDocument::Item::isString() const noexcept    { return type == Type::string; }
+bool JSONDocument::Item::isArray() const noexcept     { return type == Type::array; }
+bool JSONDocument::Item::isObject() const noexcept    { return type == Type::object; }
+
+bool JSONDocument::Item::getBool() const noexcept
+{
+    return type == Type::floatingPoint ? doubleValue != 0 : getInt() != 0;
+}
+
+int64 JSONDocument::Item::getInt() const noexcept
+{
+    switch (type)
+    {
+        case Type::boolean:
+        case Type::integer:         return intValue;
+        case Type::floatingPoint:   return (int64) doubleValue;
+        case Type::null:
+        case Type::string:
+        case Type::array:
+        case Type::object:
+        default:                    return 0;
+    }
+}
+
+double JSONDocument::Item::getDouble() const noexcept
+{
+    return type == Type::floatingPoint ? doubleValue : (double) getInt();
+}
+
+StringRef JSONDocument::Item::getString() const noexcept
+{
+    return type == Type::string ? StringRef (String::CharPointerType (text)) : StringRef();
+}
+
+int JSONDocument::Item::size() const noexcept
+{
+    return (int) numChildren;
+}
+
+JSONDocument::Item JSONDocument::Item::operator[] (int index) const noexcept
+{
+    return isPositiveAndBelow (index, size()) ? children[index] : Item();
+}
+
+JSONDocument::Item JSONDocument::Item::operator[] (StringRef propertyName) const noexcept
+{
+    if (type == Type::object)
+        for (auto& child : *this)
+            if (propertyName == StringRef (String::CharPointerType (child.name)))
+                return child;
+
+    return {};
+}
+
+StringRef JSONDocument::Item::getPropertyName (int index) const noexcept
+{
+    return type == Type::object && isPositiveAndBelow (index, size())
+             ? StringRef (String::CharPointerType (children[index].name)) : StringRef();
+}
+
+const JSONDocument::Item* JSONDocument::Item::begin() const noexcept
+{
+    return numChildren > 0 ? children : nullptr;
+}
+
+const JSONDocument::Item* JSONDocument::Item::end() const noexcept
+{
+    return begin() + numChildren;
+}
+
+var JSONDocument::Item::toVar() const
+{
+    switch (type)
+    {
+        case Type::boolean:         return intValue != 0;
+        case Type::floatingPoint:   return doubleValue;
+        case Type::string:          return String (CharPointer_UTF8 (text));
+
+        case Type::integer:
+            return isPositiveAndBelow (intValue + 0x80000000ll, 0x100000000ll) ? var ((int) intValue)
+                                                                             : var (intValue);
+
+        case Type::array:
+        {
+            Array<var> array;
+            array.ensureStorageAllocated (size());
+
+            for (auto& child : *this)
+                array.add (child.toVar());
+
+            return array;
+        }
+
+        case Type::object:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+
+            for (auto& child : *this)
+                object->setProperty (String (CharPointer_UTF8 (child.name)), child.toVar());
+
+            return result;
+        }
+
+        case Type::null:
+        default:
+            return {};
+    }
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONDocumentTests  : public UnitTest
+{
+public:
+    JSONDocumentTests()
+        : UnitTest ("JSONDocument", UnitTestCategories::json)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Navigation");
+        {
+            JSONDocument document;
+            expect (document.parse ("{ \"name\": \"Caf\\u00e9\", \"size\": 3, \"gain\": -0.5, \"on\": true, "
+                                    "\"tracks\": [ { \"id\": 1 }, { \"id\": 2 }, null ], \"empty\": {} }").wasOk());
+
+            auto root = document.getRoot();
+            expect (root.isObject() && root.size() == 6);
+            expect (root.getPropertyName (0) == StringRef ("name"));
+            expect (String (root["name"].getString()) == String (CharPointer_UTF8 ("Caf\xc3\xa9")));
+            expect (root["size"].isInt() && root["size"].getInt() == 3 && root["size"].getDouble() == 3.0);
+            expect (root["gain"].isDouble() && root["gain"].getDouble() == -0.5);
+            expect (root["on"].isBool() && root["on"].getBool());
+            expect (root["empty"].isObject() && root["empty"].size() == 0);
+            expect (root["missing"].isVoid() && root["missing"]["more"][3].isVoid());
+            expect (root["tracks"].isArray() && root["tracks"][2].isVoid() && root["tracks"][3].isVoid());
+
+            int64 total = 0;
+
+            for (auto track : root["tracks"])
+                total += track["id"].getInt();
+
+            expect (total == 3);
+            expect (document.getMemoryUsed() > 0);
+
+            expect (document.parse ("[ 1, 2").failed());
+            expect (document.getRoot().isVoid() && document.getMemoryUsed() == 0);
+        }
+
+        beginTest ("Conversion to var");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                auto v = JSONTests::createRandomVar (r, 0);
+                auto asString = JSON::toString (v, true);
+
+                JSONDocument document;
+                expect (document.parse (asString).wasOk());
+                expectEquals (JSON::toString (document.getRoot().toVar(), true), asString);
+            }
+        }
+    }
+};
+
+static JSONDocumentTests jsonDocumentTests;
+
+#endif
+
+} // namespace juce
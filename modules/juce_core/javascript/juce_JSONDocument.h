@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only JSON document, which is parsed into a compact tree that's allocated
+    in a few large blocks of memory.
+
+    JSON::parse() creates a DynamicObject, a NamedValueSet, an Identifier and a String
+    for every object, property and string in a document, which means a lot of small
+    allocations for big documents. A JSONDocument stores all of its items and strings
+    in an arena instead, which is much faster to fill and to free, and uses less memory.
+    Use it when you need to read a large document but not modify it, and call
+    Item::toVar() for any parts of it that you do need as vars.
+
+    @code
+    JSONDocument document;
+
+    if (document.parse (stream).wasOk())
+        for (auto track : document.getRoot()["tracks"])
+            DBG (track["name"].getString());
+    @endcode
+
+    The Items that a document returns refer to its memory, so they're only valid until
+    the document is cleared, parsed again or deleted.
+
+    @see JSON, JSONStreamParser
+
+    @tags{Core}
+*/
+class JUCE_API  JSONDocument
+{
+private:
+    struct Data;
+
+public:
+    //==============================================================================
+    /** Creates an empty document. */
+    JSONDocument();
+
+    /** Destructor. */
+    ~JSONDocument();
+
+    /** Parses a JSON document from a stream, replacing the current content.
+
+        If the document is malformed, this returns a failed Result and the document
+        will be empty.
+        @see JSONStreamParser::parse
+    */
+    Result parse (InputStream& input);
+
+    /** Parses a JSON document from a string, replacing the current content. */
+    Result parse (const String& text);
+
+    /** Releases all the memory that the document uses. */
+    void clear();
+
+    //==============================================================================
+    /**
+        Refers to a value in a JSONDocument.
+
+        An Item that doesn't refer to anything behaves like a JSON null, so you can
+        safely look up a chain of properties without checking each one.
+    */
+    class JUCE_API  Item
+    {
+    public:
+        /** Creates an Item that behaves like a JSON null. */
+        Item() = default;
+
+        bool isVoid() const noexcept;       /**< True for null, and for missing items. */
+        bool isBool() const noexcept;       /**< True for 'true' and 'false'. */
+        bool isInt() const noexcept;        /**< True for numbers without a decimal point or exponent. */
+        bool isDouble() const noexcept;     /**< True for any other numbers. */
+        bool isString() const noexcept;     /**< True for strings. */
+        bool isArray() const noexcept;      /**< True for arrays. */
+        bool isObject() const noexcept;     /**< True for objects. */
+
+        /** Returns the value of a bool, or a number converted to a bool. */
+        bool getBool() const noexcept;
+
+        /** Returns the value of a number, or 0 for other items. */
+        int64 getInt() const noexcept;
+
+        /** Returns the value of a number, or 0 for other items. */
+        double getDouble() const noexcept;
+
+        /** Returns the text of a string, or an empty string for other items. */
+        StringRef getString() const noexcept;
+
+        //==============================================================================
+        /** Returns the number of items in an array or properties in an object, or 0 for other items. */
+        int size() const noexcept;
+
+        /** Returns one of the items in an array or the values of an object's properties. */
+        Item operator[] (int index) const noexcept;
+
+        /** Returns the value of the property with the given name, if this is an object. */
+        Item operator[] (StringRef propertyName) const noexcept;
+
+        /** Returns the name of one of an object's properties. */
+        StringRef getPropertyName (int index) const noexcept;
+
+        /** Allows the items in an array or the values of an object to be iterated. */
+        const Item* begin() const noexcept;
+
+        /** Allows the items in an array or the values of an object to be iterated. */
+        const Item* end() const noexcept;
+
+        //==============================================================================
+        /** Creates a var with the same content as this item, in the same format that
+            JSON::parse() would have returned it.
+        */
+        var toVar() const;
+
+    private:
+        friend struct JSONDocument::Data;
+
+        enum class Type : uint8  { null, boolean, integer, floatingPoint, string, array, object };
+
+        const char* name = nullptr;
+        Type type = Type::null;
+        uint32 numChildren = 0;
+
+        union
+        {
+            int64 intValue = 0;
+            double doubleValue;
+            const char* text;
+            const Item* children;
+        };
+    };
+
+    //==============================================================================
+    /** Returns the top-level item of the document. */
+    Item getRoot() const noexcept;
+
+    /** Returns the number of bytes that the document has allocated. */
+    size_t getMemoryUsed() const noexcept;
+
+private:
+    //==============================================================================
+    std::unique_ptr<Data> data;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONDocument)
+};
+
+} // namespace juce
@@ -0,0 +1,834 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct JSONStreamParser::Reader
+{
+    Reader (InputStream& in, Listener& l)  : input (in), listener (l)
+    {
+        buffer.malloc (bufferSize);
+    }
+
+    struct ErrorException
+    {
+        String message;
+        int64 line, column;
+    };
+
+    [[noreturn]] void throwError (const String& message)
+    {
+        // The position of the character that was read last, counting from 1
+        const auto position = jmax ((int64) 0, getPosition() - 1);
+        throw ErrorException { message, line, position - lineStart + 1 };
+    }
+
+    //==============================================================================
+    void parseDocument()
+    {
+        skipWhitespace();
+
+        if (isEOF())
+            return;
+
+        for (;;)
+        {
+            if (! parseValue())
+                continue;
+
+            // Keep closing containers until we find a place where another value is expected
+            for (;;)
+            {
+                skipWhitespace();
+
+                if (containers.empty())
+                {
+                    if (! isEOF())
+                        throwError ("Unexpected text after the end of the JSON data");
+
+                    return;
+                }
+
+                const auto isObject = containers.back();
+                const auto c = readByte();
+
+                if (c == ',')
+                {
+                    skipWhitespace();
+
+                    // A trailing comma is allowed, so the container may end here
+                    if (peekByte() != (isObject ? '}' : ']'))
+                    {
+                        if (isObject)
+                            parsePropertyName();
+
+                        break;
+                    }
+
+                    readByte();
+                }
+                else if (c != (isObject ? '}' : ']'))
+                {
+                    throwError (c == 0 ? (isObject ? "Unexpected EOF in object declaration" : "Unexpected EOF in array declaration")
+                                       : (isObject ? "Expected ',' or '}'" : "Expected ',' or ']'"));
+                }
+
+                endContainer();
+            }
+        }
+    }
+
+    // Returns false if this started an object or array, whose first item needs to be parsed next.
+    // The containers are tracked with a stack rather than by recursion, so that deeply nested
+    // documents can't overflow the call stack.
+    bool parseValue()
+    {
+        skipWhitespace();
+        const auto c = readByte();
+
+        switch (c)
+        {
+            case '{':
+                listener.objectStarted();
+                containers.push_back (true);
+                skipWhitespace();
+
+                if (peekByte() == '}')
+                {
+                    readByte();
+                    endContainer();
+                    return true;
+                }
+
+                parsePropertyName();
+                return false;
+
+            case '[':
+                listener.arrayStarted();
+                containers.push_back (false);
+                skipWhitespace();
+
+                if (peekByte() == ']')
+                {
+                    readByte();
+                    endContainer();
+                    return true;
+                }
+
+                return false;
+
+            case '"':
+            case '\'':
+                parseString (c);
+                listener.stringValue (StringRef (String::CharPointerType (text.get())));
+                return true;
+
+            case '-':
+                skipWhitespace();
+                parseNumber (readByte(), true);
+                return true;
+
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                parseNumber (c, false);
+                return true;
+
+            case 't':   if (matchString ("rue"))  { listener.boolValue (true);  return true; }  break;
+            case 'f':   if (matchString ("alse")) { listener.boolValue (false); return true; }  break;
+            case 'n':   if (matchString ("ull"))  { listener.nullValue();       return true; }  break;
+
+            case 0:     throwError ("Unexpected EOF");
+            default:    break;
+        }
+
+        throwError ("Syntax error");
+    }
+
+    void endContainer()
+    {
+        if (containers.back())
+            listener.objectEnded();
+        else
+            listener.arrayEnded();
+
+        containers.pop_back();
+    }
+
+    void parsePropertyName()
+    {
+        skipWhitespace();
+
+        if (readByte() != '"')
+            throwError ("Expected a property name in double-quotes");
+
+        parseString ('"');
+
+        if (textLength == 0)
+            throwError ("Invalid property name");
+
+        skipWhitespace();
+
+        if (readByte() != ':')
+            throwError ("Expected ':'");
+
+        listener.propertyName (StringRef (String::CharPointerType (text.get())));
+    }
+
+    //==============================================================================
+    // Reads the rest of a string into the text buffer, and null-terminates it
+    void parseString (char quote)
+    {
+        textLength = 0;
+
+        for (;;)
+        {
+            // Copy the longest run of characters that don't need any special treatment
+            auto* start = next;
+
+            while (next < end && *next != quote && *next != '\\' && *next != '\n' && *next != 0)
+                ++next;
+
+            appendText (start, (size_t) (next - start));
+
+            if (next == end)
+            {
+                // The run stopped at the end of the buffer, so carry on with the next block
+                if (! refill())
+                    throwError ("Unexpected EOF in string constant");
+
+                continue;
+            }
+
+            const auto c = *next++;
+
+            if (c == quote)
+                break;
+
+            if (c == 0)
+                throwError ("Unexpected EOF in string constant");
+
+            if (c == '\n')
+            {
+                startNewLine();
+                appendText ("\n", 1);
+                continue;
+            }
+
+            appendChar (parseEscapeSequence());
+        }
+
+        if (! CharPointer_UTF8::isValidString (text.get(), (int) textLength))
+            throwError ("Invalid UTF-8 in string constant");
+
+        appendText ("", 1);
+        --textLength;
+    }
+
+    juce_wchar parseEscapeSequence()
+    {
+        switch (readByte())
+        {
+            case '"':   return '"';
+            case '\'':  return '\'';
+            case '\\':  return '\\';
+            case '/':   return '/';
+            case 'a':   return '\a';
+            case 'b':   return '\b';
+            case 'f':   return '\f';
+            case 'n':   return '\n';
+            case 'r':   return '\r';
+            case 't':   return '\t';
+
+            case 'u':
+            {
+                auto c = parseHexDigits();
+
+                // Characters outside the BMP are written as a surrogate pair
+                if (c >= 0xd800 && c <= 0xdbff && peekByte() == '\\')
+                {
+                    readByte();
+
+                    if (readByte() != 'u')
+                        throwError ("Expected a low surrogate after a high surrogate");
+
+                    auto low = parseHexDigits();
+
+                    if (low < 0xdc00 || low > 0xdfff)
+                        throwError ("Expected a low surrogate after a high surrogate");
+
+                    return (juce_wchar) (0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00));
+                }
+
+                if (c >= 0xd800 && c <= 0xdfff)
+                    return 0xfffd;
+
+                return c;
+            }
+
+            case 0:     throwError ("Unexpected EOF in string constant");
+            default:    throwError ("Illegal escape sequence in string constant");
+        }
+    }
+
+    juce_wchar parseHexDigits()
+    {
+        juce_wchar c = 0;
+
+        for (int i = 4; --i >= 0;)
+        {
+            auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) readByte());
+
+            if (digitValue < 0)
+                throwError ("Syntax error in unicode escape sequence");
+
+            c = (juce_wchar) ((c << 4) + static_cast<juce_wchar> (digitValue));
+        }
+
+        return c;
+    }
+
+    //==============================================================================
+    void parseNumber (char firstDigit, bool isNegative)
+    {
+        if (! isPositiveAndBelow (firstDigit - '0', 10))
+            throwError ("Syntax error in number");
+
+        char digits[64] = { firstDigit };
+        size_t numDigits = 1;
+        bool isDouble = false, overflowed = false;
+        auto intValue = (uint64) (firstDigit - '0');
+
+        for (auto previous = firstDigit;; previous = digits[numDigits++] = readByte())
+        {
+            const auto c = peekByte();
+            const auto digit = c - '0';
+
+            if (isPositiveAndBelow (digit, 10))
+            {
+                overflowed = overflowed || intValue > (std::numeric_limits<uint64>::max() - (uint64) digit) / 10;
+                intValue = intValue * 10 + (uint64) digit;
+            }
+            else if (c == '.' || c == 'e' || c == 'E' || ((c == '-' || c == '+') && (previous == 'e' || previous == 'E')))
+            {
+                isDouble = true;
+            }
+            else
+            {
+                if (! (CharacterFunctions::isWhitespace ((juce_wchar) (uint8) c)
+                        || c == ',' || c == '}' || c == ']' || c == 0))
+                    throwError ("Syntax error in number");
+
+                break;
+            }
+
+            if (numDigits == numElementsInArray (digits) - 1)
+                throwError ("Number too long");
+        }
+
+        const auto maxMagnitude = isNegative ? (uint64) std::numeric_limits<int64>::max() + 1
+                                             : (uint64) std::numeric_limits<int64>::max();
+
+        if (isDouble || overflowed || intValue > maxMagnitude)
+        {
+            digits[numDigits] = 0;
+            CharPointer_ASCII t (digits);
+            const auto value = CharacterFunctions::readDoubleValue (t);
+            return listener.doubleValue (isNegative ? -value : value);
+        }
+
+        listener.intValue (isNegative ? (int64) (0 - intValue) : (int64) intValue);
+    }
+
+    bool matchString (const char* t)
+    {
+        while (*t != 0)
+            if (readByte() != *t++)
+                return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    void skipWhitespace()
+    {
+        for (;;)
+        {
+            while (next < end && CharacterFunctions::isWhitespace ((juce_wchar) (uint8) *next))
+            {
+                if (*next == '\n')
+                {
+                    ++next;
+                    startNewLine();
+                }
+                else
+                {
+                    ++next;
+                }
+            }
+
+            if (next < end || ! refill())
+                return;
+        }
+    }
+
+    char peekByte()
+    {
+        if (next == end && ! refill())
+            return 0;
+
+        return *next;
+    }
+
+    char readByte()
+    {
+        if (next == end && ! refill())
+            return 0;
+
+        return *next++;
+    }
+
+    bool isEOF()        { return peekByte() == 0; }
+
+    bool refill()
+    {
+        if (reachedEnd)
+            return false;
+
+        bufferStart += bytesInBuffer;
+        bytesInBuffer = jmax (0, input.read (buffer, bufferSize));
+        next = buffer;
+        end = buffer + bytesInBuffer;
+        reachedEnd = (bytesInBuffer == 0);
+
+        return ! reachedEnd;
+    }
+
+    int64 getPosition() const noexcept      { return bufferStart + (next - buffer.get()); }
+
+    void startNewLine() noexcept
+    {
+        ++line;
+        lineStart = getPosition();
+    }
+
+    //==============================================================================
+    void appendText (const char* data, size_t numBytes)
+    {
+        if (numBytes == 0)
+            return;
+
+        if (textLength + numBytes > textAllocated)
+        {
+            textAllocated = jmax ((size_t) 256, (textLength + numBytes) * 2);
+            text.realloc (textAllocated);
+        }
+
+        memcpy (text + textLength, data, numBytes);
+        textLength += numBytes;
+    }
+
+    void appendChar (juce_wchar c)
+    {
+        char bytes[8];
+        CharPointer_UTF8 dest (bytes);
+        dest.write (c);
+        appendText (bytes, (size_t) (dest.getAddress() - bytes));
+    }
+
+    //==============================================================================
+    static constexpr int bufferSize = 16384;
+
+    InputStream& input;
+    Listener& listener;
+    HeapBlock<char> buffer, text;
+    const char* next = nullptr;
+    const char* end = nullptr;
+    int bytesInBuffer = 0;
+    int64 bufferStart = 0, line = 1, lineStart = 0;
+    bool reachedEnd = false;
+    size_t textLength = 0, textAllocated = 0;
+    std::vector<bool> containers;
+};
+
+//==============================================================================
+JSONStreamParser::JSONStreamParser (Listener& l)  : listener (l) {}
+JSONStreamParser::~JSONStreamParser() = default;
+
+Result JSONStreamParser::parse (InputStream& input)
+{
+    Reader reader (input, listener);
+
+    try
+    {
+        reader.parseDocument();
+    }
+    catch (const Reader::ErrorException& error)
+    {
+        return Result::fail (String (error.line) + ":" + String (error.column) + ": error: " + error.message);
+    }
+
+    return Result::ok();
+}
+
+//==============================================================================
+JSONStreamWriter::JSONStreamWriter (OutputStream& output, bool oneLine, int decimalPlaces)
+    : out (output), allOnOneLine (oneLine), maximumDecimalPlaces (decimalPlaces)
+{
+}
+
+JSONStreamWriter::~JSONStreamWriter()
+{
+    // All the objects and arrays need to be ended before the writer is deleted!
+    jassert (levels.empty());
+}
+
+int JSONStreamWriter::getIndentLevel() const noexcept
+{
+    return (int) levels.size() * JSONFormatter::indentSize;
+}
+
+void JSONStreamWriter::startValue()
+{
+    if (levels.empty())
+        return;
+
+    auto& level = levels.back();
+
+    if (level.isObject)
+    {
+        // Every value in an object needs a name, so you must call writePropertyName() first!
+        jassert (hasPropertyName);
+        hasPropertyName = false;
+        return;
+    }
+
+    if (level.numItems++ > 0)
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+    else if (! allOnOneLine)
+    {
+        out << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (out, getIndentLevel());
+}
+
+void JSONStreamWriter::startContainer (bool isObject)
+{
+    startValue();
+    out << (isObject ? '{' : '[');
+
+    if (isObject && ! allOnOneLine)
+        out << newLine;
+
+    levels.push_back ({ isObject, 0 });
+}
+
+void JSONStreamWriter::endContainer (bool isObject)
+{
+    // The object or array that you're ending must be the one that was started most recently!
+    jassert (! levels.empty() && levels.back().isObject == isObject && ! hasPropertyName);
+
+    if (levels.empty())
+        return;
+
+    const auto numItems = levels.back().numItems;
+    levels.pop_back();
+
+    if (! allOnOneLine)
+    {
+        if (numItems > 0)
+            out << newLine;
+
+        if (numItems > 0 || isObject)
+            JSONFormatter::writeSpaces (out, getIndentLevel());
+    }
+
+    out << (isObject ? '}' : ']');
+}
+
+void JSONStreamWriter::startObject()    { startContainer (true); }
+void JSONStreamWriter::endObject()      { endContainer (true); }
+void JSONStreamWriter::startArray()     { startContainer (false); }
+void JSONStreamWriter::endArray()       { endContainer (false); }
+
+void JSONStreamWriter::writePropertyName (StringRef name)
+{
+    // Property names can only be written inside an object, and each one needs a value!
+    jassert (! levels.empty() && levels.back().isObject && ! hasPropertyName);
+
+    if (levels.empty())
+        return;
+
+    if (levels.back().numItems++ > 0)
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (out, getIndentLevel());
+
+    out << '"';
+    JSONFormatter::writeString (out, name.text);
+    out << "\": ";
+
+    hasPropertyName = true;
+}
+
+void JSONStreamWriter::writeString (StringRef text)
+{
+    startValue();
+    out << '"';
+    JSONFormatter::writeString (out, text.text);
+    out << '"';
+}
+
+void JSONStreamWriter::writeInt (int64 value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONStreamWriter::writeDouble (double value)
+{
+    startValue();
+    JSONFormatter::write (out, value, getIndentLevel(), allOnOneLine, maximumDecimalPlaces);
+}
+
+void JSONStreamWriter::writeBool (bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONStreamWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONStreamWriter::writeVar (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, getIndentLevel(), allOnOneLine, maximumDecimalPlaces);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONStreamTests  : public UnitTest
+{
+public:
+    JSONStreamTests()
+        : UnitTest ("JSON streams", UnitTestCategories::json)
+    {}
+
+    // Rebuilds a var from the parser's callbacks, so that the results can be compared
+    struct VarBuilder  : public JSONStreamParser::Listener
+    {
+        void objectStarted() override                   { push (new DynamicObject()); }
+        void arrayStarted() override                    { push (Array<var>()); }
+        void objectEnded() override                     { pop(); }
+        void arrayEnded() override                      { pop(); }
+        void propertyName (StringRef name) override     { names.add (name); }
+        void stringValue (StringRef text) override      { add (String (text)); }
+        void intValue (int64 value) override            { add (isPositiveAndBelow (value + 0x80000000ll, 0x100000000ll) ? var ((int) value) : var (value)); }
+        void doubleValue (double value) override        { add (value); }
+        void boolValue (bool value) override            { add (value); }
+        void nullValue() override                       { add ({}); }
+
+        void push (const var& v)                        { add (v); stack.add (v); }
+        void pop()                                      { stack.removeLast(); }
+
+        void add (const var& v)
+        {
+            if (stack.isEmpty())
+            {
+                result = v;
+            }
+            else if (auto* object = stack.getLast().getDynamicObject())
+            {
+                object->setProperty (names[names.size() - 1], v);
+                names.remove (names.size() - 1);
+            }
+            else
+            {
+                stack.getReference (stack.size() - 1).append (v);
+            }
+        }
+
+        var result;
+        Array<var> stack;
+        StringArray names;
+    };
+
+    static var parseWithStream (const char* utf8, Result& result)
+    {
+        MemoryInputStream in (utf8, strlen (utf8), false);
+        VarBuilder builder;
+        result = JSONStreamParser (builder).parse (in);
+        return builder.result;
+    }
+
+    static var parseWithStream (const String& text, Result& result)
+    {
+        return parseWithStream (text.toRawUTF8(), result);
+    }
+
+    static var parseWithStream (const char* utf8)
+    {
+        auto result = Result::ok();
+        return parseWithStream (utf8, result);
+    }
+
+    static var parseWithStream (const String& text)
+    {
+        return parseWithStream (text.toRawUTF8());
+    }
+
+    void writeWithStream (JSONStreamWriter& writer, const var& v, Random& r)
+    {
+        if (auto* object = v.getDynamicObject())
+        {
+            writer.startObject();
+
+            for (auto& p : object->getProperties())
+            {
+                writer.writePropertyName (p.name.toString());
+                writeWithStream (writer, p.value, r);
+            }
+
+            writer.endObject();
+        }
+        else if (auto* array = v.getArray())
+        {
+            // Mix in writeVar() for some of the nested items, to check that the layouts match
+            if (r.nextInt (4) == 0)
+                return writer.writeVar (v);
+
+            writer.startArray();
+
+            for (auto& item : *array)
+                writeWithStream (writer, item, r);
+
+            writer.endArray();
+        }
+        else if (v.isString())      writer.writeString (v.toString());
+        else if (v.isInt() || v.isInt64()) writer.writeInt (v);
+        else if (v.isDouble())      writer.writeDouble (v);
+        else if (v.isBool())        writer.writeBool (v);
+        else if (v.isVoid())        writer.writeNull();
+        else                        writer.writeVar (v);
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Parsing");
+        {
+            expect (parseWithStream ("").isVoid());
+            expect (parseWithStream ("  \n ").isVoid());
+            expect (parseWithStream ("{}").isObject());
+            expect (parseWithStream ("[]").isArray());
+            expect (parseWithStream ("[ 1234 ]")[0].isInt());
+            expect (parseWithStream ("[ 12345678901234 ]")[0].isInt64());
+            expect (parseWithStream ("[ 1.123e3 ]")[0].isDouble());
+            expect (parseWithStream ("[-1234]")[0] == var (-1234));
+            expect (parseWithStream ("[- 12345678901234]")[0] == var (-12345678901234ll));
+            expect (parseWithStream ("[-1.123e3]")[0] == var (-1123.0));
+            expect (parseWithStream ("[1e400, 123456789012345678901234567890]")[1].isDouble());
+            expect (parseWithStream ("[-9223372036854775808]")[0] == var (std::numeric_limits<int64>::min()));
+            expect (parseWithStream ("[1, 2, ]").size() == 2);
+            expect (parseWithStream ("{ \"a\" : true, \"b\": [ null, false ], }").getProperty ("b", {}).size() == 2);
+            expect (parseWithStream ("\"top\"") == var ("top"));
+            expect (parseWithStream ("[ \"\\u00e9\\ud83d\\ude00\\n\" ]")[0] == var (String (CharPointer_UTF8 ("\xc3\xa9\xf0\x9f\x98\x80\n"))));
+            expect (parseWithStream ("[ 'single' ]")[0] == var ("single"));
+
+            for (auto* bad : { "[1 2]", "{\"a\" 1}", "{a: 1}", "{\"\": 1}", "[tru]", "[\"unterminated",
+                               "[1", "{\"a\": 1", "[1.2.3x]", "[\"\\q\"]", "[\"\\ud83d\\u0041\"]", "[] []", "[\"\xff\"]" })
+            {
+                auto result = Result::ok();
+                parseWithStream (bad, result);
+                expect (result.failed(), String::fromUTF8 (bad));
+            }
+
+            auto result = Result::ok();
+            parseWithStream ("[\n  1,\n  2 3\n]", result);
+            expect (result.getErrorMessage().startsWith ("3:5:"), result.getErrorMessage());
+        }
+
+        beginTest ("Random documents");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                auto v = JSONTests::createRandomVar (r, 0);
+                const auto oneLine = r.nextBool();
+                auto asString = JSON::toString (v, oneLine);
+
+                auto result = Result::ok();
+                auto parsed = parseWithStream (asString, result);
+                expect (result.wasOk(), result.getErrorMessage());
+                expectEquals (JSON::toString (parsed, oneLine), asString);
+
+                MemoryOutputStream out;
+
+                {
+                    JSONStreamWriter writer (out, oneLine);
+                    writeWithStream (writer, v, r);
+                }
+
+                expectEquals (out.toString(), asString);
+            }
+        }
+
+        beginTest ("Reading in blocks");
+        {
+            // Long strings and numbers will cross the boundaries of the parser's buffer
+            var array;
+
+            for (int i = 0; i < 2000; ++i)
+                array.append (i % 3 == 0 ? var (String::repeatedString ("abc\\\"\xc3\xa9", i)) : var (i * 1234567.0));
+
+            auto asString = JSON::toString (array, true);
+            auto parsed = parseWithStream (asString);
+            expectEquals (JSON::toString (parsed, true), asString);
+        }
+    }
+};
+
+static JSONStreamTests jsonStreamTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An event-based JSON parser, which reads from a stream and calls a Listener for
+    each item that it finds, instead of building a var.
+
+    The stream is read a block at a time, so the whole document never has to be in
+    memory at once, and nothing is allocated for each object, array or string. This
+    makes it a good choice for very large documents, or when you only need a few
+    values from a document, or want to load it into your own data structures.
+
+    @code
+    struct TitleFinder  : public JSONStreamParser::Listener
+    {
+        void propertyName (StringRef name) override     { isTitle = (name == StringRef ("title")); }
+        void stringValue (StringRef text) override      { if (isTitle) titles.add (text); }
+
+        bool isTitle = false;
+        StringArray titles;
+    };
+
+    TitleFinder finder;
+    auto result = JSONStreamParser (finder).parse (stream);
+    @endcode
+
+    The parser accepts the same documents as JSON::parse(), except that the top-level
+    item can also be a primitive value, and it will fail if there's anything other than
+    whitespace after the end of the top-level item.
+
+    @see JSON, JSONStreamWriter, JSONDocument
+
+    @tags{Core}
+*/
+class JUCE_API  JSONStreamParser
+{
+public:
+    //==============================================================================
+    /**
+        Receives the items that a JSONStreamParser finds, in the order they appear in
+        the document.
+
+        The StringRefs that are passed to the callbacks point into the parser's own
+        buffer, so they're only valid until the callback returns.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() = default;
+
+        /** Called when a '{' is found. */
+        virtual void objectStarted() {}
+
+        /** Called when the '}' at the end of an object is found. */
+        virtual void objectEnded() {}
+
+        /** Called when a '[' is found. */
+        virtual void arrayStarted() {}
+
+        /** Called when the ']' at the end of an array is found. */
+        virtual void arrayEnded() {}
+
+        /** Called for each property in an object, before the callbacks for its value. */
+        virtual void propertyName (StringRef name)      { ignoreUnused (name); }
+
+        /** Called when a string value is found. */
+        virtual void stringValue (StringRef text)       { ignoreUnused (text); }
+
+        /** Called when a number without a decimal point or exponent is found. */
+        virtual void intValue (int64 value)             { ignoreUnused (value); }
+
+        /** Called when any other number is found. */
+        virtual void doubleValue (double value)         { ignoreUnused (value); }
+
+        /** Called when 'true' or 'false' is found. */
+        virtual void boolValue (bool value)             { ignoreUnused (value); }
+
+        /** Called when 'null' is found. */
+        virtual void nullValue() {}
+    };
+
+    //==============================================================================
+    /** Creates a parser that will send its callbacks to the given listener. */
+    explicit JSONStreamParser (Listener& listener);
+
+    /** Destructor. */
+    ~JSONStreamParser();
+
+    /** Reads a JSON document from a stream, calling the listener for each item in it.
+
+        If the document is malformed, this returns a failed Result that describes the
+        problem and where it was found. The listener will already have received the
+        callbacks for everything before the error.
+
+        An empty stream, or one that only contains whitespace, is not an error, and
+        doesn't produce any callbacks.
+    */
+    Result parse (InputStream& input);
+
+private:
+    //==============================================================================
+    struct Reader;
+
+    Listener& listener;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamParser)
+};
+
+//==============================================================================
+/**
+    Writes a JSON document to a stream, one item at a time.
+
+    This lets you write large documents without building a var for them first. The
+    layout is the same as JSON::writeToStream() produces, so a document that's written
+    with a JSONStreamWriter is identical to one written from the equivalent var.
+
+    @code
+    JSONStreamWriter writer (stream);
+
+    writer.startObject();
+    writer.writePropertyName ("tracks");
+    writer.startArray();
+
+    for (auto& track : tracks)
+        writer.writeString (track.getName());
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    Each value in an object must be preceded by a call to writePropertyName(), and
+    every object and array must be ended before the writer is deleted.
+
+    @see JSON, JSONStreamParser
+
+    @tags{Core}
+*/
+class JUCE_API  JSONStreamWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer for a stream, which must stay valid while the writer exists.
+
+        The allOnOneLine and maximumDecimalPlaces parameters have the same meaning as
+        they do for JSON::writeToStream().
+    */
+    explicit JSONStreamWriter (OutputStream& output,
+                               bool allOnOneLine = false,
+                               int maximumDecimalPlaces = 15);
+
+    /** Destructor. */
+    ~JSONStreamWriter();
+
+    //==============================================================================
+    /** Writes a '{' and starts a new object. */
+    void startObject();
+
+    /** Ends the object that was most recently started. */
+    void endObject();
+
+    /** Writes a '[' and starts a new array. */
+    void startArray();
+
+    /** Ends the array that was most recently started. */
+    void endArray();
+
+    /** Writes the name of the next property in the current object. */
+    void writePropertyName (StringRef name);
+
+    //==============================================================================
+    /** Writes a string value. */
+    void writeString (StringRef text);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value. */
+    void writeDouble (double value);
+
+    /** Writes 'true' or 'false'. */
+    void writeBool (bool value);
+
+    /** Writes 'null'. */
+    void writeNull();
+
+    /** Writes a var, including any objects or arrays that it contains. */
+    void writeVar (const var& value);
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& out;
+    const bool allOnOneLine;
+    const int maximumDecimalPlaces;
+    std::vector<Level> levels;
+    bool hasPropertyName = false;
+
+    void startValue();
+    void startContainer (bool isObject);
+    void endContainer (bool isObject);
+    int getIndentLevel() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamWriter)
+};
+
+} // namespace juce
@@ -71,6 +71,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     }
 
     Time timeout;
+    uint32 timeoutCheckCounter = 0;
+    int callDepth = 0, maximumCallDepth = 0;
 
     using Args = const var::NativeFunctionArgs&;
     using TokenType = const char*;
@@ -78,13 +80,28 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     void execute (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        std::unique_ptr<BlockStatement> (tb.parseStatementList())->perform (Scope ({}, *this, *this), nullptr);
+        std::unique_ptr<BlockStatement> statements (tb.parseStatementList());
+
+        CodeBlock compiledCode;
+        Compiler compiler (compiledCode, false);
+        statements->compile (compiler);
+        compiler.emit (OpCode::returnVoid, *statements);
+
+        RegisterFile registers (compiledCode.numRegisters);
+        run (Scope ({}, *this, *this, &compiledCode, registers.registers));
     }
 
     var evaluate (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        return ExpPtr (tb.parseExpression())->getResult (Scope ({}, *this, *this));
+        ExpPtr expression (tb.parseExpression());
+
+        CodeBlock compiledCode;
+        Compiler compiler (compiledCode, false);
+        compiler.emit (OpCode::returnValue, *expression, expression->compileToRegister (compiler));
+
+        RegisterFile registers (compiledCode.numRegisters);
+        return run (Scope ({}, *this, *this, &compiledCode, registers.registers));
     }
 
     //==============================================================================
@@ -125,16 +142,97 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         String::CharPointerType location;
     };
 
+    //==============================================================================
+    // Scripts are parsed into a tree of Statement and Expression nodes, which is then
+    // compiled into a list of register-based instructions for run() to execute.
+    // Each function call gets its own array of registers: the first ones hold the
+    // function's 'this', parameters and local variables, and the rest are temporaries.
+    enum class OpCode : uint8
+    {
+        loadConstant,       // a = dest, b = constant index
+        loadUndefined,      // a = dest
+        loadScopeObject,    // a = dest: the 'this' object for a plain function call
+        move,               // a = dest, b = source
+        getName,            // a = dest, b = name index
+        setName,            // a = source, b = name index
+        declareVariable,    // a = source, b = name index
+        getProperty,        // a = dest, b = object, c = name index
+        setProperty,        // a = object, b = name index, c = source
+        getElement,         // a = dest, b = object, c = key
+        setElement,         // a = object, b = key, c = source
+        add, subtract, multiply, equals, notEquals,
+        lessThan, lessThanOrEqual, greaterThan, greaterThanOrEqual,
+        binaryOperator,     // a = dest, b = lhs, c = rhs: the node is the BinaryOperator to apply
+        typeEquals,         // a = dest, b = lhs, c = rhs
+        typeNotEquals,      // a = dest, b = lhs, c = rhs
+        toBool,             // a = dest, b = source
+        jump,               // c = target
+        jumpIfFalse,        // a = condition, c = target
+        jumpIfTrue,         // a = condition, c = target
+        findMethod,         // a = function call base, c = name index
+        call,               // a = dest, b = function call base, c = number of arguments
+        callMethod,         // a = dest, b = function call base, c = number of arguments
+        beginNew,           // a = dest, b = function call base, c = target if there's no function to call
+        newObject,          // a = dest
+        initProperty,       // a = object, b = name index, c = source
+        newArray,           // a = dest, b = first element, c = number of elements
+        checkTimeOut,
+        throwAssignmentError,
+        returnValue,        // a = source
+        returnVoid
+    };
+
+    struct Statement;
+
+    struct Instruction
+    {
+        OpCode op;
+        int a, b, c;
+        const Statement* node; // the node that this was compiled from, which provides the location for errors
+    };
+
+    struct CodeBlock
+    {
+        Array<Instruction> instructions;
+        Array<var> constants;
+        Array<Identifier> names, localNames;
+        int numRegisters = 0;
+    };
+
+    struct RegisterFile
+    {
+        RegisterFile (int numRegisters)
+            : registers (numRegisters <= numElementsInArray (localStorage)
+                            ? localStorage : (heapStorage.reset (new var[(size_t) numRegisters]), heapStorage.get()))
+        {}
+
+        var localStorage[16];
+        std::unique_ptr<var[]> heapStorage;
+        var* const registers;
+
+        JUCE_DECLARE_NON_COPYABLE (RegisterFile)
+    };
+
     //==============================================================================
     struct Scope
     {
-        Scope (const Scope* p, ReferenceCountedObjectPtr<RootObject> rt, DynamicObject::Ptr scp) noexcept
-            : parent (p), root (std::move (rt)),
-              scope (std::move (scp)) {}
+        Scope (const Scope* p, RootObject& rt, DynamicObject::Ptr scp,
+               const CodeBlock* c = nullptr, var* regs = nullptr) noexcept
+            : parent (p), root (rt), scope (std::move (scp)), code (c), registers (regs) {}
+
+        Scope (const Scope* p, RootObject& rt, const CodeBlock& c, var* regs) noexcept
+            : parent (p), root (rt), code (&c), registers (regs) {}
 
         const Scope* const parent;
-        ReferenceCountedObjectPtr<RootObject> root;
-        DynamicObject::Ptr scope;
+        RootObject& root;
+        DynamicObject::Ptr scope;   // null if this is a function call, whose variables are in its registers
+        const CodeBlock* const code;
+        var* const registers;
+
+        var getScopeObject() const
+        {
+            return scope != nullptr ? var (scope.get()) : var (&root);
+        }
 
         var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName) const
         {
@@ -172,19 +270,31 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var* findRootClassProperty (const Identifier& className, const Identifier& propName) const
         {
-            if (auto* cls = root->getProperty (className).getDynamicObject())
+            if (auto* cls = root.getProperty (className).getDynamicObject())
                 return getPropertyPointer (*cls, propName);
 
             return nullptr;
         }
 
-        var findSymbolInParentScopes (const Identifier& name) const
+        const var* findSymbolInParentScopes (const Identifier& name) const
         {
-            if (auto v = getPropertyPointer (*scope, name))
-                return *v;
+            for (auto* s = this; s != nullptr; s = s->parent)
+            {
+                if (s->scope != nullptr)
+                {
+                    if (auto* v = getPropertyPointer (*s->scope, name))
+                        return v;
+                }
+                else
+                {
+                    auto index = s->code->localNames.indexOf (name);
 
-            return parent != nullptr ? parent->findSymbolInParentScopes (name)
-                                     : var::undefined();
+                    if (index >= 0)
+                        return s->registers + index;
+                }
+            }
+
+            return nullptr;
         }
 
         bool findAndInvokeMethod (const Identifier& function, const var::NativeFunctionArgs& args, var& result) const
@@ -207,7 +317,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (int i = 0; i < props.size(); ++i)
                 if (auto* o = props.getValueAt (i).getDynamicObject())
-                    if (Scope (this, *root, *o).findAndInvokeMethod (function, args, result))
+                    if (Scope (this, root, *o).findAndInvokeMethod (function, args, result))
                         return true;
 
             return false;
@@ -234,21 +344,103 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         void checkTimeOut (const CodeLocation& location) const
         {
-            if (Time::getCurrentTime() > root->timeout)
-                location.throwError (root->timeout == Time() ? "Interrupted" : "Execution timed-out");
+            // reading the clock is slow compared to a loop iteration, so it's only done every so often
+            if ((++root.timeoutCheckCounter & 31) == 0 && Time::getCurrentTime() > root.timeout)
+                location.throwError (root.timeout == Time() ? "Interrupted" : "Execution timed-out");
         }
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Scope)
     };
 
+    //==============================================================================
+    struct Compiler
+    {
+        Compiler (CodeBlock& c, bool isFunctionBody) noexcept
+            : code (c), isFunction (isFunctionBody), nextRegister (c.localNames.size())
+        {
+            code.numRegisters = nextRegister;
+        }
+
+        int emit (OpCode op, const Statement& node, int a = 0, int b = 0, int c = 0)
+        {
+            code.instructions.add ({ op, a, b, c, &node });
+            return code.instructions.size() - 1;
+        }
+
+        void emitMove (int dest, int source)
+        {
+            if (dest != source)
+                code.instructions.add ({ OpCode::move, dest, source, 0, nullptr });
+        }
+
+        int getPosition() const noexcept                     { return code.instructions.size(); }
+        void setJumpTarget (int instruction, int target)     { code.instructions.getReference (instruction).c = target; }
+        int getLocalRegister (const Identifier& name) const  { return code.localNames.indexOf (name); }
+        bool isLocalRegister (int r) const noexcept          { return r < code.localNames.size(); }
+
+        int allocateRegisters (int num)
+        {
+            auto first = nextRegister;
+            nextRegister += num;
+            code.numRegisters = jmax (code.numRegisters, nextRegister);
+            return first;
+        }
+
+        int allocateRegister()  { return allocateRegisters (1); }
+
+        int copyToNewRegister (int source)
+        {
+            auto r = allocateRegister();
+            emitMove (r, source);
+            return r;
+        }
+
+        int addConstant (const var& v)
+        {
+            code.constants.add (v);
+            return code.constants.size() - 1;
+        }
+
+        int getNameIndex (const Identifier& name)
+        {
+            auto index = code.names.indexOf (name);
+
+            if (index >= 0)
+                return index;
+
+            code.names.add (name);
+            return code.names.size() - 1;
+        }
+
+        struct Loop
+        {
+            Array<int> breaks, continues;
+        };
+
+        struct TemporaryRegisters
+        {
+            TemporaryRegisters (Compiler& c) noexcept  : compiler (c), start (c.nextRegister) {}
+            ~TemporaryRegisters()                      { compiler.nextRegister = start; }
+
+            Compiler& compiler;
+            const int start;
+        };
+
+        CodeBlock& code;
+        const bool isFunction;
+        int nextRegister;
+        Array<Loop*> loops;
+
+        JUCE_DECLARE_NON_COPYABLE (Compiler)
+    };
+
     //==============================================================================
     struct Statement
     {
         Statement (const CodeLocation& l) noexcept : location (l) {}
         virtual ~Statement() {}
 
-        enum ResultCode  { ok = 0, returnWasHit, breakWasHit, continueWasHit };
-        virtual ResultCode perform (const Scope&, var*) const  { return ok; }
+        virtual void compile (Compiler&) const {}
 
         CodeLocation location;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Statement)
@@ -258,10 +450,34 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         Expression (const CodeLocation& l) noexcept : Statement (l) {}
 
-        virtual var getResult (const Scope&) const            { return var::undefined(); }
-        virtual void assign (const Scope&, const var&) const  { location.throwError ("Cannot assign to this expression!"); }
+        // Writes the result into the given register, which mustn't be changed until
+        // all the sub-expressions have been evaluated.
+        virtual void compileInto (Compiler& c, int dest) const      { c.emit (OpCode::loadUndefined, *this, dest); }
+        virtual void compileAssignment (Compiler& c, int) const     { c.emit (OpCode::throwAssignmentError, *this); }
 
-        ResultCode perform (const Scope& s, var*) const override  { getResult (s); return ok; }
+        // Returns the register that holds the result, which may be a local variable
+        virtual int compileToRegister (Compiler& c) const
+        {
+            auto r = c.allocateRegister();
+            compileInto (c, r);
+            return r;
+        }
+
+        virtual int getLocalRegister (const Compiler&) const      { return -1; }
+        virtual bool canChangeLocalVariables() const              { return true; }
+
+        void compile (Compiler& c) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            compileToRegister (c);
+        }
+
+        // Jumps if the value of the expression is false, or true if jumpIfTrue is set.
+        int compileConditionalJump (Compiler& c, bool jumpIfTrue) const
+        {
+            Compiler::TemporaryRegisters t (c);
+            return c.emit (jumpIfTrue ? OpCode::jumpIfTrue : OpCode::jumpIfFalse, *this, compileToRegister (c));
+        }
     };
 
     using ExpPtr = std::unique_ptr<Expression>;
@@ -270,13 +486,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         BlockStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
             for (auto* statement : statements)
-                if (auto r = statement->perform (s, returnedValue))
-                    return r;
-
-            return ok;
+                statement->compile (c);
         }
 
         OwnedArray<Statement> statements;
@@ -286,9 +499,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         IfStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
-            return (condition->getResult(s) ? trueBranch : falseBranch)->perform (s, returnedValue);
+            auto jumpToFalseBranch = condition->compileConditionalJump (c, false);
+            trueBranch->compile (c);
+            auto jumpToEnd = c.emit (OpCode::jump, *this);
+            c.setJumpTarget (jumpToFalseBranch, c.getPosition());
+            falseBranch->compile (c);
+            c.setJumpTarget (jumpToEnd, c.getPosition());
         }
 
         ExpPtr condition;
@@ -299,39 +517,64 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         VarStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var*) const override
+        void compile (Compiler& c) const override
         {
-            s.scope->setProperty (name, initialiser->getResult (s));
-            return ok;
+            auto local = c.getLocalRegister (name);
+
+            if (local >= 0)
+            {
+                // A hoisted local already exists, so a declaration without a value mustn't change it
+                if (hasInitialiser)
+                    initialiser->compileInto (c, local);
+            }
+            else
+            {
+                Compiler::TemporaryRegisters t (c);
+                auto value = initialiser->compileToRegister (c);
+                c.emit (OpCode::declareVariable, *this, value, c.getNameIndex (name));
+            }
         }
 
         Identifier name;
         ExpPtr initialiser;
+        bool hasInitialiser = false;
     };
 
     struct LoopStatement  : public Statement
     {
         LoopStatement (const CodeLocation& l, bool isDo) noexcept : Statement (l), isDoLoop (isDo) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
-            initialiser->perform (s, nullptr);
+            initialiser->compile (c);
 
-            while (isDoLoop || condition->getResult (s))
-            {
-                s.checkTimeOut (location);
-                auto r = body->perform (s, returnedValue);
+            Compiler::Loop loop;
+            c.loops.add (&loop);
 
-                if (r == returnWasHit)   return r;
-                if (r == breakWasHit)    break;
+            auto start = c.getPosition();
+            auto exitJump = isDoLoop ? -1 : condition->compileConditionalJump (c, false);
 
-                iterator->perform (s, nullptr);
+            c.emit (OpCode::checkTimeOut, *this);
+            body->compile (c);
 
-                if (isDoLoop && r != continueWasHit && ! condition->getResult (s))
-                    break;
-            }
+            // in a do-loop, a 'continue' skips the condition
+            auto continueTarget = isDoLoop ? start : c.getPosition();
+            iterator->compile (c);
+
+            if (isDoLoop)
+                c.setJumpTarget (condition->compileConditionalJump (c, true), start);
+            else
+                c.emit (OpCode::jump, *this, 0, 0, start);
+
+            auto end = c.getPosition();
 
-            return ok;
+            if (exitJump >= 0)
+                c.setJumpTarget (exitJump, end);
+
+            for (auto i : loop.breaks)     c.setJumpTarget (i, end);
+            for (auto i : loop.continues)  c.setJumpTarget (i, continueTarget);
+
+            c.loops.removeLast();
         }
 
         std::unique_ptr<Statement> initialiser, iterator, body;
@@ -343,10 +586,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ReturnStatement (const CodeLocation& l, Expression* v) noexcept : Statement (l), returnValue (v) {}
 
-        ResultCode perform (const Scope& s, var* ret) const override
+        void compile (Compiler& c) const override
         {
-            if (ret != nullptr)  *ret = returnValue->getResult (s);
-            return returnWasHit;
+            // a return statement at the top level of a script just stops it
+            if (c.isFunction)
+            {
+                Compiler::TemporaryRegisters t (c);
+                c.emit (OpCode::returnValue, *this, returnValue->compileToRegister (c));
+            }
+            else
+            {
+                c.emit (OpCode::returnVoid, *this);
+            }
         }
 
         ExpPtr returnValue;
@@ -355,19 +606,36 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct BreakStatement  : public Statement
     {
         BreakStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return breakWasHit; }
+
+        void compile (Compiler& c) const override
+        {
+            if (auto* loop = c.loops.getLast())
+                loop->breaks.add (c.emit (OpCode::jump, *this));
+            else
+                c.emit (OpCode::returnVoid, *this);
+        }
     };
 
     struct ContinueStatement  : public Statement
     {
         ContinueStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return continueWasHit; }
+
+        void compile (Compiler& c) const override
+        {
+            if (auto* loop = c.loops.getLast())
+                loop->continues.add (c.emit (OpCode::jump, *this));
+            else
+                c.emit (OpCode::returnVoid, *this);
+        }
     };
 
     struct LiteralValue  : public Expression
     {
         LiteralValue (const CodeLocation& l, const var& v) noexcept : Expression (l), value (v) {}
-        var getResult (const Scope&) const override   { return value; }
+
+        void compileInto (Compiler& c, int dest) const override  { c.emit (OpCode::loadConstant, *this, dest, c.addConstant (value)); }
+        bool canChangeLocalVariables() const override            { return false; }
+
         var value;
     };
 
@@ -375,14 +643,33 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
+        int getLocalRegister (const Compiler& c) const override  { return c.getLocalRegister (name); }
+        bool canChangeLocalVariables() const override            { return false; }
+
+        int compileToRegister (Compiler& c) const override
+        {
+            auto local = getLocalRegister (c);
+            return local >= 0 ? local : Expression::compileToRegister (c);
+        }
+
+        void compileInto (Compiler& c, int dest) const override
+        {
+            auto local = getLocalRegister (c);
+
+            if (local >= 0)
+                c.emitMove (dest, local);
+            else
+                c.emit (OpCode::getName, *this, dest, c.getNameIndex (name));
+        }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void compileAssignment (Compiler& c, int value) const override
         {
-            if (auto* v = getPropertyPointer (*s.scope, name))
-                *v = newValue;
+            auto local = getLocalRegister (c);
+
+            if (local >= 0)
+                c.emitMove (local, value);
             else
-                s.root->setProperty (name, newValue);
+                c.emit (OpCode::setName, *this, value, c.getNameIndex (name));
         }
 
         Identifier name;
@@ -392,9 +679,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         DotOperator (const CodeLocation& l, ExpPtr& p, const Identifier& c) noexcept : Expression (l), parent (p.release()), child (c) {}
 
-        var getResult (const Scope& s) const override
+        static var getProperty (const var& p, const Identifier& child)
         {
-            auto p = parent->getResult (s);
             static const Identifier lengthID ("length");
 
             if (child == lengthID)
@@ -410,14 +696,22 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return var::undefined();
         }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void compileInto (Compiler& c, int dest) const override
         {
-            if (auto* o = parent->getResult (s).getDynamicObject())
-                o->setProperty (child, newValue);
-            else
-                Expression::assign (s, newValue);
+            Compiler::TemporaryRegisters t (c);
+            auto object = parent->compileToRegister (c);
+            c.emit (OpCode::getProperty, *this, dest, object, c.getNameIndex (child));
+        }
+
+        void compileAssignment (Compiler& c, int value) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            auto object = parent->compileToRegister (c);
+            c.emit (OpCode::setProperty, *this, object, c.getNameIndex (child), value);
         }
 
+        bool canChangeLocalVariables() const override   { return parent->canChangeLocalVariables(); }
+
         ExpPtr parent;
         Identifier child;
     };
@@ -426,11 +720,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArraySubscript (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        static var getElement (const var& arrayVar, const var& key)
         {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
-
             if (const auto* array = arrayVar.getArray())
                 if (key.isInt() || key.isInt64() || key.isDouble())
                     return (*array) [static_cast<int> (key)];
@@ -443,11 +734,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return var::undefined();
         }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void setElement (const var& arrayVar, const var& key, const var& newValue) const
         {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
-
             if (auto* array = arrayVar.getArray())
             {
                 if (key.isInt() || key.isInt64() || key.isDouble())
@@ -470,9 +758,37 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 }
             }
 
-            Expression::assign (s, newValue);
+            location.throwError ("Cannot assign to this expression!");
+        }
+
+        void compileInto (Compiler& c, int dest) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            int objectRegister, keyRegister;
+            compileObjectAndKey (c, objectRegister, keyRegister);
+            c.emit (OpCode::getElement, *this, dest, objectRegister, keyRegister);
+        }
+
+        void compileAssignment (Compiler& c, int value) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            int objectRegister, keyRegister;
+            compileObjectAndKey (c, objectRegister, keyRegister);
+            c.emit (OpCode::setElement, *this, objectRegister, keyRegister, value);
+        }
+
+        void compileObjectAndKey (Compiler& c, int& objectRegister, int& keyRegister) const
+        {
+            objectRegister = object->compileToRegister (c);
+
+            if (c.isLocalRegister (objectRegister) && index->canChangeLocalVariables())
+                objectRegister = c.copyToNewRegister (objectRegister);
+
+            keyRegister = index->compileToRegister (c);
         }
 
+        bool canChangeLocalVariables() const override   { return object->canChangeLocalVariables() || index->canChangeLocalVariables(); }
+
         ExpPtr object, index;
     };
 
@@ -481,14 +797,29 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         BinaryOperatorBase (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
             : Expression (l), lhs (a.release()), rhs (b.release()), operation (op) {}
 
+        void compileOperator (Compiler& c, int dest, OpCode op) const
+        {
+            Compiler::TemporaryRegisters t (c);
+            auto a = lhs->compileToRegister (c);
+
+            // the left-hand value must be kept if the right-hand side can change it
+            if (c.isLocalRegister (a) && rhs->canChangeLocalVariables())
+                a = c.copyToNewRegister (a);
+
+            auto b = rhs->compileToRegister (c);
+            c.emit (op, *this, dest, a, b);
+        }
+
+        bool canChangeLocalVariables() const override   { return lhs->canChangeLocalVariables() || rhs->canChangeLocalVariables(); }
+
         ExpPtr lhs, rhs;
         TokenType operation;
     };
 
     struct BinaryOperator  : public BinaryOperatorBase
     {
-        BinaryOperator (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
-            : BinaryOperatorBase (l, a, b, op) {}
+        BinaryOperator (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op, OpCode code = OpCode::binaryOperator) noexcept
+            : BinaryOperatorBase (l, a, b, op), opCode (code) {}
 
         virtual var getWithUndefinedArg() const                           { return var::undefined(); }
         virtual var getWithDoubles (double, double) const                 { return throwError ("Double"); }
@@ -496,10 +827,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         virtual var getWithArrayOrObject (const var& a, const var&) const { return throwError (a.isArray() ? "Array" : "Object"); }
         virtual var getWithStrings (const String&, const String&) const   { return throwError ("String"); }
 
-        var getResult (const Scope& s) const override
+        var getResult (const var& a, const var& b) const
         {
-            var a (lhs->getResult (s)), b (rhs->getResult (s));
-
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
 
@@ -512,13 +841,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return getWithStrings (a.toString(), b.toString());
         }
 
+        void compileInto (Compiler& c, int dest) const override   { compileOperator (c, dest, opCode); }
+
         var throwError (const char* typeName) const
             { location.throwError (getTokenName (operation) + " is not allowed on the " + typeName + " type"); return {}; }
+
+        // run() has fast paths for some common operators, which must give the same results as getResult()
+        const OpCode opCode;
     };
 
     struct EqualsOp  : public BinaryOperator
     {
-        EqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::equals) {}
+        EqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::equals, OpCode::equals) {}
         var getWithUndefinedArg() const override                               { return true; }
         var getWithDoubles (double a, double b) const override                 { return a == b; }
         var getWithInts (int64 a, int64 b) const override                      { return a == b; }
@@ -528,7 +862,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct NotEqualsOp  : public BinaryOperator
     {
-        NotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::notEquals) {}
+        NotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::notEquals, OpCode::notEquals) {}
         var getWithUndefinedArg() const override                               { return false; }
         var getWithDoubles (double a, double b) const override                 { return a != b; }
         var getWithInts (int64 a, int64 b) const override                      { return a != b; }
@@ -538,7 +872,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct LessThanOp  : public BinaryOperator
     {
-        LessThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThan) {}
+        LessThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThan, OpCode::lessThan) {}
         var getWithDoubles (double a, double b) const override                 { return a < b; }
         var getWithInts (int64 a, int64 b) const override                      { return a < b; }
         var getWithStrings (const String& a, const String& b) const override   { return a < b; }
@@ -546,7 +880,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct LessThanOrEqualOp  : public BinaryOperator
     {
-        LessThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThanOrEqual) {}
+        LessThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::lessThanOrEqual, OpCode::lessThanOrEqual) {}
         var getWithDoubles (double a, double b) const override                 { return a <= b; }
         var getWithInts (int64 a, int64 b) const override                      { return a <= b; }
         var getWithStrings (const String& a, const String& b) const override   { return a <= b; }
@@ -554,7 +888,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct GreaterThanOp  : public BinaryOperator
     {
-        GreaterThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThan) {}
+        GreaterThanOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThan, OpCode::greaterThan) {}
         var getWithDoubles (double a, double b) const override                 { return a > b; }
         var getWithInts (int64 a, int64 b) const override                      { return a > b; }
         var getWithStrings (const String& a, const String& b) const override   { return a > b; }
@@ -562,7 +896,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct GreaterThanOrEqualOp  : public BinaryOperator
     {
-        GreaterThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThanOrEqual) {}
+        GreaterThanOrEqualOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::greaterThanOrEqual, OpCode::greaterThanOrEqual) {}
         var getWithDoubles (double a, double b) const override                 { return a >= b; }
         var getWithInts (int64 a, int64 b) const override                      { return a >= b; }
         var getWithStrings (const String& a, const String& b) const override   { return a >= b; }
@@ -570,7 +904,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct AdditionOp  : public BinaryOperator
     {
-        AdditionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::plus) {}
+        AdditionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::plus, OpCode::add) {}
         var getWithDoubles (double a, double b) const override                 { return a + b; }
         var getWithInts (int64 a, int64 b) const override                      { return a + b; }
         var getWithStrings (const String& a, const String& b) const override   { return a + b; }
@@ -578,14 +912,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
     struct SubtractionOp  : public BinaryOperator
     {
-        SubtractionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::minus) {}
+        SubtractionOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::minus, OpCode::subtract) {}
         var getWithDoubles (double a, double b) const override { return a - b; }
         var getWithInts (int64 a, int64 b) const override      { return a - b; }
     };
 
     struct MultiplyOp  : public BinaryOperator
     {
-        MultiplyOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::times) {}
+        MultiplyOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperator (l, a, b, TokenTypes::times, OpCode::multiply) {}
         var getWithDoubles (double a, double b) const override { return a * b; }
         var getWithInts (int64 a, int64 b) const override      { return a * b; }
     };
@@ -640,49 +974,110 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         var getWithInts (int64 a, int64 b) const override   { return (int) (((uint32) a) >> (int) b); }
     };
 
-    struct LogicalAndOp  : public BinaryOperatorBase
+    struct LogicalOperator  : public BinaryOperatorBase
     {
-        LogicalAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalAnd) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) && rhs->getResult (s); }
+        LogicalOperator (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept : BinaryOperatorBase (l, a, b, op) {}
+
+        void compileInto (Compiler& c, int dest) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            auto value = c.allocateRegister();
+            lhs->compileInto (c, value);
+            auto skipRHS = c.emit (operation == TokenTypes::logicalOr ? OpCode::jumpIfTrue : OpCode::jumpIfFalse, *this, value);
+            rhs->compileInto (c, value);
+            c.setJumpTarget (skipRHS, c.getPosition());
+            c.emit (OpCode::toBool, *this, dest, value);
+        }
     };
 
-    struct LogicalOrOp  : public BinaryOperatorBase
+    struct LogicalAndOp  : public LogicalOperator
     {
-        LogicalOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalOr) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) || rhs->getResult (s); }
+        LogicalAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : LogicalOperator (l, a, b, TokenTypes::logicalAnd) {}
+    };
+
+    struct LogicalOrOp  : public LogicalOperator
+    {
+        LogicalOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : LogicalOperator (l, a, b, TokenTypes::logicalOr) {}
     };
 
     struct TypeEqualsOp  : public BinaryOperatorBase
     {
         TypeEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeEquals) {}
-        var getResult (const Scope& s) const override       { return areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileInto (Compiler& c, int dest) const override   { compileOperator (c, dest, OpCode::typeEquals); }
     };
 
     struct TypeNotEqualsOp  : public BinaryOperatorBase
     {
         TypeNotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeNotEquals) {}
-        var getResult (const Scope& s) const override       { return ! areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileInto (Compiler& c, int dest) const override   { compileOperator (c, dest, OpCode::typeNotEquals); }
     };
 
     struct ConditionalOp  : public Expression
     {
         ConditionalOp (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override              { return (condition->getResult (s) ? trueBranch : falseBranch)->getResult (s); }
-        void assign (const Scope& s, const var& v) const override  { (condition->getResult (s) ? trueBranch : falseBranch)->assign (s, v); }
+        void compileInto (Compiler& c, int dest) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            auto value = c.allocateRegister();
+            auto jumpToFalseBranch = condition->compileConditionalJump (c, false);
+            trueBranch->compileInto (c, value);
+            auto jumpToEnd = c.emit (OpCode::jump, *this);
+            c.setJumpTarget (jumpToFalseBranch, c.getPosition());
+            falseBranch->compileInto (c, value);
+            c.setJumpTarget (jumpToEnd, c.getPosition());
+            c.emitMove (dest, value);
+        }
+
+        void compileAssignment (Compiler& c, int value) const override
+        {
+            auto jumpToFalseBranch = condition->compileConditionalJump (c, false);
+            trueBranch->compileAssignment (c, value);
+            auto jumpToEnd = c.emit (OpCode::jump, *this);
+            c.setJumpTarget (jumpToFalseBranch, c.getPosition());
+            falseBranch->compileAssignment (c, value);
+            c.setJumpTarget (jumpToEnd, c.getPosition());
+        }
+
+        bool canChangeLocalVariables() const override
+        {
+            return condition->canChangeLocalVariables() || trueBranch->canChangeLocalVariables()
+                     || falseBranch->canChangeLocalVariables();
+        }
 
         ExpPtr condition, trueBranch, falseBranch;
     };
 
+    static int compileAssignmentTo (Compiler& c, const Expression& target, const Expression& newValue)
+    {
+        auto local = target.getLocalRegister (c);
+
+        if (local >= 0)
+        {
+            newValue.compileInto (c, local);
+            return local;
+        }
+
+        auto value = newValue.compileToRegister (c);
+
+        // the value must be kept if evaluating the target can change it
+        if (c.isLocalRegister (value) && target.canChangeLocalVariables())
+            value = c.copyToNewRegister (value);
+
+        target.compileAssignment (c, value);
+        return value;
+    }
+
     struct Assignment  : public Expression
     {
         Assignment (const CodeLocation& l, ExpPtr& dest, ExpPtr& source) noexcept : Expression (l), target (dest.release()), newValue (source.release()) {}
 
-        var getResult (const Scope& s) const override
+        int compileToRegister (Compiler& c) const override   { return compileAssignmentTo (c, *target, *newValue); }
+
+        void compileInto (Compiler& c, int dest) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            Compiler::TemporaryRegisters t (c);
+            c.emitMove (dest, compileToRegister (c));
         }
 
         ExpPtr target, newValue;
@@ -693,11 +1088,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         SelfAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept
             : Expression (l), target (dest), newValue (source) {}
 
-        var getResult (const Scope& s) const override
+        int compileToRegister (Compiler& c) const override   { return compileAssignmentTo (c, *target, *newValue); }
+
+        void compileInto (Compiler& c, int dest) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            Compiler::TemporaryRegisters t (c);
+            c.emitMove (dest, compileToRegister (c));
         }
 
         Expression* target; // Careful! this pointer aliases a sub-term of newValue!
@@ -709,54 +1105,83 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         PostAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept : SelfAssignment (l, dest, source) {}
 
-        var getResult (const Scope& s) const override
+        int compileToRegister (Compiler& c) const override
         {
-            auto oldValue = target->getResult (s);
-            target->assign (s, newValue->getResult (s));
+            auto oldValue = c.allocateRegister();
+            target->compileInto (c, oldValue);
+
+            Compiler::TemporaryRegisters t (c);
+            compileAssignmentTo (c, *target, *newValue);
             return oldValue;
         }
+
+        void compile (Compiler& c) const override
+        {
+            // when the old value isn't used, there's no need to read it unless that could have side-effects
+            if (dynamic_cast<const UnqualifiedName*> (target) != nullptr)
+            {
+                Compiler::TemporaryRegisters t (c);
+                compileAssignmentTo (c, *target, *newValue);
+            }
+            else
+            {
+                SelfAssignment::compile (c);
+            }
+        }
     };
 
     struct FunctionCall  : public Expression
     {
         FunctionCall (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        // The function, 'this' and the arguments are put into consecutive registers
+        int compileFunctionAndArguments (Compiler& c, OpCode& callOp) const
         {
+            auto base = c.allocateRegisters (arguments.size() + 2);
+
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
             {
-                auto thisObject = dot->parent->getResult (s);
-                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child), thisObject);
+                dot->parent->compileInto (c, base + 1);
+                c.emit (OpCode::findMethod, *this, base, 0, c.getNameIndex (dot->child));
+                callOp = OpCode::callMethod;
+            }
+            else
+            {
+                object->compileInto (c, base);
+                c.emit (OpCode::loadScopeObject, *this, base + 1);
+                callOp = OpCode::call;
             }
 
-            auto function = object->getResult (s);
-            return invokeFunction (s, function, var (s.scope.get()));
+            compileArguments (c, base);
+            return base;
         }
 
-        var invokeFunction (const Scope& s, const var& function, const var& thisObject) const
+        void compileArguments (Compiler& c, int base) const
         {
-            s.checkTimeOut (location);
-            Array<var> argVars;
-
-            for (auto* a : arguments)
-                argVars.add (a->getResult (s));
-
-            const var::NativeFunctionArgs args (thisObject, argVars.begin(), argVars.size());
-
-            if (var::NativeFunction nativeFunction = function.getNativeFunction())
-                return nativeFunction (args);
+            for (int i = 0; i < arguments.size(); ++i)
+                arguments.getUnchecked (i)->compileInto (c, base + 2 + i);
+        }
 
-            if (auto* fo = dynamic_cast<FunctionObject*> (function.getObject()))
-                return fo->invoke (s, args);
+        void compileInto (Compiler& c, int dest) const override
+        {
+            Compiler::TemporaryRegisters t (c);
+            OpCode callOp;
+            auto base = compileFunctionAndArguments (c, callOp);
+            c.emit (callOp, *this, dest, base, arguments.size());
+        }
 
-            if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
-                if (auto* o = thisObject.getDynamicObject())
-                    if (o->hasMethod (dot->child)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
-                        return o->invokeMethod (dot->child, args);
+        bool canChangeLocalVariables() const override
+        {
+            // a function can't change the caller's local variables, only its arguments can
+            for (auto* a : arguments)
+                if (a->canChangeLocalVariables())
+                    return true;
 
-            location.throwError ("This expression is not a function!"); return {};
+            return object->canChangeLocalVariables();
         }
 
+        const Identifier& getMethodName() const   { return static_cast<const DotOperator&> (*object).child; }
+
         ExpPtr object;
         OwnedArray<Expression> arguments;
     };
@@ -765,22 +1190,17 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         NewOperator (const CodeLocation& l) noexcept : FunctionCall (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileInto (Compiler& c, int dest) const override
         {
-            var classOrFunc = object->getResult (s);
-            const bool isFunc = isFunction (classOrFunc);
-
-            if (! (isFunc || classOrFunc.getDynamicObject() != nullptr))
-                return var::undefined();
+            Compiler::TemporaryRegisters t (c);
+            auto base = c.allocateRegisters (arguments.size() + 2);
+            object->compileInto (c, base);
 
-            DynamicObject::Ptr newObject (new DynamicObject());
-
-            if (isFunc)
-                invokeFunction (s, classOrFunc, newObject.get());
-            else
-                newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
-
-            return newObject.get();
+            auto jumpToEnd = c.emit (OpCode::beginNew, *this, dest, base);
+            compileArguments (c, base);
+            c.emit (OpCode::call, *this, base, base, arguments.size());
+            c.emitMove (dest, base + 1);
+            c.setJumpTarget (jumpToEnd, c.getPosition());
         }
     };
 
@@ -788,14 +1208,20 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ObjectDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileInto (Compiler& c, int dest) const override
         {
-            DynamicObject::Ptr newObject (new DynamicObject());
+            Compiler::TemporaryRegisters t (c);
+            auto newObject = c.allocateRegister();
+            c.emit (OpCode::newObject, *this, newObject);
 
             for (int i = 0; i < names.size(); ++i)
-                newObject->setProperty (names.getUnchecked(i), initialisers.getUnchecked(i)->getResult (s));
+            {
+                Compiler::TemporaryRegisters t2 (c);
+                auto value = initialisers.getUnchecked(i)->compileToRegister (c);
+                c.emit (OpCode::initProperty, *this, newObject, c.getNameIndex (names.getReference(i)), value);
+            }
 
-            return newObject.get();
+            c.emitMove (dest, newObject);
         }
 
         Array<Identifier> names;
@@ -806,17 +1232,15 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArrayDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileInto (Compiler& c, int dest) const override
         {
-            Array<var> a;
+            Compiler::TemporaryRegisters t (c);
+            auto first = c.allocateRegisters (values.size());
 
             for (int i = 0; i < values.size(); ++i)
-                a.add (values.getUnchecked(i)->getResult (s));
+                values.getUnchecked(i)->compileInto (c, first + i);
 
-            // std::move() needed here for older compilers
-            JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wredundant-move")
-            return std::move (a);
-            JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+            c.emit (OpCode::newArray, *this, dest, first, values.size());
         }
 
         OwnedArray<Expression> values;
@@ -840,27 +1264,220 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             out << "function " << functionCode;
         }
 
+        void compile()
+        {
+            // Registers 0 onwards hold 'this', the parameters and then the local variables, which
+            // are all visible from the start of the function. Its remaining registers are temporaries.
+            static const Identifier thisIdent ("this");
+            code.localNames.add (thisIdent);
+
+            for (auto& p : parameters)         code.localNames.addIfNotAlreadyThere (p);
+            for (auto& v : localVariables)     code.localNames.addIfNotAlreadyThere (v);
+            for (auto& p : parameters)         parameterRegisters.add (code.localNames.indexOf (p));
+
+            Compiler c (code, true);
+            body->compile (c);
+            c.emit (OpCode::returnVoid, *body);
+        }
+
         var invoke (const Scope& s, const var::NativeFunctionArgs& args) const
         {
-            DynamicObject::Ptr functionRoot (new DynamicObject());
+            RegisterFile registerFile (code.numRegisters);
+            auto* registers = registerFile.registers;
 
-            static const Identifier thisIdent ("this");
-            functionRoot->setProperty (thisIdent, args.thisObject);
+            registers[0] = args.thisObject;
+
+            for (int i = 1; i < code.localNames.size(); ++i)
+                registers[i] = var::undefined();
 
             for (int i = 0; i < parameters.size(); ++i)
-                functionRoot->setProperty (parameters.getReference(i),
-                                           i < args.numArguments ? args.arguments[i] : var::undefined());
+                if (i < args.numArguments)
+                    registers[parameterRegisters.getUnchecked (i)] = args.arguments[i];
 
-            var result;
-            body->perform (Scope (&s, s.root, functionRoot), &result);
-            return result;
+            return run (Scope (&s, s.root, code, registers));
         }
 
         String functionCode;
-        Array<Identifier> parameters;
+        Array<Identifier> parameters, localVariables;
+        Array<int> parameterRegisters;
         std::unique_ptr<Statement> body;
+        CodeBlock code;
+    };
+
+    //==============================================================================
+    static bool isIntOrInt64 (const var& v) noexcept   { return v.isInt() || v.isInt64(); }
+
+    template <typename IntFunction, typename DoubleFunction>
+    static var applyNumericOperator (const Instruction& i, const var& a, const var& b,
+                                     IntFunction intFunction, DoubleFunction doubleFunction)
+    {
+        if (isIntOrInt64 (a))
+        {
+            if (isIntOrInt64 (b))  return intFunction ((int64) a, (int64) b);
+            if (b.isDouble())      return doubleFunction ((double) a, (double) b);
+        }
+        else if (a.isDouble() && (b.isDouble() || isIntOrInt64 (b)))
+        {
+            return doubleFunction ((double) a, (double) b);
+        }
+
+        return static_cast<const BinaryOperator*> (i.node)->getResult (a, b);
+    }
+
+    // Each nested call uses up some native stack, so if the engine has a depth limit,
+    // runaway recursion is stopped with a script error before the stack itself overflows
+    struct ScopedCallDepth
+    {
+        ScopedCallDepth (RootObject& r, const CodeLocation& location)  : root (r)
+        {
+            if (root.maximumCallDepth > 0 && root.callDepth >= root.maximumCallDepth)
+                location.throwError ("Stack overflow");
+
+            ++root.callDepth;
+        }
+
+        ~ScopedCallDepth()     { --root.callDepth; }
+
+        RootObject& root;
     };
 
+    static var invokeFunction (const Scope& s, const Instruction& i, const var* base, int numArgs)
+    {
+        s.checkTimeOut (i.node->location);
+
+        const var::NativeFunctionArgs args (base[1], base + 2, numArgs);
+        auto& function = base[0];
+
+        if (auto* fo = dynamic_cast<FunctionObject*> (function.getObject()))
+        {
+            const ScopedCallDepth callDepth (s.root, i.node->location);
+            return fo->invoke (s, args);
+        }
+
+        if (function.isMethod())
+            return function.getNativeFunction() (args);
+
+        if (i.op == OpCode::callMethod)
+        {
+            auto& name = static_cast<const FunctionCall*> (i.node)->getMethodName();
+
+            if (auto* o = base[1].getDynamicObject())
+                if (o->hasMethod (name)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
+                    return o->invokeMethod (name, args);
+        }
+
+        i.node->location.throwError ("This expression is not a function!");
+        return {};
+    }
+
+    static var run (const Scope& s)
+    {
+        auto* const instructions = s.code->instructions.begin();
+        auto* const constants = s.code->constants.begin();
+        auto* const names = s.code->names.begin();
+        auto* const r = s.registers;
+
+        for (auto* ip = instructions;;)
+        {
+            auto& i = *ip++;
+
+            switch (i.op)
+            {
+                case OpCode::loadConstant:      r[i.a] = constants[i.b]; break;
+                case OpCode::loadUndefined:     r[i.a] = var::undefined(); break;
+                case OpCode::loadScopeObject:   r[i.a] = s.getScopeObject(); break;
+                case OpCode::move:              r[i.a] = r[i.b]; break;
+
+                case OpCode::getName:
+                {
+                    auto* v = s.findSymbolInParentScopes (names[i.b]);
+                    r[i.a] = v != nullptr ? *v : var::undefined();
+                    break;
+                }
+
+                case OpCode::setName:           s.root.setProperty (names[i.b], r[i.a]); break;
+                case OpCode::declareVariable:   s.scope->setProperty (names[i.b], r[i.a]); break;
+                case OpCode::getProperty:       r[i.a] = DotOperator::getProperty (r[i.b], names[i.c]); break;
+
+                case OpCode::setProperty:
+                {
+                    if (auto* o = r[i.a].getDynamicObject())
+                        o->setProperty (names[i.b], r[i.c]);
+                    else
+                        i.node->location.throwError ("Cannot assign to this expression!");
+
+                    break;
+                }
+
+                case OpCode::getElement:        r[i.a] = ArraySubscript::getElement (r[i.b], r[i.c]); break;
+                case OpCode::setElement:        static_cast<const ArraySubscript*> (i.node)->setElement (r[i.a], r[i.b], r[i.c]); break;
+
+                case OpCode::add:                 r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a + b); },  [] (double a, double b) { return var (a + b); }); break;
+                case OpCode::subtract:            r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a - b); },  [] (double a, double b) { return var (a - b); }); break;
+                case OpCode::multiply:            r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a * b); },  [] (double a, double b) { return var (a * b); }); break;
+                case OpCode::equals:              r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a == b); }, [] (double a, double b) { return var (a == b); }); break;
+                case OpCode::notEquals:           r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a != b); }, [] (double a, double b) { return var (a != b); }); break;
+                case OpCode::lessThan:            r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a < b); },  [] (double a, double b) { return var (a < b); }); break;
+                case OpCode::lessThanOrEqual:     r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a <= b); }, [] (double a, double b) { return var (a <= b); }); break;
+                case OpCode::greaterThan:         r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a > b); },  [] (double a, double b) { return var (a > b); }); break;
+                case OpCode::greaterThanOrEqual:  r[i.a] = applyNumericOperator (i, r[i.b], r[i.c], [] (int64 a, int64 b) { return var (a >= b); }, [] (double a, double b) { return var (a >= b); }); break;
+                case OpCode::binaryOperator:      r[i.a] = static_cast<const BinaryOperator*> (i.node)->getResult (r[i.b], r[i.c]); break;
+                case OpCode::typeEquals:          r[i.a] = areTypeEqual (r[i.b], r[i.c]); break;
+                case OpCode::typeNotEquals:       r[i.a] = ! areTypeEqual (r[i.b], r[i.c]); break;
+                case OpCode::toBool:              r[i.a] = (bool) r[i.b]; break;
+
+                case OpCode::jump:              ip = instructions + i.c; break;
+                case OpCode::jumpIfFalse:       if (! r[i.a]) ip = instructions + i.c; break;
+                case OpCode::jumpIfTrue:        if (r[i.a])   ip = instructions + i.c; break;
+
+                case OpCode::findMethod:        r[i.a] = s.findFunctionCall (i.node->location, r[i.a + 1], names[i.c]); break;
+                case OpCode::call:
+                case OpCode::callMethod:        r[i.a] = invokeFunction (s, i, r + i.b, i.c); break;
+
+                case OpCode::beginNew:
+                {
+                    auto& classOrFunc = r[i.b];
+
+                    if (isFunction (classOrFunc))
+                    {
+                        r[i.b + 1] = new DynamicObject();
+                        break;
+                    }
+
+                    if (classOrFunc.getDynamicObject() != nullptr)
+                    {
+                        DynamicObject::Ptr newObject (new DynamicObject());
+                        newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
+                        r[i.a] = newObject.get();
+                    }
+                    else
+                    {
+                        r[i.a] = var::undefined();
+                    }
+
+                    ip = instructions + i.c;
+                    break;
+                }
+
+                case OpCode::newObject:         r[i.a] = new DynamicObject(); break;
+                case OpCode::initProperty:      r[i.a].getDynamicObject()->setProperty (names[i.b], r[i.c]); break;
+
+                case OpCode::newArray:
+                {
+                    Array<var> a;
+                    a.addArray (r + i.b, i.c);
+                    r[i.a] = std::move (a);
+                    break;
+                }
+
+                case OpCode::checkTimeOut:          s.checkTimeOut (i.node->location); break;
+                case OpCode::throwAssignmentError:  i.node->location.throwError ("Cannot assign to this expression!"); break;
+                case OpCode::returnValue:           return r[i.a];
+                case OpCode::returnVoid:            return {};
+            }
+        }
+    }
+
     //==============================================================================
     struct TokenIterator
     {
@@ -1085,7 +1702,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             match (TokenTypes::closeParen);
+
+            auto* enclosingFunction = currentFunction;
+            currentFunction = &fo;
             fo.body.reset (parseBlock());
+            currentFunction = enclosingFunction;
+
+            fo.compile();
         }
 
         Expression* parseExpression()
@@ -1106,6 +1729,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         }
 
     private:
+        FunctionObject* currentFunction = nullptr;
+
         void throwError (const String& err) const  { location.throwError (err); }
 
         template <typename OpType>
@@ -1178,7 +1803,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         {
             std::unique_ptr<VarStatement> s (new VarStatement (location));
             s->name = parseIdentifier();
-            s->initialiser.reset (matchIf (TokenTypes::assign) ? parseExpression() : new Expression (location));
+
+            if (currentFunction != nullptr)
+                currentFunction->localVariables.addIfNotAlreadyThere (s->name);
+
+            s->hasInitialiser = matchIf (TokenTypes::assign);
+            s->initialiser.reset (s->hasInitialiser ? parseExpression() : new Expression (location));
 
             if (matchIf (TokenTypes::comma))
             {
@@ -1819,7 +2449,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 };
 
 //==============================================================================
-JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new RootObject())
+JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), maximumCallDepth (0), root (new RootObject())
 {
     registerNativeObject (RootObject::ObjectClass  ::getClassName(),  new RootObject::ObjectClass());
     registerNativeObject (RootObject::ArrayClass   ::getClassName(),  new RootObject::ArrayClass());
@@ -1831,8 +2461,13 @@ JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new R
 
 JavascriptEngine::~JavascriptEngine() {}
 
-void JavascriptEngine::prepareTimeout() const noexcept   { root->timeout = Time::getCurrentTime() + maximumExecutionTime; }
-void JavascriptEngine::stop() noexcept                   { root->timeout = {}; }
+void JavascriptEngine::prepareTimeout() const noexcept
+{
+    root->timeout = Time::getCurrentTime() + maximumExecutionTime;
+    root->maximumCallDepth = maximumCallDepth;
+}
+
+void JavascriptEngine::stop() noexcept   { root->timeout = {}; }
 
 void JavascriptEngine::registerNativeObject (const Identifier& name, DynamicObject* object)
 {
@@ -1916,4 +2551,235 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
 
 JUCE_END_IGNORE_WARNINGS_MSVC
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests()
+        : UnitTest ("JavascriptEngine", UnitTestCategories::javascript)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Operators");
+        {
+            expectResult ("var result = [1 + 2, 1.5 + 2, \"a\" + 1, 1 + \"a\", 7 / 2, 7 % 3, 7.5 % 2, -5 % 3, 2 * -3];",
+                          "[3, 3.5, \"a1\", \"1a\", 3.5, 1, 1.5, -2, -6]");
+            expectResult ("var result = [1 << 3, -16 >> 2, -1 >>> 28, 5 & 3, 5 | 3, 5 ^ 3, !0, !1, -(2.5)];",
+                          "[8, -4, 15, 1, 7, 6, true, false, -2.5]");
+            expectResult ("var result = [1 + 2 === 3, 1 == 1.0, 1 === 1.0, 4 === 4, \"a\" === \"a\", 1 !== 1, \"2\" < \"10\", 2 < 10];",
+                          "[true, true, false, true, true, false, false, true]");
+            expectResult ("var a; var result = [a == undefined, a === undefined, null == undefined, undefined + 1, null + 1, true + 1];",
+                          "[true, true, true, 1, \"1\", 2]");
+            expectResult ("var result = [typeof 1, typeof \"s\", typeof [], typeof {}, typeof function() {}, typeof null, typeof nothing];",
+                          "[\"number\", \"string\", \"object\", \"object\", \"function\", \"void\", \"undefined\"]");
+            expectResult ("var result = [true && false, 0 || \"a\", 1 && 2, 3 > 2 ? \"yes\" : \"no\"];",
+                          "[false, false, true, \"yes\"]");
+        }
+
+        beginTest ("Assignments");
+        {
+            expectResult ("var x = 5; var y = x++; var z = ++x; var w = x--; var result = [x, y, z, w];", "[6, 5, 7, 7]");
+            expectResult ("function f() { var x = 5; var y = x++; var z = ++x; var w = x--; x += 10; x -= 1; x *= 2; x /= 4; x %= 5; return [x, y, z, w]; } var result = f();",
+                          "[2.5, 5, 7, 7]");
+            expectResult ("function f() { var x = 1; x <<= 3; var y = 256; y >>= 2; return [x, y]; } var result = f();", "[8, 64]");
+            expectResult ("var x = 1; var y = x + (x = 5); function f() { var a = 1; var b = a + (a = 5); return [a, b]; } var result = [x, y, f()];",
+                          "[5, 6, [5, 6]]");
+            expectResult ("function f() { var a = 2; a = { v: a, w: [a, a + 1] }; return a; } var result = f();", "{\"v\": 2, \"w\": [2, 3]}");
+            expectResult ("function f() { var a = [1, 2, 3]; var i = 0; a[i++] = a[i]; return [a, i]; } var result = f();", "[[1, 2, 3], 1]");
+            expectResult ("var o = { n: 1 }; o.n++; ++o.n; o[\"n\"] += 5; var result = o.n;", "8");
+        }
+
+        beginTest ("Control flow");
+        {
+            expectResult ("var total = 0; for (var i = 0; i < 100; ++i) { if (i % 3 == 0) continue; if (i > 50) break; total += i; } var result = [total, i];",
+                          "[867, 52]");
+            expectResult ("function f() { var s = 0; for (var i = 0; i < 10; i++) { for (var j = 0; j < 10; j++) { if (j == 5) break; s += j; } } return [s, i, j]; } var result = f();",
+                          "[100, 10, 5]");
+            expectResult ("var n = 0; var k = 0; do { ++k; if (k < 5) continue; n += k; } while (k < 3); var result = [n, k];", "[5, 5]");
+            expectResult ("var n = 0; while (n < 10) n += 3; var result = n;", "12");
+            expectResult ("var result = 2; for (;;) { result *= 2; if (result > 100) break; }", "128");
+            expectResult ("function f() { for (var i = 0; i < 10; i++) if (i == 3) return i * 100; return -1; } var result = f();", "300");
+            expectResult ("var result = 5; return 7; result = 9;", "5");
+            expectResult ("function f() { var r = 1; break; r = 2; return r; } var result = typeof f();", "\"void\"");
+        }
+
+        beginTest ("Functions and scopes");
+        {
+            expectResult ("function fact (n) { return n <= 1 ? 1 : n * fact (n - 1); } var result = fact (20);", "2432902008176640000");
+            expectResult ("function f (a, b) { return [a, b, typeof b]; } var result = f (1);", "[1, undefined, \"undefined\"]");
+            expectResult ("function f() {} function g() { return; } var result = [typeof f(), typeof g()];", "[\"void\", \"undefined\"]");
+            expectResult ("function apply (fn, v) { return fn (v); } var result = apply (function (x) { return x + 1; }, 41);", "42");
+            expectResult ("var g = 10; function readG() { return g; } function f() { var g = 20; return readG(); } var result = [f(), readG()];",
+                          "[20, 10]");
+            expectResult ("function f() { undeclared = 7; return undeclared; } var result = [f(), undeclared];", "[7, 7]");
+            expectResult ("function outer() { function inner() { return 5; } return inner(); } var r = outer(); var result = [r, typeof inner];",
+                          "[5, \"function\"]");
+            expectResult ("var x = 1; function f() { var y = x; var x = 2; return y; } var result = f();", "undefined");
+            expectResult ("var x = 1; function f() { x = 2; var x; return x; } var result = [f(), x];", "[2, 1]");
+            expectResult ("function f() { var s = []; for (var i = 0; i < 3; ++i) { var k; if (i == 0) k = 5; s.push (k); } return s; } var result = f();",
+                          "[5, 5, 5]");
+            expectResult ("function f (x) { x = x + 1; return x; } var v = 1; var result = [f (v), v];", "[2, 1]");
+            expectResult ("function f() { return eval (\"40 + 2\"); } var result = f();", "42");
+        }
+
+        beginTest ("Objects and arrays");
+        {
+            expectResult ("var o = { a: 1, b: \"two\", c: [3, 4], \"d\": { e: 5 } }; o.a += 10; o.c[1]++; o.d.e = o.d.e * 2; o.f = o.a; var result = o;",
+                          "{\"a\": 11, \"b\": \"two\", \"c\": [3, 5], \"d\": {\"e\": 10}, \"f\": 11}");
+            expectResult ("var arr = [1, 2, 3]; arr[5] = 9; arr.push (10); var result = [arr, arr.length, arr.indexOf (9)];",
+                          "[[1, 2, 3, undefined, undefined, 9, 10], 7, 5]");
+            expectResult ("function Point (x, y) { this.x = x; this.y = y; } var p = new Point (3, 4); var result = [p.x, p.y];", "[3, 4]");
+            expectResult ("var proto = { greet: function() { return \"hi \" + this.name; } }; var o = new proto(); o.name = \"bob\"; var result = o.greet();",
+                          "\"hi bob\"");
+            expectResult ("var counter = { n: 0, inc: function (k) { this.n += k; return this; } }; counter.inc (2).inc (3); var result = counter.n;", "5");
+            expectResult ("var s = \"hello world\"; var result = [s.length, s.substring (1, 4), s.indexOf (\"wor\"), s.split (\" \")];",
+                          "[11, \"ell\", 6, [\"hello\", \"world\"]]");
+            expectResult ("var result = [Math.abs (-3), Math.min (3, 4), Math.max (3.5, 1), Math.sqrt (16), Math.pow (2, 10)];",
+                          "[3, 3, 3.5, 4.0, 1024.0]");
+        }
+
+        beginTest ("Errors");
+        {
+            expectError ("var result = [1, 2] + 1;", "Line 1, column 24 : '+' is not allowed on the Array type");
+            expectError ("var result = \"a\" - 1;", "Line 1, column 21 : '-' is not allowed on the String type");
+            expectError ("var result = foo();", "Line 1, column 17 : This expression is not a function!");
+            expectError ("var x = 5; x.y = 3;", "Line 1, column 16 : Cannot assign to this expression!");
+            expectError ("var result = 1 +;", "Line 1, column 17 : Found ';' when expecting an expression");
+            expectError ("function f()\n{\n    return nosuch.method();\n}\nf();", "Line 3, column 25 : Unknown function 'method'");
+        }
+
+        beginTest ("Calling functions from C++");
+        {
+            JavascriptEngine engine;
+
+            DynamicObject::Ptr native (new DynamicObject());
+            native->setMethod ("twice", [] (const var::NativeFunctionArgs& a) { return var ((int) a.arguments[0] * 2); });
+            native->setProperty ("value", 7);
+            engine.registerNativeObject ("native", native.get());
+
+            expect (engine.execute ("function add (a, b) { return a + b; }"
+                                    "var obj = { mul: function (a, b) { return a * b; } };"
+                                    "var x = native.twice (21) + native.value;"
+                                    "function useScope() { return k * 100; }").wasOk());
+
+            var args[] = { 3, 4 };
+            Result result (Result::ok());
+            expectEquals ((int) engine.callFunction ("add", var::NativeFunctionArgs ({}, args, 2), &result), 7);
+            expect (result.wasOk());
+            expectEquals ((int) engine.callFunction ("mul", var::NativeFunctionArgs ({}, args, 2), &result), 12);
+            expect (engine.callFunction ("nothing", var::NativeFunctionArgs ({}, args, 2), &result).isUndefined());
+            expectEquals ((int) engine.evaluate ("x"), 49);
+            expectEquals ((int) engine.getRootObjectProperties()["x"], 49);
+
+            DynamicObject::Ptr scope (new DynamicObject());
+            scope->setProperty ("k", 5);
+            expectEquals ((int) engine.callFunctionObject (scope.get(), engine.getRootObjectProperties()["useScope"],
+                                                           var::NativeFunctionArgs ({}, args, 0), &result), 500);
+            expect (result.wasOk());
+        }
+
+        beginTest ("Timeouts");
+        {
+            JavascriptEngine engine;
+            engine.maximumExecutionTime = RelativeTime::milliseconds (20);
+            expectEquals (engine.execute ("while (true) {}").getErrorMessage(), String ("Line 1, column 7 : Execution timed-out"));
+            expect (engine.execute ("function spin() { for (;;) {} } spin();").getErrorMessage().endsWith ("Execution timed-out"));
+
+            engine.maximumExecutionTime = RelativeTime::milliseconds (200);
+            expect (engine.execute ("function depth (n) { return n == 0 ? 0 : 1 + depth (n - 1); }").wasOk());
+            expectEquals ((int) engine.evaluate ("depth (2000)"), 2000);
+
+            engine.maximumCallDepth = 1000;
+            expect (engine.execute ("function recurse() { recurse(); } recurse();").getErrorMessage().endsWith ("Stack overflow"));
+            expectEquals ((int) engine.evaluate ("depth (900)"), 900);
+            expect (engine.evaluate ("depth (1000)").isUndefined());
+            expect (engine.execute ("function ping (n) { return pong (n + 1); } function pong (n) { return ping (n + 1); } ping (0);")
+                          .getErrorMessage().endsWith ("Stack overflow"));
+        }
+
+        beginTest ("Typical scripts");
+        {
+            // These are also useful for measuring the engine's speed
+            struct TypicalScript  { const char* name; const char* code; const char* expectedResult; };
+
+            const TypicalScript scripts[] =
+            {
+                { "recursion",
+                  "function fib (n) { return n < 2 ? n : fib (n - 1) + fib (n - 2); } var result = fib (20);",
+                  "6765" },
+
+                { "integer arithmetic",
+                  "function f() { var t = 0; for (var i = 0; i < 50000; ++i) t += i * 2 - (i % 7); return t; } var result = f();",
+                  "2499800003" },
+
+                { "global variables",
+                  "var t = 0; for (var i = 0; i < 20000; ++i) t += i; var result = t;",
+                  "199990000" },
+
+                { "floating point",
+                  "function f() { var x = 0.0; for (var i = 0; i < 20000; ++i) x = x * 0.5 + Math.abs (i * 0.25); return x; } var result = Math.round (f());",
+                  "9999" },
+
+                { "objects",
+                  "function Vec (x, y) { this.x = x; this.y = y; }"
+                  "function f() { var s = 0; for (var i = 0; i < 10000; ++i) { var v = new Vec (i, i + 1); v.x += v.y; s += v.x; } return s; }"
+                  "var result = f();",
+                  "100000000" },
+
+                { "arrays",
+                  "function f() { var a = []; for (var i = 0; i < 10000; ++i) a.push (i * 3); var s = 0; for (var i = 0; i < a.length; ++i) s += a[i]; return s; }"
+                  "var result = f();",
+                  "149985000" },
+
+                { "strings",
+                  "function f() { var s = \"\"; for (var i = 0; i < 2000; ++i) s = s + \"x\"; var c = 0; for (var i = 0; i < s.length; i += 7) if (s.charAt (i) == \"x\") ++c; return c; }"
+                  "var result = f();",
+                  "286" },
+
+                { "method calls",
+                  "var counter = { n: 0, add: function (k) { this.n += k; return this.n; } };"
+                  "function f() { for (var i = 0; i < 10000; ++i) counter.add (i & 3); return counter.n; } var result = f();",
+                  "15000" },
+
+                { "user interface logic",
+                  "var state = { knobs: [], total: 0 };"
+                  "function clamp (v, lo, hi) { return v < lo ? lo : (v > hi ? hi : v); }"
+                  "function update (i) { var k = state.knobs[i]; k.value = clamp (k.value + k.step, 0, 100); if (k.value == 100 || k.value == 0) k.step = -k.step; state.total += k.value; }"
+                  "for (var i = 0; i < 16; ++i) state.knobs.push ({ value: i * 5, step: 3 });"
+                  "function tick() { for (var j = 0; j < 500; ++j) for (var i = 0; i < 16; ++i) update (i); return state.total; }"
+                  "var result = tick();",
+                  "406735" }
+            };
+
+            for (auto& script : scripts)
+            {
+                auto startTime = Time::getMillisecondCounterHiRes();
+                expectResult (script.code, script.expectedResult);
+                logMessage (String (script.name) + ": " + String (Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+            }
+        }
+    }
+
+    void expectResult (const String& code, const String& expectedResult)
+    {
+        JavascriptEngine engine;
+        auto result = engine.execute (code);
+        expect (result.wasOk(), result.getErrorMessage());
+        expectEquals (JSON::toString (engine.evaluate ("result"), true), expectedResult);
+    }
+
+    void expectError (const String& code, const String& expectedError)
+    {
+        JavascriptEngine engine;
+        expectEquals (engine.execute (code).getErrorMessage(), expectedError);
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
+
 } // namespace juce
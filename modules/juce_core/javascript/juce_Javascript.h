@@ -37,6 +37,10 @@ namespace juce
     Variables that the script sets can be retrieved with evaluate(), and if you need to provide
     native objects for the script to use, you can add them with registerNativeObject().
 
+    Scripts are compiled into a compact register-based bytecode before being run. As in standard
+    javascript, a variable declared with 'var' inside a function is local to the whole function,
+    and a plain function call (rather than a method call) gets the root namespace as its 'this'.
+
     One caveat: Because the values and objects that the engine works with are DynamicObject
     and var objects, they use reference-counting rather than garbage-collection, so if your
     script creates complex connections between objects, you run the risk of creating cyclic
@@ -105,6 +109,15 @@ public:
     */
     RelativeTime maximumExecutionTime;
 
+    /** This limits how deeply script functions may call each other before the script
+        fails with a "Stack overflow" error.
+        Each call uses up some of the native stack, so setting a limit lets a script with
+        runaway recursion fail cleanly instead of overflowing the stack of the thread that
+        runs it. The default of 0 sets no limit, so the depth is only limited by the size
+        of the stack, as it was in earlier versions.
+    */
+    int maximumCallDepth;
+
     /** When called from another thread, causes the interpreter to time-out as soon as possible */
     void stop() noexcept;
 
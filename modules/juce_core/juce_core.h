@@ -253,6 +253,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "memory/juce_WeakReference.h"
 #include "threads/juce_ScopedLock.h"
 #include "threads/juce_CriticalSection.h"
+#include "threads/juce_SpinLock.h"
 #include "maths/juce_Range.h"
 #include "maths/juce_NormalisableRange.h"
 #include "maths/juce_StatisticsAccumulator.h"
@@ -308,6 +309,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONStream.h"
+#include "javascript/juce_JSONDocument.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -319,7 +322,6 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_HighResolutionTimer.h"
 #include "threads/juce_InterProcessLock.h"
 #include "threads/juce_Process.h"
-#include "threads/juce_SpinLock.h"
 #include "threads/juce_WaitableEvent.h"
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
@@ -337,9 +339,11 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_URLInputSource.h"
 #include "time/juce_PerformanceCounter.h"
 #include "unit_tests/juce_UnitTest.h"
+#include "xml/juce_XmlReader.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
+#include "zip/juce_ParallelGZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
 #include "containers/juce_PropertySet.h"
@@ -29,9 +29,10 @@ namespace juce
 
     Comparing two Identifier objects is very fast (an O(1) operation), but creating
     them can be slower than just using a String directly, so the optimal way to use them
-    is to keep some static Identifier objects for the things you use often.
+    is to keep some static Identifier objects for the things you use often. The
+    JUCE_IDENTIFIER macro is a handy way of doing this for a string literal.
 
-    @see NamedValueSet, ValueTree
+    @see NamedValueSet, ValueTree, JUCE_IDENTIFIER
 
     @tags{Core}
 */
@@ -129,4 +130,20 @@ private:
     String name;
 };
 
+//==============================================================================
+/** Returns a const reference to an Identifier for a string literal, which is only
+    created the first time that the expression is evaluated.
+
+    This lets you use identifiers in performance-critical code without the cost of
+    looking up the name in the global StringPool each time, and without having to
+    declare a separate static variable for each one, e.g.
+    @code
+    auto gain = tree.getProperty (JUCE_IDENTIFIER ("gain"));
+    @endcode
+
+    @see Identifier
+*/
+#define JUCE_IDENTIFIER(stringLiteral) \
+    ([]() -> const juce::Identifier& { static const juce::Identifier juceIdentifierLiteral (stringLiteral); return juceIdentifierLiteral; }())
+
 } // namespace juce
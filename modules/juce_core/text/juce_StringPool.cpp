@@ -25,9 +25,10 @@ namespace juce
 
 static const int minNumberOfStringsForGarbageCollection = 300;
 static const uint32 garbageCollectionInterval = 30000;
+static const int minTableSize = 16;
 
 
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
+StringPool::StringPool() noexcept {}
 
 struct StartEndString
 {
@@ -57,44 +58,146 @@ static int compareStrings (const StartEndString& string1, const String& string2)
     return 0;
 }
 
+// The hashes are calculated from the unicode characters rather than the raw bytes, so
+// that the same string will produce the same hash whichever form it's passed in as.
+static uint32 addCharacterToHash (uint32 hash, juce_wchar c) noexcept
+{
+    return (hash ^ (uint32) c) * 16777619u;
+}
+
+static const uint32 initialHash = 2166136261u;
+
+template <typename CharPointerType>
+static uint32 hashString (CharPointerType s) noexcept
+{
+    auto hash = initialHash;
+
+    while (auto c = s.getAndAdvance())
+        hash = addCharacterToHash (hash, c);
+
+    return hash;
+}
+
+static uint32 hashString (const String& s) noexcept
+{
+    return hashString (s.getCharPointer());
+}
+
+static uint32 hashString (const StartEndString& s) noexcept
+{
+    auto hash = initialHash;
+
+    for (auto p = s.start; p < s.end;)
+    {
+        auto c = p.getAndAdvance();
+
+        if (c == 0)
+            break;
+
+        hash = addCharacterToHash (hash, c);
+    }
+
+    return hash;
+}
+
+//==============================================================================
 template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+String StringPool::Shard::addString (const NewStringType& newString, uint32 hash)
 {
-    int start = 0;
-    int end = strings.size();
+    garbageCollectIfNeeded();
 
-    while (start < end)
+    for (;;)
     {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
+        auto mask = (uint32) entries.size() - 1;
+
+        if (entries.size() > 0)
+        {
+            for (auto i = hash & mask;; i = (i + 1) & mask)
+            {
+                auto& entry = entries.getReference ((int) i);
+
+                if (entry.string.isEmpty())
+                {
+                    // Keep the table at most three quarters full, so that the probe sequences stay short
+                    if ((numStrings + 1) * 4 > entries.size() * 3)
+                        break;
+
+                    entry.string = newString;
+                    entry.hash = hash;
+                    ++numStrings;
+                    return entry.string;
+                }
+
+                if (entry.hash == hash && compareStrings (newString, entry.string) == 0)
+                    return entry.string;
+            }
+        }
+
+        resizeTable (jmax (minTableSize, entries.size() * 2));
+    }
+}
+
+void StringPool::Shard::resizeTable (int newNumEntries)
+{
+    jassert (isPowerOfTwo (newNumEntries) || newNumEntries == 0);
 
-        if (startComp == 0)
-            return startString;
+    Array<Entry> oldEntries;
+    oldEntries.swapWith (entries);
+    entries.resize (newNumEntries);
+    numStrings = 0;
 
-        const int halfway = (start + end) / 2;
+    auto mask = (uint32) newNumEntries - 1;
 
-        if (halfway == start)
+    for (auto& oldEntry : oldEntries)
+    {
+        if (oldEntry.string.isNotEmpty())
         {
-            if (startComp > 0)
-                ++start;
+            auto i = oldEntry.hash & mask;
 
-            break;
-        }
+            while (entries.getReference ((int) i).string.isNotEmpty())
+                i = (i + 1) & mask;
 
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
+            entries.getReference ((int) i) = std::move (oldEntry);
+            ++numStrings;
+        }
+    }
+}
 
-        if (halfwayComp == 0)
-            return halfwayString;
+void StringPool::Shard::garbageCollect()
+{
+    int numStillInUse = 0;
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
+    for (auto& entry : entries)
+    {
+        if (entry.string.getReferenceCount() == 1)
+            entry.string = {};
+        else if (entry.string.isNotEmpty())
+            ++numStillInUse;
     }
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    // Removing entries from the middle of a probe sequence would break it, so the
+    // survivors are always moved into a fresh table, which may also be smaller
+    resizeTable (numStillInUse == 0 ? 0 : jmax (minTableSize, nextPowerOfTwo (numStillInUse * 2)));
+    lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+}
+
+void StringPool::Shard::garbageCollectIfNeeded()
+{
+    if (numStrings > minNumberOfStringsForGarbageCollection / numShards
+         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
+        garbageCollect();
+}
+
+//==============================================================================
+template <typename NewStringType>
+String StringPool::addString (const NewStringType& newString, uint32 hash)
+{
+    // The top bits choose the shard, and the bottom bits the position in its table
+    auto& shard = shards[hash >> 27];
+    static_assert (numShards == 32, "The shard index calculation needs updating");
+
+    const SpinLock::ScopedLockType sl (shard.lock);
+    return shard.addString (newString, hash);
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -102,9 +205,8 @@ String StringPool::getPooledString (const char* const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+    CharPointer_UTF8 utf8 (newString);
+    return addString (utf8, hashString (utf8));
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -112,9 +214,8 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    StartEndString s (start, end);
+    return addString (s, hashString (s));
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -122,9 +223,7 @@ String StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    return addString (newString.text, hashString (newString.text));
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -132,27 +231,16 @@ String StringPool::getPooledString (const String& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
-}
-
-void StringPool::garbageCollectIfNeeded()
-{
-    if (strings.size() > minNumberOfStringsForGarbageCollection
-         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
-        garbageCollect();
+    return addString (newString, hashString (newString));
 }
 
 void StringPool::garbageCollect()
 {
-    const ScopedLock sl (lock);
-
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference(i).getReferenceCount() == 1)
-            strings.remove (i);
-
-    lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+    for (auto& shard : shards)
+    {
+        const SpinLock::ScopedLockType sl (shard.lock);
+        shard.garbageCollect();
+    }
 }
 
 StringPool& StringPool::getGlobalPool() noexcept
@@ -161,4 +249,149 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests()
+        : UnitTest ("StringPool", UnitTestCategories::text)
+    {}
+
+    struct PoolingThread  : public Thread
+    {
+        PoolingThread (StringPool& p, const StringArray& s, int seed)
+            : Thread ("StringPool test"), pool (p), strings (s), random (seed)
+        {}
+
+        void run() override
+        {
+            for (int i = 0; i < 20000; ++i)
+            {
+                auto index = random.nextInt (strings.size());
+                auto pooled = pool.getPooledString (strings[index]);
+
+                if (pooled != strings[index])
+                    allStringsMatched = false;
+
+                results.set (index, pooled);
+            }
+        }
+
+        StringPool& pool;
+        const StringArray& strings;
+        Random random;
+        HashMap<int, String> results;
+        bool allStringsMatched = true;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Equal strings share the same text");
+        {
+            StringPool pool;
+            auto s1 = pool.getPooledString ("abc");
+            String source ("xabcx");
+
+            expect (s1 == "abc");
+            expect (s1.getCharPointer() == pool.getPooledString (String ("abc")).getCharPointer());
+            expect (s1.getCharPointer() == pool.getPooledString (StringRef ("abc")).getCharPointer());
+            expect (s1.getCharPointer() == pool.getPooledString (source.getCharPointer() + 1, source.getCharPointer() + 4).getCharPointer());
+            expect (s1.getCharPointer() != pool.getPooledString ("abcd").getCharPointer());
+            expect (s1.getCharPointer() != pool.getPooledString ("ab").getCharPointer());
+
+            expect (pool.getPooledString ("").isEmpty());
+            expect (pool.getPooledString (static_cast<const char*> (nullptr)).isEmpty());
+            expect (pool.getPooledString (source.getCharPointer(), source.getCharPointer()).isEmpty());
+
+            auto nonAscii = CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9");
+            expect (pool.getPooledString (nonAscii.getAddress()).getCharPointer()
+                      == pool.getPooledString (String (nonAscii)).getCharPointer());
+        }
+
+        beginTest ("Many strings");
+        {
+            StringPool pool;
+            Array<String> pooled;
+
+            for (int i = 0; i < 10000; ++i)
+                pooled.add (pool.getPooledString ("item" + String (i)));
+
+            for (int i = 0; i < 10000; ++i)
+            {
+                auto s = pool.getPooledString ("item" + String (i));
+                expect (s == "item" + String (i));
+                expect (s.getCharPointer() == pooled[i].getCharPointer());
+            }
+        }
+
+        beginTest ("Garbage collection");
+        {
+            StringPool pool;
+            auto kept = pool.getPooledString ("kept");
+
+            for (int i = 0; i < 1000; ++i)
+                pool.getPooledString ("temporary" + String (i));
+
+            pool.garbageCollect();
+
+            expect (pool.getPooledString ("kept").getCharPointer() == kept.getCharPointer());
+
+            auto temporary = pool.getPooledString ("temporary0");
+            expect (temporary == "temporary0");
+            expect (temporary.getReferenceCount() == 2);
+
+            for (int i = 0; i < 1000; ++i)
+                expect (pool.getPooledString ("temporary" + String (i)) == "temporary" + String (i));
+
+            expect (pool.getPooledString ("temporary0").getCharPointer() == temporary.getCharPointer());
+        }
+
+        beginTest ("Concurrent pooling");
+        {
+            StringPool pool;
+            StringArray strings;
+
+            for (int i = 0; i < 2000; ++i)
+                strings.add ("name" + String (i));
+
+            OwnedArray<PoolingThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new PoolingThread (pool, strings, i + 1));
+
+            for (auto* t : threads)
+                t->startThread();
+
+            for (auto* t : threads)
+                t->waitForThreadToExit (-1);
+
+            for (auto* t : threads)
+            {
+                expect (t->allStringsMatched);
+
+                for (HashMap<int, String>::Iterator i (t->results); i.next();)
+                    expect (i.getValue().getCharPointer() == pool.getPooledString (strings[i.getKey()]).getCharPointer());
+            }
+        }
+
+        beginTest ("Identifier literals");
+        {
+            auto getIdentifier = []() -> const Identifier& { return JUCE_IDENTIFIER ("stringPoolTestIdentifier"); };
+
+            expect (getIdentifier() == Identifier ("stringPoolTestIdentifier"));
+            expect (&getIdentifier() == &getIdentifier());
+            expect (JUCE_IDENTIFIER ("stringPoolTestIdentifier") == getIdentifier());
+            expect (JUCE_IDENTIFIER ("another") != getIdentifier());
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace juce
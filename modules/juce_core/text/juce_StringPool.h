@@ -34,6 +34,10 @@ namespace juce
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The pool is split into a number of independently-locked shards, each of which is a
+    hash table, so adding or looking up a string takes constant time, and threads that
+    are pooling different strings will rarely have to wait for each other.
+
     @tags{Core}
 */
 class JUCE_API  StringPool
@@ -75,11 +79,32 @@ public:
     static StringPool& getGlobalPool() noexcept;
 
 private:
-    Array<String> strings;
-    CriticalSection lock;
-    uint32 lastGarbageCollectionTime;
-
-    void garbageCollectIfNeeded();
+    //==============================================================================
+    struct Shard
+    {
+        struct Entry
+        {
+            String string;
+            uint32 hash = 0;
+        };
+
+        Array<Entry> entries;
+        int numStrings = 0;
+        uint32 lastGarbageCollectionTime = 0;
+        SpinLock lock;
+
+        template <typename NewStringType>
+        String addString (const NewStringType&, uint32 hash);
+        void resizeTable (int newNumEntries);
+        void garbageCollect();
+        void garbageCollectIfNeeded();
+    };
+
+    enum { numShards = 32 };
+    Shard shards[numShards];
+
+    template <typename NewStringType>
+    String addString (const NewStringType&, uint32 hash);
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
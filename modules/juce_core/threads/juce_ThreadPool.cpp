@@ -23,26 +23,245 @@
 namespace juce
 {
 
+struct ThreadPool::Task
+{
+    std::function<void()> function;
+    Task* next = nullptr;
+};
+
+//==============================================================================
+// A FIFO list of tasks that any thread can add to or take from. These are only used for
+// tasks that can't go onto the queue of the thread that adds them, so the lock is only
+// held for a few instructions, and isn't taken at all when the list is empty.
+struct ThreadPool::TaskQueue
+{
+    TaskQueue() = default;
+
+    ~TaskQueue()
+    {
+        while (auto* task = pop())
+            delete task;
+    }
+
+    void push (Task* task) noexcept
+    {
+        task->next = nullptr;
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (last != nullptr)
+            last->next = task;
+        else
+            first = task;
+
+        last = task;
+        ++numTasks;
+    }
+
+    Task* pop() noexcept
+    {
+        if (isEmpty())
+            return nullptr;
+
+        const SpinLock::ScopedLockType sl (lock);
+        auto* task = first;
+
+        if (task != nullptr)
+        {
+            first = task->next;
+
+            if (first == nullptr)
+                last = nullptr;
+
+            --numTasks;
+        }
+
+        return task;
+    }
+
+    bool isEmpty() const noexcept    { return numTasks.load() == 0; }
+
+    Task* first = nullptr;
+    Task* last = nullptr;
+    std::atomic<int> numTasks { 0 };
+    SpinLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+};
+
+//==============================================================================
+// A lock-free work-stealing deque, as described by Chase and Lev, using the memory
+// orderings from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.)
+// Only the thread that owns it may call push() and pop(), which work on the bottom end,
+// but any thread may call steal(), which takes the oldest task from the top end.
+struct ThreadPool::TaskDeque
+{
+    TaskDeque()
+    {
+        buffer = buffers.add (new Buffer (256));
+    }
+
+    ~TaskDeque()
+    {
+        while (auto* task = pop())
+            delete task;
+    }
+
+    void push (Task* task) noexcept
+    {
+        auto b = bottom.load (std::memory_order_relaxed);
+        auto t = top.load (std::memory_order_acquire);
+        auto* buf = buffer.load (std::memory_order_relaxed);
+
+        if (b - t >= buf->size)
+        {
+            // Stealers may still be reading the old buffer, so it's kept until the deque is deleted
+            auto* newBuffer = buffers.add (new Buffer (buf->size * 2));
+
+            for (auto i = t; i < b; ++i)
+                newBuffer->set (i, buf->get (i));
+
+            buffer.store (newBuffer, std::memory_order_release);
+            buf = newBuffer;
+        }
+
+        buf->set (b, task);
+        bottom.store (b + 1, std::memory_order_release);
+    }
+
+    Task* pop() noexcept
+    {
+        auto b = bottom.load (std::memory_order_relaxed) - 1;
+        auto* buf = buffer.load (std::memory_order_relaxed);
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto* task = buf->get (b);
+
+        if (t == b)
+        {
+            // This is the last task, so we need to race any stealers for it
+            if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+
+            bottom.store (b + 1, std::memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    Task* steal() noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return nullptr;
+
+        auto* task = buffer.load (std::memory_order_acquire)->get (t);
+
+        if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return task;
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return bottom.load (std::memory_order_relaxed) <= top.load (std::memory_order_relaxed);
+    }
+
+    struct Buffer
+    {
+        explicit Buffer (int64 numSlots)  : size (numSlots), slots (new std::atomic<Task*>[(size_t) numSlots]) {}
+
+        Task* get (int64 index) const noexcept         { return slots[(size_t) (index & (size - 1))].load (std::memory_order_relaxed); }
+        void set (int64 index, Task* task) noexcept    { slots[(size_t) (index & (size - 1))].store (task, std::memory_order_relaxed); }
+
+        const int64 size;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    std::atomic<int64> top { 0 }, bottom { 0 };
+    std::atomic<Buffer*> buffer { nullptr };
+    OwnedArray<Buffer> buffers;
+
+    JUCE_DECLARE_NON_COPYABLE (TaskDeque)
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread  : public Thread
 {
-    ThreadPoolThread (ThreadPool& p, size_t stackSize)
-       : Thread ("Pool", stackSize), pool (p)
+    ThreadPoolThread (ThreadPool& p, int threadIndex, size_t stackSize)
+       : Thread ("Pool", stackSize), pool (p), index (threadIndex)
+    {
+    }
+
+    ~ThreadPoolThread() override
     {
+        while (auto* task = spareTasks)
+        {
+            spareTasks = task->next;
+            delete task;
+        }
     }
 
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
+        {
+            if (pool.runNextTask (this) || pool.runNextJob (*this))
+                continue;
+
+            // Anyone adding a task after this point will see that we're sleeping and wake us up,
+            // and anything added before it will be found by hasTasksWaiting()
+            isSleeping = true;
+            ++pool.numSleepingThreads;
+
+            if (! pool.hasTasksWaiting (*this))
                 wait (500);
+
+            isSleeping = false;
+            --pool.numSleepingThreads;
+        }
     }
 
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
     ThreadPool& pool;
+    const int index;
+
+    TaskDeque tasks;
+    TaskQueue tasksForThisThread;
+    std::atomic<bool> isSleeping { false };
+
+    // Finished tasks are kept for reuse, so that adding tasks from inside
+    // other tasks doesn't need to allocate anything
+    Task* spareTasks = nullptr;
+    int numSpareTasks = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
 
+struct ThreadPool::TaskGroup::State
+{
+    void taskFinished()
+    {
+        if (--numUnfinishedTasks == 0)
+            tasksFinished.signal();
+    }
+
+    std::atomic<int> numUnfinishedTasks { 0 };
+    WaitableEvent tasksFinished;
+};
+
 //==============================================================================
 ThreadPoolJob::ThreadPoolJob (const String& name)  : jobName (name)
 {
@@ -91,6 +310,8 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 
 //==============================================================================
 ThreadPool::ThreadPool (int numThreads, size_t threadStackSize)
+    : highPriorityTasks (new TaskQueue()),
+      sharedTasks (new TaskQueue())
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -98,6 +319,8 @@ ThreadPool::ThreadPool (int numThreads, size_t threadStackSize)
 }
 
 ThreadPool::ThreadPool()
+    : highPriorityTasks (new TaskQueue()),
+      sharedTasks (new TaskQueue())
 {
     createThreads (SystemStats::getNumCpus());
 }
@@ -110,8 +333,8 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, threadStackSize));
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, i, threadStackSize));
 
     for (auto* t : threads)
         t->startThread();
@@ -174,6 +397,253 @@ void ThreadPool::addJob (std::function<void()> jobToRun)
     addJob (new LambdaJobWrapper (jobToRun), true);
 }
 
+//==============================================================================
+void ThreadPool::addTask (std::function<void()> task, TaskPriority priority)
+{
+    jassert (task != nullptr);
+
+    auto* currentThread = getCurrentPoolThread();
+    auto* newTask = createTask (currentThread, std::move (task));
+
+    if (priority == TaskPriority::high)
+        highPriorityTasks->push (newTask);
+    else if (currentThread != nullptr)
+        currentThread->tasks.push (newTask);
+    else
+        sharedTasks->push (newTask);
+
+    wakeSleepingThread();
+}
+
+void ThreadPool::addTaskForThread (int threadIndex, std::function<void()> task)
+{
+    jassert (task != nullptr);
+
+    if (auto* thread = threads[threadIndex])
+    {
+        thread->tasksForThisThread.push (createTask (getCurrentPoolThread(), std::move (task)));
+        thread->notify();
+    }
+    else
+    {
+        jassertfalse; // there's no thread with this index!
+    }
+}
+
+void ThreadPool::parallelFor (int startIndex, int endIndex,
+                              const std::function<void (int)>& function,
+                              int minIndexesPerTask)
+{
+    auto numIndexes = endIndex - startIndex;
+
+    // Splitting the range into a few more chunks than there are threads means that the
+    // threads which finish early can pick up some of the work left by slower ones
+    auto chunkSize = jmax (1, minIndexesPerTask, numIndexes / ((getNumThreads() + 1) * 4));
+    auto numChunks = (numIndexes + chunkSize - 1) / chunkSize;
+
+    if (numChunks <= 1)
+    {
+        for (int i = startIndex; i < endIndex; ++i)
+            function (i);
+
+        return;
+    }
+
+    std::atomic<int> nextChunk { 0 };
+
+    auto runChunks = [&]
+    {
+        for (int chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+        {
+            auto chunkStart = startIndex + chunk * chunkSize;
+            auto chunkEnd = jmin (endIndex, chunkStart + chunkSize);
+
+            for (int i = chunkStart; i < chunkEnd; ++i)
+                function (i);
+        }
+    };
+
+    TaskGroup group (*this);
+
+    for (int i = jmin (getNumThreads(), numChunks - 1); --i >= 0;)
+        group.run (runChunks);
+
+    runChunks();
+    group.wait();
+}
+
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread() const
+{
+    if (auto* t = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread()))
+        if (&t->pool == this)
+            return t;
+
+    return nullptr;
+}
+
+ThreadPool::Task* ThreadPool::createTask (ThreadPoolThread* currentThread, std::function<void()>&& function)
+{
+    Task* task;
+
+    if (currentThread != nullptr && currentThread->spareTasks != nullptr)
+    {
+        task = currentThread->spareTasks;
+        currentThread->spareTasks = task->next;
+        --currentThread->numSpareTasks;
+    }
+    else
+    {
+        task = new Task();
+    }
+
+    task->function = std::move (function);
+    return task;
+}
+
+void ThreadPool::recycleTask (ThreadPoolThread* currentThread, Task* task)
+{
+    task->function = nullptr;
+
+    if (currentThread != nullptr && currentThread->numSpareTasks < 256)
+    {
+        task->next = currentThread->spareTasks;
+        currentThread->spareTasks = task;
+        ++currentThread->numSpareTasks;
+    }
+    else
+    {
+        delete task;
+    }
+}
+
+ThreadPool::Task* ThreadPool::findNextTask (ThreadPoolThread* currentThread)
+{
+    if (auto* task = highPriorityTasks->pop())
+        return task;
+
+    if (currentThread != nullptr)
+    {
+        if (auto* task = currentThread->tasksForThisThread.pop())
+            return task;
+
+        if (auto* task = currentThread->tasks.pop())
+            return task;
+    }
+
+    if (auto* task = sharedTasks->pop())
+        return task;
+
+    auto numThreads = threads.size();
+    auto first = currentThread != nullptr ? currentThread->index + 1
+                                          : (int) (nextThreadToStealFrom++ % (uint32) numThreads);
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto* victim = threads.getUnchecked ((first + i) % numThreads);
+
+        if (victim != currentThread)
+            if (auto* task = victim->tasks.steal())
+                return task;
+    }
+
+    return nullptr;
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread* currentThread)
+{
+    if (auto* task = findNextTask (currentThread))
+    {
+        try
+        {
+            task->function();
+        }
+        catch (...)
+        {
+            jassertfalse; // Your task mustn't throw any exceptions!
+        }
+
+        recycleTask (currentThread, task);
+        return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::hasTasksWaiting (ThreadPoolThread& thread) const
+{
+    // This pairs with the fence in wakeSleepingThread(), so that either the thread adding a task
+    // sees that this thread is sleeping, or this thread sees the new task
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    if (! (highPriorityTasks->isEmpty() && sharedTasks->isEmpty() && thread.tasksForThisThread.isEmpty()))
+        return true;
+
+    for (auto* t : threads)
+        if (! t->tasks.isEmpty())
+            return true;
+
+    return false;
+}
+
+void ThreadPool::wakeSleepingThread()
+{
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    if (numSleepingThreads.load() > 0)
+    {
+        for (auto* t : threads)
+        {
+            if (t->isSleeping.exchange (false))
+            {
+                t->notify();
+                break;
+            }
+        }
+    }
+}
+
+//==============================================================================
+ThreadPool::TaskGroup::TaskGroup (ThreadPool& p)
+    : pool (p), state (std::make_shared<State>())
+{
+}
+
+ThreadPool::TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void ThreadPool::TaskGroup::run (std::function<void()> task, TaskPriority priority)
+{
+    ++(state->numUnfinishedTasks);
+
+    // The task holds its own reference to the state, because the group
+    // may be deleted as soon as the counter reaches zero
+    pool.addTask ([s = state, t = std::move (task)]
+                  {
+                      // The task is counted as finished even if it throws, so that wait() can't hang
+                      struct FinishedTask
+                      {
+                          ~FinishedTask()  { state.taskFinished(); }
+                          State& state;
+                      };
+
+                      const FinishedTask finished { *s };
+                      t();
+                  },
+                  priority);
+}
+
+void ThreadPool::TaskGroup::wait()
+{
+    auto* currentThread = pool.getCurrentPoolThread();
+
+    while (state->numUnfinishedTasks.load() > 0)
+        if (! pool.runNextTask (currentThread))
+            state->tasksFinished.wait (10);
+}
+
+//==============================================================================
 int ThreadPool::getNumJobs() const noexcept
 {
     const ScopedLock sl (lock);
@@ -429,4 +899,184 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
         deletionList.add (job);
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests()
+        : UnitTest ("ThreadPool", UnitTestCategories::threads)
+    {}
+
+    static bool waitUntil (std::function<bool()> condition)
+    {
+        for (auto start = Time::getMillisecondCounter(); ! condition();)
+        {
+            if (Time::getMillisecondCounter() > start + 10000)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    static int fibonacci (ThreadPool& pool, int n)
+    {
+        if (n < 12)
+            return n < 2 ? n : fibonacci (pool, n - 1) + fibonacci (pool, n - 2);
+
+        int a = 0, b = 0;
+
+        ThreadPool::TaskGroup group (pool);
+        group.run ([&] { a = fibonacci (pool, n - 1); });
+        b = fibonacci (pool, n - 2);
+        group.wait();
+
+        return a + b;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Jobs");
+        {
+            ThreadPool pool (3);
+            std::atomic<int> count { 0 };
+
+            for (int i = 0; i < 100; ++i)
+                pool.addJob ([&] { ++count; });
+
+            expect (waitUntil ([&] { return count == 100 && pool.getNumJobs() == 0; }));
+        }
+
+        beginTest ("Tasks");
+        {
+            ThreadPool pool (3);
+            std::atomic<int> count { 0 };
+
+            {
+                ThreadPool::TaskGroup group (pool);
+
+                for (int i = 0; i < 10000; ++i)
+                    group.run ([&] { ++count; });
+
+                group.wait();
+                expectEquals (count.load(), 10000);
+
+                for (int i = 0; i < 100; ++i)
+                    group.run ([&] { ++count; });
+            }
+
+            expectEquals (count.load(), 10100);
+
+            for (int i = 0; i < 100; ++i)
+                pool.addTask ([&] { ++count; });
+
+            expect (waitUntil ([&] { return count == 10200; }));
+        }
+
+        beginTest ("Nested tasks");
+        {
+            ThreadPool pool (4);
+            expectEquals (fibonacci (pool, 25), 75025);
+
+            ThreadPool singleThreadPool (1);
+            expectEquals (fibonacci (singleThreadPool, 20), 6765);
+        }
+
+        beginTest ("parallelFor");
+        {
+            ThreadPool pool (3);
+
+            for (auto size : { 0, 1, 2, 7, 1000, 100000 })
+            {
+                for (auto minIndexesPerTask : { 1, 10, 1000000 })
+                {
+                    std::vector<int> values ((size_t) size, 0);
+                    pool.parallelFor (0, size, [&] (int i) { values[(size_t) i] += i * 2; }, minIndexesPerTask);
+
+                    bool allCorrect = true;
+
+                    for (int i = 0; i < size; ++i)
+                        allCorrect = allCorrect && values[(size_t) i] == i * 2;
+
+                    expect (allCorrect);
+                }
+            }
+
+            std::atomic<int> count { 0 };
+
+            pool.parallelFor (10, 30, [&] (int)
+            {
+                pool.parallelFor (0, 50, [&] (int) { ++count; });
+            });
+
+            expectEquals (count.load(), 1000);
+        }
+
+        beginTest ("Task affinity");
+        {
+            ThreadPool pool (4);
+            std::vector<std::vector<Thread::ThreadID>> threadIDs (4);
+            std::atomic<int> count { 0 };
+
+            for (int i = 0; i < 100; ++i)
+            {
+                auto threadIndex = i % 4;
+                pool.addTaskForThread (threadIndex, [&, threadIndex]
+                {
+                    threadIDs[(size_t) threadIndex].push_back (Thread::getCurrentThreadId());
+                    ++count;
+                });
+            }
+
+            expect (waitUntil ([&] { return count == 100; }));
+
+            std::set<Thread::ThreadID> differentThreads;
+
+            for (auto& ids : threadIDs)
+            {
+                expectEquals ((int) ids.size(), 25);
+                expect (std::all_of (ids.begin(), ids.end(), [&] (Thread::ThreadID id) { return id == ids.front(); }));
+                differentThreads.insert (ids.front());
+            }
+
+            expectEquals ((int) differentThreads.size(), 4);
+        }
+
+        beginTest ("Task priorities");
+        {
+            ThreadPool pool (1);
+            WaitableEvent blocked, release;
+            CriticalSection orderLock;
+            String order;
+
+            auto addToOrder = [&] (const char* taskName)
+            {
+                const ScopedLock sl (orderLock);
+                order << taskName;
+            };
+
+            pool.addTask ([&] { blocked.signal(); release.wait (-1); });
+            expect (blocked.wait (10000));
+
+            pool.addJob ([&] { addToOrder ("J"); });
+            pool.addTask ([&] { addToOrder ("A"); });
+            pool.addTask ([&] { addToOrder ("B"); });
+            pool.addTask ([&] { addToOrder ("H"); }, ThreadPool::TaskPriority::high);
+            release.signal();
+
+            expect (waitUntil ([&] { const ScopedLock sl (orderLock); return order.length() == 4; }));
+            expectEquals (order, String ("HABJ"));
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
+
 } // namespace juce
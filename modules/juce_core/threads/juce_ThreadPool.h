@@ -148,6 +148,12 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
+    For large numbers of small pieces of work, the pool can also run lightweight tasks,
+    which are added with addTask(). Each thread keeps its own queue of tasks, and a thread
+    that runs out of work steals tasks from the other threads' queues, so the threads don't
+    need to share a lock to find their next task. The TaskGroup class and parallelFor()
+    method use tasks to split a piece of work between the pool's threads and wait for it.
+
     @see ThreadPoolJob, Thread
 
     @tags{Core}
@@ -230,6 +236,98 @@ public:
     */
     void addJob (std::function<void()> job);
 
+    //==============================================================================
+    /** The priorities that can be given to a task when calling addTask(). */
+    enum class TaskPriority
+    {
+        normal,     /**< The task is queued along with the other tasks, and runs before any ThreadPoolJobs. */
+        high        /**< The task is run before any normal tasks or ThreadPoolJobs that are waiting. */
+    };
+
+    /** Adds a lightweight task to the pool.
+
+        Tasks are much cheaper to add and run than ThreadPoolJobs, so they're a better choice
+        when there's a large number of short pieces of work to do. A task added by one of the
+        pool's own threads goes onto that thread's queue, and will be run by it unless another
+        thread runs out of work and steals it.
+
+        Unlike jobs, tasks can't be removed, interrupted or inspected once they've been added.
+        Any tasks which haven't started when the pool is deleted will be discarded without
+        being run, so if you need to know when some tasks have finished, use a TaskGroup.
+
+        @see addTaskForThread, TaskGroup, parallelFor
+    */
+    void addTask (std::function<void()> task, TaskPriority priority = TaskPriority::normal);
+
+    /** Adds a lightweight task that will be run by a particular one of the pool's threads.
+
+        This is like addTask(), but the task will never be stolen by another thread, which can
+        be useful if the task uses some data that belongs to the thread.
+
+        @param threadIndex  the index of the thread, between 0 and (getNumThreads() - 1)
+        @param task         the function to call
+    */
+    void addTaskForThread (int threadIndex, std::function<void()> task);
+
+    /** Calls a function for every index in a range, splitting the range between the pool's
+        threads and the calling thread, and returns when all the calls have finished.
+
+        The calls are made in chunks of neighbouring indexes, and minIndexesPerTask sets the
+        smallest chunk size - if each call only does a tiny amount of work, a larger value
+        will reduce the overhead.
+
+        This can safely be called from inside one of the pool's tasks or jobs.
+    */
+    void parallelFor (int startIndex, int endIndex,
+                      const std::function<void (int index)>& function,
+                      int minIndexesPerTask = 1);
+
+    //==============================================================================
+    /**
+        A set of tasks that can be waited for together.
+
+        This lets you fork some work into tasks which can run on the pool's threads, and then
+        join them again by calling wait(), e.g.
+        @code
+        ThreadPool::TaskGroup group (pool);
+
+        for (auto& tile : tiles)
+            group.run ([&tile] { tile.render(); });
+
+        group.wait();
+        @endcode
+
+        While it's waiting, the calling thread helps by running any tasks that are queued,
+        so it's safe to use a TaskGroup inside another task. The pool must not be deleted
+        while a TaskGroup is still using it.
+    */
+    class JUCE_API  TaskGroup
+    {
+    public:
+        /** Creates an empty group which will add tasks to the given pool. */
+        explicit TaskGroup (ThreadPool& pool);
+
+        /** Destructor. This waits for any tasks that are still running. */
+        ~TaskGroup();
+
+        /** Adds a task to the pool as part of this group.
+
+            The task mustn't throw any exceptions. If it does, it's still treated as finished,
+            so wait() won't hang.
+        */
+        void run (std::function<void()> task, TaskPriority priority = TaskPriority::normal);
+
+        /** Waits until all the tasks that have been added to this group have finished. */
+        void wait();
+
+    private:
+        struct State;
+        ThreadPool& pool;
+        std::shared_ptr<State> state;
+
+        JUCE_DECLARE_NON_COPYABLE (TaskGroup)
+    };
+
     /** Tries to remove a job from the pool.
 
         If the job isn't yet running, this will simply remove it. If it is running, it
@@ -321,12 +419,26 @@ private:
     Array<ThreadPoolJob*> jobs;
 
     struct ThreadPoolThread;
+    struct Task;
+    struct TaskQueue;
+    struct TaskDeque;
     friend class ThreadPoolJob;
     OwnedArray<ThreadPoolThread> threads;
 
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
+    std::unique_ptr<TaskQueue> highPriorityTasks, sharedTasks;
+    std::atomic<int> numSleepingThreads { 0 };
+    std::atomic<uint32> nextThreadToStealFrom { 0 };
+
+    ThreadPoolThread* getCurrentPoolThread() const;
+    Task* createTask (ThreadPoolThread*, std::function<void()>&&);
+    void recycleTask (ThreadPoolThread*, Task*);
+    Task* findNextTask (ThreadPoolThread*);
+    bool runNextTask (ThreadPoolThread*);
+    bool hasTasksWaiting (ThreadPoolThread&) const;
+    void wakeSleepingThread();
     bool runNextJob (ThreadPoolThread&);
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
@@ -38,6 +38,77 @@ std::unique_ptr<XmlElement> XmlDocument::parse (const String& textToParse)
     return XmlDocument (textToParse).getDocumentElement();
 }
 
+std::unique_ptr<XmlElement> XmlDocument::parse (XmlReader& reader)
+{
+    using TokenType = XmlReader::TokenType;
+
+    for (auto type = reader.getTokenType(); type != TokenType::startElement; type = reader.next())
+        if (type == TokenType::endOfDocument || type == TokenType::error)
+            return {};
+
+    std::unique_ptr<XmlElement> root;
+    Array<LinkedListPointer<XmlElement>*> openChildLists;
+
+    for (;;)
+    {
+        switch (reader.getTokenType())
+        {
+            case TokenType::startElement:
+            {
+                auto name = reader.getElementName();
+                auto* element = new XmlElement (name.text, name.text.findTerminatingNull());
+                LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+                for (int i = 0; i < reader.getNumAttributes(); ++i)
+                {
+                    auto attName = reader.getAttributeName (i);
+                    auto* att = new XmlElement::XmlAttributeNode (attName.text, attName.text.findTerminatingNull());
+                    att->value = String (reader.getAttributeValue (i).text);
+                    attributeAppender.append (att);
+                }
+
+                if (root == nullptr)
+                {
+                    root.reset (element);
+                }
+                else
+                {
+                    auto*& childList = openChildLists.getReference (openChildLists.size() - 1);
+                    *childList = element;
+                    childList = &(element->nextListItem);
+                }
+
+                openChildLists.add (&(element->firstChildElement));
+                break;
+            }
+
+            case TokenType::text:
+            {
+                auto* textElement = XmlElement::createTextElement (String (reader.getText().text));
+                auto*& childList = openChildLists.getReference (openChildLists.size() - 1);
+                *childList = textElement;
+                childList = &(textElement->nextListItem);
+                break;
+            }
+
+            case TokenType::endElement:
+                openChildLists.removeLast();
+
+                if (openChildLists.isEmpty())
+                    return root;
+
+                break;
+
+            case TokenType::none:
+            case TokenType::endOfDocument:
+            case TokenType::error:
+                return {};
+        }
+
+        reader.next();
+    }
+}
+
 std::unique_ptr<XmlElement> parseXML (const String& textToParse)
 {
     return XmlDocument (textToParse).getDocumentElement();
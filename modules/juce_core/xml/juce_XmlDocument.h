@@ -144,6 +144,20 @@ public:
     */
     static std::unique_ptr<XmlElement> parse (const String& xmlData);
 
+    /** Reads an element and all of its sub-elements from an XmlReader.
+
+        If the reader is positioned on a start tag, that element is read, otherwise
+        the reader is first advanced to the next start tag. When this returns, the
+        reader is left on the element's end tag, so you can carry on reading whatever
+        follows it. This lets you pick out individual elements from a huge document
+        without ever having the whole thing in memory.
+
+        @returns    a new XmlElement, or nullptr if there was an error (see
+                    XmlReader::getLastError()) or no more elements were found.
+        @see XmlReader
+    */
+    static std::unique_ptr<XmlElement> parse (XmlReader& reader);
+
 
     //==============================================================================
 private:
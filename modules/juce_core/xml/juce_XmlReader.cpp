@@ -0,0 +1,944 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlReaderHelpers
+{
+    static constexpr int bufferSize = 16384;
+
+    static bool isNameByte (uint8 c) noexcept
+    {
+        return c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c);
+    }
+
+    static bool entityNameMatches (const char* text, int length, const char* entityName) noexcept
+    {
+        for (int i = 0; i < length; ++i)
+            if (entityName[i] == 0 || CharacterFunctions::toLowerCase ((juce_wchar) (uint8) text[i]) != (juce_wchar) entityName[i])
+                return false;
+
+        return entityName[length] == 0;
+    }
+
+    static juce_wchar parseCharacterReference (const char* text, int length) noexcept
+    {
+        int64 charCode = 0;
+
+        if (length > 1 && (text[0] == 'x' || text[0] == 'X'))
+        {
+            if (length > 9)
+                return 0;
+
+            for (int i = 1; i < length; ++i)
+            {
+                auto hexValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) text[i]);
+
+                if (hexValue < 0)
+                    return 0;
+
+                charCode = (charCode << 4) | hexValue;
+            }
+        }
+        else
+        {
+            if (length == 0 || length > 12)
+                return 0;
+
+            for (int i = 0; i < length; ++i)
+            {
+                if (text[i] < '0' || text[i] > '9')
+                    return 0;
+
+                charCode = charCode * 10 + (text[i] - '0');
+            }
+        }
+
+        // Reject anything that can't be encoded as UTF-8
+        if (charCode > 0x10ffff || (charCode >= 0xd800 && charCode <= 0xdfff))
+            return 0;
+
+        return (juce_wchar) charCode;
+    }
+}
+
+//==============================================================================
+XmlReader::XmlReader (InputStream& sourceStream)  : source (sourceStream)
+{
+    buffer.malloc (XmlReaderHelpers::bufferSize);
+}
+
+XmlReader::~XmlReader() {}
+
+//==============================================================================
+bool XmlReader::ensureAvailable (int numBytes)
+{
+    return bufferEnd - bufferStart >= numBytes || refillBuffer (numBytes);
+}
+
+bool XmlReader::refillBuffer (int numBytes)
+{
+    jassert (numBytes <= XmlReaderHelpers::bufferSize);
+
+    if (bufferStart > 0)
+    {
+        auto numLeft = bufferEnd - bufferStart;
+        memmove (buffer, buffer + bufferStart, (size_t) numLeft);
+        bufferStart = 0;
+        bufferEnd = numLeft;
+    }
+
+    while (bufferEnd < numBytes && ! sourceExhausted)
+    {
+        auto numRead = source.read (buffer + bufferEnd, XmlReaderHelpers::bufferSize - bufferEnd);
+
+        if (numRead <= 0)
+            sourceExhausted = true;
+        else
+            bufferEnd += numRead;
+    }
+
+    return bufferEnd >= numBytes;
+}
+
+int XmlReader::peek (int offset)
+{
+    return ensureAvailable (offset + 1) ? (int) (uint8) buffer[bufferStart + offset] : -1;
+}
+
+bool XmlReader::matches (const char* text, int length)
+{
+    return ensureAvailable (length) && memcmp (buffer + bufferStart, text, (size_t) length) == 0;
+}
+
+void XmlReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (bufferStart < bufferEnd && CharacterFunctions::isWhitespace (buffer[bufferStart]))
+            ++bufferStart;
+
+        if (bufferStart < bufferEnd || ! refillBuffer (1))
+            return;
+    }
+}
+
+bool XmlReader::skipPast (const char* terminator, int length)
+{
+    for (;;)
+    {
+        for (auto limit = bufferEnd - length; bufferStart <= limit; ++bufferStart)
+        {
+            if (buffer[bufferStart] == terminator[0]
+                 && memcmp (buffer + bufferStart, terminator, (size_t) length) == 0)
+            {
+                bufferStart += length;
+                return true;
+            }
+        }
+
+        if (! refillBuffer (bufferEnd - bufferStart + 1))
+            return false;
+    }
+}
+
+bool XmlReader::skipDTD()
+{
+    bufferStart += 9;
+
+    for (int depth = 1; depth > 0;)
+    {
+        auto c = peek (0);
+
+        if (c < 0)
+            return false;
+
+        ++bufferStart;
+
+        if (c == '<')
+            ++depth;
+        else if (c == '>')
+            --depth;
+    }
+
+    return true;
+}
+
+//==============================================================================
+XmlReader::TokenType XmlReader::next()
+{
+    if (tokenType == TokenType::endOfDocument || tokenType == TokenType::error)
+        return tokenType;
+
+    attributes.clearQuick();
+    cdata = false;
+
+    if (tokenType == TokenType::endElement)
+    {
+        openElementNames.setPosition (openElements.getLast());
+        openElements.removeLast();
+
+        if (openElements.isEmpty())
+            return tokenType = TokenType::endOfDocument;
+    }
+
+    if (pendingEmptyElementEnd)
+    {
+        pendingEmptyElementEnd = false;
+        return tokenType = TokenType::endElement;
+    }
+
+    emptyElement = false;
+    tokenData.reset();
+
+    if (openElements.isEmpty())
+    {
+        if (! hasStarted)
+        {
+            hasStarted = true;
+
+            if (matches ("\xef\xbb\xbf", 3))
+                bufferStart += 3;
+            else if (matches ("\xfe\xff", 2) || matches ("\xff\xfe", 2))
+                return setError ("UTF-16 input isn't supported");
+        }
+
+        for (;;)
+        {
+            skipWhitespace();
+
+            if (matches ("<?", 2))
+            {
+                bufferStart += 2;
+
+                if (! skipPast ("?>", 2))
+                    return setError ("malformed header");
+            }
+            else if (matches ("<!--", 4))
+            {
+                bufferStart += 4;
+
+                if (! skipPast ("-->", 3))
+                    return setError ("unterminated comment");
+            }
+            else if (matches ("<!DOCTYPE", 9))
+            {
+                if (! skipDTD())
+                    return setError ("malformed DTD");
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        auto c = peek (0);
+
+        if (c < 0)
+            return setError ("not enough input");
+
+        if (c != '<')
+            return setError ("expected an element");
+
+        return readStartTag() ? (tokenType = TokenType::startElement) : tokenType;
+    }
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (c < 0)
+            return setError ("unmatched tags");
+
+        if (c == '<')
+        {
+            auto c1 = peek (1);
+
+            if (c1 == '/')
+                return readEndTag() ? (tokenType = TokenType::endElement) : tokenType;
+
+            if (c1 == '!' && matches ("<![CDATA[", 9))
+                return readCDATA() ? (tokenType = TokenType::text) : tokenType;
+
+            if (c1 == '!' && matches ("<!--", 4))
+            {
+                bufferStart += 4;
+
+                if (! skipPast ("-->", 3))
+                    return setError ("unterminated comment");
+
+                continue;
+            }
+
+            if (c1 == '?')
+            {
+                bufferStart += 2;
+
+                if (! skipPast ("?>", 2))
+                    return setError ("unterminated processing instruction");
+
+                continue;
+            }
+
+            return readStartTag() ? (tokenType = TokenType::startElement) : tokenType;
+        }
+
+        if (readText())
+            return tokenType = TokenType::text;
+
+        if (tokenType == TokenType::error)
+            return tokenType;
+    }
+}
+
+bool XmlReader::skipElement()
+{
+    if (tokenType != TokenType::startElement)
+        return tokenType != TokenType::error;
+
+    auto depth = getDepth();
+
+    for (;;)
+    {
+        auto type = next();
+
+        if (type == TokenType::endElement && getDepth() == depth)
+            return true;
+
+        if (type == TokenType::error || type == TokenType::endOfDocument)
+            return false;
+    }
+}
+
+XmlReader::TokenType XmlReader::setError (const String& message)
+{
+    lastError = message;
+    return tokenType = TokenType::error;
+}
+
+//==============================================================================
+bool XmlReader::readName (MemoryOutputStream& dest)
+{
+    bool foundAny = false;
+
+    for (;;)
+    {
+        auto start = bufferStart;
+
+        while (bufferStart < bufferEnd && XmlReaderHelpers::isNameByte ((uint8) buffer[bufferStart]))
+            ++bufferStart;
+
+        if (bufferStart > start)
+        {
+            dest.write (buffer + start, (size_t) (bufferStart - start));
+            foundAny = true;
+        }
+
+        if (bufferStart < bufferEnd || ! refillBuffer (1))
+            return foundAny;
+    }
+}
+
+bool XmlReader::readStartTag()
+{
+    ++bufferStart;
+    auto nameOffset = (int) openElementNames.getPosition();
+
+    if (! readName (openElementNames))
+    {
+        // no tag name - but allow for a gap after the '<' before giving an error
+        skipWhitespace();
+
+        if (! readName (openElementNames))
+        {
+            setError ("tag name missing");
+            return false;
+        }
+    }
+
+    openElementNames.writeByte (0);
+    openElements.add (nameOffset);
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = peek (0);
+
+        if (c == '>')
+        {
+            ++bufferStart;
+            return true;
+        }
+
+        if (c == '/' && peek (1) == '>')
+        {
+            bufferStart += 2;
+            emptyElement = pendingEmptyElementEnd = true;
+            return true;
+        }
+
+        if (c >= 0 && XmlReaderHelpers::isNameByte ((uint8) c))
+        {
+            Attribute att;
+            att.nameOffset = (int) tokenData.getPosition();
+            readName (tokenData);
+            tokenData.writeByte (0);
+            skipWhitespace();
+
+            if (peek (0) != '=')
+            {
+                setError ("expected '=' after attribute '" + String (getTokenString (att.nameOffset)) + "'");
+                return false;
+            }
+
+            ++bufferStart;
+            skipWhitespace();
+            auto quote = peek (0);
+
+            if (quote != '"' && quote != '\'')
+            {
+                setError ("expected a quoted value for attribute '" + String (getTokenString (att.nameOffset)) + "'");
+                return false;
+            }
+
+            ++bufferStart;
+            att.valueOffset = (int) tokenData.getPosition();
+
+            if (! readAttributeValue ((char) quote))
+                return false;
+
+            tokenData.writeByte (0);
+            attributes.add (att);
+            continue;
+        }
+
+        if (c < 0)
+            setError ("unmatched tags");
+        else
+            setError ("illegal character found in " + String (getTokenString (openElementNames, nameOffset)) + ": '" + String::charToString ((juce_wchar) c) + "'");
+
+        return false;
+    }
+}
+
+bool XmlReader::readEndTag()
+{
+    bufferStart += 2;
+
+    if (skipPast (">", 1))
+        return true;
+
+    setError ("unmatched tags");
+    return false;
+}
+
+bool XmlReader::readAttributeValue (char quote)
+{
+    for (;;)
+    {
+        auto start = bufferStart;
+
+        while (bufferStart < bufferEnd && buffer[bufferStart] != quote && buffer[bufferStart] != '&')
+            ++bufferStart;
+
+        if (bufferStart > start)
+            tokenData.write (buffer + start, (size_t) (bufferStart - start));
+
+        if (bufferStart < bufferEnd)
+        {
+            if (buffer[bufferStart] == quote)
+            {
+                ++bufferStart;
+                return true;
+            }
+
+            readEntity();
+        }
+        else if (! refillBuffer (1))
+        {
+            setError ("unmatched quotes");
+            return false;
+        }
+    }
+}
+
+bool XmlReader::readText()
+{
+    tokenData.reset();
+    bool hasContent = ! ignoreEmptyText;
+
+    for (;;)
+    {
+        auto start = bufferStart;
+
+        while (bufferStart < bufferEnd)
+        {
+            auto c = buffer[bufferStart];
+
+            if (c == '<' || c == '&' || c == '\r')
+                break;
+
+            hasContent = hasContent || ! CharacterFunctions::isWhitespace (c);
+            ++bufferStart;
+        }
+
+        if (bufferStart > start)
+            tokenData.write (buffer + start, (size_t) (bufferStart - start));
+
+        if (bufferStart == bufferEnd)
+        {
+            if (! refillBuffer (1))
+            {
+                setError ("unmatched tags");
+                return false;
+            }
+
+            continue;
+        }
+
+        auto c = buffer[bufferStart];
+
+        if (c == '\r')
+        {
+            tokenData.writeByte ('\n');
+            ++bufferStart;
+
+            if (peek (0) == '\n')
+                ++bufferStart;
+        }
+        else if (c == '&')
+        {
+            hasContent = ! CharacterFunctions::isWhitespace (readEntity()) || hasContent;
+        }
+        else if (matches ("<!--", 4))
+        {
+            bufferStart += 4;
+
+            if (! skipPast ("-->", 3))
+            {
+                setError ("unterminated comment");
+                return false;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    tokenData.writeByte (0);
+    return hasContent;
+}
+
+bool XmlReader::readCDATA()
+{
+    bufferStart += 9;
+
+    for (;;)
+    {
+        auto start = bufferStart;
+        auto limit = bufferEnd - 2;
+
+        while (bufferStart < limit
+                && ! (buffer[bufferStart] == ']' && buffer[bufferStart + 1] == ']' && buffer[bufferStart + 2] == '>'))
+            ++bufferStart;
+
+        if (bufferStart > start)
+            tokenData.write (buffer + start, (size_t) (bufferStart - start));
+
+        if (bufferStart < limit)
+        {
+            bufferStart += 3;
+            tokenData.writeByte (0);
+            cdata = true;
+            return true;
+        }
+
+        if (! refillBuffer (bufferEnd - bufferStart + 1))
+        {
+            setError ("unterminated CDATA section");
+            return false;
+        }
+    }
+}
+
+juce_wchar XmlReader::readEntity()
+{
+    // Make sure that any reasonable entity is entirely inside the buffer before decoding it
+    ensureAvailable (16);
+
+    auto* text = buffer + bufferStart + 1;
+    auto maxLength = jmin (bufferEnd - bufferStart - 1, 14);
+    int length = 0;
+
+    while (length < maxLength && text[length] != ';')
+        ++length;
+
+    if (length < maxLength)
+    {
+        juce_wchar decoded = 0;
+
+        if      (XmlReaderHelpers::entityNameMatches (text, length, "amp"))   decoded = '&';
+        else if (XmlReaderHelpers::entityNameMatches (text, length, "quot"))  decoded = '"';
+        else if (XmlReaderHelpers::entityNameMatches (text, length, "apos"))  decoded = '\'';
+        else if (XmlReaderHelpers::entityNameMatches (text, length, "lt"))    decoded = '<';
+        else if (XmlReaderHelpers::entityNameMatches (text, length, "gt"))    decoded = '>';
+        else if (length > 1 && text[0] == '#')  decoded = XmlReaderHelpers::parseCharacterReference (text + 1, length - 1);
+
+        if (decoded != 0)
+        {
+            tokenData.appendUTF8Char (decoded);
+            bufferStart += length + 2;
+            return decoded;
+        }
+    }
+
+    // Not something we can decode, so leave the ampersand in the text
+    tokenData.writeByte ('&');
+    ++bufferStart;
+    return '&';
+}
+
+//==============================================================================
+const char* XmlReader::getTokenString (const MemoryOutputStream& data, int offset) noexcept
+{
+    return static_cast<const char*> (data.getData()) + offset;
+}
+
+const char* XmlReader::getTokenString (int offset) const noexcept
+{
+    return getTokenString (tokenData, offset);
+}
+
+StringRef XmlReader::getElementName() const noexcept
+{
+    if (openElements.isEmpty() || (tokenType != TokenType::startElement && tokenType != TokenType::endElement))
+        return {};
+
+    return String::CharPointerType (getTokenString (openElementNames, openElements.getLast()));
+}
+
+StringRef XmlReader::getAttributeName (int attributeIndex) const noexcept
+{
+    if (isPositiveAndBelow (attributeIndex, attributes.size()))
+        return String::CharPointerType (getTokenString (attributes.getReference (attributeIndex).nameOffset));
+
+    return {};
+}
+
+StringRef XmlReader::getAttributeValue (int attributeIndex) const noexcept
+{
+    if (isPositiveAndBelow (attributeIndex, attributes.size()))
+        return String::CharPointerType (getTokenString (attributes.getReference (attributeIndex).valueOffset));
+
+    return {};
+}
+
+StringRef XmlReader::getAttributeValue (StringRef attributeName) const noexcept
+{
+    for (auto& att : attributes)
+        if (attributeName == StringRef (String::CharPointerType (getTokenString (att.nameOffset))))
+            return String::CharPointerType (getTokenString (att.valueOffset));
+
+    return {};
+}
+
+bool XmlReader::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (auto& att : attributes)
+        if (attributeName == StringRef (String::CharPointerType (getTokenString (att.nameOffset))))
+            return true;
+
+    return false;
+}
+
+StringRef XmlReader::getText() const noexcept
+{
+    if (tokenType == TokenType::text)
+        return String::CharPointerType (getTokenString (0));
+
+    return {};
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlReaderTests  : public UnitTest
+{
+public:
+    XmlReaderTests()
+        : UnitTest ("XmlReader", UnitTestCategories::xml)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Tokens");
+        {
+            MemoryInputStream in (toData ("\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                          "<!DOCTYPE foo [ <!ELEMENT foo ANY> ]>\n"
+                                          "<!-- comment -->\n"
+                                          "<foo a=\"1 &amp; 2\" b='&lt;&#65;&#x42;&gt;' empty=\"\">\n"
+                                          "  <bar/>\n"
+                                          "  some <!-- hidden --> text&quot;&unknown;\r\n"
+                                          "  <![CDATA[ <raw> & ]]>\n"
+                                          "  <?instruction?>\n"
+                                          "  <baz x = \"y\" ></baz>\n"
+                                          "</foo>\n"
+                                          "trailing garbage"));
+
+            XmlReader reader (in);
+
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.getElementName() == StringRef ("foo"));
+            expectEquals (reader.getDepth(), 1);
+            expectEquals (reader.getNumAttributes(), 3);
+            expectEquals (String (reader.getAttributeName (0)), String ("a"));
+            expectEquals (String (reader.getAttributeValue (0)), String ("1 & 2"));
+            expectEquals (String (reader.getAttributeValue ("b")), String ("<AB>"));
+            expect (reader.hasAttribute ("empty"));
+            expect (reader.getAttributeValue ("empty").isEmpty());
+            expect (! reader.hasAttribute ("c"));
+
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.getElementName() == StringRef ("bar"));
+            expect (reader.isEmptyElement());
+            expectEquals (reader.getDepth(), 2);
+            expect (reader.next() == XmlReader::TokenType::endElement);
+            expect (reader.getElementName() == StringRef ("bar"));
+            expectEquals (reader.getDepth(), 2);
+
+            expect (reader.next() == XmlReader::TokenType::text);
+            expectEquals (String (reader.getText()), String ("\n  some  text\"&unknown;\n  "));
+            expect (! reader.isCDATA());
+
+            expect (reader.next() == XmlReader::TokenType::text);
+            expectEquals (String (reader.getText()), String (" <raw> & "));
+            expect (reader.isCDATA());
+
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.getElementName() == StringRef ("baz"));
+            expect (! reader.isEmptyElement());
+            expectEquals (String (reader.getAttributeValue ("x")), String ("y"));
+            expect (reader.next() == XmlReader::TokenType::endElement);
+            expect (reader.getElementName() == StringRef ("baz"));
+
+            expect (reader.next() == XmlReader::TokenType::endElement);
+            expect (reader.getElementName() == StringRef ("foo"));
+            expectEquals (reader.getDepth(), 1);
+
+            expect (reader.next() == XmlReader::TokenType::endOfDocument);
+            expect (reader.next() == XmlReader::TokenType::endOfDocument);
+            expect (reader.getLastError().isEmpty());
+        }
+
+        beginTest ("Empty text");
+        {
+            const String text ("<a> <b>x</b> </a>");
+
+            {
+                MemoryInputStream in (toData (text));
+                XmlReader reader (in);
+                expect (reader.next() == XmlReader::TokenType::startElement);
+                expect (reader.next() == XmlReader::TokenType::startElement);
+                expect (reader.next() == XmlReader::TokenType::text);
+                expect (reader.next() == XmlReader::TokenType::endElement);
+                expect (reader.next() == XmlReader::TokenType::endElement);
+            }
+
+            {
+                MemoryInputStream in (toData (text));
+                XmlReader reader (in);
+                reader.setEmptyTextIgnored (false);
+                expect (reader.next() == XmlReader::TokenType::startElement);
+                expect (reader.next() == XmlReader::TokenType::text);
+                expectEquals (String (reader.getText()), String (" "));
+            }
+        }
+
+        beginTest ("Skipping elements");
+        {
+            MemoryInputStream in (toData ("<a><b><c>1</c><c/></b><d/></a>"));
+            XmlReader reader (in);
+
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.skipElement());
+            expect (reader.getElementName() == StringRef ("b"));
+            expect (reader.next() == XmlReader::TokenType::startElement);
+            expect (reader.getElementName() == StringRef ("d"));
+        }
+
+        beginTest ("Errors");
+        {
+            expectError ("", "not enough input");
+            expectError ("hello", "expected an element");
+            expectError ("<a><b></b>", "unmatched tags");
+            expectError ("<a b=\"c></a>", "unmatched quotes");
+            expectError ("<a b></a>", "expected '=' after attribute 'b'");
+            expectError ("<a b=c></a>", "expected a quoted value for attribute 'b'");
+            expectError ("<a><![CDATA[xyz</a>", "unterminated CDATA section");
+            expectError ("<a><!-- xyz</a>", "unterminated comment");
+            expectError ("<a>< ></a>", "tag name missing");
+            expectError ("<a x=\"1\" ?></a>", "illegal character found in a: '?'");
+        }
+
+        beginTest ("Building elements");
+        {
+            MemoryInputStream in (toData ("<list><item n=\"1\"/><skip><item n=\"x\"/></skip><item n=\"2\">text<sub/></item></list>"));
+            XmlReader reader (in);
+            StringArray found;
+
+            while (reader.next() == XmlReader::TokenType::startElement
+                    || reader.getTokenType() == XmlReader::TokenType::endElement)
+            {
+                if (reader.getTokenType() != XmlReader::TokenType::startElement)
+                    continue;
+
+                if (reader.getElementName() == StringRef ("skip"))
+                    expect (reader.skipElement());
+                else if (reader.getElementName() == StringRef ("item"))
+                    if (auto item = XmlDocument::parse (reader))
+                        found.add (item->toString (XmlElement::TextFormat().singleLine().withoutHeader()));
+            }
+
+            expect (reader.getTokenType() == XmlReader::TokenType::endOfDocument);
+            expectEquals (found.joinIntoString ("|"), String ("<item n=\"1\"/>|<item n=\"2\">text<sub/></item>"));
+        }
+
+        beginTest ("Random documents");
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                XmlElement original ("root");
+                createRandomChildren (r, original, 4);
+
+                auto text = original.toString();
+                auto fromDocument = parseXML (text);
+                expect (fromDocument != nullptr);
+
+                SmallChunkInputStream in (toData (text), r);
+                XmlReader reader (in);
+                auto fromReader = XmlDocument::parse (reader);
+
+                expect (fromReader != nullptr, reader.getLastError());
+
+                if (fromDocument != nullptr && fromReader != nullptr)
+                {
+                    expect (fromReader->isEquivalentTo (fromDocument.get(), false));
+                    expectEquals (fromReader->toString(), fromDocument->toString());
+                }
+            }
+        }
+    }
+
+private:
+    static MemoryBlock toData (const char* text)
+    {
+        return { text, strlen (text) };
+    }
+
+    static MemoryBlock toData (const String& text)
+    {
+        return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+    }
+
+    void expectError (const String& text, const String& expectedError)
+    {
+        MemoryInputStream in (toData (text));
+        XmlReader reader (in);
+
+        while (reader.next() != XmlReader::TokenType::error)
+        {
+            if (reader.getTokenType() == XmlReader::TokenType::endOfDocument)
+            {
+                expect (false, "Expected an error: " + expectedError);
+                return;
+            }
+        }
+
+        expectEquals (reader.getLastError(), expectedError);
+    }
+
+    static String createRandomText (Random& r)
+    {
+        static const juce_wchar chars[] = { 'a', 'b', 'Z', ' ', '&', '<', '>', '"', '\'', '\n', '\t', 0xe9, 0x4e2d, 0x1f600 };
+
+        String s;
+
+        for (int i = r.nextInt (20); --i >= 0;)
+            s << String::charToString (chars[r.nextInt (numElementsInArray (chars))]);
+
+        return s;
+    }
+
+    static void createRandomChildren (Random& r, XmlElement& parent, int depth)
+    {
+        for (int i = r.nextInt (6); --i >= 0;)
+        {
+            if (r.nextInt (4) == 0)
+            {
+                parent.addTextElement (createRandomText (r));
+            }
+            else
+            {
+                auto* child = parent.createNewChildElement ("e" + String (r.nextInt (5)));
+
+                for (int j = r.nextInt (4); --j >= 0;)
+                    child->setAttribute ("a" + String (j), createRandomText (r));
+
+                if (depth > 0)
+                    createRandomChildren (r, *child, depth - 1);
+            }
+        }
+    }
+
+    // Returns the data in small, randomly-sized pieces, to make sure that tokens
+    // are split across the reader's buffer boundaries
+    struct SmallChunkInputStream  : public InputStream
+    {
+        SmallChunkInputStream (MemoryBlock data, Random& r)  : source (std::move (data)), random (r) {}
+
+        int64 getTotalLength() override         { return source.getTotalLength(); }
+        bool isExhausted() override             { return source.isExhausted(); }
+        int64 getPosition() override            { return source.getPosition(); }
+        bool setPosition (int64 pos) override   { return source.setPosition (pos); }
+
+        int read (void* dest, int numBytes) override
+        {
+            return source.read (dest, jmin (numBytes, 1 + random.nextInt (7)));
+        }
+
+        MemoryInputStream source;
+        Random& random;
+    };
+};
+
+static XmlReaderTests xmlReaderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A streaming, pull-style XML parser.
+
+    Unlike XmlDocument, which loads the whole document and returns a complete tree
+    of XmlElements, an XmlReader reads its input in small chunks and hands back one
+    token at a time. Its memory use is bounded by the size of the largest single
+    token (i.e. a start tag with its attributes, or a run of text), rather than the
+    size of the document, so it can be used to scan through very large files.
+
+    Each call to next() moves on to the next token. Element names, attribute names
+    and values, and text are returned as StringRefs which point directly into the
+    reader's internal buffers, so no String objects need to be allocated while
+    reading. These references only remain valid until the next call to next().
+
+    e.g.
+    @code
+    FileInputStream in (myFile);
+    XmlReader reader (in);
+
+    for (;;)
+    {
+        auto token = reader.next();
+
+        if (token == XmlReader::TokenType::endOfDocument || token == XmlReader::TokenType::error)
+            break;
+
+        if (token == XmlReader::TokenType::startElement && reader.getElementName() == StringRef ("PLUGIN"))
+        {
+            // Either read the attributes straight from the reader..
+            auto pluginName = String (reader.getAttributeValue ("name"));
+
+            // ..or turn this element and its children into an XmlElement
+            if (auto plugin = XmlDocument::parse (reader))
+                addPlugin (*plugin);
+        }
+    }
+
+    if (reader.getTokenType() == XmlReader::TokenType::error)
+        DBG (reader.getLastError());
+    @endcode
+
+    The reader expects UTF-8 input. It decodes the five standard entities (amp, quot,
+    apos, lt and gt) and numeric character references in attribute values and text,
+    but skips any DTD without loading external entities, so any other entity references
+    are left in the text unchanged. Comments, processing instructions and the document
+    header are skipped.
+
+    @see XmlDocument, XmlElement
+
+    @tags{Core}
+*/
+class JUCE_API  XmlReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader which will parse the given stream.
+        The stream must remain valid for the lifetime of the reader.
+    */
+    explicit XmlReader (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~XmlReader();
+
+    //==============================================================================
+    /** The different kinds of token that the reader can return. */
+    enum class TokenType
+    {
+        none,           /**< next() hasn't been called yet. */
+        startElement,   /**< An opening tag, e.g. <FOO bar="1">. */
+        endElement,     /**< A closing tag. An empty tag such as <FOO/> produces a startElement followed by an endElement. */
+        text,           /**< A block of text or a CDATA section. */
+        endOfDocument,  /**< The outer document element has been closed. */
+        error           /**< The input couldn't be parsed - see getLastError(). */
+    };
+
+    /** Reads the next token from the stream and returns its type.
+        Once the reader reaches the end of the document or hits an error, it will
+        keep returning the same token type.
+    */
+    TokenType next();
+
+    /** Returns the type of the token that the last call to next() found. */
+    TokenType getTokenType() const noexcept                 { return tokenType; }
+
+    /** Returns the error message if the last token was TokenType::error. */
+    const String& getLastError() const noexcept             { return lastError; }
+
+    //==============================================================================
+    /** For a startElement or endElement token, this returns the element's tag name. */
+    StringRef getElementName() const noexcept;
+
+    /** Returns true if the current start or end token belongs to an empty tag, e.g. <FOO/>. */
+    bool isEmptyElement() const noexcept                    { return emptyElement; }
+
+    /** Returns the number of elements that are currently open.
+
+        This includes the element that a startElement or endElement token refers to,
+        so the outer document element is at depth 1.
+    */
+    int getDepth() const noexcept                           { return openElements.size(); }
+
+    /** Returns the number of attributes in the current startElement token. */
+    int getNumAttributes() const noexcept                   { return attributes.size(); }
+
+    /** Returns the name of one of the current element's attributes. */
+    StringRef getAttributeName (int attributeIndex) const noexcept;
+
+    /** Returns the value of one of the current element's attributes, with any entities decoded. */
+    StringRef getAttributeValue (int attributeIndex) const noexcept;
+
+    /** Returns the value of the current element's attribute with the given name.
+        If there's no such attribute, this returns an empty string.
+    */
+    StringRef getAttributeValue (StringRef attributeName) const noexcept;
+
+    /** Returns true if the current element has an attribute with the given name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** For a text token, this returns the text with any entities decoded.
+        Line breaks in ordinary text are normalised to a single newline character,
+        but the content of CDATA sections is returned unchanged.
+    */
+    StringRef getText() const noexcept;
+
+    /** Returns true if the current text token came from a CDATA section. */
+    bool isCDATA() const noexcept                           { return cdata; }
+
+    //==============================================================================
+    /** If the current token is a startElement, this skips over all of the element's
+        content, leaving the reader positioned on its matching endElement token.
+        Returns false if an error occurs.
+    */
+    bool skipElement();
+
+    /** Sets a flag to change the treatment of text that only contains whitespace.
+
+        If this is true (the default state), then any text tokens that contain only
+        whitespace characters will be skipped, in the same way that XmlDocument does
+        by default. CDATA sections are always returned.
+    */
+    void setEmptyTextIgnored (bool shouldBeIgnored) noexcept   { ignoreEmptyText = shouldBeIgnored; }
+
+private:
+    //==============================================================================
+    struct Attribute
+    {
+        int nameOffset, valueOffset;
+    };
+
+    InputStream& source;
+    HeapBlock<char> buffer;
+    int bufferStart = 0, bufferEnd = 0;
+    bool sourceExhausted = false, hasStarted = false, pendingEmptyElementEnd = false;
+
+    TokenType tokenType = TokenType::none;
+    bool emptyElement = false, cdata = false, ignoreEmptyText = true;
+    MemoryOutputStream tokenData, openElementNames;
+    Array<int> openElements;
+    Array<Attribute> attributes;
+    String lastError;
+
+    bool ensureAvailable (int numBytes);
+    bool refillBuffer (int numBytes);
+    int peek (int offset);
+    bool matches (const char* text, int length);
+    void skipWhitespace();
+    bool skipPast (const char* terminator, int length);
+    bool skipDTD();
+    bool readName (MemoryOutputStream&);
+    bool readStartTag();
+    bool readEndTag();
+    bool readText();
+    bool readCDATA();
+    bool readAttributeValue (char quote);
+    juce_wchar readEntity();
+    TokenType setError (const String&);
+    const char* getTokenString (int offset) const noexcept;
+    static const char* getTokenString (const MemoryOutputStream&, int offset) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlReader)
+};
+
+} // namespace juce
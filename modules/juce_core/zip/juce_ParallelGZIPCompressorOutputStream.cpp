@@ -0,0 +1,437 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static bool isGZIPFormat (int windowBits) noexcept   { return windowBits > 15; }
+static bool isRawFormat (int windowBits) noexcept    { return windowBits < 0; }
+static int getWindowLog (int windowBits) noexcept    { return jlimit (9, 15, std::abs (windowBits) & 15); }
+
+//==============================================================================
+struct ParallelGZIPCompressorOutputStream::Deflater
+{
+    Deflater (int compressionLevel, int windowBits)
+    {
+        using namespace zlibNamespace;
+        zerostruct (stream);
+
+        // Each block is compressed as raw deflate data, and the stream writes
+        // the header and checksum for the whole thing itself
+        isValid = (deflateInit2 (&stream, compressionLevel, Z_DEFLATED,
+                                 -getWindowLog (windowBits), 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    }
+
+    ~Deflater()
+    {
+        if (isValid)
+            zlibNamespace::deflateEnd (&stream);
+    }
+
+    zlibNamespace::z_stream stream;
+    bool isValid;
+
+    JUCE_DECLARE_NON_COPYABLE (Deflater)
+};
+
+//==============================================================================
+struct ParallelGZIPCompressorOutputStream::Block  : public ThreadPoolJob
+{
+    Block (ParallelGZIPCompressorOutputStream& s, HeapBlock<uint8>& data, size_t dataSize,
+           const MemoryBlock& dictionaryToUse, bool isLast)
+        : ThreadPoolJob ("GZIP block"),
+          owner (s),
+          inputSize (dataSize),
+          dictionary (dictionaryToUse),
+          isLastBlock (isLast)
+    {
+        input.swapWith (data);
+    }
+
+    JobStatus runJob() override
+    {
+        using namespace zlibNamespace;
+
+        if (isGZIPFormat (owner.windowBits))
+            checksum = (uint32) crc32 (0, input, (uInt) inputSize);
+        else if (! isRawFormat (owner.windowBits))
+            checksum = (uint32) adler32 (1, input, (uInt) inputSize);
+
+        auto deflater = owner.getDeflater();
+        succeeded = deflater->isValid && compress (deflater->stream);
+        owner.releaseDeflater (std::move (deflater));
+
+        return jobHasFinished;
+    }
+
+    bool compress (zlibNamespace::z_stream& stream)
+    {
+        using namespace zlibNamespace;
+
+        if (deflateReset (&stream) != Z_OK)
+            return false;
+
+        // Priming the block with the end of the previous one lets it refer back to that data,
+        // which is what keeps the compression ratio close to that of a single stream
+        if (! dictionary.isEmpty()
+             && deflateSetDictionary (&stream, static_cast<const Bytef*> (dictionary.getData()),
+                                      (uInt) dictionary.getSize()) != Z_OK)
+            return false;
+
+        output.setSize ((size_t) deflateBound (&stream, (uLong) inputSize) + 16);
+
+        stream.next_in   = input;
+        stream.avail_in  = (uInt) inputSize;
+        stream.next_out  = static_cast<Bytef*> (output.getData());
+        stream.avail_out = (uInt) output.getSize();
+
+        for (;;)
+        {
+            // A sync flush ends the block on a byte boundary without marking it as the last one,
+            // so the output of all the blocks can simply be joined together
+            auto result = deflate (&stream, isLastBlock ? Z_FINISH : Z_SYNC_FLUSH);
+            outputSize = output.getSize() - stream.avail_out;
+
+            if (result == Z_STREAM_END)
+                return true;
+
+            if (result != Z_OK && result != Z_BUF_ERROR)
+                return false;
+
+            if (! isLastBlock && stream.avail_in == 0 && stream.avail_out > 0)
+                return true;
+
+            output.setSize (output.getSize() * 2);
+            stream.next_out  = static_cast<Bytef*> (output.getData()) + outputSize;
+            stream.avail_out = (uInt) (output.getSize() - outputSize);
+        }
+    }
+
+    ParallelGZIPCompressorOutputStream& owner;
+    HeapBlock<uint8> input;
+    const size_t inputSize;
+    const MemoryBlock dictionary;
+    const bool isLastBlock;
+
+    MemoryBlock output;
+    size_t outputSize = 0;
+    uint32 checksum = 0;
+    bool succeeded = false;
+
+    JUCE_DECLARE_NON_COPYABLE (Block)
+};
+
+//==============================================================================
+ParallelGZIPCompressorOutputStream::ParallelGZIPCompressorOutputStream (OutputStream& dest, int level, int bits,
+                                                                        int numThreads, int size)
+    : destStream (dest),
+      compressionLevel ((level < 0 || level > 9) ? -1 : level),
+      windowBits (bits != 0 ? bits : MAX_WBITS),
+      blockSize (jmax (32768, size)),
+      threadPool (numThreads > 0 ? numThreads : SystemStats::getNumCpus())
+{
+    checksum = (isGZIPFormat (windowBits) || isRawFormat (windowBits)) ? 0 : 1;
+    currentBlock.malloc (blockSize);
+}
+
+ParallelGZIPCompressorOutputStream::~ParallelGZIPCompressorOutputStream()
+{
+    flush();
+}
+
+//==============================================================================
+void ParallelGZIPCompressorOutputStream::flush()
+{
+    if (! finished)
+    {
+        finished = true;
+        startBlock (true);
+
+        while (! blocksInProgress.isEmpty())
+            writeNextFinishedBlock();
+
+        if (! failed)
+        {
+            if (isGZIPFormat (windowBits))
+                failed = ! (destStream.writeInt ((int) checksum)
+                             && destStream.writeInt ((int) (uint32) totalInputSize));
+            else if (! isRawFormat (windowBits))
+                failed = ! destStream.writeIntBigEndian ((int) checksum);
+        }
+    }
+
+    destStream.flush();
+}
+
+bool ParallelGZIPCompressorOutputStream::write (const void* data, size_t numBytes)
+{
+    // When you call flush() on a gzip stream, the stream is closed, and you can
+    // no longer continue to write data to it!
+    jassert (! finished);
+    jassert (data != nullptr || numBytes == 0);
+
+    if (finished)
+        return false;
+
+    auto* source = static_cast<const uint8*> (data);
+
+    while (numBytes > 0)
+    {
+        auto numToCopy = jmin (numBytes, (size_t) blockSize - currentBlockSize);
+        memcpy (currentBlock + currentBlockSize, source, numToCopy);
+        currentBlockSize += numToCopy;
+        source += numToCopy;
+        numBytes -= numToCopy;
+
+        if (currentBlockSize == (size_t) blockSize)
+            startBlock (false);
+    }
+
+    return ! failed;
+}
+
+int64 ParallelGZIPCompressorOutputStream::getPosition()
+{
+    return destStream.getPosition();
+}
+
+bool ParallelGZIPCompressorOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+//==============================================================================
+void ParallelGZIPCompressorOutputStream::startBlock (bool isLastBlock)
+{
+    // Keeping a limited number of blocks in flight stops the memory usage growing
+    // when the data is written faster than it can be compressed
+    while (blocksInProgress.size() > threadPool.getNumThreads() * 2)
+        writeNextFinishedBlock();
+
+    auto* block = blocksInProgress.add (new Block (*this, currentBlock, currentBlockSize, dictionary, isLastBlock));
+    totalInputSize += (int64) currentBlockSize;
+
+    if (! isLastBlock)
+    {
+        auto dictionarySize = jmin (block->inputSize, (size_t) 1 << getWindowLog (windowBits));
+        dictionary.replaceAll (block->input + block->inputSize - dictionarySize, dictionarySize);
+        currentBlock.malloc (blockSize);
+    }
+
+    currentBlockSize = 0;
+    threadPool.addJob (block, false);
+}
+
+void ParallelGZIPCompressorOutputStream::writeNextFinishedBlock()
+{
+    using namespace zlibNamespace;
+
+    auto* block = blocksInProgress.getFirst();
+    threadPool.waitForJobToFinish (block, -1);
+
+    if (! headerWritten)
+    {
+        headerWritten = true;
+
+        if (isGZIPFormat (windowBits))
+        {
+            const uint8 header[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0,
+                                     (uint8) (compressionLevel == 9 ? 2 : ((compressionLevel == 0 || compressionLevel == 1) ? 4 : 0)),
+                                     0xff };
+
+            failed = ! destStream.write (header, sizeof (header));
+        }
+        else if (! isRawFormat (windowBits))
+        {
+            auto level       = compressionLevel < 0 ? 6 : compressionLevel;
+            auto methodFlags = ((uint32) (getWindowLog (windowBits) - 8) << 4) | Z_DEFLATED;
+            auto levelFlags  = (uint32) (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3))) << 6;
+            auto header      = (methodFlags << 8) | levelFlags;
+            header += 31 - header % 31;
+
+            failed = ! destStream.writeShortBigEndian ((short) header);
+        }
+    }
+
+    failed = failed || ! block->succeeded
+              || ! destStream.write (block->output.getData(), block->outputSize);
+
+    if (isGZIPFormat (windowBits))
+        checksum = (uint32) crc32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+    else if (! isRawFormat (windowBits))
+        checksum = (uint32) adler32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+
+    blocksInProgress.remove (0);
+}
+
+std::unique_ptr<ParallelGZIPCompressorOutputStream::Deflater> ParallelGZIPCompressorOutputStream::getDeflater()
+{
+    {
+        const SpinLock::ScopedLockType sl (deflaterLock);
+
+        if (! spareDeflaters.isEmpty())
+            return std::unique_ptr<Deflater> (spareDeflaters.removeAndReturn (spareDeflaters.size() - 1));
+    }
+
+    return std::make_unique<Deflater> (compressionLevel, windowBits);
+}
+
+void ParallelGZIPCompressorOutputStream::releaseDeflater (std::unique_ptr<Deflater> deflater)
+{
+    const SpinLock::ScopedLockType sl (deflaterLock);
+    spareDeflaters.add (deflater.release());
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ParallelGZIPTests  : public UnitTest
+{
+    ParallelGZIPTests()
+        : UnitTest ("ParallelGZIP", UnitTestCategories::compression)
+    {}
+
+    static MemoryBlock createTestData (Random& rng, int size)
+    {
+        // A mixture of repeated words and noise, so that the blocks have
+        // something to gain from referring back to earlier ones
+        MemoryOutputStream mo;
+
+        while ((int) mo.getDataSize() < size)
+        {
+            if (rng.nextInt (4) == 0)
+                mo.writeByte ((char) rng.nextInt (256));
+            else
+                mo << "word" << rng.nextInt (50) << ' ';
+        }
+
+        return { mo.getData(), (size_t) size };
+    }
+
+    static MemoryBlock decompress (const MemoryBlock& compressed, GZIPDecompressorInputStream::Format format)
+    {
+        MemoryInputStream compressedInput (compressed, false);
+        GZIPDecompressorInputStream unzipper (&compressedInput, false, format);
+
+        MemoryOutputStream uncompressed;
+        uncompressed << unzipper;
+        return uncompressed.getMemoryBlock();
+    }
+
+    static MemoryBlock compressSerially (const MemoryBlock& data, int level, int windowBits)
+    {
+        MemoryOutputStream compressed;
+
+        {
+            GZIPCompressorOutputStream zipper (compressed, level, windowBits);
+            zipper << data;
+        }
+
+        return compressed.getMemoryBlock();
+    }
+
+    void runTest() override
+    {
+        const std::pair<int, GZIPDecompressorInputStream::Format> formats[]
+            = { { 0,                                          GZIPDecompressorInputStream::zlibFormat },
+                { GZIPCompressorOutputStream::windowBitsGZIP, GZIPDecompressorInputStream::gzipFormat },
+                { GZIPCompressorOutputStream::windowBitsRaw,  GZIPDecompressorInputStream::deflateFormat } };
+
+        auto rng = getRandom();
+
+        beginTest ("Round trip");
+
+        for (auto& format : formats)
+        {
+            for (auto size : { 0, 1, 1000, 32768, 3 * 32768, 3 * 32768 + 1, 300000 })
+            {
+                auto data = createTestData (rng, size);
+                MemoryOutputStream compressed;
+
+                {
+                    ParallelGZIPCompressorOutputStream zipper (compressed, rng.nextInt (11) - 1, format.first,
+                                                               rng.nextInt (4) + 1, 32768);
+
+                    for (size_t pos = 0; pos < data.getSize();)
+                    {
+                        auto numBytes = jmin ((size_t) rng.nextInt (50000) + 1, data.getSize() - pos);
+                        expect (zipper.write (static_cast<const char*> (data.getData()) + pos, numBytes));
+                        pos += numBytes;
+                    }
+                }
+
+                expect (decompress (compressed.getMemoryBlock(), format.second) == data);
+            }
+        }
+
+        beginTest ("Headers and checksums match a single stream");
+
+        for (auto& format : formats)
+        {
+            for (auto level : { -1, 0, 1, 6, 9 })
+            {
+                auto data = createTestData (rng, 200000);
+                auto serial = compressSerially (data, level, format.first);
+
+                MemoryOutputStream parallel;
+
+                {
+                    ParallelGZIPCompressorOutputStream zipper (parallel, level, format.first, 3, 32768);
+                    zipper << data;
+                }
+
+                // (The last byte of a gzip header is the OS code, which is allowed to differ)
+                auto headerSize = format.first == 0 ? 2 : (format.first > 0 ? 9 : 0);
+                auto trailerSize = format.first == 0 ? 4 : (format.first > 0 ? 8 : 0);
+
+                expect (memcmp (serial.getData(), parallel.getData(), (size_t) headerSize) == 0);
+                expect (memcmp (serial.begin() + serial.getSize() - (size_t) trailerSize,
+                                static_cast<const char*> (parallel.getData()) + parallel.getDataSize() - (size_t) trailerSize,
+                                (size_t) trailerSize) == 0);
+            }
+        }
+
+        beginTest ("Compression ratio");
+        {
+            auto data = createTestData (rng, 1000000);
+            auto serial = compressSerially (data, 6, 0);
+
+            MemoryOutputStream parallel;
+
+            {
+                ParallelGZIPCompressorOutputStream zipper (parallel, 6, 0, 4);
+                zipper << data;
+            }
+
+            expect (parallel.getDataSize() < serial.getSize() * 101 / 100);
+        }
+    }
+};
+
+static ParallelGZIPTests parallelGZIPTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it on several threads at once.
+
+    The data is split into blocks which are deflated independently on a set of worker
+    threads, in the same way as pigz does. Each block is primed with the last 32K of the
+    block before it, so the compression ratio is almost as good as a single deflate
+    stream, and the blocks are joined into one standard zlib, gzip or raw deflate stream
+    which can be read back by GZIPDecompressorInputStream or any other inflater.
+
+    This is much faster than a GZIPCompressorOutputStream when compressing large amounts
+    of data on a machine with several cores, but it uses more memory, and there's no
+    benefit for small amounts of data which fit into a single block.
+
+    As with GZIPCompressorOutputStream, calling flush() finishes the compressed data, and
+    no more data can be written to the stream after that.
+
+    @see GZIPCompressorOutputStream, GZIPDecompressorInputStream
+
+    @tags{Core}
+*/
+class JUCE_API  ParallelGZIPCompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+
+        @param destStream           the stream into which the compressed data will be written
+        @param compressionLevel     how much to compress the data, between 0 and 9, where
+                                    0 is non-compressed storage, 1 is the fastest/lowest compression,
+                                    and 9 is the slowest/highest compression. Any value outside this range
+                                    indicates that a default compression level should be used.
+        @param windowBits           selects the format of the output in the same way as the
+                                    GZIPCompressorOutputStream constructor: 0 for the zlib format,
+                                    GZIPCompressorOutputStream::windowBitsGZIP for a gzip file, or
+                                    GZIPCompressorOutputStream::windowBitsRaw for raw deflate data
+        @param numThreads           the number of worker threads to use, or 0 to use one for
+                                    each of the machine's CPU cores
+        @param blockSize            the number of bytes of input compressed by each job. Smaller
+                                    blocks spread the work out more evenly, but cost a little
+                                    compression ratio and speed
+    */
+    ParallelGZIPCompressorOutputStream (OutputStream& destStream,
+                                        int compressionLevel = -1,
+                                        int windowBits = 0,
+                                        int numThreads = 0,
+                                        int blockSize = 131072);
+
+    /** Destructor. */
+    ~ParallelGZIPCompressorOutputStream() override;
+
+    //==============================================================================
+    /** Flushes and closes the stream.
+        This waits for all the blocks to be compressed and writes the end of the compressed
+        data, so no more data can be written to the stream afterwards.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    struct Block;
+    struct Deflater;
+
+    OutputStream& destStream;
+    const int compressionLevel, windowBits, blockSize;
+    ThreadPool threadPool;
+
+    OwnedArray<Block> blocksInProgress;
+    OwnedArray<Deflater> spareDeflaters;
+    SpinLock deflaterLock;
+
+    HeapBlock<uint8> currentBlock;
+    size_t currentBlockSize = 0;
+    MemoryBlock dictionary;
+    uint32 checksum = 0;
+    int64 totalInputSize = 0;
+    bool headerWritten = false, finished = false, failed = false;
+
+    void startBlock (bool isLastBlock);
+    void writeNextFinishedBlock();
+    std::unique_ptr<Deflater> getDeflater();
+    void releaseDeflater (std::unique_ptr<Deflater>);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelGZIPCompressorOutputStream)
+};
+
+} // namespace juce
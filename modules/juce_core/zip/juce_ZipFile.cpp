@@ -135,6 +135,42 @@ static bool hasSymbolicPart (const File& root, const File& f)
     return false;
 }
 
+// When the whole archive is in memory, an entry's data can be read directly from it, so
+// its stream doesn't need to share a source stream or lock anything.
+static InputStream* createStreamForEntryData (const char* data, size_t dataSize,
+                                              int64 streamOffset, int64 compressedSize)
+{
+    if (streamOffset >= 0 && (size_t) streamOffset + 30 <= dataSize)
+    {
+        auto* header = data + streamOffset;
+
+        if (readUnalignedLittleEndianInt (header) == 0x04034b50)
+        {
+            auto start = (size_t) streamOffset + 30 + readUnalignedLittleEndianShort (header + 26)
+                                                    + readUnalignedLittleEndianShort (header + 28);
+
+            if (start <= dataSize)
+                return new MemoryInputStream (data + start, (size_t) jmin ((int64) (dataSize - start), compressedSize), false);
+        }
+    }
+
+    return nullptr;
+}
+
+static String getEntryPath (const ZipFile::ZipEntry& entry)
+{
+   #if JUCE_WINDOWS
+    return entry.filename;
+   #else
+    return entry.filename.replaceCharacter ('\\', '/');
+   #endif
+}
+
+static bool isDirectoryPath (const String& entryPath)
+{
+    return entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\');
+}
+
 //==============================================================================
 struct ZipFile::ZipInputStream  : public InputStream
 {
@@ -256,6 +292,29 @@ ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
     init();
 }
 
+ZipFile::ZipFile (const File& file, UseMemoryMapping useMemoryMapping)
+{
+    if (useMemoryMapping == UseMemoryMapping::yes)
+    {
+        mappedFile.reset (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+
+        if (mappedFile->getData() != nullptr)
+        {
+            sourceData = static_cast<const char*> (mappedFile->getData());
+            sourceDataSize = mappedFile->getSize();
+        }
+        else
+        {
+            mappedFile.reset();
+        }
+    }
+
+    if (sourceData == nullptr)
+        inputSource.reset (new FileInputSource (file));
+
+    init();
+}
+
 ZipFile::ZipFile (InputSource* source)  : inputSource (source)
 {
     init();
@@ -317,9 +376,12 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
     if (auto* zei = entries[index])
     {
-        stream = new ZipInputStream (*this, *zei);
+        if (sourceData != nullptr)
+            stream = createStreamForEntryData (sourceData, sourceDataSize, zei->streamOffset, zei->compressedSize);
+        else
+            stream = new ZipInputStream (*this, *zei);
 
-        if (zei->isCompressed)
+        if (stream != nullptr && zei->isCompressed)
         {
             stream = new GZIPDecompressorInputStream (stream, true,
                                                       GZIPDecompressorInputStream::deflateFormat,
@@ -351,10 +413,21 @@ void ZipFile::sortEntriesByFilename()
 //==============================================================================
 void ZipFile::init()
 {
+    if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (inputStream))
+    {
+        sourceData = static_cast<const char*> (memoryStream->getData());
+        sourceDataSize = memoryStream->getDataSize();
+    }
+
     std::unique_ptr<InputStream> toDelete;
     InputStream* in = inputStream;
 
-    if (inputSource != nullptr)
+    if (sourceData != nullptr)
+    {
+        in = new MemoryInputStream (sourceData, sourceDataSize, false);
+        toDelete.reset (in);
+    }
+    else if (inputSource != nullptr)
     {
         in = inputSource->createInputStream();
         toDelete.reset (in);
@@ -412,6 +485,64 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory,
+                              const bool shouldOverwriteFiles,
+                              ThreadPool& threadPool)
+{
+    auto overwriteFiles = shouldOverwriteFiles ? OverwriteFiles::yes : OverwriteFiles::no;
+    Array<int> parallelEntries, laterEntries;
+    Array<Result> results;
+    std::unordered_set<String> targetPaths, parentFolders;
+
+    // The folders are all created before any jobs start, so that the jobs can't race to
+    // create the same parent folders. If several entries would be written to the same file,
+    // all but the first are extracted afterwards, in order, as the other method would do.
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto entryPath = getEntryPath (entries.getUnchecked (i)->entry);
+        auto targetFile = targetDirectory.getChildFile (entryPath);
+
+        if (isDirectoryPath (entryPath))
+        {
+            results.add (uncompressEntry (i, targetDirectory, overwriteFiles, FollowSymlinks::no));
+            continue;
+        }
+
+        if (! targetPaths.insert (targetFile.getFullPathName().toLowerCase()).second)
+        {
+            laterEntries.add (i);
+            continue;
+        }
+
+        auto parentFolder = targetFile.getParentDirectory();
+
+        if (targetFile.isAChildOf (targetDirectory)
+             && parentFolders.insert (parentFolder.getFullPathName()).second
+             && ! hasSymbolicPart (targetDirectory, parentFolder))
+            parentFolder.createDirectory();
+
+        parallelEntries.add (i);
+    }
+
+    auto firstParallelResult = results.size();
+    results.insertMultiple (-1, Result::ok(), parallelEntries.size());
+
+    threadPool.parallelFor (0, parallelEntries.size(), [&] (int i)
+    {
+        results.getReference (firstParallelResult + i) = uncompressEntry (parallelEntries.getUnchecked (i), targetDirectory,
+                                                                          overwriteFiles, FollowSymlinks::no);
+    });
+
+    for (auto i : laterEntries)
+        results.add (uncompressEntry (i, targetDirectory, overwriteFiles, FollowSymlinks::no));
+
+    for (auto& result : results)
+        if (result.failed())
+            return result;
+
+    return Result::ok();
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     return uncompressEntry (index,
@@ -423,12 +554,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, OverwriteFiles overwriteFiles, FollowSymlinks followSymlinks)
 {
     auto* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
-   #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
-   #endif
+    auto entryPath = getEntryPath (zei->entry);
 
     if (entryPath.isEmpty())
         return Result::ok();
@@ -438,7 +564,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
     if (! targetFile.isAChildOf (targetDirectory))
         return Result::fail ("Entry " + entryPath + " is outside the target directory");
 
-    if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+    if (isDirectoryPath (entryPath))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
     std::unique_ptr<InputStream> in (createStreamForEntry (index));
@@ -741,6 +867,78 @@ struct ZIPTests   : public UnitTest
         }
     }
 
+    void runParallelExtractionTest()
+    {
+        StringArray entryNames { "emptyFolder/" };
+
+        for (int i = 0; i < 200; ++i)
+            entryNames.add ("folder" + String (i % 7) + "/sub/file" + String (i));
+
+        TemporaryFile zipFile (".zip");
+        auto data = createZipMemoryBlock (entryNames);
+        zipFile.getFile().replaceWithData (data.getData(), data.getSize());
+
+        ZipFile zip (zipFile.getFile(), ZipFile::UseMemoryMapping::yes);
+        expectEquals (zip.getNumEntries(), entryNames.size());
+
+        TemporaryFile tmpDir;
+        ThreadPool pool (3);
+        expect (zip.uncompressTo (tmpDir.getFile(), true, pool).wasOk());
+        expect (tmpDir.getFile().getChildFile ("emptyFolder").isDirectory());
+
+        for (auto& entryName : entryNames)
+            if (! entryName.endsWithChar ('/'))
+                expectEquals (tmpDir.getFile().getChildFile (entryName).loadFileAsString(), entryName);
+
+        beginTest ("Parallel extraction of duplicate entries");
+
+        ZipFile::Builder builder;
+
+        for (auto content : { "first", "second", "third" })
+            builder.addEntry (new MemoryInputStream (content, strlen (content), true), 9, "duplicate", Time::getCurrentTime());
+
+        MemoryBlock duplicatesData;
+        MemoryOutputStream mo (duplicatesData, false);
+        builder.writeToStream (mo, nullptr);
+        mo.flush();
+
+        MemoryInputStream mi (duplicatesData, false);
+        ZipFile duplicates (mi);
+
+        expect (duplicates.uncompressTo (tmpDir.getFile(), true, pool).wasOk());
+        expectEquals (tmpDir.getFile().getChildFile ("duplicate").loadFileAsString(), String ("third"));
+
+        expect (duplicates.uncompressTo (tmpDir.getFile(), false, pool).wasOk());
+        expectEquals (tmpDir.getFile().getChildFile ("duplicate").loadFileAsString(), String ("third"));
+
+        beginTest ("Parallel extraction rejects entries outside the target");
+
+        auto badData = createZipMemoryBlock ({ "good", "../bad" });
+        MemoryInputStream badStream (badData, false);
+        ZipFile badZip (badStream);
+
+        expect (badZip.uncompressTo (tmpDir.getFile(), true, pool).failed());
+        expectEquals (tmpDir.getFile().getChildFile ("good").loadFileAsString(), String ("good"));
+        expect (! tmpDir.getFile().getSiblingFile ("bad").exists());
+
+        beginTest ("Parallel extraction from a thread in the same pool");
+
+        TemporaryFile singleThreadDir;
+        ThreadPool singleThreadPool (1);
+        WaitableEvent finished;
+        bool extractedOK = false;
+
+        singleThreadPool.addJob ([&]
+        {
+            extractedOK = zip.uncompressTo (singleThreadDir.getFile(), true, singleThreadPool).wasOk();
+            finished.signal();
+        });
+
+        expect (finished.wait (10000));
+        expect (extractedOK);
+        expectEquals (singleThreadDir.getFile().getChildFile (entryNames[1]).loadFileAsString(), entryNames[1]);
+    }
+
     void runTest() override
     {
         beginTest ("ZIP");
@@ -759,6 +957,49 @@ struct ZIPTests   : public UnitTest
             expectEquals (input->readEntireStreamAsString(), entryName);
         }
 
+        beginTest ("Memory-mapped ZIP");
+        {
+            TemporaryFile zipFile (".zip");
+            zipFile.getFile().replaceWithData (data.getData(), data.getSize());
+            ZipFile mapped (zipFile.getFile(), ZipFile::UseMemoryMapping::yes);
+
+            expectEquals (mapped.getNumEntries(), entryNames.size());
+
+            for (auto& entryName : entryNames)
+            {
+                std::unique_ptr<InputStream> input (mapped.createStreamForEntry (*mapped.getEntry (entryName)));
+                expectEquals (input->readEntireStreamAsString(), entryName);
+            }
+        }
+
+        beginTest ("Memory-mapped ZIP with corrupt local headers");
+        {
+            MemoryBlock corruptData (data);
+            auto* bytes = static_cast<char*> (corruptData.getData());
+
+            for (size_t i = 0; i + 4 <= corruptData.getSize(); ++i)
+                if (readUnalignedLittleEndianInt (bytes + i) == 0x04034b50)
+                    bytes[i] = 0;
+
+            TemporaryFile zipFile (".zip");
+            zipFile.getFile().replaceWithData (corruptData.getData(), corruptData.getSize());
+            ZipFile mapped (zipFile.getFile(), ZipFile::UseMemoryMapping::yes);
+
+            TemporaryFile tmpDir;
+            tmpDir.getFile().createDirectory();
+
+            expectEquals (mapped.getNumEntries(), entryNames.size());
+
+            for (int i = 0; i < mapped.getNumEntries(); ++i)
+            {
+                expect (std::unique_ptr<InputStream> (mapped.createStreamForEntry (i)) == nullptr);
+                expect (mapped.uncompressEntry (i, tmpDir.getFile()).failed());
+            }
+        }
+
+        beginTest ("Parallel extraction");
+        runParallelExtractionTest();
+
         beginTest ("ZipSlip");
         runZipSlipTest();
     }
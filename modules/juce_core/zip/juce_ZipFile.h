@@ -38,9 +38,26 @@ public:
     /** Creates a ZipFile to read a specific file. */
     explicit ZipFile (const File& file);
 
+    enum class UseMemoryMapping { no, yes };
+
+    /** Creates a ZipFile to read a specific file, optionally mapping it into memory.
+
+        When the file is memory-mapped, the streams returned by createStreamForEntry() read
+        straight from the mapped data, so any number of entries can be decompressed on different
+        threads at the same time, without any locking and without having to reopen the file for
+        each entry. If the file can't be mapped, it will be read in the same way as the
+        ZipFile (const File&) constructor.
+
+        The file mustn't be modified while the ZipFile is using it.
+    */
+    ZipFile (const File& file, UseMemoryMapping useMemoryMapping);
+
     //==============================================================================
     /** Creates a ZipFile for a given stream.
 
+        If the stream is a MemoryInputStream, its data will be read directly, in the same way
+        as a memory-mapped file, so its entries can safely be read on multiple threads.
+
         @param inputStream                  the stream to read from
         @param deleteStreamWhenDestroyed    if set to true, the object passed-in
                                             will be deleted when this ZipFile object is deleted
@@ -132,7 +149,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryInputStream, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (int index);
 
@@ -147,7 +165,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryInputStream, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (const ZipEntry& entry);
 
@@ -164,6 +183,27 @@ public:
     Result uncompressTo (const File& targetDirectory,
                          bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using a ThreadPool to extract
+        several entries at the same time.
+
+        This behaves like the other uncompressTo() method, except that a failure to extract
+        one entry won't stop the others from being extracted. If any entries fail, the
+        result for the first of them is returned. The method returns when all the entries
+        have been extracted, and the calling thread also helps to extract them.
+
+        The entries are only decompressed truly in parallel if the ZipFile was created from
+        a File, an InputSource or a MemoryInputStream, and the best results come from using
+        a memory-mapped file.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param threadPool           the pool whose threads will be used to extract the entries
+        @returns success if the file is successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         ThreadPool& threadPool);
+
     /** Uncompresses one of the entries from the zip file.
 
         This will expand the entry and write it in a target directory. The entry's path is used to
@@ -264,6 +304,9 @@ private:
     InputStream* inputStream = nullptr;
     std::unique_ptr<InputStream> streamToDelete;
     std::unique_ptr<InputSource> inputSource;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const char* sourceData = nullptr;
+    size_t sourceDataSize = 0;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -36,12 +36,10 @@ public:
     SharedObject (const SharedObject& other)
         : ReferenceCountedObject(), type (other.type), properties (other.properties)
     {
+        children.ensureStorageAllocated (other.children.size());
+
         for (auto* c : other.children)
-        {
-            auto* child = new SharedObject (*c);
-            child->parent = this;
-            children.add (child);
-        }
+            appendChild (new SharedObject (*c));
     }
 
     SharedObject& operator= (const SharedObject&) = delete;
@@ -94,32 +92,208 @@ public:
             t->callListeners (listenerToExclude, fn);
     }
 
+    //==============================================================================
+    /*  The callbacks that have been held back while a ScopedNotificationBatch is
+        active. Property changes are merged, so that each property of each tree is
+        only reported once, and the rest are kept in the order they happened.
+    */
+    struct PendingNotifications
+    {
+        enum class Type { propertyChanged, childAdded, childRemoved, childOrderChanged, parentChanged };
+
+        struct Notification
+        {
+            Type type;
+            Ptr tree, child;
+            Identifier property;
+            ValueTree::Listener* listenerToExclude;
+            int index1, index2;
+        };
+
+        void propertyChanged (SharedObject& tree, const Identifier& property, ValueTree::Listener* listenerToExclude)
+        {
+            auto& n = findOrAdd (Type::propertyChanged, tree, property.getCharPointer().getAddress(), [&]
+            {
+                return Notification { Type::propertyChanged, &tree, {}, property, listenerToExclude, 0, 0 };
+            });
+
+            // If different changes excluded different listeners, they all need to be told
+            if (n.listenerToExclude != listenerToExclude)
+                n.listenerToExclude = nullptr;
+        }
+
+        void parentChanged (SharedObject& tree)
+        {
+            findOrAdd (Type::parentChanged, tree, nullptr, [&]
+            {
+                return Notification { Type::parentChanged, &tree, {}, {}, nullptr, 0, 0 };
+            });
+        }
+
+        void add (Type type, SharedObject& tree, SharedObject* child, int index1, int index2)
+        {
+            notifications.push_back ({ type, &tree, child, {}, nullptr, index1, index2 });
+        }
+
+        void deliver()
+        {
+            for (auto& n : notifications)
+            {
+                switch (n.type)
+                {
+                    case Type::propertyChanged:     n.tree->sendPropertyChangeMessage (n.property, n.listenerToExclude); break;
+                    case Type::childAdded:          n.tree->sendChildAddedMessage (ValueTree (*n.child)); break;
+                    case Type::childRemoved:        n.tree->sendChildRemovedMessage (ValueTree (n.child), n.index1); break;
+                    case Type::childOrderChanged:   n.tree->sendChildOrderChangedMessage (n.index1, n.index2); break;
+                    case Type::parentChanged:       n.tree->sendParentChangeMessage(); break;
+                    default:                        jassertfalse; break;
+                }
+            }
+        }
+
+    private:
+        // Property and parent changes are merged by looking them up in a small open-addressed
+        // table, which is kept at most half full. The keys are stored in the table itself, so
+        // that a lookup doesn't need to touch the list of notifications at all.
+        struct Slot
+        {
+            const void* tree;
+            const void* property;
+            size_t index;
+        };
+
+        template <typename CreateNotification>
+        Notification& findOrAdd (Type type, SharedObject& tree, const void* property, CreateNotification&& create)
+        {
+            if ((numMerged + 1) * 2 > numSlots)
+                rehash (jmax ((size_t) 64, numSlots * 2));
+
+            // Parent changes have a null property, so they can't clash with property changes
+            jassert ((type == Type::parentChanged) == (property == nullptr));
+            ignoreUnused (type);
+
+            for (auto i = getSlot (&tree, property);; i = (i + 1) & (numSlots - 1))
+            {
+                auto& slot = slots[i];
+
+                if (slot.tree == nullptr)
+                {
+                    slot = { &tree, property, notifications.size() };
+                    notifications.push_back (create());
+                    ++numMerged;
+                    return notifications.back();
+                }
+
+                if (slot.tree == &tree && slot.property == property)
+                    return notifications[slot.index];
+            }
+        }
+
+        size_t getSlot (const void* tree, const void* property) const noexcept
+        {
+            auto key = (uint64) (pointer_sized_uint) tree ^ ((uint64) (pointer_sized_uint) property << 1);
+            return (size_t) ((key * 0x9e3779b97f4a7c15ull) >> 32) & (numSlots - 1);
+        }
+
+        void rehash (size_t newNumSlots)
+        {
+            HeapBlock<Slot> oldSlots (std::move (slots));
+            std::swap (numSlots, newNumSlots);
+            slots.calloc (numSlots);
+
+            for (size_t i = 0; i < newNumSlots; ++i)
+            {
+                auto& old = oldSlots[i];
+
+                if (old.tree != nullptr)
+                {
+                    auto slot = getSlot (old.tree, old.property);
+
+                    while (slots[slot].tree != nullptr)
+                        slot = (slot + 1) & (numSlots - 1);
+
+                    slots[slot] = old;
+                }
+            }
+        }
+
+        std::vector<Notification> notifications;
+        HeapBlock<Slot> slots;
+        size_t numSlots = 0, numMerged = 0;
+    };
+
+    PendingNotifications* findPendingNotifications() const noexcept
+    {
+        for (auto* t = this; t != nullptr; t = t->parent)
+            if (t->pendingNotifications != nullptr)
+                return t->pendingNotifications.get();
+
+        return nullptr;
+    }
+
+    void beginNotificationBatch()
+    {
+        if (notificationBatchDepth++ == 0)
+            pendingNotifications = std::make_unique<PendingNotifications>();
+    }
+
+    void endNotificationBatch()
+    {
+        jassert (notificationBatchDepth > 0);
+
+        if (--notificationBatchDepth == 0)
+        {
+            // The batch is detached before anything is delivered, so that the callbacks are
+            // sent straight to the listeners, or to a batch belonging to one of the parents
+            const Ptr keepAlive (this);
+            auto pending = std::move (pendingNotifications);
+            pending->deliver();
+        }
+    }
+
+    //==============================================================================
     void sendPropertyChangeMessage (const Identifier& property, ValueTree::Listener* listenerToExclude = nullptr)
     {
+        if (auto* pending = findPendingNotifications())
+            return pending->propertyChanged (*this, property, listenerToExclude);
+
         ValueTree tree (*this);
         callListenersForAllParents (listenerToExclude, [&] (Listener& l) { l.valueTreePropertyChanged (tree, property); });
     }
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (auto* pending = findPendingNotifications())
+            return pending->add (PendingNotifications::Type::childAdded, *this, child.object.get(), 0, 0);
+
         ValueTree tree (*this);
         callListenersForAllParents (nullptr, [&] (Listener& l) { l.valueTreeChildAdded (tree, child); });
     }
 
     void sendChildRemovedMessage (ValueTree child, int index)
     {
+        if (auto* pending = findPendingNotifications())
+            return pending->add (PendingNotifications::Type::childRemoved, *this, child.object.get(), index, 0);
+
         ValueTree tree (*this);
         callListenersForAllParents (nullptr, [=, &tree, &child] (Listener& l) { l.valueTreeChildRemoved (tree, child, index); });
     }
 
     void sendChildOrderChangedMessage (int oldIndex, int newIndex)
     {
+        if (auto* pending = findPendingNotifications())
+            return pending->add (PendingNotifications::Type::childOrderChanged, *this, nullptr, oldIndex, newIndex);
+
         ValueTree tree (*this);
         callListenersForAllParents (nullptr, [=, &tree] (Listener& l) { l.valueTreeChildOrderChanged (tree, oldIndex, newIndex); });
     }
 
-    void sendParentChangeMessage()
+    // A child that's just been removed has no parent, so its parent's batch has to be passed in
+    void sendParentChangeMessage (PendingNotifications* pending = nullptr)
     {
+        if (pending != nullptr || (pending = findPendingNotifications()) != nullptr)
+            return pending->parentChanged (*this);
+
         ValueTree tree (*this);
 
         for (auto j = children.size(); --j >= 0;)
@@ -201,20 +375,35 @@ public:
             setProperty (source.properties.getName (i), source.properties.getValueAt (i), undoManager);
     }
 
-    ValueTree getChildWithName (const Identifier& typeToMatch) const
+    SharedObject* findChildWithType (const Identifier& typeToMatch) const noexcept
     {
+        if (! firstChildOfType.isEmpty())
+        {
+            if (auto* index = firstChildOfType.getVarPointer (typeToMatch))
+                return children.getObjectPointerUnchecked (static_cast<int> (*index));
+
+            return nullptr;
+        }
+
         for (auto* s : children)
             if (s->type == typeToMatch)
-                return ValueTree (*s);
+                return s;
+
+        return nullptr;
+    }
+
+    ValueTree getChildWithName (const Identifier& typeToMatch) const
+    {
+        if (auto* s = findChildWithType (typeToMatch))
+            return ValueTree (*s);
 
         return {};
     }
 
     ValueTree getOrCreateChildWithName (const Identifier& typeToMatch, UndoManager* undoManager)
     {
-        for (auto* s : children)
-            if (s->type == typeToMatch)
-                return ValueTree (*s);
+        if (auto* s = findChildWithType (typeToMatch))
+            return ValueTree (*s);
 
         auto newObject = new SharedObject (typeToMatch);
         addChild (newObject, -1, undoManager);
@@ -239,9 +428,41 @@ public:
         return false;
     }
 
+    int indexOf (const SharedObject* child) const noexcept
+    {
+        if (child == nullptr || child->parent != this)
+            return -1;
+
+        // Each child remembers the index it was given when it was added or moved, but
+        // adding or removing its siblings can shift it a little, so the search starts
+        // there and works outwards
+        auto* objects = children.begin();
+        const auto numChildren = children.size();
+        const auto start = jlimit (0, numChildren - 1, child->indexInParent);
+
+        for (int before = start, after = start + 1; before >= 0 || after < numChildren; --before, ++after)
+        {
+            if (before >= 0 && objects[before] == child)
+                return before;
+
+            if (after < numChildren && objects[after] == child)
+                return after;
+        }
+
+        jassertfalse;
+        return -1;
+    }
+
     int indexOf (const ValueTree& child) const noexcept
     {
-        return children.indexOf (child.object);
+        return indexOf (child.object.get());
+    }
+
+    void appendChild (SharedObject* child)
+    {
+        children.add (child);
+        child->parent = this;
+        childInserted (children.size() - 1);
     }
 
     void addChild (SharedObject* child, int index, UndoManager* undoManager)
@@ -257,16 +478,20 @@ public:
 
                 if (child->parent != nullptr)
                 {
-                    jassert (child->parent->children.indexOf (child) >= 0);
-                    child->parent->removeChild (child->parent->children.indexOf (child), undoManager);
+                    jassert (child->parent->indexOf (child) >= 0);
+                    child->parent->removeChild (child->parent->indexOf (child), undoManager);
                 }
 
                 if (undoManager == nullptr)
                 {
+                    if (! isPositiveAndNotGreaterThan (index, children.size()))
+                        index = children.size();
+
                     children.insert (index, child);
                     child->parent = this;
+                    childInserted (index);
                     sendChildAddedMessage (ValueTree (*child));
-                    child->sendParentChangeMessage();
+                    child->sendParentChangeMessage (findPendingNotifications());
                 }
                 else
                 {
@@ -293,8 +518,10 @@ public:
             {
                 children.remove (childIndex);
                 child->parent = nullptr;
+                child->indexInParent = -1;
+                childRemoved (childIndex, child->type);
                 sendChildRemovedMessage (ValueTree (child), childIndex);
-                child->sendParentChangeMessage();
+                child->sendParentChangeMessage (findPendingNotifications());
             }
             else
             {
@@ -320,6 +547,7 @@ public:
             if (undoManager == nullptr)
             {
                 children.move (currentIndex, newIndex);
+                childMoved (currentIndex, isPositiveAndBelow (newIndex, children.size()) ? newIndex : children.size() - 1);
                 sendChildOrderChangedMessage (currentIndex, newIndex);
             }
             else
@@ -342,7 +570,7 @@ public:
 
             if (children.getObjectPointerUnchecked (i) != child)
             {
-                auto oldIndex = children.indexOf (child);
+                auto oldIndex = indexOf (child);
                 jassert (oldIndex >= 0);
                 moveChild (oldIndex, i, undoManager);
             }
@@ -407,6 +635,45 @@ public:
         }
     }
 
+    //==============================================================================
+    // These mark the start and end of a batch in an UndoManager transaction, so that
+    // undoing or redoing the transaction delivers its callbacks as a batch too
+    struct NotificationBatchAction  : public UndoableAction
+    {
+        NotificationBatchAction (Ptr targetObject, bool isStartOfBatch)
+            : target (std::move (targetObject)), isStart (isStartOfBatch)
+        {
+        }
+
+        bool perform() override
+        {
+            if (isStart)
+                target->beginNotificationBatch();
+            else
+                target->endNotificationBatch();
+
+            return true;
+        }
+
+        bool undo() override
+        {
+            if (isStart)
+                target->endNotificationBatch();
+            else
+                target->beginNotificationBatch();
+
+            return true;
+        }
+
+        int getSizeInUnits() override    { return 1; }
+
+    private:
+        const Ptr target;
+        const bool isStart;
+
+        JUCE_DECLARE_NON_COPYABLE (NotificationBatchAction)
+    };
+
     //==============================================================================
     struct SetPropertyAction  : public UndoableAction
     {
@@ -564,12 +831,117 @@ public:
         JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
     };
 
+    //==============================================================================
+    // Nodes with lots of children also keep the index of the first child of each
+    // type, so that getChildWithName() doesn't need to search either. When children
+    // are added, removed or moved, only the indexes in the range that has changed
+    // are adjusted.
+    void rebuildChildTypeIndex()
+    {
+        firstChildOfType.clear();
+
+        if (children.size() >= minNumChildrenToIndexTypes)
+            for (int i = 0; i < children.size(); ++i)
+                if (! firstChildOfType.contains (children.getObjectPointerUnchecked (i)->type))
+                    firstChildOfType.set (children.getObjectPointerUnchecked (i)->type, i);
+    }
+
+    template <typename Function>
+    void adjustFirstChildIndexes (Function&& newIndexForOldIndex)
+    {
+        for (int i = 0; i < firstChildOfType.size(); ++i)
+        {
+            auto* index = firstChildOfType.getVarPointerAt (i);
+            const auto oldIndex = static_cast<int> (*index);
+            const auto newIndex = newIndexForOldIndex (oldIndex);
+
+            if (newIndex != oldIndex)
+                *index = newIndex;
+        }
+    }
+
+    void findFirstChildOfType (const Identifier& childType, int startIndex)
+    {
+        for (int i = startIndex; i < children.size(); ++i)
+        {
+            if (children.getObjectPointerUnchecked (i)->type == childType)
+            {
+                firstChildOfType.set (childType, i);
+                return;
+            }
+        }
+
+        firstChildOfType.remove (childType);
+    }
+
+    void childInserted (int index)
+    {
+        children.getObjectPointerUnchecked (index)->indexInParent = index;
+
+        if (firstChildOfType.isEmpty())
+        {
+            rebuildChildTypeIndex();
+            return;
+        }
+
+        // Nothing needs to shift when a child is added to the end
+        if (index < children.size() - 1)
+            adjustFirstChildIndexes ([index] (int i) { return i >= index ? i + 1 : i; });
+
+        auto& childType = children.getObjectPointerUnchecked (index)->type;
+        auto* first = firstChildOfType.getVarPointer (childType);
+
+        if (first == nullptr || static_cast<int> (*first) > index)
+            firstChildOfType.set (childType, index);
+    }
+
+    void childRemoved (int index, const Identifier& childType)
+    {
+        if (children.size() < minNumChildrenToIndexTypes)
+        {
+            firstChildOfType.clear();
+            return;
+        }
+
+        const auto wasFirstOfType = static_cast<int> (firstChildOfType[childType]) == index;
+
+        if (index < children.size())
+            adjustFirstChildIndexes ([index] (int i) { return i > index ? i - 1 : i; });
+
+        if (wasFirstOfType)
+            findFirstChildOfType (childType, index);
+    }
+
+    void childMoved (int oldIndex, int newIndex)
+    {
+        const auto start = jmin (oldIndex, newIndex), end = jmax (oldIndex, newIndex);
+        children.getObjectPointerUnchecked (newIndex)->indexInParent = newIndex;
+
+        if (firstChildOfType.isEmpty())
+            return;
+
+        const auto direction = oldIndex < newIndex ? -1 : 1;
+        auto& childType = children.getObjectPointerUnchecked (newIndex)->type;
+
+        adjustFirstChildIndexes ([=] (int i) { return i == oldIndex ? newIndex
+                                                     : (i >= start && i <= end) ? i + direction : i; });
+
+        if (static_cast<int> (firstChildOfType[childType]) >= start)
+            findFirstChildOfType (childType, start);
+    }
+
+    static constexpr int minNumChildrenToIndexTypes = 16;
+
     //==============================================================================
     const Identifier type;
     NamedValueSet properties;
     ReferenceCountedArray<SharedObject> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent = nullptr;
+    int indexInParent = -1;
+    NamedValueSet firstChildOfType;
+    std::unique_ptr<PendingNotifications> pendingNotifications;
+    int notificationBatchDepth = 0;
 
     JUCE_LEAK_DETECTOR (SharedObject)
 };
@@ -929,7 +1301,7 @@ void ValueTree::removeChild (int childIndex, UndoManager* undoManager)
 void ValueTree::removeChild (const ValueTree& child, UndoManager* undoManager)
 {
     if (object != nullptr)
-        object->removeChild (object->children.indexOf (child.object), undoManager);
+        object->removeChild (object->indexOf (child), undoManager);
 }
 
 void ValueTree::removeAllChildren (UndoManager* undoManager)
@@ -985,6 +1357,51 @@ void ValueTree::sendPropertyChangeMessage (const Identifier& property)
         object->sendPropertyChangeMessage (property);
 }
 
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& treeToBatch, UndoManager* um,
+                                                             const String& transactionName)
+    : tree (treeToBatch), undoManager (um)
+{
+    auto& object = tree.object;
+
+    // You can't batch the notifications of an invalid tree!
+    jassert (object != nullptr);
+
+    if (object == nullptr)
+        return;
+
+    // A batch nested inside another one adds its changes to the outer batch's transaction,
+    // so only the outermost batch starts a transaction and records where the batch begins
+    if (undoManager != nullptr && object->findPendingNotifications() == nullptr)
+    {
+        isRecordingTransaction = true;
+        undoManager->beginNewTransaction (transactionName);
+        undoManager->perform (new SharedObject::NotificationBatchAction (object, true));
+    }
+    else
+    {
+        object->beginNotificationBatch();
+    }
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    auto& object = tree.object;
+
+    if (object == nullptr)
+        return;
+
+    if (isRecordingTransaction)
+    {
+        undoManager->perform (new SharedObject::NotificationBatchAction (object, false));
+        undoManager->beginNewTransaction();
+    }
+    else
+    {
+        object->endNotificationBatch();
+    }
+}
+
 //==============================================================================
 std::unique_ptr<XmlElement> ValueTree::createXml() const
 {
@@ -1068,8 +1485,7 @@ ValueTree ValueTree::readFromStream (InputStream& input)
         if (! child.isValid())
             return v;
 
-        v.object->children.add (child.object);
-        child.object->parent = v.object.get();
+        v.object->appendChild (child.object.get());
     }
 
     return v;
@@ -1241,6 +1657,201 @@ public:
                 expectEquals (lines[numLines - 1], "<Test number=\"" + test.second + "\"/>");
             }
         }
+
+        {
+            beginTest ("Child lookups in large trees");
+
+            auto r = getRandom();
+            const Identifier types[] = { "a", "b", "c", "d", "e" };
+            UndoManager undoManager;
+
+            ValueTree parent ("parent");
+
+            auto checkLookups = [&]
+            {
+                for (int i = 0; i < parent.getNumChildren(); ++i)
+                    expectEquals (parent.indexOf (parent.getChild (i)), i);
+
+                for (auto& type : types)
+                {
+                    ValueTree expected;
+
+                    for (const auto& child : parent)
+                    {
+                        if (child.hasType (type))
+                        {
+                            expected = child;
+                            break;
+                        }
+                    }
+
+                    expect (parent.getChildWithName (type) == expected);
+                }
+
+                expectEquals (parent.indexOf (ValueTree ("a")), -1);
+            };
+
+            for (int i = 0; i < 200; ++i)
+                parent.appendChild (ValueTree (types[r.nextInt (3)]), nullptr);
+
+            checkLookups();
+
+            for (int i = 0; i < 300; ++i)
+            {
+                switch (r.nextInt (5))
+                {
+                    case 0:  parent.addChild (ValueTree (types[r.nextInt (5)]), r.nextInt (parent.getNumChildren() + 1), &undoManager); break;
+                    case 1:  parent.appendChild (ValueTree (types[r.nextInt (5)]), &undoManager); break;
+                    case 2:  parent.removeChild (r.nextInt (parent.getNumChildren()), &undoManager); break;
+                    case 3:  parent.removeChild (parent.getNumChildren() - 1, &undoManager); break;
+                    case 4:  parent.moveChild (r.nextInt (parent.getNumChildren()), r.nextInt (parent.getNumChildren()), &undoManager); break;
+                    default: break;
+                }
+
+                undoManager.beginNewTransaction();
+
+                if (i % 10 == 0)
+                    checkLookups();
+            }
+
+            checkLookups();
+
+            while (undoManager.canUndo())
+                undoManager.undo();
+
+            checkLookups();
+
+            auto copy = parent.createCopy();
+            expect (copy.isEquivalentTo (parent));
+
+            MemoryOutputStream mo;
+            parent.writeToStream (mo);
+            MemoryInputStream mi (mo.getData(), mo.getDataSize(), false);
+            auto readBack = ValueTree::readFromStream (mi);
+
+            for (auto* tree : { &copy, &readBack })
+            {
+                for (int i = 0; i < tree->getNumChildren(); ++i)
+                    expectEquals (tree->indexOf (tree->getChild (i)), i);
+
+                for (auto& type : types)
+                    expectEquals (tree->indexOf (tree->getChildWithName (type)), parent.indexOf (parent.getChildWithName (type)));
+            }
+
+            while (parent.getNumChildren() > 0)
+            {
+                parent.removeChild (parent.getNumChildren() - 1, nullptr);
+
+                if (parent.getNumChildren() % 25 == 0)
+                    checkLookups();
+            }
+        }
+
+        {
+            beginTest ("Notification batches");
+
+            struct RecordingListener  : public ValueTree::Listener
+            {
+                void valueTreePropertyChanged (ValueTree& t, const Identifier& p) override  { events.add ("property " + t.getType() + " " + p); }
+                void valueTreeChildAdded (ValueTree& t, ValueTree& c) override              { events.add ("added " + c.getType() + " to " + t.getType()); }
+                void valueTreeChildRemoved (ValueTree& t, ValueTree& c, int i) override     { events.add ("removed " + c.getType() + " from " + t.getType() + " " + String (i)); }
+                void valueTreeChildOrderChanged (ValueTree& t, int a, int b) override       { events.add ("moved " + t.getType() + " " + String (a) + " " + String (b)); }
+                void valueTreeParentChanged (ValueTree& t) override                         { events.add ("parent " + t.getType()); }
+
+                StringArray events;
+            };
+
+            ValueTree root ("root"), a ("a"), b ("b");
+            root.appendChild (a, nullptr);
+
+            RecordingListener listener;
+            root.addListener (&listener);
+
+            RecordingListener childListener;
+            b.addListener (&childListener);
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    root.setProperty ("x", i, nullptr);
+                    a.setProperty ("x", i, nullptr);
+                }
+
+                root.appendChild (b, nullptr);
+                root.moveChild (0, 1, nullptr);
+                root.removeChild (b, nullptr);
+
+                {
+                    ValueTree::ScopedNotificationBatch nested (a);
+                    a.setProperty ("y", 1, nullptr);
+                }
+
+                expect (listener.events.isEmpty() && childListener.events.isEmpty());
+            }
+
+            // b was added and removed again, but only hears about it once
+            expect (childListener.events == StringArray ({ "parent b" }));
+            expect (listener.events == StringArray ({ "property root x", "property a x", "added b to root",
+                                                      "moved root 0 1", "removed b from root 0", "property a y" }));
+
+            UndoManager undoManager;
+            listener.events.clear();
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root, &undoManager, "Batch");
+
+                for (int i = 0; i < 10; ++i)
+                    a.setProperty ("z", i, &undoManager);
+
+                root.appendChild (b, &undoManager);
+                expect (listener.events.isEmpty());
+            }
+
+            expect (listener.events == StringArray ({ "property a z", "added b to root" }));
+            expectEquals (undoManager.getNumActionsInCurrentTransaction(), 0);
+
+            listener.events.clear();
+            expect (undoManager.undo());
+            expect (! undoManager.canUndo());
+            expect (! a.hasProperty ("z") && ! b.getParent().isValid());
+            expect (listener.events == StringArray ({ "removed b from root 1", "property a z" }));
+
+            listener.events.clear();
+            expect (undoManager.redo());
+            expect ((int) a["z"] == 9 && b.getParent() == root);
+            expect (listener.events == StringArray ({ "property a z", "added b to root" }));
+
+            undoManager.clearUndoHistory();
+            listener.events.clear();
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root, &undoManager, "Outer");
+                root.setProperty ("w", 1, &undoManager);
+
+                {
+                    ValueTree::ScopedNotificationBatch nested (a, &undoManager, "Inner");
+                    a.setProperty ("w", 1, &undoManager);
+                }
+
+                root.setProperty ("w", 2, &undoManager);
+                expect (listener.events.isEmpty());
+            }
+
+            expect (listener.events == StringArray ({ "property root w", "property a w" }));
+
+            // The nested batch is part of the outer batch's transaction
+            listener.events.clear();
+            expect (undoManager.undo());
+            expect (! undoManager.canUndo());
+            expect (! root.hasProperty ("w") && ! a.hasProperty ("w"));
+            expect (listener.events.size() == 2);
+
+            listener.events.clear();
+            root.setProperty ("v", 1, nullptr);
+            expect (listener.events == StringArray ({ "property root v" }));
+        }
     }
 };
 
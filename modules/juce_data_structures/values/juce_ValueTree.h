@@ -566,6 +566,34 @@ public:
     */
     void sendPropertyChangeMessage (const Identifier& property);
 
+    //==============================================================================
+    /** Holds back the listener callbacks for a tree and all of its children while it
+        exists, and delivers them when it's deleted.
+
+        This is handy for big edits, like pasting lots of nodes or loading a preset,
+        which would otherwise call the listeners for every single change. While the
+        batch exists, the changes are recorded instead. When it's deleted, each property
+        that changed is reported once, however many times it was set, and the children
+        that were added, removed or moved are reported in the order the changes were made.
+
+        If an UndoManager is given, the batch starts a new transaction and all the changes
+        made during it are undone or redone as a single unit. Undoing or redoing that
+        transaction also delivers its callbacks as a batch.
+
+        @code
+        {
+            ValueTree::ScopedNotificationBatch batch (tree, &undoManager, "Paste");
+
+            for (auto& node : nodesToPaste)
+                tree.appendChild (node, &undoManager);
+        }   // the listeners are called here
+        @endcode
+
+        Batches can be nested, in which case the callbacks are delivered when the
+        outermost one ends, and only the outermost one starts a new transaction.
+    */
+    class ScopedNotificationBatch;
+
     //==============================================================================
     /** This method uses a comparator object to sort the tree's children into order.
 
@@ -642,4 +670,25 @@ private:
     explicit ValueTree (SharedObject&) noexcept;
 };
 
+//==============================================================================
+/** @see ValueTree::ScopedNotificationBatch */
+class JUCE_API  ValueTree::ScopedNotificationBatch
+{
+public:
+    /** Starts holding back the callbacks for a tree. */
+    explicit ScopedNotificationBatch (const ValueTree& treeToBatch,
+                                      UndoManager* undoManager = nullptr,
+                                      const String& transactionName = {});
+
+    /** Delivers the callbacks that were held back. */
+    ~ScopedNotificationBatch();
+
+private:
+    ValueTree tree;
+    UndoManager* undoManager;
+    bool isRecordingTransaction = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+};
+
 } // namespace juce
@@ -0,0 +1,581 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  The layout of the data, in which all the numbers are little-endian uint32s:
+
+    header:         magic, version, total size, offset of root node, offset of string table
+    node:           type, numProperties, numChildren,
+                    { property name, offset of value } * numProperties,
+                    offset of child * numChildren,
+                    the values of the properties, padded to a multiple of 4 bytes,
+                    the child nodes
+    string table:   numStrings, offset of string * numStrings, null-terminated UTF-8 strings
+
+    The types and property names are stored as indexes into the string table. Nodes
+    are written before their children, so a child's offset is always greater than its
+    parent's, which means that damaged data can't send the reader round in circles.
+*/
+namespace ValueTreeSnapshotFormat
+{
+    static constexpr uint32 magic           = 0x5354564a; // "JVTS"
+    static constexpr uint32 version         = 1;
+    static constexpr uint32 headerSize      = 20;
+    static constexpr uint32 nodeHeaderSize  = 12;
+}
+
+//==============================================================================
+struct ValueTreeSnapshotWriter
+{
+    bool write (const ValueTree& tree, OutputStream& output)
+    {
+        using namespace ValueTreeSnapshotFormat;
+
+        for (uint32 i = 0; i < headerSize; i += 4)
+            out.writeInt (0);
+
+        const auto rootOffset = writeNode (tree);
+        const auto stringTableOffset = (uint32) out.getPosition();
+
+        out.writeInt ((int) strings.size());
+
+        const auto firstStringOffset = stringTableOffset + 4 + 4 * (uint32) strings.size();
+        auto stringOffset = firstStringOffset;
+
+        for (auto& s : strings)
+        {
+            out.writeInt ((int) stringOffset);
+            stringOffset += (uint32) s.getCharPointer().sizeInBytes();
+        }
+
+        for (auto& s : strings)
+            out.write (s.toRawUTF8(), s.getCharPointer().sizeInBytes());
+
+        if (out.getDataSize() > std::numeric_limits<uint32>::max())
+            return false;
+
+        out.setPosition (0);
+        out.writeInt ((int) magic);
+        out.writeInt ((int) version);
+        out.writeInt ((int) out.getDataSize());
+        out.writeInt ((int) rootOffset);
+        out.writeInt ((int) stringTableOffset);
+
+        return output.write (out.getData(), out.getDataSize());
+    }
+
+private:
+    MemoryOutputStream out;
+    Array<String> strings;
+    std::unordered_map<const void*, uint32> stringIndexes;
+
+    uint32 getStringIndex (const Identifier& name)
+    {
+        auto result = stringIndexes.insert ({ name.getCharPointer().getAddress(), (uint32) strings.size() });
+
+        if (result.second)
+            strings.add (name.toString());
+
+        return result.first->second;
+    }
+
+    void writeAt (int64 position, uint32 value)
+    {
+        const auto end = out.getPosition();
+        out.setPosition (position);
+        out.writeInt ((int) value);
+        out.setPosition (end);
+    }
+
+    uint32 writeNode (const ValueTree& tree)
+    {
+        const auto nodeOffset = (uint32) out.getPosition();
+        const auto numProperties = tree.getNumProperties();
+        const auto numChildren = tree.getNumChildren();
+
+        out.writeInt ((int) getStringIndex (tree.getType()));
+        out.writeInt (numProperties);
+        out.writeInt (numChildren);
+
+        const auto propertyTable = out.getPosition();
+        const auto childTable = propertyTable + 8 * numProperties;
+
+        for (int i = 0; i < 2 * numProperties + numChildren; ++i)
+            out.writeInt (0);
+
+        for (int i = 0; i < numProperties; ++i)
+        {
+            auto name = tree.getPropertyName (i);
+            writeAt (propertyTable + 8 * i, getStringIndex (name));
+            writeAt (propertyTable + 8 * i + 4, (uint32) out.getPosition());
+            tree.getProperty (name).writeToStream (out);
+        }
+
+        while (out.getPosition() % 4 != 0)
+            out.writeByte (0);
+
+        for (int i = 0; i < numChildren; ++i)
+            writeAt (childTable + 4 * i, writeNode (tree.getChild (i)));
+
+        return nodeOffset;
+    }
+};
+
+bool ValueTreeSnapshot::writeToStream (const ValueTree& tree, OutputStream& output)
+{
+    // You can't write an invalid tree!
+    jassert (tree.isValid());
+
+    return tree.isValid() && ValueTreeSnapshotWriter().write (tree, output);
+}
+
+//==============================================================================
+ValueTreeSnapshot::ValueTreeSnapshot (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    open (mappedFile->getData(), mappedFile->getSize());
+}
+
+ValueTreeSnapshot::ValueTreeSnapshot (const void* d, size_t numBytes)
+{
+    open (d, numBytes);
+}
+
+ValueTreeSnapshot::ValueTreeSnapshot (MemoryBlock&& block)
+    : ownedData (std::move (block))
+{
+    open (ownedData.getData(), ownedData.getSize());
+}
+
+ValueTreeSnapshot::~ValueTreeSnapshot() = default;
+
+void ValueTreeSnapshot::open (const void* d, size_t numBytes)
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    data = static_cast<const uint8*> (d);
+    size = numBytes;
+
+    auto isValidFormat = [this]
+    {
+        if (data == nullptr || size < headerSize
+             || readUint32 (0) != magic || readUint32 (4) != version || readUint32 (8) != size)
+            return false;
+
+        const auto stringTableOffset = readUint32 (16);
+        rootOffset = readUint32 (12);
+
+        if (rootOffset < headerSize || (uint64) stringTableOffset + 4 > size)
+            return false;
+
+        const auto numStrings = readUint32 (stringTableOffset);
+
+        if ((uint64) stringTableOffset + 4 + 4 * (uint64) numStrings > size)
+            return false;
+
+        identifiers.ensureStorageAllocated ((int) numStrings);
+
+        for (uint32 i = 0; i < numStrings; ++i)
+        {
+            const auto stringOffset = readUint32 (stringTableOffset + 4 + 4 * i);
+
+            if (stringOffset >= size)
+                return false;
+
+            auto* start = reinterpret_cast<const char*> (data + stringOffset);
+            auto* end = static_cast<const char*> (std::memchr (start, 0, size - stringOffset));
+
+            if (end == nullptr || end == start || ! CharPointer_UTF8::isValidString (start, (int) (end - start)))
+                return false;
+
+            identifiers.add (String::fromUTF8 (start, (int) (end - start)));
+        }
+
+        return getRoot().isValid();
+    };
+
+    if (! isValidFormat())
+    {
+        data = nullptr;
+        size = 0;
+        identifiers.clear();
+    }
+}
+
+uint32 ValueTreeSnapshot::readUint32 (size_t position) const noexcept
+{
+    jassert (position + 4 <= size);
+    return ByteOrder::littleEndianInt (data + position);
+}
+
+const Identifier& ValueTreeSnapshot::getIdentifier (uint32 index) const noexcept
+{
+    static const Identifier none;
+
+    return index < (uint32) identifiers.size() ? identifiers.getReference ((int) index) : none;
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::getRoot() const noexcept
+{
+    return isValid() ? Node (*this, rootOffset) : Node();
+}
+
+var ValueTreeSnapshot::decodeValue (uint32 valueOffset) const
+{
+    // The value starts with its size, in the format written by OutputStream::writeCompressedInt().
+    // This is checked here, so that damaged data can't make var::readFromStream() read too far.
+    if (valueOffset >= size)
+        return {};
+
+    const auto sizeByte = data[valueOffset];
+    const auto numSizeBytes = (size_t) (sizeByte & 0x7f);
+    const auto start = (size_t) valueOffset + 1 + numSizeBytes;
+
+    if ((sizeByte & 0x80) != 0 || numSizeBytes > 4 || start > size)
+        return {};
+
+    size_t numBytes = 0;
+
+    for (size_t i = numSizeBytes; i > 0; --i)
+        numBytes = (numBytes << 8) | data[valueOffset + i];
+
+    if (numBytes == 0 || numBytes > size - start)
+        return {};
+
+    // Strings are by far the most common kind of value, so they're decoded directly
+    if (data[start] == 5 /* varMarker_String */)
+    {
+        auto* text = reinterpret_cast<const char*> (data + start + 1);
+        auto length = numBytes - 1;
+
+        while (length > 0 && text[length - 1] == 0)
+            --length;
+
+        if (! CharPointer_UTF8::isValidString (text, (int) length))
+            return {};
+
+        return String::fromUTF8 (text, (int) length);
+    }
+
+    MemoryInputStream in (data + valueOffset, start + numBytes - valueOffset, false);
+    return var::readFromStream (in);
+}
+
+ValueTree ValueTreeSnapshot::decode (const Node& node) const
+{
+    ValueTree tree (node.getType());
+
+    for (int i = 0; i < node.getNumProperties(); ++i)
+    {
+        auto name = node.getPropertyName (i);
+
+        if (! name.isNull())
+            tree.setProperty (name, node.getProperty (name), nullptr);
+    }
+
+    for (int i = 0; i < node.getNumChildren(); ++i)
+        if (auto child = node.getChild (i))
+            tree.appendChild (decode (child), nullptr);
+
+    return tree;
+}
+
+//==============================================================================
+ValueTreeSnapshot::Node::Node (const ValueTreeSnapshot& s, uint32 offsetOfNode) noexcept
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    if ((uint64) offsetOfNode + nodeHeaderSize > s.size)
+        return;
+
+    const auto numProps = s.readUint32 (offsetOfNode + 4);
+    const auto numKids  = s.readUint32 (offsetOfNode + 8);
+
+    if (s.getIdentifier (s.readUint32 (offsetOfNode)).isNull()
+         || (uint64) offsetOfNode + nodeHeaderSize + 8 * (uint64) numProps + 4 * (uint64) numKids > s.size
+         || numProps > (uint32) std::numeric_limits<int>::max()
+         || numKids > (uint32) std::numeric_limits<int>::max())
+        return;
+
+    owner = &s;
+    offset = offsetOfNode;
+    numProperties = numProps;
+    numChildren = numKids;
+}
+
+Identifier ValueTreeSnapshot::Node::getType() const
+{
+    return owner != nullptr ? owner->getIdentifier (owner->readUint32 (offset)) : Identifier();
+}
+
+bool ValueTreeSnapshot::Node::hasType (const Identifier& typeName) const
+{
+    return owner != nullptr && owner->getIdentifier (owner->readUint32 (offset)) == typeName;
+}
+
+int ValueTreeSnapshot::Node::getNumProperties() const noexcept
+{
+    return (int) numProperties;
+}
+
+const uint8* ValueTreeSnapshot::Node::getPropertyEntry (int index) const noexcept
+{
+    return owner->data + offset + ValueTreeSnapshotFormat::nodeHeaderSize + 8 * (size_t) index;
+}
+
+Identifier ValueTreeSnapshot::Node::getPropertyName (int index) const
+{
+    if (! isPositiveAndBelow (index, getNumProperties()))
+        return {};
+
+    return owner->getIdentifier (ByteOrder::littleEndianInt (getPropertyEntry (index)));
+}
+
+bool ValueTreeSnapshot::Node::hasProperty (const Identifier& name) const
+{
+    for (int i = 0; i < getNumProperties(); ++i)
+        if (owner->getIdentifier (ByteOrder::littleEndianInt (getPropertyEntry (i))) == name)
+            return true;
+
+    return false;
+}
+
+var ValueTreeSnapshot::Node::getProperty (const Identifier& name) const
+{
+    return getProperty (name, {});
+}
+
+var ValueTreeSnapshot::Node::getProperty (const Identifier& name, const var& defaultReturnValue) const
+{
+    for (int i = 0; i < getNumProperties(); ++i)
+    {
+        auto* entry = getPropertyEntry (i);
+
+        if (owner->getIdentifier (ByteOrder::littleEndianInt (entry)) == name)
+        {
+            return owner->decodeValue (ByteOrder::littleEndianInt (entry + 4));
+        }
+    }
+
+    return defaultReturnValue;
+}
+
+int ValueTreeSnapshot::Node::getNumChildren() const noexcept
+{
+    return (int) numChildren;
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::Node::getChild (int index) const noexcept
+{
+    if (! isPositiveAndBelow (index, getNumChildren()))
+        return {};
+
+    const auto childOffset = ByteOrder::littleEndianInt (getPropertyEntry (getNumProperties()) + 4 * (size_t) index);
+
+    return childOffset > offset ? Node (*owner, childOffset) : Node();
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::Node::getChildWithName (const Identifier& type) const
+{
+    for (int i = 0; i < getNumChildren(); ++i)
+        if (auto child = getChild (i))
+            if (child.hasType (type))
+                return child;
+
+    return {};
+}
+
+ValueTree ValueTreeSnapshot::Node::getValueTree() const
+{
+    if (owner == nullptr)
+        return {};
+
+    auto& tree = owner->decodedTrees[offset];
+
+    if (! tree.isValid())
+        tree = owner->decode (*this);
+
+    return tree;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSnapshotTests  : public UnitTest
+{
+public:
+    ValueTreeSnapshotTests()
+        : UnitTest ("ValueTreeSnapshot", UnitTestCategories::values)
+    {}
+
+    static ValueTree createRandomTree (Random& r, int depth)
+    {
+        static const Identifier types[] = { "node", "track", "clip", "marker" };
+        static const Identifier names[] = { "name", "colour", "gain", "enabled", "data", "position" };
+
+        ValueTree tree (types[r.nextInt (numElementsInArray (types))]);
+
+        for (int i = r.nextInt (5); --i >= 0;)
+        {
+            auto& propertyName = names[r.nextInt (numElementsInArray (names))];
+
+            switch (r.nextInt (5))
+            {
+                case 0:  tree.setProperty (propertyName, r.nextInt(), nullptr); break;
+                case 1:  tree.setProperty (propertyName, r.nextDouble(), nullptr); break;
+                case 2:  tree.setProperty (propertyName, r.nextBool(), nullptr); break;
+                case 3:  tree.setProperty (propertyName, "text " + String (r.nextInt64()) + String::charToString (0x20ac), nullptr); break;
+                case 4:  { MemoryBlock m ((size_t) r.nextInt (20)); r.fillBitsRandomly (m.getData(), m.getSize()); tree.setProperty (propertyName, m, nullptr); } break;
+                default: break;
+            }
+        }
+
+        if (depth < 4)
+            for (int i = r.nextInt (6); --i >= 0;)
+                tree.appendChild (createRandomTree (r, depth + 1), nullptr);
+
+        return tree;
+    }
+
+    void expectMatches (const ValueTreeSnapshot::Node& node, const ValueTree& tree)
+    {
+        expect (node.isValid());
+        expect (node.getType() == tree.getType() && node.hasType (tree.getType()));
+        expectEquals (node.getNumProperties(), tree.getNumProperties());
+        expectEquals (node.getNumChildren(), tree.getNumChildren());
+
+        for (int i = 0; i < tree.getNumProperties(); ++i)
+        {
+            auto propertyName = tree.getPropertyName (i);
+            expect (node.getPropertyName (i) == propertyName && node.hasProperty (propertyName));
+            expect (node[propertyName] == tree[propertyName]);
+        }
+
+        for (int i = 0; i < tree.getNumChildren(); ++i)
+            expectMatches (node.getChild (i), tree.getChild (i));
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Round trip");
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                auto tree = createRandomTree (r, 0);
+
+                MemoryOutputStream out;
+                expect (ValueTreeSnapshot::writeToStream (tree, out));
+
+                ValueTreeSnapshot snapshot (out.getData(), out.getDataSize());
+                expect (snapshot.isValid());
+                expectMatches (snapshot.getRoot(), tree);
+
+                auto root = snapshot.getRoot();
+                expect (root.getValueTree().isEquivalentTo (tree));
+                expect (root.getValueTree() == root.getValueTree());
+                expect (! root.hasProperty ("missing") && root.getProperty ("missing", 42) == var (42));
+                expect (! root.getChild (-1).isValid() && ! root.getChild (root.getNumChildren()).isValid());
+                expect (! root.getChildWithName ("missing").isValid());
+
+                if (tree.getNumChildren() > 0)
+                {
+                    auto child = root.getChildWithName (tree.getChild (0).getType());
+                    expect (child.getValueTree().isEquivalentTo (tree.getChildWithName (tree.getChild (0).getType())));
+                }
+            }
+        }
+
+        beginTest ("Memory-mapped files");
+        {
+            auto tree = createRandomTree (r, 0);
+            TemporaryFile temp;
+
+            {
+                FileOutputStream out (temp.getFile());
+                expect (out.openedOk() && ValueTreeSnapshot::writeToStream (tree, out));
+            }
+
+            ValueTreeSnapshot snapshot (temp.getFile());
+            expect (snapshot.isValid());
+            expectMatches (snapshot.getRoot(), tree);
+
+            MemoryBlock block;
+            expect (temp.getFile().loadFileAsData (block));
+
+            ValueTreeSnapshot ownedSnapshot (std::move (block));
+            expectMatches (ownedSnapshot.getRoot(), tree);
+        }
+
+        beginTest ("Damaged data");
+        {
+            expect (! ValueTreeSnapshot (nullptr, 0).isValid());
+            expect (! ValueTreeSnapshot (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("missing", ".snapshot")).isValid());
+
+            auto tree = createRandomTree (r, 0);
+            MemoryOutputStream out;
+            ValueTreeSnapshot::writeToStream (tree, out);
+
+            expect (! ValueTreeSnapshot (out.getData(), out.getDataSize() - 1).isValid());
+
+            std::function<int (const ValueTreeSnapshot::Node&)> visit = [&] (const ValueTreeSnapshot::Node& node)
+            {
+                int numVisited = 1;
+
+                for (int i = 0; i < node.getNumProperties(); ++i)
+                    node.getProperty (node.getPropertyName (i));
+
+                for (int i = 0; i < node.getNumChildren(); ++i)
+                    if (auto child = node.getChild (i))
+                        numVisited += visit (child);
+
+                return numVisited;
+            };
+
+            for (int i = 0; i < 200; ++i)
+            {
+                MemoryBlock damaged (out.getData(), out.getDataSize());
+
+                for (int j = 1 + r.nextInt (8); --j >= 0;)
+                    damaged[r.nextInt ((int) damaged.getSize())] = (char) r.nextInt (256);
+
+                ValueTreeSnapshot snapshot (std::move (damaged));
+
+                if (auto root = snapshot.getRoot())
+                {
+                    visit (root);
+                    root.getValueTree();
+                }
+            }
+        }
+    }
+};
+
+static ValueTreeSnapshotTests valueTreeSnapshotTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of a ValueTree that has been saved in an indexed binary format.
+
+    ValueTree::readFromStream() and ValueTree::fromXml() have to parse a whole file
+    and create every node and property before any of it can be used, which can take
+    a long time for big documents. The format used by this class stores the offset
+    of every node, so a file can be memory-mapped and navigated straight away, and
+    only the parts that are actually visited ever get decoded.
+
+    To create the data, use writeToStream(). To read it, create a ValueTreeSnapshot
+    from a file, which will be memory-mapped, or from a block of memory, and then use
+    getRoot() to start navigating it:
+
+    @code
+    ValueTreeSnapshot snapshot (sessionFile);
+
+    if (auto tracks = snapshot.getRoot().getChildWithName ("TRACKS"))
+        for (int i = 0; i < tracks.getNumChildren(); ++i)
+            DBG (tracks.getChild (i)["name"].toString());
+    @endcode
+
+    When you need a real ValueTree that can be edited or listened to, call
+    Node::getValueTree(), which only decodes the subtree that you ask for.
+
+    The file format is little-endian and uses 32-bit offsets, so it can hold up to
+    4GB of data. The values of the properties are stored in the same format as
+    var::writeToStream().
+
+    @see ValueTree::writeToStream, MemoryMappedFile
+
+    @tags{DataStructures}
+*/
+class JUCE_API  ValueTreeSnapshot
+{
+public:
+    //==============================================================================
+    /** Memory-maps a file that was created with writeToStream().
+
+        If the file can't be opened or doesn't contain a valid snapshot, isValid()
+        will return false. The file mustn't be modified while the snapshot exists.
+    */
+    explicit ValueTreeSnapshot (const File& file);
+
+    /** Creates a snapshot that refers to some data that was created with writeToStream().
+
+        The data isn't copied, so it must stay valid for as long as this object and any
+        Nodes that were taken from it exist.
+    */
+    ValueTreeSnapshot (const void* data, size_t numBytes);
+
+    /** Creates a snapshot that takes ownership of a block of data that was created
+        with writeToStream().
+    */
+    explicit ValueTreeSnapshot (MemoryBlock&& data);
+
+    /** Destructor. */
+    ~ValueTreeSnapshot();
+
+    /** Returns true if the data was opened successfully and has a valid header. */
+    bool isValid() const noexcept                   { return data != nullptr; }
+
+    //==============================================================================
+    /** Writes a ValueTree to a stream in the format that this class reads.
+        Returns false if the stream couldn't be written to, or if the tree is too big
+        for the format.
+    */
+    static bool writeToStream (const ValueTree& tree, OutputStream& output);
+
+    //==============================================================================
+    /**
+        A lightweight reference to one of the nodes in a ValueTreeSnapshot.
+
+        Nodes are cheap to copy, and must not outlive the snapshot that they came from.
+        If the snapshot's data is damaged, the methods will return empty nodes and
+        values rather than reading outside the data.
+    */
+    class JUCE_API  Node
+    {
+    public:
+        /** Creates an invalid node. */
+        Node() = default;
+
+        /** Returns true if this refers to a node in a snapshot. */
+        bool isValid() const noexcept                       { return owner != nullptr; }
+
+        /** Returns true if this refers to a node in a snapshot. */
+        explicit operator bool() const noexcept             { return isValid(); }
+
+        /** Returns the node's type. */
+        Identifier getType() const;
+
+        /** Returns true if the node has the given type. */
+        bool hasType (const Identifier& typeName) const;
+
+        //==============================================================================
+        /** Returns the number of properties that the node has. */
+        int getNumProperties() const noexcept;
+
+        /** Returns the name of one of the node's properties. */
+        Identifier getPropertyName (int index) const;
+
+        /** Returns true if the node has a property with this name. */
+        bool hasProperty (const Identifier& name) const;
+
+        /** Decodes and returns the value of a property, or a void var if the node
+            doesn't have a property with this name.
+        */
+        var getProperty (const Identifier& name) const;
+
+        /** Decodes and returns the value of a property, or the given default if the
+            node doesn't have a property with this name.
+        */
+        var getProperty (const Identifier& name, const var& defaultReturnValue) const;
+
+        /** Decodes and returns the value of a property. */
+        var operator[] (const Identifier& name) const       { return getProperty (name); }
+
+        //==============================================================================
+        /** Returns the number of children that the node has. */
+        int getNumChildren() const noexcept;
+
+        /** Returns one of the node's children, or an invalid node if the index is out of range. */
+        Node getChild (int index) const noexcept;
+
+        /** Returns the first child with the given type, or an invalid node if there isn't one. */
+        Node getChildWithName (const Identifier& type) const;
+
+        //==============================================================================
+        /** Returns a ValueTree that contains this node and all of its children.
+
+            The subtree is decoded the first time this is called for a node, and the
+            same ValueTree is returned by later calls, so that any changes you make to
+            it are kept. Trees that are returned for a node and one of its children are
+            separate copies, though.
+
+            This mustn't be called by more than one thread at once.
+        */
+        ValueTree getValueTree() const;
+
+    private:
+        friend class ValueTreeSnapshot;
+
+        Node (const ValueTreeSnapshot& s, uint32 offsetOfNode) noexcept;
+
+        const uint8* getPropertyEntry (int index) const noexcept;
+
+        const ValueTreeSnapshot* owner = nullptr;
+        uint32 offset = 0, numProperties = 0, numChildren = 0;
+    };
+
+    //==============================================================================
+    /** Returns the root node, or an invalid node if the snapshot isn't valid. */
+    Node getRoot() const noexcept;
+
+private:
+    //==============================================================================
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    MemoryBlock ownedData;
+    const uint8* data = nullptr;
+    size_t size = 0;
+    uint32 rootOffset = 0;
+    Array<Identifier> identifiers;
+    mutable std::unordered_map<uint32, ValueTree> decodedTrees;
+
+    void open (const void*, size_t);
+    const Identifier& getIdentifier (uint32 index) const noexcept;
+    uint32 readUint32 (size_t position) const noexcept;
+    var decodeValue (uint32 offset) const;
+    ValueTree decode (const Node&) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ValueTreeSnapshot)
+};
+
+} // namespace juce
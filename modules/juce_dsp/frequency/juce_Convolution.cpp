@@ -197,7 +197,7 @@ struct ConvolutionEngine
                                          static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
 
             FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
-            prepareForConvolution (impulseResponse);
+            prepareForConvolution (impulseResponse, fftSize);
 
             currentPtr += (fftSize - blockSize);
         }
@@ -242,7 +242,7 @@ struct ConvolutionEngine
             FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
             fftObject->performRealOnlyForwardTransform (inputSegmentData);
-            prepareForConvolution (inputSegmentData);
+            prepareForConvolution (inputSegmentData, fftSize);
 
             // Complex multiplication
             if (inputDataWasEmpty)
@@ -260,7 +260,8 @@ struct ConvolutionEngine
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
                                                         buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
+                                                        outputTempData,
+                                                        fftSize);
                 }
             }
 
@@ -268,9 +269,10 @@ struct ConvolutionEngine
 
             convolutionProcessingAndAccumulate (inputSegmentData,
                                                 buffersImpulseSegments.front().getWritePointer (0),
-                                                outputData);
+                                                outputData,
+                                                fftSize);
 
-            updateSymmetricFrequencyDomainData (outputData);
+            updateSymmetricFrequencyDomainData (outputData, fftSize);
             fftObject->performRealOnlyInverseTransform (outputData);
 
             // Add overlap
@@ -330,7 +332,7 @@ struct ConvolutionEngine
                 FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
                 fftObject->performRealOnlyForwardTransform (inputSegmentData);
-                prepareForConvolution (inputSegmentData);
+                prepareForConvolution (inputSegmentData, fftSize);
 
                 // Complex multiplication
                 FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
@@ -346,16 +348,18 @@ struct ConvolutionEngine
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
                                                         buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
+                                                        outputTempData,
+                                                        fftSize);
                 }
 
                 FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
                 convolutionProcessingAndAccumulate (inputSegmentData,
                                                     buffersImpulseSegments.front().getWritePointer (0),
-                                                    outputData);
+                                                    outputData,
+                                                    fftSize);
 
-                updateSymmetricFrequencyDomainData (outputData);
+                updateSymmetricFrequencyDomainData (outputData, fftSize);
                 fftObject->performRealOnlyInverseTransform (outputData);
 
                 // Add overlap
@@ -378,7 +382,7 @@ struct ConvolutionEngine
     }
 
     // After each FFT, this function is called to allow convolution to be performed with only 4 SIMD functions calls.
-    void prepareForConvolution (float *samples) noexcept
+    static void prepareForConvolution (float* samples, size_t fftSize) noexcept
     {
         auto FFTSizeDiv2 = fftSize / 2;
 
@@ -392,7 +396,7 @@ struct ConvolutionEngine
     }
 
     // Does the convolution operation itself only on half of the frequency domain samples.
-    void convolutionProcessingAndAccumulate (const float *input, const float *impulse, float *output)
+    static void convolutionProcessingAndAccumulate (const float* input, const float* impulse, float* output, size_t fftSize) noexcept
     {
         auto FFTSizeDiv2 = fftSize / 2;
 
@@ -408,7 +412,7 @@ struct ConvolutionEngine
     // Undoes the re-organization of samples from the function prepareForConvolution.
     // Then takes the conjugate of the frequency domain first half of samples to fill the
     // second half, so that the inverse transform will return real samples in the time domain.
-    void updateSymmetricFrequencyDomainData (float* samples) noexcept
+    static void updateSymmetricFrequencyDomainData (float* samples, size_t fftSize) noexcept
     {
         auto FFTSizeDiv2 = fftSize / 2;
 
@@ -439,6 +443,208 @@ struct ConvolutionEngine
     std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 };
 
+//==============================================================================
+class BackgroundConvolutionWorkers;
+
+// A section of the impulse response which is convolved on a background thread.
+//
+// The stage is given the part of the IR that starts 2 * partitionSize samples in.
+// Each time a partition's worth of input has arrived, it is handed to a worker thread,
+// which then has until the end of the following partition to compute the result. The
+// result is then played back during the partition after that, which lines it up
+// exactly with its offset in the IR, so no latency is added.
+class BackgroundConvolutionStage
+{
+public:
+    BackgroundConvolutionStage (std::unique_ptr<ConvolutionEngine> engineIn, int partitionSizeIn)
+        : engine (std::move (engineIn)),
+          partitionSize ((size_t) partitionSizeIn),
+          inputBuffers  (2, partitionSizeIn),
+          outputBuffers (2, partitionSizeIn)
+    {
+        inputBuffers.clear();
+        outputBuffers.clear();
+    }
+
+    // Called on the audio thread to add this stage's output to the output buffer
+    void processSamples (const float* input, float* output, size_t numSamples,
+                         int64 blockStartTime, BackgroundConvolutionWorkers& workers);
+
+    // Called on the audio thread
+    void reset()
+    {
+        waitForJobToFinish();
+
+        engine->reset();
+        inputBuffers.clear();
+        outputBuffers.clear();
+        position = 0;
+        currentIndex = 0;
+    }
+
+    // Called by the workers to find the most urgent job
+    bool isQueued() const noexcept          { return state.load() == queued; }
+    int64 getDeadline() const noexcept      { return deadline.load(); }
+
+    // Returns true if the caller now owns the queued job, and must call runJob()
+    bool tryToStartJob() noexcept
+    {
+        auto expected = queued;
+        return state.compare_exchange_strong (expected, running);
+    }
+
+    void runJob() noexcept
+    {
+        const auto jobIndex = 1 - currentIndex;
+
+        engine->processSamples (inputBuffers.getReadPointer (jobIndex),
+                                outputBuffers.getWritePointer (jobIndex),
+                                partitionSize);
+
+        state = idle;
+        jobFinished.signal();
+    }
+
+private:
+    void waitForJobToFinish() noexcept
+    {
+        // If none of the workers has got round to this job yet, it's quicker to do it here
+        if (tryToStartJob())
+        {
+            runJob();
+            return;
+        }
+
+        while (state.load() != idle)
+            jobFinished.wait (-1);
+    }
+
+    enum State { idle, queued, running };
+
+    std::unique_ptr<ConvolutionEngine> engine;
+    const size_t partitionSize;
+
+    // The audio thread fills the input buffer and plays the output buffer at currentIndex,
+    // while the job reads and writes the other ones.
+    AudioBuffer<float> inputBuffers, outputBuffers;
+    size_t position = 0;
+    int currentIndex = 0;
+
+    std::atomic<State> state { idle };
+    std::atomic<int64> deadline { 0 };
+    WaitableEvent jobFinished;
+};
+
+// A set of threads which compute the jobs from a set of BackgroundConvolutionStages,
+// always picking the one whose result will be needed soonest.
+class BackgroundConvolutionWorkers
+{
+public:
+    BackgroundConvolutionWorkers (std::vector<BackgroundConvolutionStage*> stagesIn, int numThreads)
+        : stages (std::move (stagesIn))
+    {
+        for (int i = 0; i < numThreads; ++i)
+            workers.emplace_back (std::make_unique<Worker> (*this, i));
+
+        for (auto& w : workers)
+            w->startThread (Thread::realtimeAudioPriority);
+    }
+
+    ~BackgroundConvolutionWorkers()
+    {
+        for (auto& w : workers)
+            w->signalThreadShouldExit();
+
+        notify();
+
+        for (auto& w : workers)
+            w->stopThread (-1);
+    }
+
+    // Wakes the workers up when a new job has been queued
+    void notify() noexcept
+    {
+        for (auto& w : workers)
+            w->workAvailable.signal();
+    }
+
+private:
+    struct Worker  : public Thread
+    {
+        Worker (BackgroundConvolutionWorkers& o, int index)
+            : Thread ("Convolution worker " + String (index)), owner (o)
+        {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                if (auto* stage = owner.findMostUrgentStage())
+                {
+                    if (stage->tryToStartJob())
+                        stage->runJob();
+                }
+                else
+                {
+                    workAvailable.wait (-1);
+                }
+            }
+        }
+
+        BackgroundConvolutionWorkers& owner;
+        WaitableEvent workAvailable;
+    };
+
+    BackgroundConvolutionStage* findMostUrgentStage() const noexcept
+    {
+        BackgroundConvolutionStage* best = nullptr;
+
+        for (auto* stage : stages)
+            if (stage->isQueued() && (best == nullptr || stage->getDeadline() < best->getDeadline()))
+                best = stage;
+
+        return best;
+    }
+
+    const std::vector<BackgroundConvolutionStage*> stages;
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+void BackgroundConvolutionStage::processSamples (const float* input, float* output, size_t numSamples,
+                                                 int64 blockStartTime, BackgroundConvolutionWorkers& workers)
+{
+    size_t numSamplesProcessed = 0;
+
+    while (numSamplesProcessed < numSamples)
+    {
+        auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, partitionSize - position);
+
+        FloatVectorOperations::copy (inputBuffers.getWritePointer (currentIndex, (int) position),
+                                     input + numSamplesProcessed, (int) numSamplesToProcess);
+
+        FloatVectorOperations::add (output + numSamplesProcessed,
+                                    outputBuffers.getReadPointer (currentIndex, (int) position),
+                                    (int) numSamplesToProcess);
+
+        position += numSamplesToProcess;
+        numSamplesProcessed += numSamplesToProcess;
+
+        if (position == partitionSize)
+        {
+            // The previous job's result is needed for the next partition, and the input
+            // that has just been collected becomes the next job
+            waitForJobToFinish();
+
+            position = 0;
+            currentIndex = 1 - currentIndex;
+
+            deadline = blockStartTime + (int64) (numSamplesProcessed + partitionSize);
+            state = queued;
+            workers.notify();
+        }
+    }
+}
+
 //==============================================================================
 class MultichannelEngine
 {
@@ -468,6 +674,39 @@ public:
             for (int i = 0; i < numChannels; ++i)
                 head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<uint32> (maxBufferSize)));
         }
+        else if (headSizeIn.numBackgroundThreads > 0 && isZeroDelay)
+        {
+            // The head covers the first two partitions of the first stage, then each stage's
+            // partitions are four times larger than the last, up to maxPartitionSize
+            constexpr auto maxPartitionSize = 16384;
+
+            auto partitionSize = jmax (headSizeIn.headSizeInSamples, nextPowerOfTwo (maxBufferSize));
+            auto offset = jmin (buf.getNumSamples(), 2 * partitionSize);
+
+            for (int i = 0; i < numChannels; ++i)
+                head.emplace_back (makeEngine (i, 0, offset, static_cast<uint32> (maxBufferSize)));
+
+            backgroundStages.resize (numChannels);
+            std::vector<BackgroundConvolutionStage*> allStages;
+
+            for (; offset < buf.getNumSamples(); partitionSize *= 4)
+            {
+                const auto length = partitionSize * 4 > maxPartitionSize ? buf.getNumSamples() - offset
+                                                                         : jmin (buf.getNumSamples() - offset, 6 * partitionSize);
+
+                for (int i = 0; i < numChannels; ++i)
+                {
+                    backgroundStages[(size_t) i].push_back (std::make_unique<BackgroundConvolutionStage> (makeEngine (i, offset, length, static_cast<uint32> (partitionSize)),
+                                                                                                          partitionSize));
+                    allStages.push_back (backgroundStages[(size_t) i].back().get());
+                }
+
+                offset += length;
+            }
+
+            if (! allStages.empty())
+                workers = std::make_unique<BackgroundConvolutionWorkers> (allStages, jmin (headSizeIn.numBackgroundThreads, (int) allStages.size()));
+        }
         else
         {
             const auto size = jmin (buf.getNumSamples(), headSizeIn.headSizeInSamples);
@@ -490,6 +729,12 @@ public:
 
         for (const auto& e : tail)
             e->reset();
+
+        for (const auto& channelStages : backgroundStages)
+            for (const auto& stage : channelStages)
+                stage->reset();
+
+        sampleTime = 0;
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
@@ -501,13 +746,29 @@ public:
         const auto tailBlock = fullTailBlock.getSubBlock (0, (size_t) numSamples);
 
         const auto isUniform = tail.empty();
+        const auto hasBackgroundStages = workers != nullptr;
 
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
+            // The tail must read the input before the head overwrites it, in case the
+            // processing is in-place
             if (! isUniform)
+            {
                 tail[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
                                                                tailBlock.getChannelPointer (0),
                                                                numSamples);
+            }
+            else if (hasBackgroundStages)
+            {
+                tailBlock.clear();
+
+                for (const auto& stage : backgroundStages[channel])
+                    stage->processSamples (input.getChannelPointer (channel),
+                                           tailBlock.getChannelPointer (0),
+                                           numSamples,
+                                           sampleTime,
+                                           *workers);
+            }
 
             if (isZeroDelay)
                 head[channel]->processSamples (input.getChannelPointer (channel),
@@ -518,10 +779,12 @@ public:
                                                                output.getChannelPointer (channel),
                                                                numSamples);
 
-            if (! isUniform)
+            if (! isUniform || hasBackgroundStages)
                 output.getSingleChannelBlock (channel) += tailBlock;
         }
 
+        sampleTime += (int64) numSamples;
+
         const auto numOutputChannels = output.getNumChannels();
 
         for (auto i = numChannels; i < numOutputChannels; ++i)
@@ -534,6 +797,9 @@ public:
 
 private:
     std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
+    std::vector<std::vector<std::unique_ptr<BackgroundConvolutionStage>>> backgroundStages;
+    std::unique_ptr<BackgroundConvolutionWorkers> workers;
+    int64 sampleTime = 0;
     AudioBuffer<float> tailBuffer;
 
     const int latency;
@@ -733,7 +999,8 @@ public:
     ConvolutionEngineFactory (Convolution::Latency requiredLatency,
                               Convolution::NonUniform requiredHeadSize)
         : latency  { (requiredLatency.latencyInSamples   <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredLatency.latencyInSamples)) },
-          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)) },
+          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)),
+                     requiredHeadSize.numBackgroundThreads },
           shouldBeZeroLatency (requiredLatency.latencyInSamples == 0)
     {}
 
@@ -1293,5 +1560,307 @@ int Convolution::getCurrentIRSize() const { return pimpl->getCurrentIRSize(); }
 
 int Convolution::getLatency() const { return pimpl->getLatency(); }
 
+//==============================================================================
+class MatrixConvolution::Impl
+{
+public:
+    void loadImpulseResponses (const AudioBuffer<float>& impulseResponses, int numIns, int numOuts)
+    {
+        // The buffer must contain one impulse response for each input/output pair
+        jassert (numIns >= 0 && numOuts >= 0 && impulseResponses.getNumChannels() == numIns * numOuts);
+
+        irs.makeCopyOf (impulseResponses);
+        numInputs = numIns;
+        numOutputs = numOuts;
+
+        if (maxBlockSize > 0)
+            build();
+    }
+
+    void prepare (const ProcessSpec& spec)
+    {
+        maxBlockSize = (int) spec.maximumBlockSize;
+        build();
+    }
+
+    void reset() noexcept
+    {
+        inputBuffers.clear();
+        inputSegments.clear();
+        outputBuffers.clear();
+        tempOutputBuffers.clear();
+        overlapBuffers.clear();
+
+        currentSegment = 0;
+        inputDataPos = 0;
+    }
+
+    void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output, bool isBypassed) noexcept
+    {
+        const auto numSamples = jmin (input.getNumSamples(), output.getNumSamples());
+        const auto numChannelsIn = jmin ((size_t) numInputs, input.getNumChannels());
+        const auto numChannelsOut = jmin ((size_t) numOutputs, output.getNumChannels());
+
+        if (isBypassed || fftObject == nullptr)
+        {
+            // If you hit this, you need to call prepare() before processing!
+            jassert (isBypassed);
+
+            const auto numToCopy = jmin (input.getNumChannels(), output.getNumChannels());
+
+            for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
+            {
+                auto outputChannel = output.getSingleChannelBlock (channel).getSubBlock (0, numSamples);
+
+                if (channel >= numToCopy)
+                    outputChannel.clear();
+                else if (input.getChannelPointer (channel) != output.getChannelPointer (channel))
+                    outputChannel.copyFrom (input.getSingleChannelBlock (channel).getSubBlock (0, numSamples));
+            }
+
+            return;
+        }
+
+        const auto hop = (fftSize - blockSize) / blockSize;
+        size_t numSamplesProcessed = 0;
+
+        while (numSamplesProcessed < numSamples)
+        {
+            const bool inputDataWasEmpty = (inputDataPos == 0);
+            auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
+
+            // Each input is only transformed once, however many outputs it feeds. All
+            // the inputs are read before any outputs are written, so that the processing
+            // can be done in-place.
+            for (auto channel : usedInputs)
+            {
+                auto* inputData = inputBuffers.getWritePointer (channel);
+
+                if ((size_t) channel < numChannelsIn)
+                    FloatVectorOperations::copy (inputData + inputDataPos,
+                                                 input.getChannelPointer ((size_t) channel) + numSamplesProcessed,
+                                                 static_cast<int> (numSamplesToProcess));
+
+                auto* inputSegmentData = getInputSegment (channel, currentSegment);
+                FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
+
+                fftObject->performRealOnlyForwardTransform (inputSegmentData);
+                ConvolutionEngine::prepareForConvolution (inputSegmentData, fftSize);
+            }
+
+            for (size_t channel = 0; channel < numChannelsOut; ++channel)
+            {
+                const auto& paths = pathsForOutput[channel];
+                auto* outputChannel = output.getChannelPointer (channel) + numSamplesProcessed;
+
+                if (paths.empty())
+                {
+                    FloatVectorOperations::clear (outputChannel, static_cast<int> (numSamplesToProcess));
+                    continue;
+                }
+
+                auto* outputTempData = tempOutputBuffers.getWritePointer ((int) channel);
+                auto* outputData     = outputBuffers.getWritePointer ((int) channel);
+                auto* overlapData    = overlapBuffers.getWritePointer ((int) channel);
+
+                // The contributions from earlier partitions only change once per block
+                if (inputDataWasEmpty)
+                {
+                    FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+
+                    for (const auto& path : paths)
+                    {
+                        auto index = currentSegment;
+
+                        for (int i = 1; i < path.segments.getNumChannels(); ++i)
+                        {
+                            index += hop;
+
+                            if (index >= numInputSegments)
+                                index -= numInputSegments;
+
+                            ConvolutionEngine::convolutionProcessingAndAccumulate (getInputSegment (path.input, index),
+                                                                                   path.segments.getReadPointer (i),
+                                                                                   outputTempData,
+                                                                                   fftSize);
+                        }
+                    }
+                }
+
+                FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+
+                for (const auto& path : paths)
+                    ConvolutionEngine::convolutionProcessingAndAccumulate (getInputSegment (path.input, currentSegment),
+                                                                           path.segments.getReadPointer (0),
+                                                                           outputData,
+                                                                           fftSize);
+
+                // All the paths to this output share a single inverse transform
+                ConvolutionEngine::updateSymmetricFrequencyDomainData (outputData, fftSize);
+                fftObject->performRealOnlyInverseTransform (outputData);
+
+                FloatVectorOperations::add (outputChannel, &outputData[inputDataPos], &overlapData[inputDataPos], (int) numSamplesToProcess);
+            }
+
+            inputDataPos += numSamplesToProcess;
+
+            if (inputDataPos == blockSize)
+            {
+                for (auto channel : usedInputs)
+                    FloatVectorOperations::fill (inputBuffers.getWritePointer (channel), 0.0f, static_cast<int> (fftSize));
+
+                for (size_t channel = 0; channel < numChannelsOut; ++channel)
+                {
+                    if (pathsForOutput[channel].empty())
+                        continue;
+
+                    auto* outputData  = outputBuffers.getWritePointer ((int) channel);
+                    auto* overlapData = overlapBuffers.getWritePointer ((int) channel);
+
+                    FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+                    FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+                }
+
+                inputDataPos = 0;
+                currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
+            }
+
+            numSamplesProcessed += numSamplesToProcess;
+        }
+
+        for (auto channel = numChannelsOut; channel < output.getNumChannels(); ++channel)
+            output.getSingleChannelBlock (channel).getSubBlock (0, numSamples).clear();
+    }
+
+    int getNumInputs() const noexcept       { return numInputs; }
+    int getNumOutputs() const noexcept      { return numOutputs; }
+    int getCurrentIRSize() const noexcept   { return irs.getNumSamples(); }
+
+    int getNumActivePaths() const noexcept
+    {
+        int result = 0;
+
+        for (const auto& paths : pathsForOutput)
+            result += (int) paths.size();
+
+        return result;
+    }
+
+private:
+    struct Path
+    {
+        int input;
+        AudioBuffer<float> segments;
+    };
+
+    void build()
+    {
+        blockSize = (size_t) nextPowerOfTwo (maxBlockSize);
+        fftSize = blockSize > 128 ? 2 * blockSize : 4 * blockSize;
+        fftObject = std::make_unique<FFT> (roundToInt (std::log2 (fftSize)));
+
+        const auto segmentLength = fftSize - blockSize;
+        size_t maxNumSegments = 1;
+
+        pathsForOutput.clear();
+        pathsForOutput.resize ((size_t) numOutputs);
+        usedInputs.clear();
+
+        for (int out = 0; out < numOutputs; ++out)
+        {
+            for (int in = 0; in < numInputs; ++in)
+            {
+                const auto* ir = irs.getReadPointer (out * numInputs + in);
+
+                // Silent paths are left out, and trailing silence doesn't need any segments
+                auto length = (size_t) irs.getNumSamples();
+
+                while (length > 0 && ir[length - 1] == 0.0f)
+                    --length;
+
+                if (length == 0)
+                    continue;
+
+                const auto numSegments = length / segmentLength + 1;
+                maxNumSegments = jmax (maxNumSegments, numSegments);
+
+                Path path { in, AudioBuffer<float> ((int) numSegments, (int) fftSize * 2) };
+                path.segments.clear();
+
+                for (size_t i = 0; i < numSegments; ++i)
+                {
+                    auto* segment = path.segments.getWritePointer ((int) i);
+                    const auto offset = i * segmentLength;
+
+                    FloatVectorOperations::copy (segment, ir + offset, static_cast<int> (jmin (segmentLength, length - offset)));
+
+                    fftObject->performRealOnlyForwardTransform (segment);
+                    ConvolutionEngine::prepareForConvolution (segment, fftSize);
+                }
+
+                pathsForOutput[(size_t) out].push_back (std::move (path));
+
+                if (std::find (usedInputs.begin(), usedInputs.end(), in) == usedInputs.end())
+                    usedInputs.push_back (in);
+            }
+        }
+
+        numInputSegments = (segmentLength / blockSize) * maxNumSegments;
+
+        inputBuffers     .setSize (numInputs, (int) fftSize);
+        inputSegments    .setSize (numInputs * (int) numInputSegments, (int) fftSize * 2);
+        outputBuffers    .setSize (numOutputs, (int) fftSize * 2);
+        tempOutputBuffers.setSize (numOutputs, (int) fftSize * 2);
+        overlapBuffers   .setSize (numOutputs, (int) fftSize);
+
+        reset();
+    }
+
+    float* getInputSegment (int input, size_t segment) noexcept
+    {
+        return inputSegments.getWritePointer (input * (int) numInputSegments + (int) segment);
+    }
+
+    //==============================================================================
+    AudioBuffer<float> irs;
+    int numInputs = 0, numOutputs = 0, maxBlockSize = 0;
+
+    size_t blockSize = 0, fftSize = 0, numInputSegments = 0;
+    size_t currentSegment = 0, inputDataPos = 0;
+    std::unique_ptr<FFT> fftObject;
+
+    std::vector<std::vector<Path>> pathsForOutput;
+    std::vector<int> usedInputs;
+
+    AudioBuffer<float> inputBuffers, inputSegments, outputBuffers, tempOutputBuffers, overlapBuffers;
+};
+
+//==============================================================================
+MatrixConvolution::MatrixConvolution()
+    : pimpl (std::make_unique<Impl>())
+{}
+
+MatrixConvolution::~MatrixConvolution() noexcept = default;
+
+void MatrixConvolution::loadImpulseResponses (const AudioBuffer<float>& impulseResponses, int numInputs, int numOutputs)
+{
+    pimpl->loadImpulseResponses (impulseResponses, numInputs, numOutputs);
+}
+
+void MatrixConvolution::prepare (const ProcessSpec& spec)    { pimpl->prepare (spec); }
+void MatrixConvolution::reset() noexcept                     { pimpl->reset(); }
+
+void MatrixConvolution::processSamples (const AudioBlock<const float>& input,
+                                        AudioBlock<float>& output,
+                                        bool isBypassed) noexcept
+{
+    pimpl->processSamples (input, output, isBypassed);
+}
+
+int MatrixConvolution::getNumInputs() const noexcept         { return pimpl->getNumInputs(); }
+int MatrixConvolution::getNumOutputs() const noexcept        { return pimpl->getNumOutputs(); }
+int MatrixConvolution::getNumActivePaths() const noexcept    { return pimpl->getNumActivePaths(); }
+int MatrixConvolution::getCurrentIRSize() const noexcept     { return pimpl->getCurrentIRSize(); }
+
 } // namespace dsp
 } // namespace juce
@@ -87,8 +87,9 @@ private:
     Note: The default operation of this class uses zero latency and a uniform
     partitioned algorithm. If the impulse response size is large, or if the
     algorithm is too CPU intensive, it is possible to use either a fixed
-    latency version of the algorithm, or a simple non-uniform partitioned
-    convolution algorithm.
+    latency version of the algorithm, or a non-uniform partitioned convolution
+    algorithm, which can optionally process the later parts of the impulse
+    response on background threads.
 
     Threading: It is not safe to interleave calls to the methods of this
     class. If you need to load new impulse responses during processing the
@@ -131,7 +132,17 @@ public:
     explicit Convolution (const Latency& requiredLatency);
 
     /** Contains configuration information for a non-uniform convolution. */
-    struct NonUniform { int headSizeInSamples; };
+    struct NonUniform
+    {
+        /** The size of the part of the IR that is processed with the smallest partitions. */
+        int headSizeInSamples;
+
+        /** If this is greater than zero, the IR after the head is split into several
+            stages with increasingly large partitions, which are processed on this many
+            background threads rather than on the audio thread.
+        */
+        int numBackgroundThreads = 0;
+    };
 
     /** Initialises an object for performing convolution in the frequency domain
         using a non-uniform partitioned algorithm.
@@ -140,8 +151,24 @@ public:
         efficiency of the processing for IR sizes of 4096 samples or greater
         (recommended for reverberation IRs).
 
-        @param requiredHeadSize       the head IR size for two stage non-uniform
-                                      partitioned convolution
+        By default, the convolution is split into two stages: a head which is
+        processed in partitions of the block size, and a tail which is processed
+        in partitions of the head size.
+
+        If numBackgroundThreads is greater than zero, the part of the IR after the
+        first two head-sized partitions is split into stages whose partition sizes
+        grow by a factor of four each time, up to 16384 samples. Each stage's partitions
+        are computed by background threads, which have a whole partition's worth of
+        time to finish before their results are needed, and the threads always work on
+        the most urgent partition first. The output is identical to that of the other
+        algorithms and there's still no added latency, but the audio thread only has
+        to do the work for the head, which makes this the best choice for very long
+        IRs used with small block sizes. If a background thread falls behind, the audio
+        thread will wait for it, or compute the partition itself if no thread has
+        started on it yet.
+
+        @param requiredHeadSize       the head IR size and number of background threads
+                                      for non-uniform partitioned convolution
      */
     explicit Convolution (const NonUniform& requiredHeadSize);
 
@@ -306,5 +333,100 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Convolution)
 };
 
+//==============================================================================
+/**
+    Performs a matrix of convolutions, in which each output channel is the sum
+    of several input channels convolved with their own impulse responses.
+
+    This is useful for things like true-stereo reverbs and binaural or ambisonic
+    decoders, where every input channel feeds several outputs. Using one Convolution
+    per path would transform each input channel once for every output it feeds,
+    and then transform every path's result back again. This class transforms each
+    input channel only once per partition, accumulates all the paths that lead to an
+    output in the frequency domain, and then does a single inverse transform per output.
+
+    The processing uses the same zero latency uniform partitioned algorithm as the
+    default Convolution mode, but unlike the Convolution class it doesn't do any
+    resampling, trimming or normalisation of the impulse responses, and doesn't
+    crossfade when they change. Loading new impulse responses isn't thread safe, so
+    it mustn't happen while process() might be called.
+
+    @tags{DSP}
+*/
+class JUCE_API  MatrixConvolution
+{
+public:
+    //==============================================================================
+    /** Creates a matrix convolution with no impulse responses loaded. */
+    MatrixConvolution();
+
+    /** Destructor. */
+    ~MatrixConvolution() noexcept;
+
+    //==============================================================================
+    /** Loads the impulse responses for the whole matrix.
+
+        The buffer must contain numInputs * numOutputs channels, where channel
+        (outputChannel * numInputs + inputChannel) holds the impulse response of the
+        path from that input to that output. Channels which are entirely silent are
+        skipped during processing, so sparse matrices only pay for the paths they use.
+
+        The impulse responses are copied and aren't resampled, so they should already
+        be at the sample rate that will be used for processing.
+
+        This allocates memory, and must not be called concurrently with process().
+    */
+    void loadImpulseResponses (const AudioBuffer<float>& impulseResponses, int numInputs, int numOutputs);
+
+    /** Must be called before first calling process.
+
+        This allocates memory, and must not be called concurrently with process().
+    */
+    void prepare (const ProcessSpec&);
+
+    /** Resets the processing pipeline ready to start a new stream of data. */
+    void reset() noexcept;
+
+    /** Performs the convolution.
+
+        The input block should have getNumInputs() channels, and the output block
+        getNumOutputs() channels. Any missing input channels are treated as silent,
+        and any extra output channels are cleared. The context may be replacing,
+        even if the number of inputs and outputs are different. If the context is
+        bypassed, each input channel is copied to the output with the same index.
+    */
+    template <typename ProcessContext,
+              std::enable_if_t<std::is_same<typename ProcessContext::SampleType, float>::value, int> = 0>
+    void process (const ProcessContext& context) noexcept
+    {
+        processSamples (context.getInputBlock(), context.getOutputBlock(), context.isBypassed);
+    }
+
+    //==============================================================================
+    /** Returns the number of input channels of the current matrix. */
+    int getNumInputs() const noexcept;
+
+    /** Returns the number of output channels of the current matrix. */
+    int getNumOutputs() const noexcept;
+
+    /** Returns the number of paths that are actually processed, i.e. the number
+        of impulse responses which aren't silent.
+    */
+    int getNumActivePaths() const noexcept;
+
+    /** Returns the length of the longest impulse response in the matrix. */
+    int getCurrentIRSize() const noexcept;
+
+private:
+    //==============================================================================
+    void processSamples (const AudioBlock<const float>&, AudioBlock<float>&, bool isBypassed) noexcept;
+
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MatrixConvolution)
+};
+
 } // namespace dsp
 } // namespace juce
@@ -548,6 +548,26 @@ public:
             }
         }
 
+        beginTest ("Multi-threaded non-uniform convolutions work");
+        {
+            const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 80);
+
+            for (auto headSize : { spec.maximumBlockSize / 2, spec.maximumBlockSize * 3 })
+            {
+                for (auto numThreads : { 1, 3 })
+                {
+                    testConvolution (spec,
+                                     Convolution::NonUniform { static_cast<int> (headSize), numThreads },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::yes,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
+            }
+        }
+
         beginTest ("Convolutions with latency work");
         {
             const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 8);
@@ -569,6 +589,71 @@ public:
                                  ramp);
             }
         }
+
+        beginTest ("Matrix convolutions match the direct convolution of each path");
+        {
+            constexpr int numInputs = 3, numOutputs = 2, irLength = 700, signalLength = 3000;
+
+            Random random (0x1234);
+
+            AudioBuffer<float> irs (numInputs * numOutputs, irLength);
+
+            for (auto channel = 0; channel != irs.getNumChannels(); ++channel)
+                for (auto sample = 0; sample != irLength; ++sample)
+                    irs.setSample (channel, sample, random.nextFloat() - 0.5f);
+
+            // A silent path, and a path which is much shorter than the others
+            irs.clear (1, 0, irLength);
+            irs.clear (4, 100, irLength - 100);
+
+            AudioBuffer<float> signal (numInputs, signalLength);
+
+            for (auto channel = 0; channel != numInputs; ++channel)
+                for (auto sample = 0; sample != signalLength; ++sample)
+                    signal.setSample (channel, sample, random.nextFloat() - 0.5f);
+
+            AudioBuffer<float> expected (numOutputs, signalLength);
+            expected.clear();
+
+            for (auto out = 0; out != numOutputs; ++out)
+                for (auto in = 0; in != numInputs; ++in)
+                    for (auto sample = 0; sample != signalLength; ++sample)
+                        for (auto tap = 0; tap <= jmin (sample, irLength - 1); ++tap)
+                            expected.addSample (out, sample, irs.getSample (out * numInputs + in, tap)
+                                                               * signal.getSample (in, sample - tap));
+
+            for (auto maxBlockSize : { 64, 256, 512 })
+            {
+                MatrixConvolution matrix;
+                matrix.loadImpulseResponses (irs, numInputs, numOutputs);
+                matrix.prepare ({ spec.sampleRate, (uint32) maxBlockSize, (uint32) numInputs });
+
+                expectEquals (matrix.getNumActivePaths(), numInputs * numOutputs - 1);
+
+                // The processing is done in-place, with a buffer wide enough for the inputs
+                AudioBuffer<float> output (numInputs, signalLength);
+                output.makeCopyOf (signal);
+
+                for (int start = 0; start < signalLength;)
+                {
+                    const auto numSamples = jmin (signalLength - start, random.nextInt ({ 1, maxBlockSize + 1 }));
+
+                    auto subBlock = AudioBlock<float> (output).getSubBlock ((size_t) start, (size_t) numSamples);
+                    matrix.process (ProcessContextReplacing<float> (subBlock));
+
+                    start += numSamples;
+                }
+
+                for (auto out = 0; out != numOutputs; ++out)
+                    for (auto sample = 0; sample != signalLength; ++sample)
+                        nonAllocatingExpectWithinAbsoluteError (output.getSample (out, sample),
+                                                                expected.getSample (out, sample),
+                                                                1.0e-3f);
+
+                // Output channels without any paths are cleared
+                expectEquals (output.getMagnitude (numOutputs, 0, signalLength), 0.0f);
+            }
+        }
     }
 };
 
@@ -431,6 +431,384 @@ struct FFTFallback  : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+/*  A self-contained engine which is used whenever none of the platform libraries
+    are available.
+
+    Complex transforms are done with an iterative radix-2^2 decimation-in-time
+    algorithm, working on split real/imaginary scratch buffers so that each
+    butterfly can be computed several at a time with SIMDRegister. Real transforms
+    use a complex transform of half the size plus a post-processing pass.
+
+    All the twiddle factors are calculated in advance, and each call uses its own
+    scratch space, so a single instance can be used by several threads at once.
+*/
+struct FFTRadix4  : public FFT::Instance
+{
+    // this should have a higher priority than the fallback, but lower than any platform library
+    static constexpr int priority = 0;
+
+    static FFTRadix4* create (int order)
+    {
+        return new FFTRadix4 (order);
+    }
+
+    FFTRadix4 (int order)
+        : size (1 << order),
+          complexPlan (order),
+          realPlan (jmax (0, order - 1)),
+          realTwiddles ((size_t) (size / 2 + 1))
+    {
+        for (int k = 0; k <= size / 2; ++k)
+        {
+            auto phase = -MathConstants<double>::twoPi * k / size;
+            realTwiddles[k] = { (float) std::cos (phase), (float) std::sin (phase) };
+        }
+    }
+
+    void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept override
+    {
+        withScratchSpace (size, [&] (float* re, float* im)
+        {
+            auto* bitReversed = complexPlan.bitReversed.getData();
+
+            for (int i = 0; i < size; ++i)
+            {
+                re[bitReversed[i]] = input[i].real();
+                im[bitReversed[i]] = input[i].imag();
+            }
+
+            // An inverse transform is a forward transform with the real and imaginary parts swapped
+            if (inverse)
+                complexPlan.perform (im, re);
+            else
+                complexPlan.perform (re, im);
+
+            auto scale = inverse ? 1.0f / (float) size : 1.0f;
+
+            for (int i = 0; i < size; ++i)
+                output[i] = { re[i] * scale, im[i] * scale };
+        });
+    }
+
+    void performRealOnlyForwardTransform (float* d, bool onlyCalculateNonNegativeFrequencies) const noexcept override
+    {
+        // A single sample transforms to itself, with no imaginary part
+        if (size == 1)
+        {
+            d[1] = 0.0f;
+            return;
+        }
+
+        const auto half = size / 2;
+
+        withScratchSpace (half, [&] (float* re, float* im)
+        {
+            // Treat the even and odd samples as the real and imaginary parts of a half-size signal
+            auto* bitReversed = realPlan.bitReversed.getData();
+
+            for (int i = 0; i < half; ++i)
+            {
+                re[bitReversed[i]] = d[2 * i];
+                im[bitReversed[i]] = d[2 * i + 1];
+            }
+
+            realPlan.perform (re, im);
+
+            auto* out = reinterpret_cast<Complex<float>*> (d);
+            out[0]    = { re[0] + im[0], 0.0f };
+            out[half] = { re[0] - im[0], 0.0f };
+
+            for (int k = 1; k < half; ++k)
+            {
+                // even = (Z[k] + conj (Z[half - k])) / 2, odd = (Z[k] - conj (Z[half - k])) / 2i
+                auto evenRe = 0.5f * (re[k] + re[half - k]);
+                auto evenIm = 0.5f * (im[k] - im[half - k]);
+                auto oddRe  = 0.5f * (im[k] + im[half - k]);
+                auto oddIm  = 0.5f * (re[half - k] - re[k]);
+
+                auto w = realTwiddles[k];
+                out[k] = { evenRe + w.real() * oddRe - w.imag() * oddIm,
+                           evenIm + w.real() * oddIm + w.imag() * oddRe };
+            }
+
+            if (! onlyCalculateNonNegativeFrequencies)
+                for (int k = 1; k < half; ++k)
+                    out[size - k] = std::conj (out[k]);
+        });
+    }
+
+    void performRealOnlyInverseTransform (float* d) const noexcept override
+    {
+        if (size == 1)
+        {
+            d[1] = 0.0f;
+            return;
+        }
+
+        const auto half = size / 2;
+
+        withScratchSpace (half, [&] (float* re, float* im)
+        {
+            auto* in = reinterpret_cast<const Complex<float>*> (d);
+            auto* bitReversed = realPlan.bitReversed.getData();
+
+            for (int k = 0; k < half; ++k)
+            {
+                auto x = in[k];
+                auto y = in[half - k];
+
+                // even = (X[k] + conj (X[half - k])) / 2, odd = (X[k] - conj (X[half - k])) * conj (w) / 2
+                auto evenRe = 0.5f * (x.real() + y.real());
+                auto evenIm = 0.5f * (x.imag() - y.imag());
+                auto diffRe = 0.5f * (x.real() - y.real());
+                auto diffIm = 0.5f * (x.imag() + y.imag());
+
+                auto w = realTwiddles[k];
+                auto oddRe = diffRe * w.real() + diffIm * w.imag();
+                auto oddIm = diffIm * w.real() - diffRe * w.imag();
+
+                re[bitReversed[k]] = evenRe - oddIm;
+                im[bitReversed[k]] = evenIm + oddRe;
+            }
+
+            realPlan.perform (im, re);
+
+            auto scale = 1.0f / (float) half;
+
+            for (int i = 0; i < half; ++i)
+            {
+                d[2 * i]     = re[i] * scale;
+                d[2 * i + 1] = im[i] * scale;
+            }
+        });
+    }
+
+    //==============================================================================
+    static constexpr size_t maxFFTScratchSpaceToAlloca = 256 * 1024;
+    static constexpr size_t alignment = 64;
+
+    /*  Calls the function with two aligned scratch buffers, each big enough for
+        the given number of floats.
+    */
+    template <typename Fn>
+    static void withScratchSpace (int numElements, Fn&& fn) noexcept
+    {
+        const auto bufferSize = ((size_t) numElements + alignment - 1) & ~(alignment - 1);
+        const auto scratchSize = alignment + 2 * bufferSize * sizeof (float);
+
+        if (scratchSize < maxFFTScratchSpaceToAlloca)
+        {
+            JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6255)
+            auto* scratch = snapPointerToAlignment (static_cast<float*> (alloca (scratchSize)), alignment);
+            JUCE_END_IGNORE_WARNINGS_MSVC
+            fn (scratch, scratch + bufferSize);
+        }
+        else
+        {
+            HeapBlock<char> heapSpace (scratchSize);
+            auto* scratch = snapPointerToAlignment (unalignedPointerCast<float*> (heapSpace.getData()), alignment);
+            fn (scratch, scratch + bufferSize);
+        }
+    }
+
+    //==============================================================================
+    struct ScalarOps
+    {
+        using Type = float;
+        static constexpr int width = 1;
+
+        static Type load (const float* p) noexcept              { return *p; }
+        static void store (float* p, Type v) noexcept           { *p = v; }
+    };
+
+   #if JUCE_USE_SIMD
+    struct VectorOps
+    {
+        using Type = SIMDRegister<float>;
+        static constexpr int width = (int) Type::size();
+
+        static Type load (const float* p) noexcept              { return Type::fromRawArray (p); }
+        static void store (float* p, Type v) noexcept           { v.copyToRawArray (p); }
+    };
+   #else
+    using VectorOps = ScalarOps;
+   #endif
+
+    //==============================================================================
+    /*  The twiddle factors and bit-reversal table for a complex transform of one size. */
+    struct Plan
+    {
+        explicit Plan (int orderToUse)
+            : order (orderToUse), size (1 << orderToUse), bitReversed ((size_t) size)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                int reversed = 0;
+
+                for (int bit = 0; bit < order; ++bit)
+                    reversed |= ((i >> bit) & 1) << (order - 1 - bit);
+
+                bitReversed[i] = reversed;
+            }
+
+            // The first stage doesn't need any twiddles, so only the later ones are stored
+            size_t totalTwiddles = 0;
+
+            for (int length = firstTwiddledLength(); length < size; length *= 4)
+                totalTwiddles += 6 * paddedLength (length);
+
+            twiddleStorage.malloc (totalTwiddles + alignment / sizeof (float));
+            twiddles = snapPointerToAlignment (twiddleStorage.getData(), alignment);
+
+            auto* tw = twiddles;
+
+            for (int length = firstTwiddledLength(); length < size; length *= 4)
+            {
+                const auto padded = paddedLength (length);
+
+                for (int k = 0; k < length; ++k)
+                {
+                    for (int q = 1; q <= 3; ++q)
+                    {
+                        auto phase = -MathConstants<double>::twoPi * q * k / (4 * length);
+                        tw[(size_t) (2 * q - 2) * padded + (size_t) k] = (float) std::cos (phase);
+                        tw[(size_t) (2 * q - 1) * padded + (size_t) k] = (float) std::sin (phase);
+                    }
+                }
+
+                tw += 6 * padded;
+            }
+        }
+
+        /*  Performs an in-place forward transform on data that has already
+            been put into bit-reversed order.
+        */
+        void perform (float* re, float* im) const noexcept
+        {
+            if (size == 1)
+                return;
+
+            if ((order & 1) != 0)
+                firstRadix2Stage (re, im);
+            else
+                firstRadix4Stage (re, im);
+
+            auto* tw = twiddles;
+
+            for (int length = firstTwiddledLength(); length < size; length *= 4)
+            {
+                if (length >= VectorOps::width)
+                    radix4Stage<VectorOps> (re, im, length, tw, paddedLength (length));
+                else
+                    radix4Stage<ScalarOps> (re, im, length, tw, paddedLength (length));
+
+                tw += 6 * paddedLength (length);
+            }
+        }
+
+        int firstTwiddledLength() const noexcept    { return (order & 1) != 0 ? 2 : 4; }
+
+        static size_t paddedLength (int length) noexcept
+        {
+            return ((size_t) length + alignment / sizeof (float) - 1) & ~(alignment / sizeof (float) - 1);
+        }
+
+        void firstRadix2Stage (float* re, float* im) const noexcept
+        {
+            for (int i = 0; i < size; i += 2)
+            {
+                auto r = re[i + 1], m = im[i + 1];
+                re[i + 1] = re[i] - r;  im[i + 1] = im[i] - m;
+                re[i] += r;             im[i] += m;
+            }
+        }
+
+        /*  Within each group of four blocks, the blocks hold the transforms of the elements
+            whose indices are 0, 2, 1 and 3 (mod 4), because the data is in bit-reversed order.
+        */
+        void firstRadix4Stage (float* re, float* im) const noexcept
+        {
+            for (int i = 0; i < size; i += 4)
+            {
+                auto* r = re + i;
+                auto* m = im + i;
+
+                auto s0r = r[0] + r[1], s0i = m[0] + m[1];
+                auto s1r = r[0] - r[1], s1i = m[0] - m[1];
+                auto s2r = r[2] + r[3], s2i = m[2] + m[3];
+                auto s3r = r[2] - r[3], s3i = m[2] - m[3];
+
+                r[0] = s0r + s2r;  m[0] = s0i + s2i;
+                r[2] = s0r - s2r;  m[2] = s0i - s2i;
+                r[1] = s1r + s3i;  m[1] = s1i - s3r;
+                r[3] = s1r - s3i;  m[3] = s1i + s3r;
+            }
+        }
+
+        template <typename Ops>
+        void radix4Stage (float* re, float* im, int length, const float* tw, size_t padded) const noexcept
+        {
+            using V = typename Ops::Type;
+
+            const auto* w1r = tw;
+            const auto* w1i = tw + padded;
+            const auto* w2r = tw + 2 * padded;
+            const auto* w2i = tw + 3 * padded;
+            const auto* w3r = tw + 4 * padded;
+            const auto* w3i = tw + 5 * padded;
+
+            for (int block = 0; block < size; block += 4 * length)
+            {
+                auto* r0 = re + block;  auto* r1 = r0 + length;  auto* r2 = r1 + length;  auto* r3 = r2 + length;
+                auto* i0 = im + block;  auto* i1 = i0 + length;  auto* i2 = i1 + length;  auto* i3 = i2 + length;
+
+                for (int k = 0; k < length; k += Ops::width)
+                {
+                    const V a0r = Ops::load (r0 + k), a0i = Ops::load (i0 + k);
+                    const V a1r = Ops::load (r1 + k), a1i = Ops::load (i1 + k);
+                    const V a2r = Ops::load (r2 + k), a2i = Ops::load (i2 + k);
+                    const V a3r = Ops::load (r3 + k), a3i = Ops::load (i3 + k);
+
+                    const V c1r = Ops::load (w1r + k), c1i = Ops::load (w1i + k);
+                    const V c2r = Ops::load (w2r + k), c2i = Ops::load (w2i + k);
+                    const V c3r = Ops::load (w3r + k), c3i = Ops::load (w3i + k);
+
+                    // As in firstRadix4Stage, the second and third blocks are swapped
+                    const V f1r = a2r * c1r - a2i * c1i,  f1i = a2r * c1i + a2i * c1r;
+                    const V f2r = a1r * c2r - a1i * c2i,  f2i = a1r * c2i + a1i * c2r;
+                    const V f3r = a3r * c3r - a3i * c3i,  f3i = a3r * c3i + a3i * c3r;
+
+                    const V s0r = a0r + f2r, s0i = a0i + f2i;
+                    const V s1r = a0r - f2r, s1i = a0i - f2i;
+                    const V s2r = f1r + f3r, s2i = f1i + f3i;
+                    const V s3r = f1r - f3r, s3i = f1i - f3i;
+
+                    Ops::store (r0 + k, s0r + s2r);  Ops::store (i0 + k, s0i + s2i);
+                    Ops::store (r2 + k, s0r - s2r);  Ops::store (i2 + k, s0i - s2i);
+                    Ops::store (r1 + k, s1r + s3i);  Ops::store (i1 + k, s1i - s3r);
+                    Ops::store (r3 + k, s1r - s3i);  Ops::store (i3 + k, s1i + s3r);
+                }
+            }
+        }
+
+        const int order, size;
+        HeapBlock<int> bitReversed;
+        HeapBlock<float> twiddleStorage;
+        float* twiddles = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Plan)
+    };
+
+    //==============================================================================
+    const int size;
+    Plan complexPlan, realPlan;
+    HeapBlock<Complex<float>> realTwiddles;
+};
+
+FFT::EngineImpl<FFTRadix4> fftRadix4;
+
 //==============================================================================
 //==============================================================================
 #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
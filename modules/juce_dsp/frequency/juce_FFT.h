@@ -31,9 +31,12 @@ namespace dsp
 /**
     Performs a fast fourier transform.
 
-    This is only a simple low-footprint implementation and isn't tuned for speed - it may
-    be useful for simple applications where one of the more complex FFT libraries would be
-    overkill. (But in the future it may end up becoming optimised of course...)
+    If one of the supported platform libraries (vDSP, FFTW, MKL or IPP) is available it
+    will be used, otherwise a built-in radix-4 engine is used, which takes advantage of
+    SIMD instructions where the platform supports them.
+
+    The built-in engine doesn't use any locks or shared scratch space, so a single FFT
+    object that uses it can be shared between several threads.
 
     The FFT class itself contains lookup tables, so there's some overhead in creating
     one, you should create and cache an FFT object for each size/direction of transform
@@ -196,6 +196,115 @@ struct FFTUnitTest  : public UnitTest
         }
     };
 
+    struct BuiltInEngineTest
+    {
+        template <typename Type>
+        static bool checkArrayIsSimilar (const Type* a, const Type* b, size_t n, float tolerance) noexcept
+        {
+            for (size_t i = 0; i < n; ++i)
+                if (std::abs (a[i] - b[i]) > tolerance)
+                    return false;
+
+            return true;
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 0; order <= 16; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+                const auto tolerance = 1.0e-4f * std::sqrt ((float) n) + 1.0e-5f;
+
+                FFTFallback reference (order);
+                FFTRadix4 engine (order);
+
+                HeapBlock<Complex<float>> input (n), expected (n), output (n);
+                fillRandom (random, input.getData(), n);
+
+                for (auto inverse : { false, true })
+                {
+                    reference.perform (input.getData(), expected.getData(), inverse);
+                    engine.perform (input.getData(), output.getData(), inverse);
+                    u.expect (checkArrayIsSimilar (output.getData(), expected.getData(), n, tolerance));
+                }
+
+                // the transform should also work in-place
+                memcpy (output.getData(), input.getData(), n * sizeof (Complex<float>));
+                engine.perform (output.getData(), output.getData(), false);
+                reference.perform (input.getData(), expected.getData(), false);
+                u.expect (checkArrayIsSimilar (output.getData(), expected.getData(), n, tolerance));
+
+                std::vector<float> realInput (n * 2, 0.0f);
+                fillRandom (random, realInput.data(), n);
+
+                auto realExpected = realInput, realOutput = realInput;
+                reference.performRealOnlyForwardTransform (realExpected.data(), false);
+                engine.performRealOnlyForwardTransform (realOutput.data(), false);
+                u.expect (checkArrayIsSimilar (realOutput.data(), realExpected.data(), n * 2, tolerance));
+
+                engine.performRealOnlyInverseTransform (realOutput.data());
+                u.expect (checkArrayIsSimilar (realOutput.data(), realInput.data(), n, 1.0e-4f));
+            }
+
+            // a single sample has no imaginary part, whatever was in the second half of the array
+            FFTRadix4 engine (0);
+            float data[] = { 0.5f, 123.0f };
+
+            engine.performRealOnlyForwardTransform (data, false);
+            u.expect (data[0] == 0.5f && data[1] == 0.0f);
+
+            data[1] = 123.0f;
+            engine.performRealOnlyInverseTransform (data);
+            u.expect (data[0] == 0.5f && data[1] == 0.0f);
+        }
+    };
+
+    struct ConcurrentUseTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            constexpr int order = 12, numThreads = 4, numIterations = 50;
+            constexpr auto n = (size_t) 1 << order;
+
+            Random random (378272);
+            FFTRadix4 engine (order);
+
+            std::vector<float> input (n * 2, 0.0f);
+            fillRandom (random, input.data(), n);
+
+            auto expected = input;
+            engine.performRealOnlyForwardTransform (expected.data(), false);
+
+            std::atomic<int> numMismatches { 0 };
+
+            {
+                ThreadPool pool (numThreads);
+
+                for (int t = 0; t < numThreads; ++t)
+                {
+                    pool.addJob ([&]
+                    {
+                        for (int i = 0; i < numIterations; ++i)
+                        {
+                            auto data = input;
+                            engine.performRealOnlyForwardTransform (data.data(), false);
+
+                            if (data != expected)
+                                ++numMismatches;
+                        }
+                    });
+                }
+
+                while (pool.getNumJobs() > 0)
+                    Thread::sleep (1);
+            }
+
+            u.expectEquals (numMismatches.load(), 0);
+        }
+    };
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -209,6 +318,8 @@ struct FFTUnitTest  : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<BuiltInEngineTest> ("Built-in engine matches the fallback engine");
+        runTestForAllTypes<ConcurrentUseTest> ("Built-in engine can be used by several threads at once");
     }
 };
 
@@ -145,6 +145,114 @@ double LookupTableTransform<FloatType>::calculateRelativeDifference (double x, d
     return absDiff / std::min (absX, absY);
 }
 
+//==============================================================================
+namespace LookupTableHelpers
+{
+    template <typename FloatType, LookupTableInterpolation interpolation, bool clampInput>
+    static void processBlock (const FloatType* table, FloatType scaler, FloatType offset,
+                              FloatType minInputValue, FloatType maxInputValue,
+                              const FloatType* input, FloatType* output, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if JUCE_USE_SIMD
+        using Lanes = SIMDRegister<FloatType>;
+        constexpr auto numLanes = Lanes::SIMDNumElements;
+        constexpr auto numTaps = interpolation == LookupTableInterpolation::linear ? 2 : 4;
+        constexpr auto firstTap = interpolation == LookupTableInterpolation::linear ? 0 : -1;
+
+        const auto vScaler = Lanes::expand (scaler);
+        const auto vOffset = Lanes::expand (offset);
+        const auto vMin = Lanes::expand (minInputValue);
+        const auto vMax = Lanes::expand (maxInputValue);
+
+        alignas (Lanes) FloatType values[numLanes], taps[4][numLanes];
+
+        for (; i + numLanes <= numSamples; i += numLanes)
+        {
+            std::copy (input + i, input + i + numLanes, values);
+            auto x = Lanes::fromRawArray (values);
+
+            if (clampInput)
+                x = Lanes::min (Lanes::max (x, vMin), vMax);
+
+            const auto index = x * vScaler + vOffset;
+            const auto whole = Lanes::truncate (index);
+            const auto f = index - whole;
+
+            whole.copyToRawArray (values);
+
+            // The table is read one lane at a time, but everything else is done on
+            // all the lanes together
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                const auto* p = table + static_cast<int> (values[lane]) + firstTap;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                    taps[tap][lane] = p[tap];
+            }
+
+            Lanes result;
+
+            if (interpolation == LookupTableInterpolation::linear)
+            {
+                const auto p0 = Lanes::fromRawArray (taps[0]);
+                result = p0 + f * (Lanes::fromRawArray (taps[1]) - p0);
+            }
+            else
+            {
+                const auto pm1 = Lanes::fromRawArray (taps[0]);
+                const auto p0  = Lanes::fromRawArray (taps[1]);
+                const auto p1  = Lanes::fromRawArray (taps[2]);
+                const auto p2  = Lanes::fromRawArray (taps[3]);
+
+                const auto c1 = Lanes::expand (static_cast<FloatType> (0.5)) * (p1 - pm1);
+                const auto c2 = pm1 - Lanes::expand (static_cast<FloatType> (2.5)) * p0
+                                    + Lanes::expand (static_cast<FloatType> (2)) * p1
+                                    - Lanes::expand (static_cast<FloatType> (0.5)) * p2;
+                const auto c3 = Lanes::expand (static_cast<FloatType> (0.5)) * (p2 - pm1)
+                                    + Lanes::expand (static_cast<FloatType> (1.5)) * (p0 - p1);
+
+                result = ((c3 * f + c2) * f + c1) * f + p0;
+            }
+
+            result.copyToRawArray (values);
+            std::copy (values, values + numLanes, output + i);
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            auto x = clampInput ? jlimit (minInputValue, maxInputValue, input[i]) : input[i];
+            output[i] = interpolate<interpolation> (table, scaler * x + offset);
+        }
+    }
+
+    template <typename FloatType>
+    void process (const FloatType* table, LookupTableInterpolation interpolation,
+                  FloatType scaler, FloatType offset,
+                  FloatType minInputValue, FloatType maxInputValue, bool clampInput,
+                  const FloatType* input, FloatType* output, size_t numSamples) noexcept
+    {
+        constexpr auto linear = LookupTableInterpolation::linear;
+        constexpr auto cubic  = LookupTableInterpolation::cubic;
+
+        if (interpolation == linear)
+        {
+            if (clampInput) processBlock<FloatType, linear, true>  (table, scaler, offset, minInputValue, maxInputValue, input, output, numSamples);
+            else            processBlock<FloatType, linear, false> (table, scaler, offset, minInputValue, maxInputValue, input, output, numSamples);
+        }
+        else
+        {
+            if (clampInput) processBlock<FloatType, cubic, true>   (table, scaler, offset, minInputValue, maxInputValue, input, output, numSamples);
+            else            processBlock<FloatType, cubic, false>  (table, scaler, offset, minInputValue, maxInputValue, input, output, numSamples);
+        }
+    }
+
+    template void process<float>  (const float*,  LookupTableInterpolation, float,  float,  float,  float,  bool, const float*,  float*,  size_t) noexcept;
+    template void process<double> (const double*, LookupTableInterpolation, double, double, double, double, bool, const double*, double*, size_t) noexcept;
+}
+
 //==============================================================================
 template class LookupTable<float>;
 template class LookupTable<double>;
@@ -140,6 +140,9 @@ public:
     /** Returns true if the LookupTable is initialised and ready to be used. */
     bool isInitialised() const noexcept                         { return data.size() > 1; }
 
+    /** Returns the pre-calculated data points, followed by a copy of the last one. */
+    const FloatType* getRawData() const noexcept                { return data.begin(); }
+
 private:
     //==============================================================================
     Array<FloatType> data;
@@ -152,6 +155,57 @@ private:
 };
 
 
+//==============================================================================
+/** The kinds of interpolation that a FixedSizeLookupTableTransform can use.
+
+    @see FixedSizeLookupTableTransform
+
+    @tags{DSP}
+*/
+enum class LookupTableInterpolation
+{
+    linear,     /**< Interpolates linearly between the two nearest points. */
+    cubic       /**< Fits a Catmull-Rom spline through the four nearest points. */
+};
+
+//==============================================================================
+/** Used internally by the lookup tables to evaluate blocks of samples. */
+namespace LookupTableHelpers
+{
+    /** Interpolates a table at a fractional index.
+
+        For cubic interpolation, the table must have valid points at index - 1
+        and index + 2, and linear interpolation needs a point at index + 1.
+    */
+    template <LookupTableInterpolation interpolation, typename FloatType>
+    inline FloatType interpolate (const FloatType* table, FloatType index) noexcept
+    {
+        auto i = static_cast<int> (index);
+        auto f = index - static_cast<FloatType> (i);
+        const auto* p = table + i;
+
+        if (interpolation == LookupTableInterpolation::linear)
+            return p[0] + f * (p[1] - p[0]);
+
+        auto c1 = static_cast<FloatType> (0.5) * (p[1] - p[-1]);
+        auto c2 = p[-1] - static_cast<FloatType> (2.5) * p[0] + static_cast<FloatType> (2) * p[1] - static_cast<FloatType> (0.5) * p[2];
+        auto c3 = static_cast<FloatType> (0.5) * (p[2] - p[-1]) + static_cast<FloatType> (1.5) * (p[0] - p[1]);
+
+        return ((c3 * f + c2) * f + c1) * f + p[0];
+    }
+
+    /** Evaluates a table for a block of input values, several values at a time.
+
+        Each input value is mapped to an index with (input * scaler + offset). If
+        clampInput is true, the inputs are first limited to the given range.
+    */
+    template <typename FloatType>
+    void process (const FloatType* table, LookupTableInterpolation interpolation,
+                  FloatType scaler, FloatType offset,
+                  FloatType minInputValue, FloatType maxInputValue, bool clampInput,
+                  const FloatType* input, FloatType* output, size_t numSamples) noexcept;
+}
+
 //==============================================================================
 /** Class for approximating expensive arithmetic operations.
 
@@ -271,8 +325,8 @@ public:
     */
     void processUnchecked (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
     {
-        for (size_t i = 0; i < numSamples; ++i)
-            output[i] = processSampleUnchecked (input[i]);
+        LookupTableHelpers::process (lookupTable.getRawData(), LookupTableInterpolation::linear, scaler, offset,
+                                     minInputValue, maxInputValue, false, input, output, numSamples);
     }
 
     //==============================================================================
@@ -281,8 +335,8 @@ public:
     */
     void process (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
     {
-        for (size_t i = 0; i < numSamples; ++i)
-            output[i] = processSample (input[i]);
+        LookupTableHelpers::process (lookupTable.getRawData(), LookupTableInterpolation::linear, scaler, offset,
+                                     minInputValue, maxInputValue, true, input, output, numSamples);
     }
 
     //==============================================================================
@@ -326,5 +380,131 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LookupTableTransform)
 };
 
+//==============================================================================
+/** A lookup table for approximating a function over a range, with a size that's
+    fixed at compile time.
+
+    This works like LookupTableTransform, but the table lives inside the object
+    rather than on the heap, and the size and type of interpolation are template
+    parameters, so the compiler can specialise the code that reads it. If the
+    function can be called in a constant expression, the whole table can be
+    created at compile time:
+
+    @code
+    struct Square
+    {
+        constexpr float operator() (float x) const noexcept  { return x * x; }
+    };
+
+    static constexpr FixedSizeLookupTableTransform<float, 256> squareTable { Square{}, -1.0f, 1.0f };
+    @endcode
+
+    It can also be used as the function of a WaveShaper, which will then shape
+    whole blocks at a time with SIMD instructions:
+
+    @code
+    WaveShaper<float, FixedSizeLookupTableTransform<float, 1024, LookupTableInterpolation::cubic>> shaper
+        { { [] (float x) { return std::tanh (x); }, -5.0f, 5.0f } };
+    @endcode
+
+    @see LookupTableTransform, LookupTableInterpolation
+
+    @tags{DSP}
+*/
+template <typename FloatType, size_t numPoints, LookupTableInterpolation interpolation = LookupTableInterpolation::linear>
+class FixedSizeLookupTableTransform
+{
+public:
+    //==============================================================================
+    /** Creates the table.
+
+        @param functionToApproximate The function to be approximated. This should be a
+                                     mapping from a FloatType to FloatType.
+        @param minInputValueToUse    The lowest input value used.
+        @param maxInputValueToUse    The highest input value used.
+    */
+    template <typename Function>
+    constexpr FixedSizeLookupTableTransform (Function&& functionToApproximate,
+                                             FloatType minInputValueToUse,
+                                             FloatType maxInputValueToUse)
+        : minInputValue (minInputValueToUse),
+          maxInputValue (maxInputValueToUse),
+          scaler (static_cast<FloatType> (numPoints - 1) / (maxInputValueToUse - minInputValueToUse)),
+          offset (-minInputValueToUse * scaler)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+            data[i + 1] = functionToApproximate (i == numPoints - 1
+                                                   ? maxInputValueToUse
+                                                   : minInputValueToUse + (maxInputValueToUse - minInputValueToUse)
+                                                                            * static_cast<FloatType> (i) / static_cast<FloatType> (numPoints - 1));
+
+        // The guard points continue the first and last segments in a straight line,
+        // so the interpolation never reads outside the table
+        data[0] = 2 * data[1] - data[2];
+        data[numPoints + 1] = 2 * data[numPoints] - data[numPoints - 1];
+        data[numPoints + 2] = 2 * data[numPoints + 1] - data[numPoints];
+    }
+
+    //==============================================================================
+    /** Calculates the approximated value for the given input value without range checking.
+
+        Use this if you can guarantee that the input value is within the range specified
+        in the constructor, otherwise use processSample().
+    */
+    FloatType processSampleUnchecked (FloatType value) const noexcept
+    {
+        jassert (value >= minInputValue && value <= maxInputValue);
+        return LookupTableHelpers::interpolate<interpolation> (data + 1, scaler * value + offset);
+    }
+
+    /** Calculates the approximated value for the given input value with range checking.
+
+        Out-of-range input values will be clipped to the range given in the constructor.
+    */
+    FloatType processSample (FloatType value) const noexcept
+    {
+        return LookupTableHelpers::interpolate<interpolation> (data + 1, scaler * jlimit (minInputValue, maxInputValue, value) + offset);
+    }
+
+    /** @see processSampleUnchecked */
+    FloatType operator[] (FloatType index) const noexcept       { return processSampleUnchecked (index); }
+
+    /** @see processSample */
+    FloatType operator() (FloatType index) const noexcept       { return processSample (index); }
+
+    //==============================================================================
+    /** Processes an array of input values without range checking.
+        @see process
+    */
+    void processUnchecked (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
+    {
+        LookupTableHelpers::process (data + 1, interpolation, scaler, offset, minInputValue, maxInputValue,
+                                     false, input, output, numSamples);
+    }
+
+    /** Processes an array of input values with range checking.
+        @see processUnchecked
+    */
+    void process (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
+    {
+        LookupTableHelpers::process (data + 1, interpolation, scaler, offset, minInputValue, maxInputValue,
+                                     true, input, output, numSamples);
+    }
+
+    //==============================================================================
+    /** Returns the number of pre-calculated values. */
+    static constexpr size_t getNumPoints() noexcept             { return numPoints; }
+
+private:
+    //==============================================================================
+    static_assert (numPoints > 1, "A lookup table needs at least two points");
+
+    FloatType minInputValue, maxInputValue;
+    FloatType scaler, offset;
+
+    // A plain array, because std::array can't be written to in a C++14 constant expression
+    FloatType data[numPoints + 3] {};
+};
+
 } // namespace dsp
 } // namespace juce
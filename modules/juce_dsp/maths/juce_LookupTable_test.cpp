@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct LookupTableTestSquare
+{
+    constexpr float operator() (float x) const noexcept  { return x * x; }
+};
+
+class LookupTableTest : public UnitTest
+{
+public:
+    LookupTableTest()
+        : UnitTest ("Lookup Table", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Processing a block matches processing single samples");
+        {
+            LookupTableTransform<float> transform ([] (float x) { return std::tanh (x); }, -5.0f, 5.0f, 64);
+            checkBlocksMatchSamples (transform, -4.9f, 4.9f);
+
+            LookupTableTransform<double> doubleTransform ([] (double x) { return std::tanh (x); }, -5.0, 5.0, 64);
+            checkBlocksMatchSamples (doubleTransform, -4.9, 4.9);
+
+            FixedSizeLookupTableTransform<float, 64> linear ([] (float x) { return std::tanh (x); }, -5.0f, 5.0f);
+            checkBlocksMatchSamples (linear, -4.9f, 4.9f);
+
+            FixedSizeLookupTableTransform<double, 64, LookupTableInterpolation::cubic> cubic ([] (double x) { return std::tanh (x); }, -5.0, 5.0);
+            checkBlocksMatchSamples (cubic, -4.9, 4.9);
+        }
+
+        beginTest ("Fixed size tables match LookupTableTransform");
+        {
+            LookupTableTransform<float> transform ([] (float x) { return std::exp (x); }, -2.0f, 2.0f, 128);
+            FixedSizeLookupTableTransform<float, 128> fixed ([] (float x) { return std::exp (x); }, -2.0f, 2.0f);
+
+            for (int i = 0; i <= 1000; ++i)
+            {
+                const auto x = jmap ((float) i, 0.0f, 1000.0f, -2.0f, 2.0f);
+                expectWithinAbsoluteError (fixed.processSample (x), transform.processSample (x), 1.0e-5f);
+            }
+        }
+
+        beginTest ("Cubic interpolation is more accurate than linear");
+        {
+            auto fn = [] (double x) { return std::tanh (x); };
+
+            FixedSizeLookupTableTransform<double, 256> linear (fn, -5.0, 5.0);
+            FixedSizeLookupTableTransform<double, 256, LookupTableInterpolation::cubic> cubic (fn, -5.0, 5.0);
+
+            double linearError = 0, cubicError = 0;
+
+            for (int i = 0; i <= 10000; ++i)
+            {
+                const auto x = jmap ((double) i, 0.0, 10000.0, -5.0, 5.0);
+                linearError = jmax (linearError, std::abs (linear (x) - fn (x)));
+                cubicError  = jmax (cubicError,  std::abs (cubic (x) - fn (x)));
+            }
+
+            expectLessThan (cubicError, 1.0e-5);
+            expectLessThan (cubicError * 10.0, linearError);
+        }
+
+        beginTest ("Out of range inputs are clipped");
+        {
+            FixedSizeLookupTableTransform<float, 32, LookupTableInterpolation::cubic> table ([] (float x) { return x * x; }, 0.0f, 1.0f);
+
+            const float input[] = { -10.0f, -1.0f, 0.0f, 1.0f, 2.0f, 100.0f, 0.5f };
+            float output[numElementsInArray (input)];
+            table.process (input, output, numElementsInArray (input));
+
+            expectWithinAbsoluteError (output[0], 0.0f, 1.0e-6f);
+            expectWithinAbsoluteError (output[1], 0.0f, 1.0e-6f);
+            expectWithinAbsoluteError (output[3], 1.0f, 1.0e-6f);
+            expectWithinAbsoluteError (output[5], 1.0f, 1.0e-6f);
+            expectWithinAbsoluteError (output[6], 0.25f, 1.0e-4f);
+        }
+
+        beginTest ("Tables can be created at compile time");
+        {
+            static constexpr FixedSizeLookupTableTransform<float, 64> table { LookupTableTestSquare{}, -1.0f, 1.0f };
+            static_assert (decltype (table)::getNumPoints() == 64, "");
+
+            expectWithinAbsoluteError (table (0.5f), 0.25f, 1.0e-3f);
+        }
+
+        beginTest ("WaveShaper processes blocks with a lookup table");
+        {
+            using Table = FixedSizeLookupTableTransform<float, 512, LookupTableInterpolation::cubic>;
+            WaveShaper<float, Table> shaper { { [] (float x) { return std::tanh (x); }, -5.0f, 5.0f } };
+
+            AudioBuffer<float> buffer (2, 301);
+            Random random (1);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (ch, i, random.nextFloat() * 12.0f - 6.0f);
+
+            auto input = buffer;
+            AudioBlock<float> block (buffer);
+            shaper.process (ProcessContextReplacing<float> (block));
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    expectEquals (buffer.getSample (ch, i), shaper.processSample (input.getSample (ch, i)));
+        }
+    }
+
+private:
+    template <typename Table, typename FloatType>
+    void checkBlocksMatchSamples (const Table& table, FloatType minValue, FloatType maxValue)
+    {
+        constexpr size_t numSamples = 203;
+        std::vector<FloatType> input (numSamples), output (numSamples), uncheckedOutput (numSamples);
+
+        // Some values are out of range, and only used with the range-checked functions
+        for (size_t i = 0; i < numSamples; ++i)
+            input[i] = jmap ((FloatType) i, (FloatType) 0, (FloatType) (numSamples - 1), minValue * 2, maxValue * 2);
+
+        table.process (input.data(), output.data(), numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            expectEquals (output[i], table.processSample (input[i]));
+
+        for (size_t i = 0; i < numSamples; ++i)
+            input[i] = jmap ((FloatType) i, (FloatType) 0, (FloatType) (numSamples - 1), minValue, maxValue);
+
+        table.processUnchecked (input.data(), uncheckedOutput.data(), numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            expectEquals (uncheckedOutput[i], table.processSampleUnchecked (input[i]));
+    }
+};
+
+static LookupTableTest lookupTableTest;
+
+} // namespace dsp
+} // namespace juce
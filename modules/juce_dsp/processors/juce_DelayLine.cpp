@@ -71,7 +71,7 @@ void DelayLine<SampleType, InterpolationType>::prepare (const ProcessSpec& spec)
 {
     jassert (spec.numChannels > 0);
 
-    bufferData.setSize ((int) spec.numChannels, totalSize, false, false, true);
+    bufferData.setSize ((int) spec.numChannels, totalSize + numGuardSamples, false, false, true);
 
     writePos.resize (spec.numChannels);
     readPos.resize  (spec.numChannels);
@@ -87,7 +87,7 @@ void DelayLine<SampleType, InterpolationType>::setMaximumDelayInSamples (int max
 {
     jassert (maxDelayInSamples >= 0);
     totalSize = jmax (4, maxDelayInSamples + 1);
-    bufferData.setSize ((int) bufferData.getNumChannels(), totalSize, false, false, true);
+    bufferData.setSize ((int) bufferData.getNumChannels(), totalSize + numGuardSamples, false, false, true);
     reset();
 }
 
@@ -106,8 +106,13 @@ void DelayLine<SampleType, InterpolationType>::reset()
 template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::pushSample (int channel, SampleType sample)
 {
-    bufferData.setSample (channel, writePos[(size_t) channel], sample);
-    writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) % totalSize;
+    auto& pos = writePos[(size_t) channel];
+    bufferData.setSample (channel, pos, sample);
+
+    if (pos < numGuardSamples)
+        bufferData.setSample (channel, pos + totalSize, sample);
+
+    pos = (pos + totalSize - 1) % totalSize;
 }
 
 template <typename SampleType, typename InterpolationType>
@@ -124,6 +129,216 @@ SampleType DelayLine<SampleType, InterpolationType>::popSample (int channel, Sam
     return result;
 }
 
+//==============================================================================
+namespace DelayLineBlockHelpers
+{
+    /* Reads a single tap over a block. The read position moves back through the buffer by one
+       sample for each sample of the block, as it does in popSample().
+
+       If adjustForLagrange is true, the integer part of the delay is reduced by one whenever
+       possible, so that the fractional part lies in the range [1, 2).
+    */
+    template <bool adjustForLagrange, typename SampleType, typename Interpolator>
+    static void readTap (const SampleType* buffer, int totalSize, int readPos,
+                         const SampleType* delays, SampleType* output, int numSamples,
+                         Interpolator&& interpolate) noexcept
+    {
+        const auto maxDelay = (SampleType) (totalSize - 1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto delay = jlimit ((SampleType) 0, maxDelay, delays[i]);
+            auto delayInt = static_cast<int> (delay);
+            auto delayFrac = delay - (SampleType) delayInt;
+
+            if (adjustForLagrange && delayInt >= 1)
+            {
+                delayFrac++;
+                delayInt--;
+            }
+
+            auto index = readPos + delayInt;
+
+            if (index >= totalSize)
+                index -= totalSize;
+
+            output[i] = interpolate (buffer + index, delayFrac, i);
+            readPos = (readPos == 0 ? totalSize : readPos) - 1;
+        }
+    }
+
+    template <typename SampleType>
+    static void readTaps (DelayLineInterpolationTypes::None, const SampleType* buffer, int totalSize, int readPos,
+                          const SampleType* const* tapDelays, SampleType* const* tapOutputs,
+                          int numTaps, int numSamples, SampleType&) noexcept
+    {
+        for (int tap = 0; tap < numTaps; ++tap)
+            readTap<false> (buffer, totalSize, readPos, tapDelays[tap], tapOutputs[tap], numSamples,
+                            [] (const SampleType* samples, SampleType, int) { return samples[0]; });
+    }
+
+    template <typename SampleType>
+    static void readTaps (DelayLineInterpolationTypes::Linear, const SampleType* buffer, int totalSize, int readPos,
+                          const SampleType* const* tapDelays, SampleType* const* tapOutputs,
+                          int numTaps, int numSamples, SampleType&) noexcept
+    {
+        for (int tap = 0; tap < numTaps; ++tap)
+            readTap<false> (buffer, totalSize, readPos, tapDelays[tap], tapOutputs[tap], numSamples,
+                            [] (const SampleType* samples, SampleType frac, int)
+                            {
+                                return samples[0] + frac * (samples[1] - samples[0]);
+                            });
+    }
+
+    template <typename SampleType>
+    static void readLagrangeTap (const SampleType* buffer, int totalSize, int readPos,
+                                 const SampleType* delays, SampleType* output, int numSamples) noexcept
+    {
+       #if JUCE_USE_SIMD
+        using Vec = SIMDRegister<SampleType>;
+        constexpr int vecSize = (int) Vec::size();
+        const auto load = [] (const SampleType* src) { return Vec::fromRawArray (src); };
+        const auto constant = [] (SampleType v) { return Vec::expand (v); };
+       #else
+        constexpr int vecSize = 1;
+        const auto load = [] (const SampleType* src) { return *src; };
+        const auto constant = [] (SampleType v) { return v; };
+       #endif
+
+        // The four neighbours of a group of samples are gathered into transposed arrays,
+        // so that the interpolation itself can be done with vector operations
+        alignas (16 * sizeof (SampleType)) SampleType values[4][(size_t) vecSize], fracs[(size_t) vecSize],
+                                                      results[(size_t) vecSize];
+
+        for (int start = 0; start < numSamples; start += vecSize)
+        {
+            const auto num = jmin (vecSize, numSamples - start);
+
+            readTap<true> (buffer, totalSize, readPos, delays + start, fracs, num,
+                           [&values] (const SampleType* samples, SampleType frac, int i)
+                           {
+                               for (int k = 0; k < 4; ++k)
+                                   values[k][i] = samples[k];
+
+                               return frac;
+                           });
+
+            for (int i = num; i < vecSize; ++i)
+            {
+                fracs[i] = 0;
+
+                for (int k = 0; k < 4; ++k)
+                    values[k][i] = 0;
+            }
+
+            const auto frac = load (fracs);
+            const auto d1 = frac - constant (1);
+            const auto d2 = frac - constant (2);
+            const auto d3 = frac - constant (3);
+
+            const auto c1 = constant (-1 / (SampleType) 6) * d1 * d2 * d3;
+            const auto c2 = constant ((SampleType) 0.5) * d2 * d3;
+            const auto c3 = constant ((SampleType) -0.5) * d1 * d3;
+            const auto c4 = constant (1 / (SampleType) 6) * d1 * d2;
+
+            const auto result = load (values[0]) * c1
+                              + frac * (load (values[1]) * c2 + load (values[2]) * c3 + load (values[3]) * c4);
+
+           #if JUCE_USE_SIMD
+            result.copyToRawArray (results);
+           #else
+            results[0] = result;
+           #endif
+
+            std::copy (results, results + num, output + start);
+            // A whole register can hold more samples than a very short delay line, so this
+            // may have to wrap around more than once
+            readPos = ((readPos - num) % totalSize + totalSize) % totalSize;
+        }
+    }
+
+    template <typename SampleType>
+    static void readTaps (DelayLineInterpolationTypes::Lagrange3rd, const SampleType* buffer, int totalSize, int readPos,
+                          const SampleType* const* tapDelays, SampleType* const* tapOutputs,
+                          int numTaps, int numSamples, SampleType&) noexcept
+    {
+        for (int tap = 0; tap < numTaps; ++tap)
+            readLagrangeTap (buffer, totalSize, readPos, tapDelays[tap], tapOutputs[tap], numSamples);
+    }
+
+    template <typename SampleType>
+    static void readTaps (DelayLineInterpolationTypes::Thiran, const SampleType* buffer, int totalSize, int readPos,
+                          const SampleType* const* tapDelays, SampleType* const* tapOutputs,
+                          int numTaps, int numSamples, SampleType& state) noexcept
+    {
+        // The Thiran interpolator is recursive, and its state is shared between the taps in
+        // the same way as with popSample(), so this runs through the samples one at a time
+        const auto maxDelay = (SampleType) (totalSize - 1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const auto delay = jlimit ((SampleType) 0, maxDelay, tapDelays[tap][i]);
+                auto delayInt = static_cast<int> (delay);
+                auto delayFrac = delay - (SampleType) delayInt;
+
+                if (delayFrac < (SampleType) 0.618 && delayInt >= 1)
+                {
+                    delayFrac++;
+                    delayInt--;
+                }
+
+                const auto alpha = (1 - delayFrac) / (1 + delayFrac);
+                auto index = readPos + delayInt;
+
+                if (index >= totalSize)
+                    index -= totalSize;
+
+                const auto value1 = buffer[index];
+                const auto value2 = buffer[index + 1];
+
+                state = delayFrac == 0 ? value1 : value2 + alpha * (value1 - state);
+                tapOutputs[tap][i] = state;
+            }
+
+            readPos = (readPos == 0 ? totalSize : readPos) - 1;
+        }
+    }
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::pushBlock (int channel, const SampleType* samples, int numSamples)
+{
+    auto* data = bufferData.getWritePointer (channel);
+    auto pos = writePos[(size_t) channel];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        data[pos] = samples[i];
+
+        if (pos < numGuardSamples)
+            data[pos + totalSize] = samples[i];
+
+        pos = (pos == 0 ? totalSize : pos) - 1;
+    }
+
+    writePos[(size_t) channel] = pos;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::popBlock (int channel, const SampleType* const* tapDelays,
+                                                         SampleType* const* tapOutputs, int numTaps, int numSamples)
+{
+    const auto* data = bufferData.getReadPointer (channel);
+    auto& pos = readPos[(size_t) channel];
+
+    DelayLineBlockHelpers::readTaps (InterpolationType{}, data, totalSize, pos, tapDelays, tapOutputs,
+                                     numTaps, numSamples, v[(size_t) channel]);
+
+    pos = (int) (((int64) pos - numSamples) % totalSize + totalSize) % totalSize;
+}
+
 //==============================================================================
 template class DelayLine<float,  DelayLineInterpolationTypes::None>;
 template class DelayLine<double, DelayLineInterpolationTypes::None>;
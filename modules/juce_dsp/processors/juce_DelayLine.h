@@ -160,6 +160,40 @@ public:
     */
     SampleType popSample (int channel, SampleType delayInSamples = -1, bool updateReadPointer = true);
 
+    //==============================================================================
+    /** Pushes a block of samples into one channel of the delay line.
+
+        This is equivalent to calling pushSample for each of the samples in turn.
+
+        @see popBlock, pushSample
+    */
+    void pushBlock (int channel, const SampleType* samples, int numSamples);
+
+    /** Reads one or more taps from one channel of the delay line, with a separate
+        delay time for every tap and every sample.
+
+        For each sample of the block, every tap is read using the delay found in
+        tapDelays[tap][sample], and the result is written to tapOutputs[tap][sample].
+        The read pointer then moves on by one sample. This gives the same results as
+        calling popSample for each tap with updateReadPointer set to false, and then
+        moving the read pointer once, but avoids the per-sample call overhead. The
+        3rd order Lagrange interpolation is computed with SIMD operations when they
+        are available. The Thiran interpolator is recursive, so it's computed one
+        sample at a time.
+
+        The samples being read must already have been pushed into the delay line.
+        Either push the whole block before reading it, in which case the maximum
+        delay must be long enough to hold the block on top of the longest delay,
+        or, if the output is fed back into the input, make sure that none of the
+        delays is shorter than the block, and push the block afterwards.
+
+        Unlike popSample, this doesn't change the delay set with setDelay.
+
+        @see pushBlock, popSample
+    */
+    void popBlock (int channel, const SampleType* const* tapDelays, SampleType* const* tapOutputs,
+                   int numTaps, int numSamples);
+
     //==============================================================================
     /** Processes the input and output samples supplied in the processing context.
 
@@ -323,6 +357,11 @@ private:
         alpha = (1 - delayFrac) / (1 + delayFrac);
     }
 
+    //==============================================================================
+    // The first few samples of each channel are repeated after the end of the buffer,
+    // so that the interpolators can read their neighbours without wrapping around
+    static constexpr int numGuardSamples = 3;
+
     //==============================================================================
     double sampleRate;
 
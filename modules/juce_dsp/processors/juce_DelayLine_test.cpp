@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class DelayLineTest : public UnitTest
+{
+public:
+    DelayLineTest()
+        : UnitTest ("DelayLine", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Block processing with no interpolation matches sample processing");
+        runBlockTest<DelayLineInterpolationTypes::None> (3);
+
+        beginTest ("Block processing with linear interpolation matches sample processing");
+        runBlockTest<DelayLineInterpolationTypes::Linear> (3);
+
+        beginTest ("Block processing with Lagrange interpolation matches sample processing");
+        runBlockTest<DelayLineInterpolationTypes::Lagrange3rd> (3);
+
+        beginTest ("Block processing with Thiran interpolation matches sample processing");
+        runBlockTest<DelayLineInterpolationTypes::Thiran> (1);
+
+        beginTest ("Blocks can be read before they are pushed when the delays are long enough");
+        {
+            constexpr int blockSize = 32;
+            DelayLine<float, DelayLineInterpolationTypes::Linear> blockDelay (200), sampleDelay (200);
+            blockDelay.prepare ({ 44100.0, (uint32) blockSize, 1 });
+            sampleDelay.prepare ({ 44100.0, (uint32) blockSize, 1 });
+
+            Random random (27);
+            float lastBlockOutput = 0.0f, lastSampleOutput = 0.0f;
+
+            for (int block = 0; block < 50; ++block)
+            {
+                float delays[blockSize], outputs[blockSize], inputs[blockSize];
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    delays[i] = (float) blockSize + random.nextFloat() * 150.0f;
+                    inputs[i] = random.nextFloat() * 2.0f - 1.0f;
+                }
+
+                // Feedback, processed a block at a time by reading before writing
+                const float* delayPointers[] = { delays };
+                float* outputPointers[] = { outputs };
+                blockDelay.popBlock (0, delayPointers, outputPointers, 1, blockSize);
+
+                float toPush[blockSize];
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    toPush[i] = inputs[i] - lastBlockOutput * 0.5f;
+                    lastBlockOutput = outputs[i];
+                }
+
+                blockDelay.pushBlock (0, toPush, blockSize);
+
+                // The same feedback loop, one sample at a time
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    sampleDelay.pushSample (0, inputs[i] - lastSampleOutput * 0.5f);
+                    lastSampleOutput = sampleDelay.popSample (0, delays[i]);
+
+                    expectWithinAbsoluteError (outputs[i], lastSampleOutput, 1.0e-6f);
+                }
+            }
+        }
+    }
+
+private:
+    template <typename InterpolationType>
+    void runBlockTest (int numTaps)
+    {
+        constexpr int maxDelay = 100, numSamples = 1000;
+
+        // The whole block is pushed before being read, so the delay line needs room for
+        // the longest block on top of the longest delay
+        DelayLine<float, InterpolationType> blockDelay (maxDelay + 400), sampleDelay (maxDelay + 400);
+        blockDelay.prepare ({ 44100.0, (uint32) numSamples, 2 });
+        sampleDelay.prepare ({ 44100.0, (uint32) numSamples, 2 });
+
+        Random random (1234);
+        std::vector<float> input ((size_t) numSamples);
+        std::vector<std::vector<float>> delays ((size_t) numTaps), outputs ((size_t) numTaps);
+
+        for (auto& s : input)
+            s = random.nextFloat() * 2.0f - 1.0f;
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            outputs[(size_t) tap].resize ((size_t) numSamples);
+
+            // Slowly modulated delays, which cover the whole range including the extremes
+            for (int i = 0; i < numSamples; ++i)
+                delays[(size_t) tap].push_back (jlimit (0.0f, (float) maxDelay,
+                                                        (float) maxDelay * (0.5f + 0.6f * std::sin ((float) i * 0.01f * (float) (tap + 1)))));
+        }
+
+        for (auto blockSize : { 1, 7, 64, 333 })
+        {
+            blockDelay.reset();
+            sampleDelay.reset();
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                const auto num = jmin (blockSize, numSamples - start);
+
+                std::vector<const float*> delayPointers;
+                std::vector<float*> outputPointers;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    delayPointers.push_back (delays[(size_t) tap].data() + start);
+                    outputPointers.push_back (outputs[(size_t) tap].data() + start);
+                }
+
+                blockDelay.pushBlock (1, input.data() + start, num);
+                blockDelay.popBlock (1, delayPointers.data(), outputPointers.data(), numTaps, num);
+            }
+
+            auto maxError = 0.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                sampleDelay.pushSample (1, input[(size_t) i]);
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    const auto expected = sampleDelay.popSample (1, delays[(size_t) tap][(size_t) i], tap == numTaps - 1);
+                    maxError = jmax (maxError, std::abs (outputs[(size_t) tap][(size_t) i] - expected));
+                }
+            }
+
+            expectLessThan (maxError, 1.0e-5f);
+        }
+    }
+};
+
+static DelayLineTest delayLineTest;
+
+} // namespace dsp
+} // namespace juce
@@ -157,5 +157,138 @@ void FIR::Coefficients<NumericType>::Coefficients::normalise() noexcept
 template struct FIR::Coefficients<float>;
 template struct FIR::Coefficients<double>;
 
+//==============================================================================
+FIR::PartitionedConvolution::PartitionedConvolution (const float* taps, size_t numTapsToUse, size_t partitionSizeToUse)
+    : fft (std::make_unique<FFT> (roundToInt (std::log2 (2 * partitionSizeToUse)))),
+      partitionSize (partitionSizeToUse),
+      numTaps (numTapsToUse),
+      numPartitions (jmax ((size_t) 1, (numTapsToUse + partitionSizeToUse - 1) / partitionSizeToUse)),
+      numBins (partitionSizeToUse + 1)
+{
+    // The partition size must be a power of two
+    jassert (isPowerOfTwo (partitionSize));
+
+    // The spectra are stored as separate arrays of real and imaginary parts, so that
+    // the complex multiplications can be done with FloatVectorOperations
+    tapSpectra   .malloc (2 * numBins * numPartitions);
+    inputSpectra .malloc (2 * numBins * numPartitions);
+    accumulator  .malloc (2 * numBins);
+    workspace    .malloc (4 * partitionSize);
+    previousInput.malloc (partitionSize);
+    output       .malloc (partitionSize);
+    currentTaps  .malloc (jmax ((size_t) 1, numTaps));
+
+    transformTaps (taps);
+    reset();
+}
+
+FIR::PartitionedConvolution::~PartitionedConvolution() = default;
+
+void FIR::PartitionedConvolution::reset() noexcept
+{
+    FloatVectorOperations::clear (inputSpectra.get(), (int) (2 * numBins * numPartitions));
+    FloatVectorOperations::clear (previousInput.get(), (int) partitionSize);
+    FloatVectorOperations::clear (output.get(), (int) partitionSize);
+    currentPartition = 0;
+}
+
+void FIR::PartitionedConvolution::transformTaps (const float* taps) noexcept
+{
+    std::copy (taps, taps + numTaps, currentTaps.get());
+
+    const auto fftSize = 2 * partitionSize;
+    auto* buffer = workspace.get();
+
+    for (size_t partition = 0; partition < numPartitions; ++partition)
+    {
+        const auto start = partition * partitionSize;
+        const auto num = start < numTaps ? jmin (partitionSize, numTaps - start) : (size_t) 0;
+
+        FloatVectorOperations::clear (buffer, (int) (2 * fftSize));
+        FloatVectorOperations::copy (buffer, taps + start, (int) num);
+
+        fft->performRealOnlyForwardTransform (buffer, true);
+
+        auto* re = tapSpectra.get() + 2 * numBins * partition;
+        auto* im = re + numBins;
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+        {
+            re[bin] = buffer[2 * bin];
+            im[bin] = buffer[2 * bin + 1];
+        }
+    }
+}
+
+void FIR::PartitionedConvolution::processBlock (const float* input, const float* taps) noexcept
+{
+    if (! std::equal (taps, taps + numTaps, currentTaps.get()))
+        transformTaps (taps);
+
+    const auto fftSize = 2 * partitionSize;
+    auto* buffer = workspace.get();
+
+    // Overlap-save: transform the previous and current blocks of input together
+    FloatVectorOperations::copy (buffer, previousInput.get(), (int) partitionSize);
+    FloatVectorOperations::copy (buffer + partitionSize, input, (int) partitionSize);
+    FloatVectorOperations::clear (buffer + fftSize, (int) fftSize);
+    FloatVectorOperations::copy (previousInput.get(), input, (int) partitionSize);
+
+    fft->performRealOnlyForwardTransform (buffer, true);
+
+    {
+        auto* re = inputSpectra.get() + 2 * numBins * currentPartition;
+        auto* im = re + numBins;
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+        {
+            re[bin] = buffer[2 * bin];
+            im[bin] = buffer[2 * bin + 1];
+        }
+    }
+
+    // Each partition of the taps is multiplied with the input from that many blocks ago
+    auto* accRe = accumulator.get();
+    auto* accIm = accRe + numBins;
+    FloatVectorOperations::clear (accRe, (int) (2 * numBins));
+
+    auto inputIndex = currentPartition;
+
+    for (size_t partition = 0; partition < numPartitions; ++partition)
+    {
+        const auto* xRe = inputSpectra.get() + 2 * numBins * inputIndex;
+        const auto* xIm = xRe + numBins;
+        const auto* hRe = tapSpectra.get() + 2 * numBins * partition;
+        const auto* hIm = hRe + numBins;
+
+        FloatVectorOperations::addWithMultiply      (accRe, xRe, hRe, (int) numBins);
+        FloatVectorOperations::subtractWithMultiply (accRe, xIm, hIm, (int) numBins);
+        FloatVectorOperations::addWithMultiply      (accIm, xRe, hIm, (int) numBins);
+        FloatVectorOperations::addWithMultiply      (accIm, xIm, hRe, (int) numBins);
+
+        inputIndex = (inputIndex == 0 ? numPartitions - 1 : inputIndex - 1);
+    }
+
+    currentPartition = (currentPartition + 1 == numPartitions ? 0 : currentPartition + 1);
+
+    // The inverse transform needs the whole conjugate-symmetric spectrum
+    for (size_t bin = 0; bin < numBins; ++bin)
+    {
+        buffer[2 * bin]     = accRe[bin];
+        buffer[2 * bin + 1] = accIm[bin];
+    }
+
+    for (size_t bin = 1; bin < partitionSize; ++bin)
+    {
+        buffer[2 * (fftSize - bin)]     =  accRe[bin];
+        buffer[2 * (fftSize - bin) + 1] = -accIm[bin];
+    }
+
+    fft->performRealOnlyInverseTransform (buffer);
+
+    // Only the second half of the result is free from circular wrap-around
+    FloatVectorOperations::copy (output.get(), buffer + partitionSize, (int) partitionSize);
+}
+
 } // namespace dsp
 } // namespace juce
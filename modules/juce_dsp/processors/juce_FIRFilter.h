@@ -28,6 +28,8 @@ namespace juce
 namespace dsp
 {
 
+class FFT;
+
 /**
     Classes for FIR filter processing.
 */
@@ -36,15 +38,72 @@ namespace FIR
     template <typename NumericType>
     struct Coefficients;
 
+    //==============================================================================
+    /**
+        Convolves a signal with a set of FIR taps in the frequency domain, using a
+        uniformly partitioned overlap-save algorithm.
+
+        This is used internally by FIR::Filter for long filters. The input is supplied
+        in blocks of the partition size, and the output is the convolution of the taps
+        with the input, delayed by one partition. The Filter processes the first
+        partition of its coefficients itself, so the combined output has no latency.
+
+        @see FIR::Filter
+
+        @tags{DSP}
+    */
+    class JUCE_API  PartitionedConvolution
+    {
+    public:
+        /** Creates an object for the given taps. The partition size must be a power of two. */
+        PartitionedConvolution (const float* taps, size_t numTaps, size_t partitionSize);
+
+        /** Destructor. */
+        ~PartitionedConvolution();
+
+        /** Clears the input history and the output. */
+        void reset() noexcept;
+
+        /** Takes the next partitionSize samples of input, and calculates the next
+            partitionSize samples of output.
+
+            The taps are compared with the ones that were used last time, and
+            transformed again if they've changed.
+        */
+        void processBlock (const float* input, const float* taps) noexcept;
+
+        /** Returns the output that was calculated by the last call to processBlock(). */
+        const float* getOutput() const noexcept     { return output.get(); }
+
+    private:
+        //==============================================================================
+        void transformTaps (const float* taps) noexcept;
+
+        std::unique_ptr<FFT> fft;
+        const size_t partitionSize, numTaps, numPartitions, numBins;
+        size_t currentPartition = 0;
+
+        HeapBlock<float> tapSpectra, inputSpectra, accumulator, workspace,
+                         previousInput, output, currentTaps;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolution)
+    };
+
     //==============================================================================
     /**
         A processing class that can perform FIR filtering on an audio signal, in the
         time domain.
 
-        Using FIRFilter is fast enough for FIRCoefficients with a size lower than 128
-        samples. For longer filters, it might be more efficient to use the class
-        Convolution instead, which does the same processing in the frequency domain
-        thanks to FFT.
+        The samples are filtered in blocks, with each tap applied to a whole block
+        at once, so the work is vectorised across the output samples. When the
+        SampleType is a SIMDRegister, several channels are also processed at once.
+
+        For float filters with more than maxTimeDomainSize coefficients, only the
+        first partition of the coefficients is applied in the time domain, and the
+        rest are applied in the frequency domain with a PartitionedConvolution. This
+        is done without adding any latency. For very long filters that don't change,
+        it can still be more efficient to use the Convolution class, which supports
+        non-uniform partitioning.
 
         @see FIRFilter::Coefficients, Convolution, FFT
 
@@ -62,6 +121,11 @@ namespace FIR
         /** A typedef for a ref-counted pointer to the coefficients object */
         using CoefficientsPtr = typename Coefficients<NumericType>::Ptr;
 
+        /** Float filters with more coefficients than this are processed partly in the
+            frequency domain.
+        */
+        static constexpr size_t maxTimeDomainSize = 128;
+
         //==============================================================================
         /** This will create a filter which will produce silence. */
         Filter() : coefficients (new Coefficients<NumericType>)                                     { reset(); }
@@ -97,14 +161,26 @@ namespace FIR
 
                 if (newSize != size)
                 {
-                    memory.malloc (1 + jmax (newSize, size, static_cast<size_t> (128)));
+                    size = newSize;
+                    partitions = createPartitions (static_cast<SampleType*> (nullptr), coefficients->getRawCoefficients(), size);
+                    numDirectTaps = partitions != nullptr ? blockSize : size;
 
+                    // The buffer holds the history needed by the direct taps, followed by the current block
+                    memory.malloc (numDirectTaps + blockSize);
                     fifo = snapPointerToAlignment (memory.getData(), sizeof (SampleType));
-                    size = newSize;
                 }
 
-                for (size_t i = 0; i < size; ++i)
+                // An empty set of coefficients has no taps, and so no state to clear
+                if (size == 0)
+                    return;
+
+                for (size_t i = 0; i < numDirectTaps - 1 + blockSize; ++i)
                     fifo[i] = SampleType {0};
+
+                if (partitions != nullptr)
+                    partitions->reset();
+
+                pos = 0;
             }
         }
 
@@ -134,28 +210,10 @@ namespace FIR
             jassert (inputBlock.getNumChannels()  == 1);
             jassert (outputBlock.getNumChannels() == 1);
 
-            auto numSamples = inputBlock.getNumSamples();
-            auto* src = inputBlock .getChannelPointer (0);
-            auto* dst = outputBlock.getChannelPointer (0);
-
-            auto* fir = coefficients->getRawCoefficients();
-            size_t p = pos;
-
-            if (context.isBypassed)
-            {
-                for (size_t i = 0; i < numSamples; ++i)
-                {
-                    fifo[p] = dst[i] = src[i];
-                    p = (p == 0 ? size - 1 : p - 1);
-                }
-            }
-            else
-            {
-                for (size_t i = 0; i < numSamples; ++i)
-                    dst[i] = processSingleSample (src[i], fifo, fir, size, p);
-            }
-
-            pos = p;
+            processSamples (inputBlock .getChannelPointer (0),
+                            outputBlock.getChannelPointer (0),
+                            inputBlock.getNumSamples(),
+                            context.isBypassed);
         }
 
 
@@ -165,14 +223,20 @@ namespace FIR
         SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType sample) noexcept
         {
             check();
-            return processSingleSample (sample, fifo, coefficients->getRawCoefficients(), size, pos);
+
+            SampleType out;
+            processSamples (&sample, &out, 1, false);
+            return out;
         }
 
     private:
         //==============================================================================
+        static constexpr size_t blockSize = 64;
+
         HeapBlock<SampleType> memory;
         SampleType* fifo = nullptr;
-        size_t pos = 0, size = 0;
+        size_t pos = 0, size = 0, numDirectTaps = 0;
+        std::unique_ptr<PartitionedConvolution> partitions;
 
         //==============================================================================
         void check()
@@ -183,25 +247,122 @@ namespace FIR
                 reset();
         }
 
-        static SampleType JUCE_VECTOR_CALLTYPE processSingleSample (SampleType sample, SampleType* buf,
-                                                                    const NumericType* fir, size_t m, size_t& p) noexcept
+        void processSamples (const SampleType* src, SampleType* dst, size_t numSamples, bool isBypassed) noexcept
         {
-            SampleType out (0);
+            // A filter without any coefficients produces silence
+            if (size == 0)
+            {
+                if (isBypassed)
+                    std::copy (src, src + numSamples, dst);
+                else
+                    std::fill (dst, dst + numSamples, SampleType (0));
 
-            buf[p] = sample;
+                return;
+            }
 
-            size_t k;
-            for (k = 0; k < m - p; ++k)
-                out += buf[(p + k)] * fir[k];
+            auto* fir = coefficients->getRawCoefficients();
+            const auto historySize = numDirectTaps - 1;
 
-            for (size_t j = 0; j < p; ++j)
-                out += buf[j] * fir[j + k];
+            for (size_t numDone = 0; numDone < numSamples;)
+            {
+                const auto num = jmin (numSamples - numDone, blockSize - pos);
+                auto* input = fifo + historySize + pos;
+                auto* out = dst + numDone;
 
-            p = (p == 0 ? m - 1 : p - 1);
+                std::copy (src + numDone, src + numDone + num, input);
 
-            return out;
+                if (isBypassed)
+                {
+                    std::copy (input, input + num, out);
+                }
+                else if (num < 4)
+                {
+                    for (size_t i = 0; i < num; ++i)
+                    {
+                        SampleType sum (0);
+
+                        for (size_t k = 0; k < numDirectTaps; ++k)
+                            sum += *(input + i - k) * fir[k];
+
+                        out[i] = sum;
+                    }
+                }
+                else
+                {
+                    // Each tap is applied to the whole block at once, which vectorises much
+                    // better than calculating one output sample at a time
+                    std::fill (out, out + num, SampleType (0));
+
+                    for (size_t k = 0; k < numDirectTaps; ++k)
+                        addWithMultiply (out, input - k, fir[k], num);
+                }
+
+                if (partitions != nullptr && ! isBypassed)
+                    addPartitionsOutput (out, partitions->getOutput() + pos, num);
+
+                pos += num;
+                numDone += num;
+
+                if (pos == blockSize)
+                {
+                    if (partitions != nullptr)
+                        processPartitions (*partitions, fifo + historySize, fir + numDirectTaps);
+
+                    // The end of this block becomes the history for the next one
+                    std::copy (fifo + blockSize, fifo + blockSize + historySize, fifo);
+                    pos = 0;
+                }
+            }
+        }
+
+        //==============================================================================
+        static void addWithMultiply (float* dst, const float* src, float multiplier, size_t num) noexcept
+        {
+            FloatVectorOperations::addWithMultiply (dst, src, multiplier, (int) num);
+        }
+
+        static void addWithMultiply (double* dst, const double* src, double multiplier, size_t num) noexcept
+        {
+            FloatVectorOperations::addWithMultiply (dst, src, multiplier, (int) num);
+        }
+
+        template <typename Type>
+        static void addWithMultiply (Type* dst, const Type* src, NumericType multiplier, size_t num) noexcept
+        {
+            for (size_t i = 0; i < num; ++i)
+                dst[i] += src[i] * multiplier;
+        }
+
+        // Only plain float filters can use the partitioned convolution
+        static std::unique_ptr<PartitionedConvolution> createPartitions (float*, const float* fir, size_t numTaps)
+        {
+            if (numTaps <= maxTimeDomainSize)
+                return {};
+
+            return std::make_unique<PartitionedConvolution> (fir + blockSize, numTaps - blockSize, blockSize);
+        }
+
+        template <typename Type>
+        static std::unique_ptr<PartitionedConvolution> createPartitions (Type*, const NumericType*, size_t)
+        {
+            return {};
+        }
+
+        static void addPartitionsOutput (float* dst, const float* src, size_t num) noexcept
+        {
+            FloatVectorOperations::add (dst, src, (int) num);
+        }
+
+        template <typename Type>
+        static void addPartitionsOutput (Type*, const float*, size_t) noexcept     { jassertfalse; }
+
+        static void processPartitions (PartitionedConvolution& p, const float* input, const float* taps) noexcept
+        {
+            p.processBlock (input, taps);
         }
 
+        template <typename Type>
+        static void processPartitions (PartitionedConvolution&, const Type*, const NumericType*) noexcept     { jassertfalse; }
 
         JUCE_LEAK_DETECTOR (Filter)
     };
@@ -203,6 +203,110 @@ class FIRFilterTest : public UnitTest
     }
 
 
+    //==============================================================================
+    template <typename TheTest>
+    void runLongFilterTest (const char* unitTestName)
+    {
+        beginTest (unitTestName);
+
+        Random random (2938471);
+
+        for (auto size : {129, 300, 1000})
+        {
+            constexpr size_t n = 3011;
+
+            HeapBlock<float> input (n), output (n), ref (n), fir (static_cast<size_t> (size));
+            fillRandom (random, input.get(), n);
+            fillRandom (random, fir.get(), static_cast<size_t> (size));
+
+            FIR::Filter<float> filter (*new FIR::Coefficients<float> (fir.get(), static_cast<size_t> (size)));
+            filter.prepare ({ 0.0, n, 1 });
+
+            reference<float, float> (fir.get(), static_cast<size_t> (size), input.get(), ref.get(), n);
+            TheTest::template run<float> (filter, input.get(), output.get(), n);
+
+            // the tail of a long filter is computed in the frequency domain,
+            // so allow for the rounding errors of the FFT
+            auto maxError = 0.0f;
+
+            for (size_t i = 0; i < n; ++i)
+                maxError = jmax (maxError, std::abs (output[i] - ref[i]));
+
+            expectLessThan (maxError, 1.0e-4f);
+        }
+    }
+
+    void runChangingLongFilterTest()
+    {
+        beginTest ("Changing long filter coefficients");
+
+        Random random (1287364);
+
+        constexpr size_t n = 2000, size = 500;
+        HeapBlock<float> input (n), output (n), ref (n), fir (size);
+        fillRandom (random, input.get(), n);
+        fillRandom (random, fir.get(), size);
+
+        FIR::Coefficients<float>::Ptr coefficients (new FIR::Coefficients<float> (fir.get(), size));
+        FIR::Filter<float> filter (coefficients);
+        filter.prepare ({ 0.0, n, 1 });
+
+        // process in place, then swap the coefficients for new ones of the same length
+        FloatVectorOperations::copy (output.get(), input.get(), (int) n);
+
+        {
+            auto* data = output.get();
+            AudioBlock<float> block (&data, 1, n);
+            filter.process (ProcessContextReplacing<float> (block));
+        }
+
+        reference<float, float> (fir.get(), size, input.get(), ref.get(), n);
+
+        for (size_t i = 0; i < n; ++i)
+            expectWithinAbsoluteError (output[i], ref[i], 1.0e-4f);
+
+        fillRandom (random, coefficients->getRawCoefficients(), size);
+        filter.reset();
+
+        reference<float, float> (coefficients->getRawCoefficients(), size, input.get(), ref.get(), n);
+        SplitBlockTest::run<float> (filter, input.get(), output.get(), n);
+
+        auto maxError = 0.0f;
+
+        for (size_t i = 0; i < n; ++i)
+            maxError = jmax (maxError, std::abs (output[i] - ref[i]));
+
+        expectLessThan (maxError, 1.0e-4f);
+    }
+
+    void runEmptyCoefficientsTest()
+    {
+        beginTest ("Empty coefficients");
+
+        constexpr size_t n = 300;
+        HeapBlock<float> input (n), output (n), fir (n);
+        Random random (8273645);
+        fillRandom (random, input.get(), n);
+        fillRandom (random, fir.get(), n);
+
+        FIR::Filter<float> filter;
+        filter.prepare ({ 0.0, n, 1 });
+        LargeBlockTest::run<float> (filter, input.get(), output.get(), n);
+
+        for (size_t i = 0; i < n; ++i)
+            expectEquals (output[i], 0.0f);
+
+        // a long filter has partitions, which have to be removed when the coefficients are emptied
+        filter.coefficients = new FIR::Coefficients<float> (fir.get(), n);
+        filter.reset();
+        filter.coefficients = new FIR::Coefficients<float>();
+        filter.reset();
+        SampleBySampleTest::run<float> (filter, input.get(), output.get(), n);
+
+        for (size_t i = 0; i < n; ++i)
+            expectEquals (output[i], 0.0f);
+    }
+
 public:
     FIRFilterTest()
         : UnitTest ("FIR Filter", UnitTestCategories::dsp)
@@ -213,6 +317,12 @@ public:
         runTestForAllTypes<LargeBlockTest> ("Large Blocks");
         runTestForAllTypes<SampleBySampleTest> ("Sample by Sample");
         runTestForAllTypes<SplitBlockTest> ("Split Block");
+
+        runLongFilterTest<LargeBlockTest> ("Long filters with large blocks");
+        runLongFilterTest<SampleBySampleTest> ("Long filters sample by sample");
+        runLongFilterTest<SplitBlockTest> ("Long filters with split blocks");
+        runChangingLongFilterTest();
+        runEmptyCoefficientsTest();
     }
 };
 
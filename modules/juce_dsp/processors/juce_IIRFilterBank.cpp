@@ -0,0 +1,366 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+//==============================================================================
+template <typename SampleType>
+FilterBank<SampleType>::FilterBank (int initialNumSections, Topology initialTopology)
+    : topology (initialTopology)
+{
+    setNumSections (initialNumSections);
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::setNumSections (int newNumSections)
+{
+    jassert (newNumSections > 0);
+
+    numSections = newNumSections;
+    sectionCoefficients.resize ((size_t) numSections, { { 1, 0, 0, 0, 0 } });
+    rampSamplesRemaining.clear();
+
+    // The bank has to be prepared again before it can process anything
+    numGroups = 0;
+    memory.free();
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::setRampDurationSeconds (double newDurationSeconds) noexcept
+{
+    jassert (newDurationSeconds >= 0);
+    rampDurationSeconds = newDurationSeconds;
+}
+
+//==============================================================================
+template <typename SampleType>
+typename FilterBank<SampleType>::SectionCoefficients FilterBank<SampleType>::toSectionCoefficients (const Coefficients<SampleType>& c) noexcept
+{
+    const auto* raw = c.getRawCoefficients();
+
+    switch (c.getFilterOrder())
+    {
+        case 1:   return { { raw[0], raw[1], 0, raw[2], 0 } };
+        case 2:   return { { raw[0], raw[1], raw[2], raw[3], raw[4] } };
+
+        default:
+            // A filter bank can only handle first and second order sections. Higher order
+            // filters should be split into several second order sections.
+            jassertfalse;
+            return { { 1, 0, 0, 0, 0 } };
+    }
+}
+
+template <typename SampleType>
+typename FilterBank<SampleType>::Lanes FilterBank<SampleType>::expand (SampleType value) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Lanes::expand (value);
+   #else
+    return value;
+   #endif
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::setCoefficients (int sectionIndex, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (sectionIndex, numSections));
+
+    const auto values = toSectionCoefficients (newCoefficients);
+    sectionCoefficients[(size_t) sectionIndex] = values;
+
+    if (numGroups == 0)
+        return;
+
+    for (size_t group = 0; group < numGroups; ++group)
+    {
+        auto* t = getTarget ((size_t) sectionIndex, group);
+
+        for (size_t k = 0; k < numCoefficients; ++k)
+            t[k] = expand (values[k]);
+
+        startRamp ((size_t) sectionIndex, group);
+    }
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::setCoefficients (int sectionIndex, int channel, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (sectionIndex, numSections));
+
+    // Per-channel coefficients can only be set once the bank has been prepared
+    jassert (isPositiveAndBelow (channel, (int) numChannels));
+
+    if (! isPositiveAndBelow (channel, (int) numChannels))
+        return;
+
+    const auto values = toSectionCoefficients (newCoefficients);
+    const auto group = (size_t) channel / numLanes;
+    auto* t = reinterpret_cast<SampleType*> (getTarget ((size_t) sectionIndex, group));
+
+    for (size_t k = 0; k < numCoefficients; ++k)
+        t[k * numLanes + (size_t) channel % numLanes] = values[k];
+
+    startRamp ((size_t) sectionIndex, group);
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::startRamp (size_t sectionIndex, size_t group) noexcept
+{
+    auto* c = getCurrent (sectionIndex, group);
+    auto* t = getTarget (sectionIndex, group);
+    auto* inc = getIncrement (sectionIndex, group);
+
+    for (size_t k = 0; k < numCoefficients; ++k)
+    {
+        if (rampLength > 0)
+            inc[k] = (t[k] - c[k]) * expand (static_cast<SampleType> (1.0 / rampLength));
+        else
+            c[k] = t[k];
+    }
+
+    getRampSamplesRemaining (sectionIndex, group) = rampLength;
+}
+
+//==============================================================================
+template <typename SampleType>
+void FilterBank<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    numChannels = spec.numChannels;
+    maxBlockSize = spec.maximumBlockSize;
+    numGroups = (numChannels + numLanes - 1) / numLanes;
+    rampLength = roundToInt (rampDurationSeconds * sampleRate);
+
+    const auto numSectionLanes = (size_t) numSections * numGroups;
+    rampSamplesRemaining.assign (numSectionLanes, 0);
+
+    memory.malloc ((numSectionLanes * (3 * numCoefficients + 2) + 2 * numGroups * maxBlockSize + 1) * sizeof (Lanes));
+    current       = reinterpret_cast<Lanes*> (snapPointerToAlignment (memory.getData(), sizeof (Lanes)));
+    target        = current   + numSectionLanes * numCoefficients;
+    increment     = target    + numSectionLanes * numCoefficients;
+    state         = increment + numSectionLanes * numCoefficients;
+    inputScratch  = state     + numSectionLanes * 2;
+    outputScratch = inputScratch + numGroups * maxBlockSize;
+
+    for (size_t sectionIndex = 0; sectionIndex < (size_t) numSections; ++sectionIndex)
+    {
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            auto* c = getCurrent (sectionIndex, group);
+            auto* t = getTarget (sectionIndex, group);
+            auto* inc = getIncrement (sectionIndex, group);
+
+            for (size_t k = 0; k < numCoefficients; ++k)
+            {
+                c[k] = t[k] = expand (sectionCoefficients[sectionIndex][k]);
+                inc[k] = expand (0);
+            }
+        }
+    }
+
+    reset();
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::reset() noexcept
+{
+    for (size_t i = 0; i < (size_t) numSections * numGroups * 2; ++i)
+        state[i] = expand (0);
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::snapToZero() noexcept
+{
+    for (size_t i = 0; i < (size_t) numSections * numGroups * 2; ++i)
+        util::snapToZero (state[i]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void FilterBank<SampleType>::processBlock (const AudioBlock<const SampleType>& inputBlock,
+                                           AudioBlock<SampleType>& outputBlock) noexcept
+{
+    const auto channelsToProcess = outputBlock.getNumChannels();
+    const auto numSamples = outputBlock.getNumSamples();
+
+    jassert (numGroups > 0);    // The bank hasn't been prepared!
+    jassert (channelsToProcess <= numChannels);
+    jassert (numSamples <= maxBlockSize);
+
+    const auto groupsToProcess = (channelsToProcess + numLanes - 1) / numLanes;
+
+    for (size_t group = 0; group < groupsToProcess; ++group)
+    {
+        auto* src = inputScratch  + group * maxBlockSize;
+        auto* dst = outputScratch + group * maxBlockSize;
+
+        // Interleave the channels of this group, one channel per lane
+        auto* interleaved = reinterpret_cast<SampleType*> (src);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            const auto channel = group * numLanes + lane;
+
+            if (channel < channelsToProcess)
+            {
+                const auto* channelData = inputBlock.getChannelPointer (channel);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    interleaved[i * numLanes + lane] = channelData[i];
+            }
+            else
+            {
+                for (size_t i = 0; i < numSamples; ++i)
+                    interleaved[i * numLanes + lane] = 0;
+            }
+        }
+
+        if (topology == Topology::series)
+        {
+            for (size_t sectionIndex = 0; sectionIndex < (size_t) numSections; ++sectionIndex)
+                processSection<false> (sectionIndex, group, src, src, numSamples);
+
+            dst = src;
+        }
+        else
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                dst[i] = expand (0);
+
+            for (size_t sectionIndex = 0; sectionIndex < (size_t) numSections; ++sectionIndex)
+                processSection<true> (sectionIndex, group, src, dst, numSamples);
+        }
+
+        const auto* result = reinterpret_cast<const SampleType*> (dst);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            const auto channel = group * numLanes + lane;
+
+            if (channel < channelsToProcess)
+            {
+                auto* channelData = outputBlock.getChannelPointer (channel);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    channelData[i] = result[i * numLanes + lane];
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+template <bool accumulate>
+void FilterBank<SampleType>::processSection (size_t sectionIndex, size_t group,
+                                             const Lanes* src, Lanes* dst, size_t numSamples) noexcept
+{
+    auto* coeffs = getCurrent (sectionIndex, group);
+    auto* lv = getState (sectionIndex, group);
+
+    auto b0 = coeffs[0];
+    auto b1 = coeffs[1];
+    auto b2 = coeffs[2];
+    auto a1 = coeffs[3];
+    auto a2 = coeffs[4];
+
+    auto lv1 = lv[0];
+    auto lv2 = lv[1];
+
+    auto processSample = [&] (size_t i) noexcept
+    {
+        const auto in = src[i];
+        const auto out = (in * b0) + lv1;
+
+        lv1 = (in * b1) - (out * a1) + lv2;
+        lv2 = (in * b2) - (out * a2);
+
+        if (accumulate)
+            dst[i] += out;
+        else
+            dst[i] = out;
+    };
+
+    size_t i = 0;
+    auto& rampSamplesLeft = getRampSamplesRemaining (sectionIndex, group);
+    const auto rampRemaining = (size_t) rampSamplesLeft;
+
+    if (rampRemaining > 0)
+    {
+        const auto* inc = getIncrement (sectionIndex, group);
+        const auto numRampSamples = jmin (rampRemaining, numSamples);
+        rampSamplesLeft -= (int) numRampSamples;
+
+        for (; i < numRampSamples; ++i)
+        {
+            b0 += inc[0];
+            b1 += inc[1];
+            b2 += inc[2];
+            a1 += inc[3];
+            a2 += inc[4];
+
+            processSample (i);
+        }
+
+        if (numRampSamples == rampRemaining)
+        {
+            // Land exactly on the target, whatever rounding errors have built up
+            const auto* t = getTarget (sectionIndex, group);
+
+            b0 = t[0];
+            b1 = t[1];
+            b2 = t[2];
+            a1 = t[3];
+            a2 = t[4];
+        }
+
+        coeffs[0] = b0;
+        coeffs[1] = b1;
+        coeffs[2] = b2;
+        coeffs[3] = a1;
+        coeffs[4] = a2;
+    }
+
+    for (; i < numSamples; ++i)
+        processSample (i);
+
+    lv[0] = lv1;
+    lv[1] = lv2;
+}
+
+//==============================================================================
+template class FilterBank<float>;
+template class FilterBank<double>;
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
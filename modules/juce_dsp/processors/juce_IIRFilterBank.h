@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+/**
+    Processes a whole bank of second-order IIR sections on a multi-channel signal.
+
+    The sections can either be run in series, like the bands of a graphic EQ, or in
+    parallel, in which case each section is fed with the input signal and their
+    outputs are summed, like in a filter bank used for resynthesis.
+
+    The coefficients and states are stored as structures of arrays, with one channel
+    in each element of a SIMDRegister, so that each section processes a whole group
+    of channels with every vector multiply-add. A 31-band EQ on 8 channels only needs
+    to run 62 vectorised biquads with SSE, rather than 248 scalar ones.
+
+    When the coefficients of a section are changed after prepare() has been called,
+    the filter interpolates linearly from the old set to the new one over a short
+    ramp, to avoid the zipper noise caused by sudden coefficient changes. The stable
+    region of second-order denominators is convex, so every set of coefficients along
+    the ramp is stable too. If you need fast modulation of cutoff frequencies though,
+    you should still prefer the StateVariableTPTFilter class.
+
+    @see IIR::Filter, IIR::Coefficients
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class FilterBank
+{
+public:
+    //==============================================================================
+    /** The way the sections of a bank are connected together. */
+    enum class Topology
+    {
+        series,     /**< The output of each section is fed into the next one. */
+        parallel    /**< Every section is fed with the input, and their outputs are summed. */
+    };
+
+    //==============================================================================
+    /** Creates a filter bank with the given number of sections.
+
+        All of the sections are initially set to let the signal through unchanged.
+    */
+    explicit FilterBank (int numSections = 1, Topology topology = Topology::series);
+
+    //==============================================================================
+    /** Changes the number of sections in the bank.
+
+        This function is not realtime-safe, and you must call prepare() again after
+        calling it. New sections are set to let the signal through unchanged.
+    */
+    void setNumSections (int newNumSections);
+
+    /** Returns the number of sections in the bank. */
+    int getNumSections() const noexcept                  { return numSections; }
+
+    /** Changes the way the sections are connected together. */
+    void setTopology (Topology newTopology) noexcept     { topology = newTopology; }
+
+    /** Returns the way the sections are connected together. */
+    Topology getTopology() const noexcept                { return topology; }
+
+    /** Sets the time taken to move from one set of coefficients to a new one.
+
+        The default is 20 ms. A duration of zero applies new coefficients immediately.
+        This will only affect ramps that start after the next call to prepare().
+    */
+    void setRampDurationSeconds (double newDurationSeconds) noexcept;
+
+    //==============================================================================
+    /** Sets the coefficients of one section for all the channels.
+
+        The coefficients must be either of first or second order. This function doesn't
+        allocate, so it can be called from the audio thread between process() calls.
+    */
+    void setCoefficients (int sectionIndex, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    /** Sets the coefficients of one section for a single channel.
+
+        The coefficients must be either of first or second order. This can only be used
+        once the filter bank has been prepared, as that's when the number of channels
+        is known. Calling prepare() again replaces the coefficients of every channel with
+        the ones that were last set for all the channels.
+    */
+    void setCoefficients (int sectionIndex, int channel, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    //==============================================================================
+    /** Initialises the filter bank, and jumps straight to the latest coefficients. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of the filters. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                       "The sample-type of the filter bank must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom (inputBlock);
+
+            return;
+        }
+
+        processBlock (inputBlock, outputBlock);
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        snapToZero();
+       #endif
+    }
+
+    /** Ensure that the state variables are rounded to zero if the state
+        variables are denormals.
+    */
+    void snapToZero() noexcept;
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Lanes = SIMDRegister<SampleType>;
+   #else
+    using Lanes = SampleType;
+   #endif
+
+    static constexpr size_t numLanes = sizeof (Lanes) / sizeof (SampleType);
+    static constexpr size_t numCoefficients = 5;
+
+    using SectionCoefficients = std::array<SampleType, numCoefficients>;
+
+    static SectionCoefficients toSectionCoefficients (const Coefficients<SampleType>&) noexcept;
+    static Lanes expand (SampleType) noexcept;
+
+    void processBlock (const AudioBlock<const SampleType>&, AudioBlock<SampleType>&) noexcept;
+
+    template <bool accumulate>
+    void processSection (size_t sectionIndex, size_t group, const Lanes* src, Lanes* dst, size_t numSamples) noexcept;
+
+    void startRamp (size_t sectionIndex, size_t group) noexcept;
+
+    Lanes* getCurrent   (size_t sectionIndex, size_t group) noexcept  { return current   + (sectionIndex * numGroups + group) * numCoefficients; }
+    Lanes* getTarget    (size_t sectionIndex, size_t group) noexcept  { return target    + (sectionIndex * numGroups + group) * numCoefficients; }
+    Lanes* getIncrement (size_t sectionIndex, size_t group) noexcept  { return increment + (sectionIndex * numGroups + group) * numCoefficients; }
+    Lanes* getState     (size_t sectionIndex, size_t group) noexcept  { return state     + (sectionIndex * numGroups + group) * 2; }
+    int& getRampSamplesRemaining (size_t sectionIndex, size_t group) noexcept  { return rampSamplesRemaining[sectionIndex * numGroups + group]; }
+
+    //==============================================================================
+    int numSections = 0;
+    Topology topology = Topology::series;
+    std::vector<SectionCoefficients> sectionCoefficients;
+    std::vector<int> rampSamplesRemaining;
+
+    double sampleRate = 44100.0, rampDurationSeconds = 0.02;
+    int rampLength = 0;
+    size_t numChannels = 0, numGroups = 0, maxBlockSize = 0;
+
+    HeapBlock<char> memory;
+    Lanes* current = nullptr;
+    Lanes* target = nullptr;
+    Lanes* increment = nullptr;
+    Lanes* state = nullptr;
+    Lanes* inputScratch = nullptr;
+    Lanes* outputScratch = nullptr;
+
+    JUCE_LEAK_DETECTOR (FilterBank)
+};
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
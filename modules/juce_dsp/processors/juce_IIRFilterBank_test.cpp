@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class IIRFilterBankTest : public UnitTest
+{
+public:
+    IIRFilterBankTest()
+        : UnitTest ("IIR Filter Bank", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        const auto coefficients = makeCoefficients();
+
+        beginTest ("Series banks match a cascade of IIR filters");
+        {
+            for (auto numChannels : { 1, 3, 5, 8 })
+            {
+                IIR::FilterBank<float> bank ((int) coefficients.size());
+
+                for (size_t i = 0; i < coefficients.size(); ++i)
+                    bank.setCoefficients ((int) i, *coefficients[i]);
+
+                bank.prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+
+                const auto input = makeNoise (numChannels);
+                auto output = input;
+                processInBlocks (bank, output);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    auto expected = getChannel (input, ch);
+
+                    for (auto& c : coefficients)
+                        filter (c, expected);
+
+                    expectChannelIsSimilar (output, ch, expected);
+                }
+            }
+        }
+
+        beginTest ("Parallel banks match the sum of IIR filters");
+        {
+            IIR::FilterBank<float> bank ((int) coefficients.size(), IIR::FilterBank<float>::Topology::parallel);
+
+            for (size_t i = 0; i < coefficients.size(); ++i)
+                bank.setCoefficients ((int) i, *coefficients[i]);
+
+            bank.prepare ({ sampleRate, (uint32) blockSize, 6 });
+
+            const auto input = makeNoise (6);
+            auto output = input;
+            processInBlocks (bank, output);
+
+            for (int ch = 0; ch < 6; ++ch)
+            {
+                std::vector<float> expected ((size_t) numSamples, 0.0f);
+
+                for (auto& c : coefficients)
+                {
+                    auto band = getChannel (input, ch);
+                    filter (c, band);
+
+                    for (size_t i = 0; i < band.size(); ++i)
+                        expected[i] += band[i];
+                }
+
+                expectChannelIsSimilar (output, ch, expected);
+            }
+        }
+
+        beginTest ("Channels can have their own coefficients");
+        {
+            IIR::FilterBank<float> bank (2);
+            bank.setRampDurationSeconds (0.0);
+            bank.prepare ({ sampleRate, (uint32) blockSize, 5 });
+
+            bank.setCoefficients (0, *coefficients[0]);
+            bank.setCoefficients (1, 3, *coefficients[1]);
+
+            const auto input = makeNoise (5);
+            auto output = input;
+            processInBlocks (bank, output);
+
+            for (int ch = 0; ch < 5; ++ch)
+            {
+                auto expected = getChannel (input, ch);
+                filter (coefficients[0], expected);
+
+                if (ch == 3)
+                    filter (coefficients[1], expected);
+
+                expectChannelIsSimilar (output, ch, expected);
+            }
+        }
+
+        beginTest ("Coefficient changes are ramped");
+        {
+            auto getLargestStep = [] (double rampDuration)
+            {
+                IIR::FilterBank<double> bank (1);
+                bank.setRampDurationSeconds (rampDuration);
+                bank.setCoefficients (0, *IIR::Coefficients<double>::makeLowShelf (sampleRate, 500.0, 0.7, 1.0));
+                bank.prepare ({ sampleRate, (uint32) blockSize, 1 });
+
+                AudioBuffer<double> buffer (1, blockSize);
+                AudioBlock<double> block (buffer);
+                auto largestStep = 0.0, lastSample = 1.0;
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    if (i == 10)
+                        bank.setCoefficients (0, *IIR::Coefficients<double>::makeLowShelf (sampleRate, 500.0, 0.7, 4.0));
+
+                    block.fill (1.0);
+                    bank.process (ProcessContextReplacing<double> (block));
+
+                    for (int n = 0; n < blockSize; ++n)
+                    {
+                        const auto sample = buffer.getSample (0, n);
+                        largestStep = jmax (largestStep, std::abs (sample - lastSample));
+                        lastSample = sample;
+                    }
+                }
+
+                // Once the ramp is over, the DC gain must be the new one
+                return std::make_pair (largestStep, lastSample);
+            };
+
+            const auto immediate = getLargestStep (0.0);
+            const auto ramped = getLargestStep (0.05);
+
+            expectWithinAbsoluteError (immediate.second, 4.0, 1.0e-6);
+            expectWithinAbsoluteError (ramped.second, 4.0, 1.0e-6);
+            expectLessThan (ramped.first * 10.0, immediate.first);
+        }
+
+        beginTest ("Ramps only advance for the channels that are processed");
+        {
+            constexpr int numChannels = 16;
+
+            auto createBank = []
+            {
+                auto bank = std::make_unique<IIR::FilterBank<float>> (1);
+                bank->setRampDurationSeconds (0.05);
+                bank->setCoefficients (0, *IIR::Coefficients<float>::makeLowShelf (sampleRate, 500.0f, 0.7f, 1.0f));
+                bank->prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+                bank->setCoefficients (0, *IIR::Coefficients<float>::makeLowShelf (sampleRate, 500.0f, 0.7f, 4.0f));
+                return bank;
+            };
+
+            auto partlyProcessedBank = createBank();
+            auto freshBank = createBank();
+
+            // Run the first two channels for longer than the ramp, which mustn't move the
+            // ramps of the channels that weren't processed
+            AudioBuffer<float> buffer (numChannels, blockSize);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto block = AudioBlock<float> (buffer).getSubsetChannelBlock (0, 2);
+                block.fill (1.0f);
+                partlyProcessedBank->process (ProcessContextReplacing<float> (block));
+            }
+
+            const auto input = makeNoise (numChannels);
+            AudioBuffer<float> partlyProcessedOutput (numChannels, blockSize), freshOutput (numChannels, blockSize);
+
+            for (auto* output : { &partlyProcessedOutput, &freshOutput })
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output->copyFrom (ch, 0, input, ch, 0, blockSize);
+
+            AudioBlock<float> partlyProcessedBlock (partlyProcessedOutput), freshBlock (freshOutput);
+            partlyProcessedBank->process (ProcessContextReplacing<float> (partlyProcessedBlock));
+            freshBank->process (ProcessContextReplacing<float> (freshBlock));
+
+            for (int i = 0; i < blockSize; ++i)
+                expectEquals (partlyProcessedOutput.getSample (numChannels - 1, i), freshOutput.getSample (numChannels - 1, i));
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 64;
+    static constexpr int numSamples = 1000;
+
+    static std::vector<IIR::Coefficients<float>::Ptr> makeCoefficients()
+    {
+        return { IIR::Coefficients<float>::makePeakFilter (sampleRate, 100.0f, 1.0f, 2.0f),
+                 IIR::Coefficients<float>::makeLowShelf (sampleRate, 300.0f, 0.5f, 0.5f),
+                 IIR::Coefficients<float>::makeFirstOrderHighPass (sampleRate, 20.0f),
+                 IIR::Coefficients<float>::makePeakFilter (sampleRate, 2000.0f, 4.0f, 0.25f),
+                 IIR::Coefficients<float>::makeHighShelf (sampleRate, 8000.0f, 0.7f, 1.5f) };
+    }
+
+    static AudioBuffer<float> makeNoise (int numChannels)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        Random random (12345);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return buffer;
+    }
+
+    static std::vector<float> getChannel (const AudioBuffer<float>& buffer, int channel)
+    {
+        const auto* data = buffer.getReadPointer (channel);
+        return { data, data + buffer.getNumSamples() };
+    }
+
+    static void filter (IIR::Coefficients<float>::Ptr coefficients, std::vector<float>& samples)
+    {
+        IIR::Filter<float> filter (coefficients);
+
+        for (auto& s : samples)
+            s = filter.processSample (s);
+    }
+
+    static void processInBlocks (IIR::FilterBank<float>& bank, AudioBuffer<float>& buffer)
+    {
+        for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+        {
+            AudioBlock<float> block (buffer);
+            auto subBlock = block.getSubBlock ((size_t) start, (size_t) jmin (blockSize, buffer.getNumSamples() - start));
+            bank.process (ProcessContextReplacing<float> (subBlock));
+        }
+    }
+
+    void expectChannelIsSimilar (const AudioBuffer<float>& buffer, int channel, const std::vector<float>& expected)
+    {
+        auto maxError = 0.0f;
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            maxError = jmax (maxError, std::abs (buffer.getSample (channel, i) - expected[(size_t) i]));
+
+        expectLessThan (maxError, 1.0e-5f);
+    }
+};
+
+static IIRFilterBankTest iirFilterBankTest;
+
+} // namespace dsp
+} // namespace juce
@@ -528,6 +528,328 @@ private:
 };
 
 
+//==============================================================================
+/** Oversampling stage class performing any integer factor of oversampling using
+    polyphase FIR filters designed with the Kaiser window method. The filters are
+    linear phase, or can be converted to minimum phase to reduce the latency.
+
+    The channels are processed in groups, with one channel in each element of a
+    SIMDRegister, so that the filtering of a whole group is done with vector
+    multiply-adds.
+*/
+template <typename SampleType>
+struct OversamplingPolyphaseFIR  : public Oversampling<SampleType>::OversamplingStage
+{
+    using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+
+   #if JUCE_USE_SIMD
+    using Lanes = SIMDRegister<SampleType>;
+    static Lanes expand (SampleType value) noexcept                     { return Lanes::expand (value); }
+    static SampleType getLane (const Lanes& l, size_t i) noexcept       { return l.get (i); }
+    static void setLane (Lanes& l, size_t i, SampleType v) noexcept     { l.set (i, v); }
+   #else
+    using Lanes = SampleType;
+    static Lanes expand (SampleType value) noexcept                     { return value; }
+    static SampleType getLane (Lanes l, size_t) noexcept                { return l; }
+    static void setLane (Lanes& l, size_t, SampleType v) noexcept       { l = v; }
+   #endif
+
+    static constexpr size_t numLanes = sizeof (Lanes) / sizeof (SampleType);
+
+    OversamplingPolyphaseFIR (size_t numChans,
+                              size_t newFactor,
+                              bool isMinimumPhase,
+                              SampleType normalisedTransitionWidthUp,
+                              SampleType stopbandAmplitudedBUp,
+                              SampleType normalisedTransitionWidthDown,
+                              SampleType stopbandAmplitudedBDown)
+        : ParentType (numChans, newFactor)
+    {
+        jassert (newFactor > 1);
+
+        const auto firUp   = designFilter (newFactor, normalisedTransitionWidthUp,   stopbandAmplitudedBUp,   isMinimumPhase);
+        const auto firDown = designFilter (newFactor, normalisedTransitionWidthDown, stopbandAmplitudedBDown, isMinimumPhase);
+
+        latency = static_cast<SampleType> (getGroupDelay (firUp) + getGroupDelay (firDown));
+
+        // The upsampling filter is split into one sub-filter per output phase. Both sets of
+        // coefficients are stored in reverse, ready to be applied to a window of the history
+        // which runs from the oldest to the newest sample.
+        numTapsUp = (firUp.size() + newFactor - 1) / newFactor;
+        coefficientsUp.allocate (numTapsUp * newFactor);
+
+        for (size_t phase = 0; phase < newFactor; ++phase)
+        {
+            for (size_t tap = 0; tap < numTapsUp; ++tap)
+            {
+                const auto index = (numTapsUp - 1 - tap) * newFactor + phase;
+
+                // Zero stuffing divides the level by the factor, so it's made up for here
+                coefficientsUp[phase * numTapsUp + tap] = expand (index < firUp.size() ? static_cast<SampleType> (firUp[index] * (double) newFactor)
+                                                                                      : SampleType());
+            }
+        }
+
+        numTapsDown = firDown.size();
+        coefficientsDown.allocate (numTapsDown);
+
+        for (size_t tap = 0; tap < numTapsDown; ++tap)
+            coefficientsDown[tap] = expand (static_cast<SampleType> (firDown[numTapsDown - 1 - tap]));
+
+        // The histories are stored twice over, so that the most recent samples can always be
+        // read as one contiguous window
+        numGroups = (this->numChannels + numLanes - 1) / numLanes;
+        historyUp  .allocate (numGroups * numTapsUp   * 2);
+        historyDown.allocate (numGroups * numTapsDown * 2);
+        positionsUp  .resize (numGroups);
+        positionsDown.resize (numGroups);
+    }
+
+    //==============================================================================
+    SampleType getLatencyInSamples() const override
+    {
+        return latency;
+    }
+
+    void reset() override
+    {
+        ParentType::reset();
+
+        historyUp.clear();
+        historyDown.clear();
+
+        std::fill (positionsUp.begin(),   positionsUp.end(),   (size_t) 0);
+        std::fill (positionsDown.begin(), positionsDown.end(), (size_t) 0);
+    }
+
+    void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        const auto numChannelsToProcess = inputBlock.getNumChannels();
+        const auto numSamples = inputBlock.getNumSamples();
+        const auto numPhases = ParentType::factor;
+
+        for (size_t group = 0; group * numLanes < numChannelsToProcess; ++group)
+        {
+            const auto firstChannel = group * numLanes;
+            const auto numChannelsInGroup = jmin (numLanes, numChannelsToProcess - firstChannel);
+
+            const SampleType* inputs[numLanes];
+            SampleType* outputs[numLanes];
+
+            for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+            {
+                inputs[lane]  = inputBlock.getChannelPointer (firstChannel + lane);
+                outputs[lane] = ParentType::buffer.getWritePointer (static_cast<int> (firstChannel + lane));
+            }
+
+            auto* history = historyUp.get() + group * numTapsUp * 2;
+            auto pos = positionsUp[group];
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto input = expand (0);
+
+                for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+                    setLane (input, lane, inputs[lane][i]);
+
+                history[pos] = input;
+                history[pos + numTapsUp] = input;
+
+                pos = (pos + 1 == numTapsUp ? 0 : pos + 1);
+
+                const auto* window = history + pos;
+
+                for (size_t phase = 0; phase < numPhases; ++phase)
+                {
+                    const auto out = dotProduct (window, coefficientsUp.get() + phase * numTapsUp, numTapsUp);
+
+                    for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+                        outputs[lane][i * numPhases + phase] = getLane (out, lane);
+                }
+            }
+
+            positionsUp[group] = pos;
+        }
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        const auto numChannelsToProcess = outputBlock.getNumChannels();
+        const auto numSamples = outputBlock.getNumSamples();
+        const auto numPhases = ParentType::factor;
+
+        for (size_t group = 0; group * numLanes < numChannelsToProcess; ++group)
+        {
+            const auto firstChannel = group * numLanes;
+            const auto numChannelsInGroup = jmin (numLanes, numChannelsToProcess - firstChannel);
+
+            const SampleType* inputs[numLanes];
+            SampleType* outputs[numLanes];
+
+            for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+            {
+                inputs[lane]  = ParentType::buffer.getReadPointer (static_cast<int> (firstChannel + lane));
+                outputs[lane] = outputBlock.getChannelPointer (firstChannel + lane);
+            }
+
+            auto* history = historyDown.get() + group * numTapsDown * 2;
+            auto pos = positionsDown[group];
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                for (size_t phase = 0; phase < numPhases; ++phase)
+                {
+                    auto input = expand (0);
+
+                    for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+                        setLane (input, lane, inputs[lane][i * numPhases + phase]);
+
+                    history[pos] = input;
+                    history[pos + numTapsDown] = input;
+
+                    pos = (pos + 1 == numTapsDown ? 0 : pos + 1);
+
+                    // Only the first sample of each group of phases produces an output
+                    if (phase == 0)
+                    {
+                        const auto out = dotProduct (history + pos, coefficientsDown.get(), numTapsDown);
+
+                        for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+                            outputs[lane][i] = getLane (out, lane);
+                    }
+                }
+            }
+
+            positionsDown[group] = pos;
+        }
+    }
+
+private:
+    //==============================================================================
+    /** An array of Lanes with the right alignment for SIMD loads and stores. */
+    struct LanesArray
+    {
+        void allocate (size_t newSize)
+        {
+            size = newSize;
+            memory.malloc (size * sizeof (Lanes) + alignof (Lanes));
+            data = snapPointerToAlignment (reinterpret_cast<Lanes*> (memory.getData()), alignof (Lanes));
+            clear();
+        }
+
+        void clear() noexcept                           { std::fill (data, data + size, expand (0)); }
+        Lanes* get() const noexcept                     { return data; }
+        Lanes& operator[] (size_t index) noexcept       { return data[index]; }
+
+        HeapBlock<char> memory;
+        Lanes* data = nullptr;
+        size_t size = 0;
+    };
+
+    static Lanes dotProduct (const Lanes* samples, const Lanes* coeffs, size_t numTaps) noexcept
+    {
+        auto result = expand (0);
+
+        for (size_t i = 0; i < numTaps; ++i)
+            result += samples[i] * coeffs[i];
+
+        return result;
+    }
+
+    /** Designs a low-pass filter at the input Nyquist frequency, with a unity gain. */
+    static std::vector<double> designFilter (size_t factor, SampleType normalisedTransitionWidth,
+                                             SampleType stopbandAmplitudedB, bool isMinimumPhase)
+    {
+        // The transition width is relative to the sample rate of a factor-of-two stage
+        auto coeffs = FilterDesign<double>::designFIRLowpassKaiserMethod (0.5 / (double) factor, 1.0,
+                                                                          2.0 * (double) normalisedTransitionWidth / (double) factor,
+                                                                          (double) stopbandAmplitudedB);
+
+        const auto* raw = coeffs->getRawCoefficients();
+        std::vector<double> result (raw, raw + coeffs->getFilterOrder() + 1);
+
+        double sum = 0;
+
+        for (auto c : result)
+            sum += c;
+
+        for (auto& c : result)
+            c /= sum;
+
+        if (isMinimumPhase)
+            convertToMinimumPhase (result);
+
+        return result;
+    }
+
+    /** Replaces a filter with the minimum phase filter that has the same magnitude
+        response, using the homomorphic (cepstrum) method.
+    */
+    static void convertToMinimumPhase (std::vector<double>& fir)
+    {
+        const auto order = jmax (10, (int) std::ceil (std::log2 ((double) fir.size() * 16.0)));
+        const auto size = (size_t) 1 << order;
+
+        FFT fft (order);
+        std::vector<Complex<float>> a (size), b (size);
+
+        for (size_t i = 0; i < fir.size(); ++i)
+            a[i] = (float) fir[i];
+
+        fft.perform (a.data(), b.data(), false);
+
+        // The floor keeps the logarithm finite at any zeros in the stop band
+        for (size_t i = 0; i < size; ++i)
+            a[i] = std::log (jmax (std::abs (b[i]), 1.0e-9f));
+
+        fft.perform (a.data(), b.data(), true);
+
+        // Folding the real cepstrum onto its causal half gives the minimum phase spectrum
+        for (size_t i = 0; i < size; ++i)
+            a[i] = (i == 0 || i == size / 2) ? b[i].real() : (i < size / 2 ? 2.0f * b[i].real() : 0.0f);
+
+        fft.perform (a.data(), b.data(), false);
+
+        for (size_t i = 0; i < size; ++i)
+            a[i] = std::exp (b[i]);
+
+        fft.perform (a.data(), b.data(), true);
+
+        for (size_t i = 0; i < fir.size(); ++i)
+            fir[i] = (double) b[i].real();
+    }
+
+    /** Returns the group delay of a filter at DC, which is its latency for low frequencies. */
+    static double getGroupDelay (const std::vector<double>& fir) noexcept
+    {
+        double weighted = 0, sum = 0;
+
+        for (size_t i = 0; i < fir.size(); ++i)
+        {
+            weighted += (double) i * fir[i];
+            sum += fir[i];
+        }
+
+        return weighted / sum;
+    }
+
+    //==============================================================================
+    LanesArray coefficientsUp, coefficientsDown, historyUp, historyDown;
+    std::vector<size_t> positionsUp, positionsDown;
+    size_t numTapsUp = 0, numTapsDown = 0, numGroups = 0;
+    SampleType latency = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingPolyphaseFIR)
+};
+
+
 //==============================================================================
 template <typename SampleType>
 Oversampling<SampleType>::Oversampling (size_t newNumChannels)
@@ -547,43 +869,23 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
     jassert (isPositiveAndBelow (newFactor, 5) && numChannels > 0);
 
     if (newFactor == 0)
-    {
         addDummyOversamplingStage();
-    }
-    else if (newType == FilterType::filterHalfBandPolyphaseIIR)
-    {
-        for (size_t n = 0; n < newFactor; ++n)
-        {
-            auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
-            auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
-
-            auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
-            auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
-            auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
-            auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
-
-            addOversamplingStage (FilterType::filterHalfBandPolyphaseIIR,
-                                  twUp, gaindBStartUp + gaindBFactorUp * (float) n,
-                                  twDown, gaindBStartDown + gaindBFactorDown * (float) n);
-        }
-    }
-    else if (newType == FilterType::filterHalfBandFIREquiripple)
-    {
-        for (size_t n = 0; n < newFactor; ++n)
-        {
-            auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
-            auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
+    else
+        addDefaultOversamplingStages (newType, (size_t) 1 << newFactor, isMaximumQuality);
+}
 
-            auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
-            auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
-            auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
-            auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
+template <typename SampleType>
+Oversampling<SampleType>::Oversampling (size_t newNumChannels, FilterType newType,
+                                        size_t newOversamplingFactor, bool isMaximumQuality,
+                                        bool useIntegerLatency)
+    : numChannels (newNumChannels), shouldUseIntegerLatency (useIntegerLatency)
+{
+    jassert (newOversamplingFactor > 0 && numChannels > 0);
 
-            addOversamplingStage (FilterType::filterHalfBandFIREquiripple,
-                                  twUp, gaindBStartUp + gaindBFactorUp * (float) n,
-                                  twDown, gaindBStartDown + gaindBFactorDown * (float) n);
-        }
-    }
+    if (newOversamplingFactor <= 1)
+        addDummyOversamplingStage();
+    else
+        addDefaultOversamplingStages (newType, newOversamplingFactor, isMaximumQuality);
 }
 
 template <typename SampleType>
@@ -606,20 +908,89 @@ void Oversampling<SampleType>::addOversamplingStage (FilterType type,
                                                      float normalisedTransitionWidthDown,
                                                      float stopbandAmplitudedBDown)
 {
+    addOversamplingStage (type, 2,
+                          normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                          normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+}
+
+template <typename SampleType>
+void Oversampling<SampleType>::addOversamplingStage (FilterType type,
+                                                     size_t stageFactor,
+                                                     float normalisedTransitionWidthUp,
+                                                     float stopbandAmplitudedBUp,
+                                                     float normalisedTransitionWidthDown,
+                                                     float stopbandAmplitudedBDown)
+{
+    jassert (stageFactor > 1);
+
     if (type == FilterType::filterHalfBandPolyphaseIIR)
     {
+        // The half band filters can only be used for a factor of two!
+        jassert (stageFactor == 2);
+
         stages.add (new Oversampling2TimesPolyphaseIIR<SampleType> (numChannels,
                                                                     normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
                                                                     normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+        stageFactor = 2;
     }
-    else
+    else if (type == FilterType::filterHalfBandFIREquiripple)
     {
+        // The half band filters can only be used for a factor of two!
+        jassert (stageFactor == 2);
+
         stages.add (new Oversampling2TimesEquirippleFIR<SampleType> (numChannels,
                                                                      normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
                                                                      normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+        stageFactor = 2;
+    }
+    else
+    {
+        stages.add (new OversamplingPolyphaseFIR<SampleType> (numChannels, stageFactor,
+                                                              type == FilterType::filterPolyphaseFIRMinimumPhase,
+                                                              normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                              normalisedTransitionWidthDown, stopbandAmplitudedBDown));
     }
 
-    factorOversampling *= 2;
+    factorOversampling *= stageFactor;
+}
+
+template <typename SampleType>
+void Oversampling<SampleType>::addDefaultOversamplingStages (FilterType type, size_t oversamplingFactor, bool isMaximumQuality)
+{
+    size_t n = 0;
+
+    for (size_t stageFactor = 2; oversamplingFactor > 1;)
+    {
+        if (oversamplingFactor % stageFactor != 0)
+        {
+            ++stageFactor;
+            continue;
+        }
+
+        auto twUp   = (isMaximumQuality ? 0.10f : 0.12f) * (n == 0 ? 0.5f : 1.0f);
+        auto twDown = (isMaximumQuality ? 0.12f : 0.15f) * (n == 0 ? 0.5f : 1.0f);
+
+        auto gaindBStartUp    = (isMaximumQuality ? -90.0f : -70.0f);
+        auto gaindBStartDown  = (isMaximumQuality ? -75.0f : -60.0f);
+        auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
+        auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
+
+        // The half band filters can only do factors of two, so any other factors use
+        // the polyphase FIR filters that are closest to them
+        auto stageType = type;
+
+        if (stageFactor != 2 && type == FilterType::filterHalfBandFIREquiripple)
+            stageType = FilterType::filterPolyphaseFIR;
+        else if (stageFactor != 2 && type == FilterType::filterHalfBandPolyphaseIIR)
+            stageType = FilterType::filterPolyphaseFIRMinimumPhase;
+
+        addOversamplingStage (stageType, stageFactor,
+                              twUp, gaindBStartUp + gaindBFactorUp * (float) n,
+                              twDown, gaindBStartDown + gaindBFactorDown * (float) n);
+
+        oversamplingFactor /= stageFactor;
+        ++n;
+    }
 }
 
 template <typename SampleType>
@@ -34,7 +34,8 @@ namespace dsp
 
     This class can be configured to do a factor of 2, 4, 8 or 16 times
     oversampling, using multiple stages, with polyphase allpass IIR filters or FIR
-    filters, and latency compensation.
+    filters, and latency compensation. Using polyphase FIR filters, any integer
+    oversampling factor can be used, such as 3 or 6 times.
 
     The principle of oversampling is to increase the sample rate of a given
     non-linear process to prevent it from creating aliasing. Oversampling works
@@ -45,7 +46,12 @@ namespace dsp
     Choose between FIR or IIR filtering depending on your needs in terms of
     latency and phase distortion. With FIR filters the phase is linear but the
     latency is maximised. With IIR filtering the phase is compromised around the
-    Nyquist frequency but the latency is minimised.
+    Nyquist frequency but the latency is minimised. The minimum phase FIR filters
+    are a compromise between the two, with a much lower latency than the linear
+    phase FIR filters but a flatter phase response than the IIR filters.
+
+    The polyphase FIR stages process groups of channels together, with one channel
+    in each element of a SIMDRegister, so several channels are filtered at once.
 
     @see FilterDesign.
 
@@ -60,6 +66,8 @@ public:
     {
         filterHalfBandFIREquiripple = 0,
         filterHalfBandPolyphaseIIR,
+        filterPolyphaseFIR,             /**< Linear phase polyphase FIR filters, which can be used for any factor. */
+        filterPolyphaseFIRMinimumPhase, /**< Minimum phase polyphase FIR filters, which can be used for any factor. */
         numFilterTypes
     };
 
@@ -94,6 +102,31 @@ public:
                   bool isMaxQuality = true,
                   bool useIntegerLatency = false);
 
+    /** Constructor for any integer oversampling factor.
+
+        The factor is split into its prime factors, and a stage is added for each one.
+        The factor-of-two stages use the requested filter type, while the other stages
+        use polyphase FIR filters, which are minimum phase if the requested type is
+        filterPolyphaseFIRMinimumPhase or filterHalfBandPolyphaseIIR, and linear phase
+        otherwise.
+
+        @param numChannels          the number of channels to process with this object
+        @param type                 the type of filter design employed for filtering during
+                                    oversampling
+        @param oversamplingFactor   the total oversampling factor, which must be at least 1
+        @param isMaxQuality         if the oversampling is done using the maximum quality, where
+                                    the filters will be more efficient but the CPU load will
+                                    increase as well
+        @param useIntegerLatency    if true this processor will add some fractional delay at the
+                                    end of the signal path to ensure that the overall latency of
+                                    the oversampling is an integer
+    */
+    Oversampling (size_t numChannels,
+                  FilterType type,
+                  size_t oversamplingFactor,
+                  bool isMaxQuality = true,
+                  bool useIntegerLatency = false);
+
     /** Destructor. */
     ~Oversampling();
 
@@ -171,6 +204,21 @@ public:
                                float normalisedTransitionWidthUp,   float stopbandAmplitudedBUp,
                                float normalisedTransitionWidthDown, float stopbandAmplitudedBDown);
 
+    /** Adds a new oversampling stage to the Oversampling class, multiplying the
+        current oversampling factor by the given factor.
+
+        The half band filter types can only be used with a factor of two, but the
+        polyphase FIR types can be used with any factor greater than one. The
+        transition widths are relative to the sample rate of a factor-of-two stage,
+        so the same values give the same absolute transition band with any factor.
+
+        @see addOversamplingStage, clearOversamplingStages
+    */
+    void addOversamplingStage (FilterType,
+                               size_t stageFactor,
+                               float normalisedTransitionWidthUp,   float stopbandAmplitudedBUp,
+                               float normalisedTransitionWidthDown, float stopbandAmplitudedBDown);
+
     /** Adds a new "dummy" oversampling stage, which does nothing to the signal. Using
         one can be useful if your application features a customisable oversampling factor
         and if you want to select the current one from an OwnedArray without changing
@@ -197,6 +245,7 @@ public:
 
 private:
     //===============================================================================
+    void addDefaultOversamplingStages (FilterType, size_t oversamplingFactor, bool isMaxQuality);
     void updateDelayLine();
     SampleType getUncompensatedLatency() const noexcept;
 
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class OversamplingTest : public UnitTest
+{
+public:
+    OversamplingTest()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Arbitrary factors produce the right number of samples");
+        {
+            for (auto type : { Oversampling<float>::filterPolyphaseFIR,
+                               Oversampling<float>::filterPolyphaseFIRMinimumPhase,
+                               Oversampling<float>::filterHalfBandFIREquiripple,
+                               Oversampling<float>::filterHalfBandPolyphaseIIR })
+            {
+                for (int factor : { 1, 2, 3, 4, 5, 6, 8, 12 })
+                {
+                    Oversampling<float> oversampling (3, type, (size_t) factor);
+                    oversampling.initProcessing (blockSize);
+
+                    expectEquals ((int) oversampling.getOversamplingFactor(), factor);
+
+                    AudioBuffer<float> buffer (3, blockSize);
+                    buffer.clear();
+
+                    AudioBlock<float> block (buffer);
+                    expectEquals ((int) oversampling.processSamplesUp (block).getNumSamples(), blockSize * factor);
+                    oversampling.processSamplesDown (block);
+                }
+            }
+        }
+
+        beginTest ("Linear phase polyphase stages pass low frequencies with the reported latency");
+        {
+            for (int factor : { 2, 3, 6 })
+            {
+                Oversampling<double> oversampling (1, Oversampling<double>::filterPolyphaseFIR, (size_t) factor, true, true);
+                const auto output = processSine (oversampling, 1);
+                const auto latency = roundToInt (oversampling.getLatencyInSamples());
+
+                expect (oversampling.getLatencyInSamples() == (double) latency);
+
+                for (int i = numSamplesToSettle; i < output.getNumSamples(); ++i)
+                    expectWithinAbsoluteError (output.getSample (0, i), getSine (0, i - latency), 1.0e-3);
+            }
+        }
+
+        beginTest ("Minimum phase polyphase stages have a lower latency, and the same gain");
+        {
+            for (int factor : { 2, 3, 6 })
+            {
+                Oversampling<double> linear (1, Oversampling<double>::filterPolyphaseFIR, (size_t) factor);
+                Oversampling<double> minimum (1, Oversampling<double>::filterPolyphaseFIRMinimumPhase, (size_t) factor);
+
+                expect (minimum.getLatencyInSamples() < linear.getLatencyInSamples() * 0.5);
+
+                const auto output = processSine (minimum, 1);
+                const auto expectedRMS = std::sqrt (0.5) * amplitude;
+
+                expectWithinAbsoluteError (output.getRMSLevel (0, numSamplesToSettle, output.getNumSamples() - numSamplesToSettle),
+                                           expectedRMS, expectedRMS * 0.01);
+            }
+        }
+
+        beginTest ("Channels are processed independently of the SIMD grouping");
+        {
+            // An odd number of channels, so that the last group is only partially used
+            constexpr int numChannels = 5;
+
+            Oversampling<float> multichannel (numChannels, Oversampling<float>::filterPolyphaseFIR, 3);
+            const auto output = processSine (multichannel, numChannels);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                Oversampling<float> single (1, Oversampling<float>::filterPolyphaseFIR, 3);
+                const auto expected = processSine (single, 1, channel);
+
+                for (int i = 0; i < output.getNumSamples(); ++i)
+                    expectWithinAbsoluteError (output.getSample (channel, i), expected.getSample (0, i), 1.0e-6f);
+            }
+        }
+    }
+
+private:
+    static constexpr int blockSize = 64, numBlocks = 40, numSamplesToSettle = 1024;
+    static constexpr double amplitude = 0.5;
+
+    // A different low frequency sine for each channel
+    static double getSine (int channel, int sample)
+    {
+        const auto frequency = 0.01 * (channel + 1);
+        return sample < 0 ? 0.0 : amplitude * std::sin (MathConstants<double>::twoPi * frequency * sample);
+    }
+
+    template <typename SampleType>
+    static AudioBuffer<SampleType> processSine (Oversampling<SampleType>& oversampling, int numChannels, int firstChannel = 0)
+    {
+        oversampling.initProcessing (blockSize);
+
+        AudioBuffer<SampleType> result (numChannels, blockSize * numBlocks);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < result.getNumSamples(); ++i)
+                result.setSample (channel, i, static_cast<SampleType> (getSine (firstChannel + channel, i)));
+
+        for (int start = 0; start < result.getNumSamples(); start += blockSize)
+        {
+            auto block = AudioBlock<SampleType> (result).getSubBlock ((size_t) start, (size_t) blockSize);
+            oversampling.processSamplesUp (block);
+            oversampling.processSamplesDown (block);
+        }
+
+        return result;
+    }
+};
+
+static OversamplingTest oversamplingUnitTest;
+
+} // namespace dsp
+} // namespace juce
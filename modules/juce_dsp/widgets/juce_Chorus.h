@@ -120,22 +120,33 @@ public:
 
         dryWet.pushDrySamples (inputBlock);
 
+        // The delay is never shorter than a millisecond, so chunks of up to that length can
+        // be read from the delay line before being pushed into it, with the feedback added
+        const auto chunkSize = (size_t) jmax (1, (int) (sampleRate / 1000.0));
+        auto* delayInput = bufferDelayInput.getWritePointer (0);
+
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
             auto* inputSamples  = inputBlock .getChannelPointer (channel);
             auto* outputSamples = outputBlock.getChannelPointer (channel);
 
-            for (size_t i = 0; i < numSamples; ++i)
+            for (size_t start = 0; start < numSamples; start += chunkSize)
             {
-                auto input = inputSamples[i];
-                auto output = input - lastOutput[channel];
+                const auto num = jmin (chunkSize, numSamples - start);
+                const SampleType* tapDelays[] = { delaySamples + start };
+                SampleType* tapOutputs[] = { outputSamples + start };
+
+                // the input is copied first, as the output may use the same memory
+                std::copy (inputSamples + start, inputSamples + start + num, delayInput);
+                delay.popBlock ((int) channel, tapDelays, tapOutputs, 1, (int) num);
 
-                delay.pushSample ((int) channel, output);
-                delay.setDelay (delaySamples[i]);
-                output = delay.popSample ((int) channel);
+                for (size_t i = 0; i < num; ++i)
+                {
+                    delayInput[i] -= lastOutput[channel];
+                    lastOutput[channel] = tapOutputs[0][i] * feedbackVolume[channel].getNextValue();
+                }
 
-                outputSamples[i] = output;
-                lastOutput[channel] = output * feedbackVolume[channel].getNextValue();
+                delay.pushBlock ((int) channel, delayInput, (int) num);
             }
         }
 
@@ -153,7 +164,7 @@ private:
     std::vector<SmoothedValue<SampleType, ValueSmoothingTypes::Linear>> feedbackVolume { 2 };
     DryWetMixer<SampleType> dryWet;
     std::vector<SampleType> lastOutput { 2 };
-    AudioBuffer<SampleType> bufferDelayTimes;
+    AudioBuffer<SampleType> bufferDelayTimes, bufferDelayInput;
 
     double sampleRate = 44100.0;
     SampleType rate = 1.0, depth = 0.25, feedback = 0.0, mix = 0.5,
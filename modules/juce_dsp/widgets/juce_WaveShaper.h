@@ -61,13 +61,32 @@ struct WaveShaper
         }
         else
         {
-            AudioBlock<FloatType>::process (context.getInputBlock(),
-                                            context.getOutputBlock(),
-                                            functionToUse);
+            processBlocks (context.getInputBlock(), context.getOutputBlock(), 0);
         }
     }
 
     void reset() noexcept {}
+
+private:
+    //==============================================================================
+    // Functions that can process a whole array at once, like the lookup table classes,
+    // are given one channel at a time rather than being called for every sample
+    template <typename InputBlock, typename OutputBlock, typename Fn = Function>
+    auto processBlocks (const InputBlock& inputBlock, const OutputBlock& outputBlock, int) const noexcept
+        -> decltype (std::declval<const Fn&>().process (std::declval<const FloatType*>(), std::declval<FloatType*>(), size_t()), void())
+    {
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+        for (size_t ch = 0; ch < outputBlock.getNumChannels(); ++ch)
+            functionToUse.process (inputBlock.getChannelPointer (ch), outputBlock.getChannelPointer (ch), outputBlock.getNumSamples());
+    }
+
+    template <typename InputBlock, typename OutputBlock>
+    void processBlocks (const InputBlock& inputBlock, const OutputBlock& outputBlock, long) const noexcept
+    {
+        AudioBlock<FloatType>::process (inputBlock, outputBlock, functionToUse);
+    }
 };
 
 //==============================================================================
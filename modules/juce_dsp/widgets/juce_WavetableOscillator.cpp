@@ -0,0 +1,366 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+BandLimitedWavetable<SampleType>::BandLimitedWavetable (const std::function<SampleType (SampleType)>& function,
+                                                        int tableSizeOrder)
+{
+    jassert (tableSizeOrder > 1 && tableSizeOrder < 24);
+
+    tableSize = 1 << tableSizeOrder;
+    HeapBlock<float> cycle ((size_t) tableSize);
+
+    for (int i = 0; i < tableSize; ++i)
+        cycle[i] = (float) function (jmap ((SampleType) i, (SampleType) 0, (SampleType) tableSize,
+                                           -MathConstants<SampleType>::pi, MathConstants<SampleType>::pi));
+
+    createTables (cycle);
+}
+
+template <typename SampleType>
+BandLimitedWavetable<SampleType>::BandLimitedWavetable (const SampleType* singleCycle, int numSamples)
+{
+    // The number of samples must be a power of two, so that it can be transformed with an FFT
+    jassert (numSamples > 2 && isPowerOfTwo (numSamples));
+
+    tableSize = numSamples;
+    HeapBlock<float> cycle ((size_t) tableSize);
+
+    for (int i = 0; i < tableSize; ++i)
+        cycle[i] = (float) singleCycle[i];
+
+    createTables (cycle);
+}
+
+template <typename SampleType>
+void BandLimitedWavetable<SampleType>::createTables (const float* singleCycle)
+{
+    const auto order = roundToInt (std::log2 ((double) tableSize));
+    const auto stride = (size_t) tableSize + 1;
+    numLevels = order;
+
+    FFT fft (order);
+    HeapBlock<float> spectrum ((size_t) tableSize * 2), level ((size_t) tableSize * 2);
+
+    std::copy (singleCycle, singleCycle + tableSize, spectrum.get());
+    fft.performRealOnlyForwardTransform (spectrum, true);
+
+    tables.malloc ((size_t) numLevels * stride);
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        // The top harmonic of the first table would be at exactly half the sample rate
+        // when the table is played at its own size, so it's left out
+        const auto numHarmonics = i == 0 ? tableSize / 2 - 1 : (tableSize / 2) >> i;
+
+        std::copy (spectrum.get(), spectrum.get() + 2 * (numHarmonics + 1), level.get());
+        std::fill (level.get() + 2 * (numHarmonics + 1), level.get() + 2 * tableSize, 0.0f);
+        fft.performRealOnlyInverseTransform (level);
+
+        auto* table = tables.get() + (size_t) i * stride;
+
+        for (int j = 0; j < tableSize; ++j)
+            table[j] = (SampleType) level[j];
+
+        table[tableSize] = table[0];
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+const SampleType* BandLimitedWavetable<SampleType>::getTable (int level) const noexcept
+{
+    jassert (isPositiveAndBelow (level, numLevels));
+    return tables.get() + (size_t) level * ((size_t) tableSize + 1);
+}
+
+template <typename SampleType>
+int BandLimitedWavetable<SampleType>::getLevelForPhaseIncrement (SampleType phaseIncrement) const noexcept
+{
+    // Level n holds (tableSize / 2) >> n harmonics, and the highest of those has to stay
+    // below half the sample rate, so the smallest level that works is log2 (tableSize * increment)
+    const auto harmonicsRatio = (double) phaseIncrement * tableSize;
+
+    if (harmonicsRatio <= 1.0)
+        return 0;
+
+    return jmin (numLevels - 1, (int) std::ceil (std::log2 (harmonicsRatio)));
+}
+
+//==============================================================================
+namespace WavetableHelpers
+{
+    // The table that oscillators without a wavetable read from, with room for
+    // the interpolation's extra sample
+    template <typename SampleType>
+    const SampleType* getSilence() noexcept
+    {
+        static const SampleType silence[2] = {};
+        return silence;
+    }
+
+   #if JUCE_USE_SIMD
+    template <typename SampleType>
+    void store (SIMDRegister<SampleType> v, SampleType* dst) noexcept  { v.copyToRawArray (dst); }
+
+    template <typename SampleType>
+    SIMDRegister<SampleType> truncate (SIMDRegister<SampleType> v) noexcept  { return SIMDRegister<SampleType>::truncate (v); }
+
+    template <typename SampleType>
+    SampleType sum (SIMDRegister<SampleType> v) noexcept               { return v.sum(); }
+   #endif
+
+    template <typename SampleType>
+    void store (SampleType v, SampleType* dst) noexcept                { *dst = v; }
+
+    template <typename SampleType>
+    SampleType truncate (SampleType v) noexcept                        { return std::trunc (v); }
+
+    template <typename SampleType>
+    SampleType sum (SampleType v) noexcept                             { return v; }
+}
+
+//==============================================================================
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::Lanes WavetableOscillatorBank<SampleType>::load (const SampleType* src) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Lanes::fromRawArray (src);
+   #else
+    return *src;
+   #endif
+}
+
+template <typename SampleType>
+typename WavetableOscillatorBank<SampleType>::Lanes WavetableOscillatorBank<SampleType>::expand (SampleType value) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Lanes::expand (value);
+   #else
+    return value;
+   #endif
+}
+
+//==============================================================================
+template <typename SampleType>
+WavetableOscillatorBank<SampleType>::WavetableOscillatorBank (int initialNumOscillators)
+{
+    setNumOscillators (initialNumOscillators);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setNumOscillators (int newNumOscillators)
+{
+    jassert (newNumOscillators >= 0);
+
+    // The phases and gains are kept, so that existing oscillators carry on as they were
+    std::vector<SampleType> oldPhases (phases, phases + numOscillators);
+    std::vector<SampleType> oldGains (gains, gains + numOscillators);
+    oldGains.resize ((size_t) newNumOscillators, SampleType (1));
+    oldPhases.resize ((size_t) newNumOscillators, SampleType());
+
+    numOscillators = newNumOscillators;
+    numGroups = (numOscillators + (int) numLanes - 1) / (int) numLanes;
+
+    const auto numValues = (size_t) numGroups * numLanes;
+    memory.calloc (sizeof (Lanes) * (chunkSize + 1) + 4 * numValues * sizeof (SampleType));
+
+    scratch    = reinterpret_cast<Lanes*> (snapPointerToAlignment (memory.getData(), sizeof (Lanes)));
+    phases     = reinterpret_cast<SampleType*> (scratch + chunkSize);
+    increments = phases + numValues;
+    gains      = increments + numValues;
+    tableSizes = gains + numValues;
+
+    std::copy (oldPhases.begin(), oldPhases.end(), phases);
+    std::copy (oldGains.begin(), oldGains.end(), gains);
+
+    frequencies.resize ((size_t) numOscillators, SampleType());
+    wavetables.resize ((size_t) numOscillators);
+
+    // The unused lanes of the last group are left silent, with a gain of zero
+    tables.assign (numValues, WavetableHelpers::getSilence<SampleType>());
+    std::fill (tableSizes, tableSizes + numValues, SampleType (1));
+
+    for (int i = 0; i < numOscillators; ++i)
+        setFrequency (i, frequencies[(size_t) i]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setWavetable (typename BandLimitedWavetable<SampleType>::Ptr newWavetable)
+{
+    for (int i = 0; i < numOscillators; ++i)
+        setWavetable (i, newWavetable);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setWavetable (int oscillator, typename BandLimitedWavetable<SampleType>::Ptr newWavetable)
+{
+    jassert (isPositiveAndBelow (oscillator, numOscillators));
+
+    wavetables[(size_t) oscillator] = std::move (newWavetable);
+    updateTable (oscillator);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setFrequency (int oscillator, SampleType newFrequencyHz) noexcept
+{
+    jassert (isPositiveAndBelow (oscillator, numOscillators));
+
+    // Negative frequencies aren't supported
+    jassert (newFrequencyHz >= 0);
+
+    frequencies[(size_t) oscillator] = newFrequencyHz;
+    increments[oscillator] = static_cast<SampleType> (newFrequencyHz / sampleRate);
+    updateTable (oscillator);
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setGain (int oscillator, SampleType newGain) noexcept
+{
+    jassert (isPositiveAndBelow (oscillator, numOscillators));
+    gains[oscillator] = newGain;
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::setPhase (int oscillator, SampleType newPhase) noexcept
+{
+    jassert (isPositiveAndBelow (oscillator, numOscillators));
+    phases[oscillator] = newPhase - std::floor (newPhase);
+}
+
+template <typename SampleType>
+SampleType WavetableOscillatorBank<SampleType>::getFrequency (int oscillator) const noexcept
+{
+    jassert (isPositiveAndBelow (oscillator, numOscillators));
+    return frequencies[(size_t) oscillator];
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::updateTable (int oscillator) noexcept
+{
+    if (auto* wavetable = wavetables[(size_t) oscillator].get())
+    {
+        tables[(size_t) oscillator] = wavetable->getTable (wavetable->getLevelForPhaseIncrement (increments[oscillator]));
+        tableSizes[oscillator] = (SampleType) wavetable->getTableSize();
+    }
+    else
+    {
+        tables[(size_t) oscillator] = WavetableHelpers::getSilence<SampleType>();
+        tableSizes[oscillator] = 1;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+
+    for (int i = 0; i < numOscillators; ++i)
+        setFrequency (i, frequencies[(size_t) i]);
+
+    reset();
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::reset() noexcept
+{
+    std::fill (phases, phases + (size_t) numGroups * numLanes, SampleType());
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::renderNextBlock (SampleType* output, int numSamples) noexcept
+{
+    for (int start = 0; start < numSamples; start += chunkSize)
+        renderChunk (output + start, jmin (chunkSize, numSamples - start));
+}
+
+template <typename SampleType>
+void WavetableOscillatorBank<SampleType>::renderChunk (SampleType* output, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        scratch[i] = expand (0);
+
+    alignas (Lanes) SampleType positions[numLanes], lower[numLanes], upper[numLanes];
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        const auto offset = (size_t) group * numLanes;
+        const auto* groupTables = tables.data() + offset;
+
+        auto phase = load (phases + offset);
+        const auto increment = load (increments + offset);
+        const auto gain = load (gains + offset);
+        const auto size = load (tableSizes + offset);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            phase = phase + increment;
+            phase = phase - WavetableHelpers::truncate (phase);
+
+            const auto position = phase * size;
+            const auto index = WavetableHelpers::truncate (position);
+            const auto fraction = position - index;
+
+            WavetableHelpers::store (index, positions);
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                const auto* sample = groupTables[lane] + (int) positions[lane];
+                lower[lane] = sample[0];
+                upper[lane] = sample[1];
+            }
+
+            const auto a = load (lower);
+            const auto b = load (upper);
+
+            scratch[i] = scratch[i] + (a + (b - a) * fraction) * gain;
+        }
+
+        WavetableHelpers::store (phase, phases + offset);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        output[i] += WavetableHelpers::sum (scratch[i]);
+}
+
+//==============================================================================
+template class BandLimitedWavetable<float>;
+template class BandLimitedWavetable<double>;
+template class WavetableOscillatorBank<float>;
+template class WavetableOscillatorBank<double>;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    One cycle of a waveform, stored as a set of band-limited tables.
+
+    The waveform is sampled and transformed with an FFT, and each table keeps only
+    half of the harmonics of the one before it, so there's one table for every
+    octave of the playback frequency. When an oscillator reads the table that
+    matches its frequency, none of the harmonics it plays are above the Nyquist
+    frequency, so there is no aliasing.
+
+    The tables are immutable once they've been created, so they can be shared
+    between many oscillators.
+
+    @see WavetableOscillatorBank
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class BandLimitedWavetable  : public ReferenceCountedObject
+{
+public:
+    /** A handy typedef for a ref-counted pointer to a wavetable. */
+    using Ptr = ReferenceCountedObjectPtr<BandLimitedWavetable>;
+
+    //==============================================================================
+    /** Creates the tables from a periodic function, over the range -pi..pi.
+
+        This takes the same kind of function as the Oscillator class. The size of each
+        table is 2 to the power of tableSizeOrder.
+    */
+    explicit BandLimitedWavetable (const std::function<SampleType (SampleType)>& function,
+                                   int tableSizeOrder = 11);
+
+    /** Creates the tables from one cycle of a waveform.
+
+        The number of samples in the cycle must be a power of two, and becomes the size
+        of each of the tables.
+    */
+    BandLimitedWavetable (const SampleType* singleCycle, int numSamples);
+
+    //==============================================================================
+    /** Returns the number of samples in each table. */
+    int getTableSize() const noexcept                   { return tableSize; }
+
+    /** Returns the number of tables, one for each octave. */
+    int getNumLevels() const noexcept                   { return numLevels; }
+
+    /** Returns the table that contains the given number of harmonics. Level 0 contains
+        all the harmonics that can be represented, and each level above that contains
+        half as many as the one below. The last level is a sine wave.
+
+        Each table has one extra sample at its end, which is a copy of its first sample.
+    */
+    const SampleType* getTable (int level) const noexcept;
+
+    /** Returns the level which should be used to play the waveform with the given
+        phase increment, in cycles per sample, without aliasing.
+    */
+    int getLevelForPhaseIncrement (SampleType phaseIncrement) const noexcept;
+
+private:
+    //==============================================================================
+    void createTables (const float* singleCycle);
+
+    int tableSize = 0, numLevels = 0;
+    HeapBlock<SampleType> tables;
+
+    JUCE_LEAK_DETECTOR (BandLimitedWavetable)
+};
+
+//==============================================================================
+/**
+    Renders a bank of wavetable oscillators, and adds them all together.
+
+    The oscillators are stored as structures of arrays, with one oscillator in each
+    element of a SIMDRegister, so that a whole group of oscillators can have their
+    phases advanced and their tables interpolated with vector operations. This makes
+    it cheap to run lots of detuned oscillators in a single SynthesiserVoice, or to
+    render all the voices of a simple synth in one go.
+
+    Each oscillator has its own frequency, gain, phase and wavetable, and the tables
+    are chosen to avoid aliasing whenever the frequency changes. For example, a voice
+    with a 7-oscillator supersaw might look like this:
+
+    @code
+    void startNote (int midiNoteNumber, float, SynthesiserSound*, int) override
+    {
+        auto frequency = (float) MidiMessage::getMidiNoteInHertz (midiNoteNumber);
+
+        for (int i = 0; i < bank.getNumOscillators(); ++i)
+        {
+            bank.setFrequency (i, frequency * std::pow (2.0f, (float) (i - 3) * 0.1f / 12.0f));
+            bank.setPhase (i, random.nextFloat());
+        }
+    }
+
+    void renderNextBlock (AudioBuffer<float>& output, int startSample, int numSamples) override
+    {
+        auto* scratch = scratchBuffer.getWritePointer (0);
+        FloatVectorOperations::clear (scratch, numSamples);
+        bank.renderNextBlock (scratch, numSamples);
+
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+            output.addFrom (ch, startSample, scratch, numSamples);
+    }
+    @endcode
+
+    @see BandLimitedWavetable, Oscillator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class WavetableOscillatorBank
+{
+public:
+    //==============================================================================
+    /** Creates a bank with the given number of oscillators.
+
+        The oscillators are silent until they've been given a wavetable.
+    */
+    explicit WavetableOscillatorBank (int numOscillators = 1);
+
+    /** Changes the number of oscillators in the bank.
+
+        This function is not realtime-safe. The new oscillators are silent until
+        they've been given a wavetable.
+    */
+    void setNumOscillators (int newNumOscillators);
+
+    /** Returns the number of oscillators in the bank. */
+    int getNumOscillators() const noexcept              { return numOscillators; }
+
+    //==============================================================================
+    /** Sets the wavetable used by all the oscillators. */
+    void setWavetable (typename BandLimitedWavetable<SampleType>::Ptr newWavetable);
+
+    /** Sets the wavetable used by one oscillator. */
+    void setWavetable (int oscillator, typename BandLimitedWavetable<SampleType>::Ptr newWavetable);
+
+    /** Sets the frequency of one oscillator, in Hz. */
+    void setFrequency (int oscillator, SampleType newFrequencyHz) noexcept;
+
+    /** Sets the gain of one oscillator. */
+    void setGain (int oscillator, SampleType newGain) noexcept;
+
+    /** Sets the phase of one oscillator, between 0 and 1. */
+    void setPhase (int oscillator, SampleType newPhase) noexcept;
+
+    /** Returns the frequency of one oscillator, in Hz. */
+    SampleType getFrequency (int oscillator) const noexcept;
+
+    //==============================================================================
+    /** Called before processing starts. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the phases of all the oscillators to zero. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Adds the sum of all the oscillators to a buffer. */
+    void renderNextBlock (SampleType* output, int numSamples) noexcept;
+
+    /** Replaces the contents of every output channel with the sum of all the oscillators. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& outBlock = context.getOutputBlock();
+        const auto numChannels = outBlock.getNumChannels();
+        const auto numSamples = outBlock.getNumSamples();
+
+        jassert (context.getInputBlock().getNumSamples() == numSamples);
+
+        if (context.isBypassed || numChannels == 0)
+        {
+            outBlock.clear();
+            return;
+        }
+
+        auto* first = outBlock.getChannelPointer (0);
+        std::fill (first, first + numSamples, SampleType());
+        renderNextBlock (first, (int) numSamples);
+
+        for (size_t ch = 1; ch < numChannels; ++ch)
+            std::copy (first, first + numSamples, outBlock.getChannelPointer (ch));
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Lanes = SIMDRegister<SampleType>;
+   #else
+    using Lanes = SampleType;
+   #endif
+
+    static constexpr size_t numLanes = sizeof (Lanes) / sizeof (SampleType);
+    static constexpr int chunkSize = 64;
+
+    static Lanes load (const SampleType*) noexcept;
+    static Lanes expand (SampleType) noexcept;
+
+    void updateTable (int oscillator) noexcept;
+    void renderChunk (SampleType* output, int numSamples) noexcept;
+
+    //==============================================================================
+    int numOscillators = 0, numGroups = 0;
+    double sampleRate = 44100.0;
+
+    HeapBlock<char> memory;
+    SampleType* phases = nullptr;
+    SampleType* increments = nullptr;
+    SampleType* gains = nullptr;
+    SampleType* tableSizes = nullptr;
+    Lanes* scratch = nullptr;
+
+    std::vector<SampleType> frequencies;
+    std::vector<typename BandLimitedWavetable<SampleType>::Ptr> wavetables;
+    std::vector<const SampleType*> tables;
+
+    JUCE_LEAK_DETECTOR (WavetableOscillatorBank)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class WavetableOscillatorTest : public UnitTest
+{
+public:
+    WavetableOscillatorTest()
+        : UnitTest ("Wavetable Oscillator", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Every level of a sine table is the sine wave");
+        {
+            BandLimitedWavetable<float> wavetable ([] (float x) { return std::sin (x); });
+
+            expectEquals (wavetable.getTableSize(), 2048);
+            expectEquals (wavetable.getNumLevels(), 11);
+
+            for (int level = 0; level < wavetable.getNumLevels(); ++level)
+            {
+                const auto* table = wavetable.getTable (level);
+                auto maxError = 0.0f;
+
+                for (int i = 0; i <= wavetable.getTableSize(); ++i)
+                    maxError = jmax (maxError, std::abs (table[i] - std::sin (getAngle (i, wavetable.getTableSize()))));
+
+                expectLessThan (maxError, 1.0e-4f);
+            }
+        }
+
+        beginTest ("Levels remove the harmonics that would alias");
+        {
+            constexpr int size = 256;
+            BandLimitedWavetable<float> wavetable ([] (float x) { return x / MathConstants<float>::pi; }, 8);
+
+            expectEquals (wavetable.getNumLevels(), 8);
+
+            FFT fft (8);
+            HeapBlock<float> spectrum (size * 2);
+
+            for (int level = 0; level < wavetable.getNumLevels(); ++level)
+            {
+                std::copy (wavetable.getTable (level), wavetable.getTable (level) + size, spectrum.get());
+                fft.performFrequencyOnlyForwardTransform (spectrum, true);
+
+                const auto numHarmonics = level == 0 ? size / 2 - 1 : (size / 2) >> level;
+
+                // A saw wave's harmonics fall off as 1/n, so they're all well above this
+                for (int bin = 1; bin <= numHarmonics; ++bin)
+                    expectGreaterThan (spectrum[bin], 1.0f);
+
+                for (int bin = numHarmonics + 1; bin <= size / 2; ++bin)
+                    expectLessThan (spectrum[bin], 1.0e-3f);
+            }
+
+            expectEquals (wavetable.getLevelForPhaseIncrement (0.0f), 0);
+            expectEquals (wavetable.getLevelForPhaseIncrement (1.0f / size), 0);
+            expectEquals (wavetable.getLevelForPhaseIncrement (1.5f / size), 1);
+            expectEquals (wavetable.getLevelForPhaseIncrement (2.0f / size), 1);
+            expectEquals (wavetable.getLevelForPhaseIncrement (4.0f / size), 2);
+            expectEquals (wavetable.getLevelForPhaseIncrement (0.5f), wavetable.getNumLevels() - 1);
+        }
+
+        beginTest ("A single oscillator plays its wavetable");
+        {
+            BandLimitedWavetable<float>::Ptr wavetable (new BandLimitedWavetable<float> ([] (float x) { return std::sin (x); }));
+
+            WavetableOscillatorBank<float> bank;
+            bank.setWavetable (wavetable);
+            bank.prepare ({ sampleRate, 512, 1 });
+            bank.setFrequency (0, 1000.0f);
+
+            std::vector<float> output (1000, 0.0f);
+            bank.renderNextBlock (output.data(), (int) output.size());
+
+            auto maxError = 0.0f;
+
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                const auto phase = std::fmod ((double) (i + 1) * 1000.0 / sampleRate, 1.0);
+                maxError = jmax (maxError, std::abs (output[i] - (float) -std::sin (MathConstants<double>::twoPi * phase)));
+            }
+
+            expectLessThan (maxError, 1.0e-3f);
+        }
+
+        beginTest ("A bank adds up its oscillators");
+        {
+            constexpr int numOscillators = 7;
+
+            BandLimitedWavetable<float>::Ptr saw (new BandLimitedWavetable<float> ([] (float x) { return x / MathConstants<float>::pi; }));
+            BandLimitedWavetable<float>::Ptr square (new BandLimitedWavetable<float> ([] (float x) { return x < 0 ? -1.0f : 1.0f; }));
+
+            auto setUp = [&] (WavetableOscillatorBank<float>& bank, int oscillatorIndex, int i)
+            {
+                bank.setWavetable (oscillatorIndex, i % 2 == 0 ? saw : square);
+                bank.setFrequency (oscillatorIndex, 110.0f * (float) (i + 1) + 3.0f);
+                bank.setGain (oscillatorIndex, 1.0f / (float) (i + 1));
+                bank.setPhase (oscillatorIndex, (float) i * 0.1f);
+            };
+
+            WavetableOscillatorBank<float> bank (numOscillators);
+            bank.prepare ({ sampleRate, 512, 1 });
+
+            for (int i = 0; i < numOscillators; ++i)
+                setUp (bank, i, i);
+
+            std::vector<float> output (1000, 0.0f), expected (1000, 0.0f);
+            bank.renderNextBlock (output.data(), 300);
+            bank.renderNextBlock (output.data() + 300, 700);
+
+            for (int i = 0; i < numOscillators; ++i)
+            {
+                WavetableOscillatorBank<float> single;
+                single.prepare ({ sampleRate, 512, 1 });
+                setUp (single, 0, i);
+                single.renderNextBlock (expected.data(), (int) expected.size());
+            }
+
+            expectVectorsAreSimilar (output, expected);
+        }
+
+        beginTest ("Changing the number of oscillators keeps the existing ones");
+        {
+            BandLimitedWavetable<float>::Ptr saw (new BandLimitedWavetable<float> ([] (float x) { return x / MathConstants<float>::pi; }));
+
+            WavetableOscillatorBank<float> bank (3), reference (3);
+
+            for (auto* b : { &bank, &reference })
+            {
+                b->prepare ({ sampleRate, 512, 1 });
+                b->setWavetable (saw);
+
+                for (int i = 0; i < 3; ++i)
+                    b->setFrequency (i, 200.0f + 50.0f * (float) i);
+            }
+
+            std::vector<float> output (400, 0.0f), expected (400, 0.0f);
+            bank.renderNextBlock (output.data(), 200);
+            reference.renderNextBlock (expected.data(), 200);
+
+            // The new oscillators don't have a wavetable, so they're silent
+            bank.setNumOscillators (9);
+            expectEquals (bank.getFrequency (2), 300.0f);
+
+            bank.renderNextBlock (output.data() + 200, 200);
+            reference.renderNextBlock (expected.data() + 200, 200);
+
+            expectVectorsAreSimilar (output, expected);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    static float getAngle (int index, int size)
+    {
+        return jmap ((float) index, 0.0f, (float) size, -MathConstants<float>::pi, MathConstants<float>::pi);
+    }
+
+    void expectVectorsAreSimilar (const std::vector<float>& actual, const std::vector<float>& expected)
+    {
+        auto maxError = 0.0f;
+
+        for (size_t i = 0; i < actual.size(); ++i)
+            maxError = jmax (maxError, std::abs (actual[i] - expected[i]));
+
+        expectLessThan (maxError, 1.0e-5f);
+    }
+};
+
+static WavetableOscillatorTest wavetableOscillatorTest;
+
+} // namespace dsp
+} // namespace juce